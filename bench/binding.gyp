@@ -0,0 +1,40 @@
+{
+  "targets": [
+    {
+      "target_name": "darts_bench",
+      "type": "executable",
+      "sources": [
+        "native_bench.cpp",
+        "../src/native/third_party/darts/darts.cpp"
+      ],
+      "include_dirs": [
+        "../src/native"
+      ],
+      "cflags!": [
+        "-fno-exceptions"
+      ],
+      "cflags_cc!": [
+        "-fno-exceptions"
+      ],
+      "xcode_settings": {
+        "GCC_ENABLE_CPP_EXCEPTIONS": "YES",
+        "CLANG_CXX_LANGUAGE_STANDARD": "c++17",
+        "GCC_OPTIMIZATION_LEVEL": "3"
+      },
+      "msvs_settings": {
+        "VCCLCompilerTool": {
+          "ExceptionHandling": 1,
+          "AdditionalOptions": [ "/std:c++17" ]
+        }
+      },
+      "conditions": [
+        [
+          "OS=='linux'",
+          {
+            "cflags_cc": [ "-std=c++17", "-O3" ]
+          }
+        ]
+      ]
+    }
+  ]
+}
@@ -0,0 +1,159 @@
+/**
+ * Deterministic corpora for the benchmarks
+ *
+ * The generated sets approximate the shape of real dictionaries (word counts, key lengths
+ * and alphabets) so that results are comparable across machines without shipping word
+ * lists. Real lists can be used instead through `--corpus FILE`.
+ */
+
+/* eslint-disable no-bitwise */
+
+const fs = require('fs');
+
+/**
+ * Small seeded PRNG (mulberry32), so that every run sees the same keys
+ * @param {number} seed
+ * @returns {() => number} generator of floats in [0, 1)
+ */
+function createRandom(seed) {
+  let state = seed >>> 0;
+  return () => {
+    state = (state + 0x6d2b79f5) >>> 0;
+    let t = state;
+    t = Math.imul(t ^ (t >>> 15), t | 1);
+    t ^= t + Math.imul(t ^ (t >>> 7), t | 61);
+    return ((t ^ (t >>> 14)) >>> 0) / 4294967296;
+  };
+}
+
+function pick(random, items) {
+  return items[Math.floor(random() * items.length)];
+}
+
+// Skewed towards the low end, like word frequencies and lengths
+function skewed(random, max) {
+  return Math.floor(random() ** 2 * max);
+}
+
+function codePoints(from, to) {
+  const result = [];
+  for (let c = from; c <= to; c += 1) {
+    result.push(String.fromCodePoint(c));
+  }
+  return result;
+}
+
+const HIRAGANA = codePoints(0x3041, 0x3093);
+const KATAKANA = codePoints(0x30a1, 0x30f3);
+// The most common CJK ideographs are spread over the start of the block
+const KANJI = codePoints(0x4e00, 0x4e00 + 2999);
+
+/**
+ * Japanese words shaped like an IPADIC surface list: mostly 1-4 kanji with kana endings,
+ * plus katakana loanwords
+ */
+function japaneseWord(random) {
+  const kind = random();
+  let word = '';
+  if (kind < 0.2) {
+    const length = 2 + skewed(random, 7);
+    for (let i = 0; i < length; i += 1) {
+      word += pick(random, KATAKANA);
+    }
+    return word;
+  }
+  const stem = 1 + skewed(random, 4);
+  for (let i = 0; i < stem; i += 1) {
+    word += pick(random, KANJI);
+  }
+  const ending = kind < 0.6 ? 0 : 1 + skewed(random, 4);
+  for (let i = 0; i < ending; i += 1) {
+    word += pick(random, HIRAGANA);
+  }
+  return word;
+}
+
+const ONSETS = ['', 'b', 'c', 'd', 'f', 'g', 'h', 'k', 'l', 'm', 'n', 'p', 'r', 's', 't', 'v', 'w',
+  'br', 'ch', 'cl', 'cr', 'dr', 'gr', 'pl', 'pr', 'sh', 'st', 'str', 'th', 'tr'];
+const VOWELS = ['a', 'e', 'i', 'o', 'u', 'ea', 'ou', 'io', 'ai', 'y'];
+const CODAS = ['', '', 'n', 'r', 's', 't', 'l', 'm', 'nd', 'ng', 'st', 'ck', 'rt', 'x'];
+const SUFFIXES = ['', '', '', 's', 'ed', 'ing', 'er', 'ly', 'tion', 'ness', 'able'];
+
+/**
+ * English-like words built from syllables, with inflectional suffixes
+ */
+function englishWord(random) {
+  const syllables = 1 + skewed(random, 4);
+  let word = '';
+  for (let i = 0; i < syllables; i += 1) {
+    word += pick(random, ONSETS) + pick(random, VOWELS) + pick(random, CODAS);
+  }
+  return word + pick(random, SUFFIXES);
+}
+
+/** Generated corpora and their default sizes */
+const CORPORA = {
+  // IPADIC 2.7.0 has about 392k entries
+  ja: { size: 392126, word: japaneseWord },
+  en: { size: 1000000, word: englishWord },
+};
+
+/**
+ * Generates a corpus of unique keys
+ * @param {string} name corpus name, see CORPORA
+ * @param {number} scale fraction of the default size
+ * @returns {string[]} keys in generation order
+ */
+function generateCorpus(name, scale) {
+  const corpus = CORPORA[name];
+  if (!corpus) {
+    throw new Error(`Unknown corpus: ${name} (expected ${Object.keys(CORPORA).join(', ')})`);
+  }
+  const size = Math.max(1, Math.round(corpus.size * scale));
+  const random = createRandom(0x5eed);
+  const keys = new Set();
+  while (keys.size < size) {
+    keys.add(corpus.word(random));
+  }
+  return Array.from(keys);
+}
+
+/**
+ * Reads a word list with one key per line; for a MeCab CSV only the surface is kept
+ * @param {string} filePath
+ * @returns {string[]} unique keys
+ */
+function readCorpus(filePath) {
+  const keys = new Set();
+  fs.readFileSync(filePath, 'utf8')
+    .split(/\r?\n/)
+    .forEach((line) => {
+      const key = line.split(',')[0];
+      if (key) {
+        keys.add(key);
+      }
+    });
+  return Array.from(keys);
+}
+
+/**
+ * Builds the query sets for a corpus
+ * Exact queries are half hits and half near misses; prefix queries are keys followed by
+ * text, as a tokenizer would see them at each position.
+ * @param {string[]} keys
+ * @param {number} count queries per set
+ * @returns {{ exact: string[], prefix: string[] }}
+ */
+function createQueries(keys, count) {
+  const random = createRandom(0x9e3779b9);
+  const exact = [];
+  const prefix = [];
+  for (let i = 0; i < count; i += 1) {
+    const key = pick(random, keys);
+    exact.push(i % 2 === 0 ? key : `${key}${pick(random, keys).charAt(0)}`);
+    prefix.push(key + pick(random, keys) + pick(random, keys));
+  }
+  return { exact, prefix };
+}
+
+module.exports = { CORPORA, generateCorpus, readCorpus, createQueries };
@@ -0,0 +1,268 @@
+// Standalone benchmark of the Darts Double-Array, without N-API in the way.
+//
+// Reads the key set and the query sets written by bench/run.js (one UTF-8 key per line),
+// then measures build throughput, exact and common prefix lookups, save/load time and
+// memory. Results are printed as one JSON object, so that run.js can compare them with
+// the same operations measured through the addon.
+// The addon's batch kernel (batch_lookup.h) and save-time relayout (relayout.h) are
+// measured on the same array, as they need no N-API either.
+//
+// Usage: darts_bench --keys FILE --exact FILE --prefix FILE [--rounds N] [--tmp FILE]
+
+// Include standard library header files first
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#ifdef __linux__
+#include <unistd.h>
+#endif
+
+#include "third_party/darts/darts.h"
+#include "batch_lookup.h"
+#include "relayout.h"
+
+namespace {
+
+typedef std::chrono::steady_clock Clock;
+
+double ElapsedNs(Clock::time_point start) {
+  return std::chrono::duration<double, std::nano>(Clock::now() - start).count();
+}
+
+// Resident set size in bytes, or 0 where it cannot be read
+size_t ResidentBytes() {
+#ifdef __linux__
+  std::FILE* file = std::fopen("/proc/self/statm", "r");
+  if (!file) {
+    return 0;
+  }
+  unsigned long total = 0;
+  unsigned long resident = 0;
+  int fields = std::fscanf(file, "%lu %lu", &total, &resident);
+  std::fclose(file);
+  return fields == 2 ? resident * static_cast<size_t>(sysconf(_SC_PAGESIZE)) : 0;
+#else
+  return 0;
+#endif
+}
+
+bool ReadLines(const char* path, std::vector<std::string>* lines) {
+  std::ifstream file(path, std::ios::binary);
+  if (!file) {
+    std::fprintf(stderr, "Cannot read %s\n", path);
+    return false;
+  }
+  std::string line;
+  while (std::getline(file, line)) {
+    if (!line.empty() && line.back() == '\r') {
+      line.pop_back();
+    }
+    if (!line.empty()) {
+      lines->push_back(line);
+    }
+  }
+  return true;
+}
+
+// One unit of a Darts array, as the addon's kernels read it
+struct Unit {
+  int base;
+  unsigned int check;
+};
+
+// Queries as Darts takes them, with explicit lengths
+struct QuerySet {
+  std::vector<const char*> keys;
+  std::vector<size_t> lengths;
+  size_t bytes = 0;
+};
+
+QuerySet MakeQuerySet(const std::vector<std::string>& lines) {
+  QuerySet set;
+  for (const std::string& line : lines) {
+    set.keys.push_back(line.c_str());
+    set.lengths.push_back(line.length());
+    set.bytes += line.length();
+  }
+  return set;
+}
+
+// Best of several rounds, so that a round disturbed by the scheduler does not count
+template <class Body>
+double BestNsPerOp(size_t rounds, size_t ops, Body body) {
+  double best = 0;
+  for (size_t round = 0; round < rounds; round++) {
+    Clock::time_point start = Clock::now();
+    body();
+    double ns = ElapsedNs(start) / static_cast<double>(ops);
+    if (round == 0 || ns < best) {
+      best = ns;
+    }
+  }
+  return best;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  const char* keys_path = nullptr;
+  const char* exact_path = nullptr;
+  const char* prefix_path = nullptr;
+  const char* tmp_path = "darts_bench.tmp";
+  size_t rounds = 5;
+  for (int i = 1; i + 1 < argc; i += 2) {
+    if (std::strcmp(argv[i], "--keys") == 0) {
+      keys_path = argv[i + 1];
+    } else if (std::strcmp(argv[i], "--exact") == 0) {
+      exact_path = argv[i + 1];
+    } else if (std::strcmp(argv[i], "--prefix") == 0) {
+      prefix_path = argv[i + 1];
+    } else if (std::strcmp(argv[i], "--tmp") == 0) {
+      tmp_path = argv[i + 1];
+    } else if (std::strcmp(argv[i], "--rounds") == 0) {
+      rounds = static_cast<size_t>(std::max(1L, std::strtol(argv[i + 1], nullptr, 10)));
+    }
+  }
+  if (!keys_path || !exact_path || !prefix_path) {
+    std::fprintf(stderr,
+                 "Usage: %s --keys FILE --exact FILE --prefix FILE [--rounds N] [--tmp FILE]\n",
+                 argv[0]);
+    return 2;
+  }
+
+  std::vector<std::string> keys;
+  std::vector<std::string> exact_lines;
+  std::vector<std::string> prefix_lines;
+  if (!ReadLines(keys_path, &keys) || !ReadLines(exact_path, &exact_lines) ||
+      !ReadLines(prefix_path, &prefix_lines)) {
+    return 1;
+  }
+
+  // Darts needs unique keys in byte order, which std::string comparison gives
+  std::sort(keys.begin(), keys.end());
+  keys.erase(std::unique(keys.begin(), keys.end()), keys.end());
+  QuerySet key_set = MakeQuerySet(keys);
+  QuerySet exact = MakeQuerySet(exact_lines);
+  QuerySet prefix = MakeQuerySet(prefix_lines);
+
+  size_t rss_before = ResidentBytes();
+  Darts::DoubleArray dict;
+  Clock::time_point build_start = Clock::now();
+  if (dict.build(key_set.keys.size(), key_set.keys.data(), key_set.lengths.data()) != 0) {
+    std::fprintf(stderr, "Build failed\n");
+    return 1;
+  }
+  double build_ns = ElapsedNs(build_start);
+  size_t rss_after = ResidentBytes();
+
+  // Sinks keep the compiler from dropping the lookups
+  long long exact_sink = 0;
+  size_t exact_hits = 0;
+  auto measure_exact = [&](const Darts::DoubleArray& array) {
+    return BestNsPerOp(rounds, exact.keys.size(), [&]() {
+      exact_hits = 0;
+      for (size_t i = 0; i < exact.keys.size(); i++) {
+        int value = array.exactMatchSearch<int>(exact.keys[i], exact.lengths[i]);
+        exact_sink += value;
+        exact_hits += value >= 0;
+      }
+    });
+  };
+
+  std::vector<int32_t> batch_results(exact.keys.size());
+  auto measure_batch = [&](const Darts::DoubleArray& array) {
+    return BestNsPerOp(rounds, exact.keys.size(), [&]() {
+      node_darts::ExactMatchBatch(
+          static_cast<const Unit*>(array.array()), array.size(), exact.keys.size(),
+          [&exact](size_t i, const char** key, size_t* length) {
+            *key = exact.keys[i];
+            *length = exact.lengths[i];
+          },
+          batch_results.data());
+      exact_sink += batch_results[0];
+    });
+  };
+
+  std::vector<Darts::DoubleArray::result_pair_type> results(256);
+  size_t prefix_matches = 0;
+  auto measure_prefix = [&](const Darts::DoubleArray& array) {
+    return BestNsPerOp(rounds, prefix.keys.size(), [&]() {
+      prefix_matches = 0;
+      for (size_t i = 0; i < prefix.keys.size(); i++) {
+        prefix_matches += array.commonPrefixSearch(prefix.keys[i], results.data(),
+                                                   results.size(), prefix.lengths[i]);
+      }
+    });
+  };
+
+  double exact_ns = measure_exact(dict);
+  double batch_ns = measure_batch(dict);
+  size_t batch_hits = 0;
+  for (int32_t value : batch_results) {
+    batch_hits += value >= 0;
+  }
+  double prefix_ns = measure_prefix(dict);
+
+  // The same lookups on the array as save({ relayout: true }) writes it
+  Clock::time_point relayout_start = Clock::now();
+  std::vector<Unit> relaid = node_darts::RelayoutForCache(
+      static_cast<const Unit*>(dict.array()), dict.size(), node_darts::kRelayoutHotDepth, 257);
+  double relayout_ns = ElapsedNs(relayout_start);
+  Darts::DoubleArray relaid_dict;
+  relaid_dict.set_array(relaid.data(), relaid.size());
+  double relaid_exact_ns = measure_exact(relaid_dict);
+  double relaid_batch_ns = measure_batch(relaid_dict);
+  double relaid_prefix_ns = measure_prefix(relaid_dict);
+
+  Clock::time_point save_start = Clock::now();
+  if (dict.save(tmp_path) != 0) {
+    std::fprintf(stderr, "Cannot write %s\n", tmp_path);
+    return 1;
+  }
+  double save_ns = ElapsedNs(save_start);
+
+  Darts::DoubleArray loaded;
+  double load_ns = BestNsPerOp(rounds, 1, [&]() {
+    if (loaded.open(tmp_path) != 0) {
+      std::fprintf(stderr, "Cannot read %s\n", tmp_path);
+      std::exit(1);
+    }
+  });
+  std::remove(tmp_path);
+
+  std::printf("{\n");
+  std::printf("  \"harness\": \"native\",\n");
+  std::printf("  \"keys\": %zu,\n", key_set.keys.size());
+  std::printf("  \"keyBytes\": %zu,\n", key_set.bytes);
+  std::printf("  \"build\": { \"ms\": %.3f, \"keysPerSec\": %.0f },\n", build_ns / 1e6,
+              static_cast<double>(key_set.keys.size()) / (build_ns / 1e9));
+  std::printf("  \"exactMatchSearch\": { \"queries\": %zu, \"hits\": %zu, \"nsPerOp\": %.2f },\n",
+              exact.keys.size(), exact_hits, exact_ns);
+  std::printf(
+      "  \"exactMatchSearchBatch\": { \"queries\": %zu, \"hits\": %zu, \"nsPerOp\": %.2f },\n",
+      exact.keys.size(), batch_hits, batch_ns);
+  std::printf(
+      "  \"commonPrefixSearch\": { \"queries\": %zu, \"matches\": %zu, \"nsPerOp\": %.2f },\n",
+      prefix.keys.size(), prefix_matches, prefix_ns);
+  std::printf(
+      "  \"relayout\": { \"ms\": %.3f, \"units\": %zu, \"exactMatchSearchNsPerOp\": %.2f, "
+      "\"exactMatchSearchBatchNsPerOp\": %.2f, \"commonPrefixSearchNsPerOp\": %.2f },\n",
+      relayout_ns / 1e6, relaid.size(), relaid_exact_ns, relaid_batch_ns, relaid_prefix_ns);
+  std::printf("  \"save\": { \"ms\": %.3f },\n", save_ns / 1e6);
+  std::printf("  \"load\": { \"ms\": %.3f },\n", load_ns / 1e6);
+  std::printf(
+      "  \"memory\": { \"units\": %zu, \"nonzeroUnits\": %zu, \"arrayBytes\": %zu, "
+      "\"buildRssBytes\": %zu },\n",
+      dict.size(), dict.nonzero_size(), dict.total_size(),
+      rss_after > rss_before ? rss_after - rss_before : 0);
+  std::printf("  \"sink\": %lld\n", exact_sink);
+  std::printf("}\n");
+  return 0;
+}
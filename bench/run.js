@@ -0,0 +1,292 @@
+/**
+ * node-darts benchmark runner
+ *
+ * Measures the same operations twice over the same keys and queries: once in the
+ * standalone C++ harness (bench/native_bench.cpp, the trie alone) and once through the
+ * addon's JS API (trie + N-API + wrappers). Prints one JSON document with both results
+ * and their ratios, so that regressions in either layer can be tracked across releases.
+ *
+ * Usage: node bench/run.js [--corpus ja|en|FILE]... [--scale N] [--queries N]
+ *                          [--rounds N] [--out FILE] [--skip-native] [--skip-node]
+ *
+ * Build first with `yarn build` (the addon) and `yarn bench:build` (the C++ harness),
+ * or run `yarn bench`, which does both.
+ */
+
+/* eslint-disable @typescript-eslint/no-require-imports, no-console */
+
+const { execFileSync } = require('child_process');
+const fs = require('fs');
+const os = require('os');
+const path = require('path');
+const { CORPORA, generateCorpus, readCorpus, createQueries } = require('./corpus');
+
+function parseArgs(argv) {
+  const options = {
+    corpora: [],
+    scale: 1,
+    queries: 200000,
+    rounds: 5,
+    out: null,
+    native: true,
+    node: true,
+  };
+  for (let i = 0; i < argv.length; i += 1) {
+    const arg = argv[i];
+    if (arg === '--corpus') {
+      i += 1;
+      options.corpora.push(argv[i]);
+    } else if (arg === '--scale') {
+      i += 1;
+      options.scale = Number(argv[i]);
+    } else if (arg === '--queries') {
+      i += 1;
+      options.queries = Number(argv[i]);
+    } else if (arg === '--rounds') {
+      i += 1;
+      options.rounds = Number(argv[i]);
+    } else if (arg === '--out') {
+      i += 1;
+      options.out = argv[i];
+    } else if (arg === '--skip-native') {
+      options.native = false;
+    } else if (arg === '--skip-node') {
+      options.node = false;
+    } else {
+      throw new Error(`Unknown argument: ${arg}`);
+    }
+  }
+  if (options.corpora.length === 0) {
+    options.corpora = Object.keys(CORPORA);
+  }
+  return options;
+}
+
+function hrtimeNs(start) {
+  return Number(process.hrtime.bigint() - start);
+}
+
+// Best of several rounds, as in the C++ harness
+function bestNsPerOp(rounds, ops, body) {
+  let best = Infinity;
+  for (let round = 0; round < rounds; round += 1) {
+    const start = process.hrtime.bigint();
+    body();
+    best = Math.min(best, hrtimeNs(start) / ops);
+  }
+  return best;
+}
+
+function round2(value) {
+  return Math.round(value * 100) / 100;
+}
+
+function nativeBinary() {
+  const name = process.platform === 'win32' ? 'darts_bench.exe' : 'darts_bench';
+  return path.join(__dirname, 'build', 'Release', name);
+}
+
+function runNative(files, options) {
+  const binary = nativeBinary();
+  if (!fs.existsSync(binary)) {
+    throw new Error(`${binary} not found; run \`yarn bench:build\` first`);
+  }
+  const output = execFileSync(
+    binary,
+    [
+      '--keys',
+      files.keys,
+      '--exact',
+      files.exact,
+      '--prefix',
+      files.prefix,
+      '--rounds',
+      String(options.rounds),
+      '--tmp',
+      files.nativeDict,
+    ],
+    { encoding: 'utf8', maxBuffer: 1 << 20 }
+  );
+  const result = JSON.parse(output);
+  delete result.sink;
+  return result;
+}
+
+async function runNode(keys, queries, files, options) {
+  // The built package, as the examples use it
+  const { Builder, Dictionary, encodeKeys } = require('../dist');
+  const builder = new Builder();
+  const { rounds } = options;
+  let sink = 0;
+
+  if (global.gc) {
+    global.gc();
+  }
+  const before = process.memoryUsage();
+  let start = process.hrtime.bigint();
+  const dict = builder.build(keys);
+  const buildNs = hrtimeNs(start);
+  const after = process.memoryUsage();
+
+  // Off the main thread; the difference to build is the cost of the worker round trip
+  start = process.hrtime.bigint();
+  const asyncDict = await builder.buildAsync(keys);
+  const asyncBuildNs = hrtimeNs(start);
+  asyncDict.dispose();
+
+  // Lookups through the public API, one N-API crossing per call
+  const exactNs = bestNsPerOp(rounds, queries.exact.length, () => {
+    for (let i = 0; i < queries.exact.length; i += 1) {
+      sink += dict.exactMatchSearch(queries.exact[i]);
+    }
+  });
+  const results = new Int32Array(queries.exact.length);
+  const batchNs = bestNsPerOp(rounds, queries.exact.length, () => {
+    sink += dict.exactMatchSearchBatch(queries.exact, results)[0];
+  });
+  const encoded = encodeKeys(queries.exact);
+  const bufferNs = bestNsPerOp(rounds, queries.exact.length, () => {
+    sink += dict.exactMatchSearchBuffer(encoded.buffer, encoded.offsets, results)[0];
+  });
+  const prefixNs = bestNsPerOp(rounds, queries.prefix.length, () => {
+    for (let i = 0; i < queries.prefix.length; i += 1) {
+      sink += dict.commonPrefixSearch(queries.prefix[i]).length;
+    }
+  });
+  const pairs = new Int32Array(512);
+  const prefixIntoNs = bestNsPerOp(rounds, queries.prefix.length, () => {
+    for (let i = 0; i < queries.prefix.length; i += 1) {
+      sink += dict.commonPrefixSearchInto(queries.prefix[i], pairs);
+    }
+  });
+
+  start = process.hrtime.bigint();
+  dict.saveSync(files.nodeDict);
+  const saveNs = hrtimeNs(start);
+  const fileBytes = fs.statSync(files.nodeDict).size;
+
+  const loaded = new Dictionary();
+  const loadNs = bestNsPerOp(rounds, 1, () => loaded.loadSync(files.nodeDict));
+  const mmapNs = bestNsPerOp(rounds, 1, () => loaded.loadSync(files.nodeDict, { mmap: true }));
+  loaded.dispose();
+
+  dict.dispose();
+  return {
+    harness: 'node',
+    keys: keys.length,
+    build: {
+      ms: round2(buildNs / 1e6),
+      keysPerSec: Math.round(keys.length / (buildNs / 1e9)),
+      asyncMs: round2(asyncBuildNs / 1e6),
+    },
+    exactMatchSearch: { queries: queries.exact.length, nsPerOp: round2(exactNs) },
+    exactMatchSearchBatch: { queries: queries.exact.length, nsPerOp: round2(batchNs) },
+    exactMatchSearchBuffer: { queries: queries.exact.length, nsPerOp: round2(bufferNs) },
+    commonPrefixSearch: { queries: queries.prefix.length, nsPerOp: round2(prefixNs) },
+    commonPrefixSearchInto: { queries: queries.prefix.length, nsPerOp: round2(prefixIntoNs) },
+    save: { ms: round2(saveNs / 1e6) },
+    load: { ms: round2(loadNs / 1e6), mmapMs: round2(mmapNs / 1e6) },
+    memory: {
+      fileBytes,
+      buildRssBytes: Math.max(0, after.rss - before.rss),
+      heapUsedBytes: Math.max(0, after.heapUsed - before.heapUsed),
+      externalBytes: Math.max(0, after.external - before.external),
+    },
+    // Keeps the lookups observable; dropped from the report
+    sink,
+  };
+}
+
+// How much slower the N-API path is than the trie alone (1 = no overhead)
+function ratios(native, node) {
+  const ratio = (a, b) => round2(a / b);
+  return {
+    exactMatchSearch: ratio(node.exactMatchSearch.nsPerOp, native.exactMatchSearch.nsPerOp),
+    // Both batch calls go through the same prefetching kernel as the native batch
+    exactMatchSearchBatch: ratio(
+      node.exactMatchSearchBatch.nsPerOp,
+      native.exactMatchSearchBatch.nsPerOp
+    ),
+    exactMatchSearchBuffer: ratio(
+      node.exactMatchSearchBuffer.nsPerOp,
+      native.exactMatchSearchBatch.nsPerOp
+    ),
+    commonPrefixSearch: ratio(node.commonPrefixSearch.nsPerOp, native.commonPrefixSearch.nsPerOp),
+    commonPrefixSearchInto: ratio(
+      node.commonPrefixSearchInto.nsPerOp,
+      native.commonPrefixSearch.nsPerOp
+    ),
+    build: ratio(node.build.ms, native.build.ms),
+  };
+}
+
+async function runCorpus(corpus, options, tempDir) {
+  const isFile = !CORPORA[corpus];
+  const keys = isFile ? readCorpus(corpus) : generateCorpus(corpus, options.scale);
+  const queries = createQueries(keys, options.queries);
+
+  const files = {
+    keys: path.join(tempDir, 'keys.txt'),
+    exact: path.join(tempDir, 'exact.txt'),
+    prefix: path.join(tempDir, 'prefix.txt'),
+    nativeDict: path.join(tempDir, 'native.darts'),
+    nodeDict: path.join(tempDir, 'node.darts'),
+  };
+  fs.writeFileSync(files.keys, keys.join('\n'));
+  fs.writeFileSync(files.exact, queries.exact.join('\n'));
+  fs.writeFileSync(files.prefix, queries.prefix.join('\n'));
+
+  const result = {
+    corpus: isFile ? path.basename(corpus) : corpus,
+    keys: keys.length,
+    keyBytes: keys.reduce((total, key) => total + Buffer.byteLength(key, 'utf8'), 0),
+  };
+  if (options.native) {
+    console.error(`[${result.corpus}] native harness, ${keys.length} keys`);
+    result.native = runNative(files, options);
+  }
+  if (options.node) {
+    console.error(`[${result.corpus}] node harness, ${keys.length} keys`);
+    result.node = await runNode(keys, queries, files, options);
+    delete result.node.sink;
+  }
+  if (result.native && result.node) {
+    result.ratio = ratios(result.native, result.node);
+  }
+  return result;
+}
+
+async function main() {
+  const options = parseArgs(process.argv.slice(2));
+  const tempDir = fs.mkdtempSync(path.join(os.tmpdir(), 'node-darts-bench-'));
+  try {
+    const report = {
+      version: require('../package.json').version,
+      node: process.version,
+      platform: `${process.platform}-${process.arch}`,
+      cpu: os.cpus()[0] ? os.cpus()[0].model : 'unknown',
+      date: new Date().toISOString(),
+      options: { scale: options.scale, queries: options.queries, rounds: options.rounds },
+      results: [],
+    };
+    for (let i = 0; i < options.corpora.length; i += 1) {
+      // Sequential on purpose, so that runs do not compete for the CPU
+      // eslint-disable-next-line no-await-in-loop
+      report.results.push(await runCorpus(options.corpora[i], options, tempDir));
+    }
+
+    const json = `${JSON.stringify(report, null, 2)}\n`;
+    if (options.out) {
+      fs.writeFileSync(options.out, json);
+    } else {
+      process.stdout.write(json);
+    }
+  } finally {
+    fs.rmSync(tempDir, { recursive: true, force: true });
+  }
+}
+
+main().catch((error) => {
+  console.error(error);
+  process.exit(1);
+});
@@ -10,7 +10,23 @@
       "sources": [
         "src/native/bindings.cpp",
         "src/native/dictionary.cpp",
+        "src/native/array_builder.cpp",
         "src/native/builder.cpp",
+        "src/native/compact_array.cpp",
+        "src/native/compressed_file.cpp",
+        "src/native/cursor.cpp",
+        "src/native/delta_layer.cpp",
+        "src/native/dict_group.cpp",
+        "src/native/dictionary_group.cpp",
+        "src/native/file_format.cpp",
+        "src/native/key_arena.cpp",
+        "src/native/key_index.cpp",
+        "src/native/layered_dictionary.cpp",
+        "src/native/lookup_stats.cpp",
+        "src/native/scan_table.cpp",
+        "src/native/stream_builder.cpp",
+        "src/native/storage.cpp",
+        "src/native/value_table.cpp",
         "src/native/third_party/darts/darts.cpp"
       ],
       "include_dirs": [
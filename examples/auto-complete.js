@@ -41,6 +41,29 @@ const words = [
 // Build the dictionary (values are word indices)
 const dict = buildDictionary(words);
 
+// The cursor remembers the trie node reached by the previous input, so when the user
+// keeps typing only the newly typed characters have to be traversed
+const cursor = dict.createCursor();
+let typed = '';
+
+/**
+ * Function to check whether any word starts with the input
+ * @param {string} input The current input
+ * @returns {boolean} false if no dictionary word starts with the input
+ */
+function hasCandidates(input) {
+  if (input.startsWith(typed)) {
+    cursor.advance(input.substring(typed.length));
+  } else {
+    cursor.reset();
+    cursor.advance(input);
+  }
+  typed = input;
+
+  // -2 means that the trie has no path for the input
+  return cursor.status !== -2;
+}
+
 /**
  * Function to get auto-completion candidates
  * @param {string} prefix The input prefix
@@ -50,18 +73,9 @@ const dict = buildDictionary(words);
 function getCompletions(prefix, limit = 5) {
   if (!prefix) return [];
 
-  // Get candidates using common prefix search
-  const results = [];
-
-  // Check if each word starts with the prefix
-  for (let i = 0; i < words.length; i += 1) {
-    if (words[i].startsWith(prefix)) {
-      results.push(words[i]);
-      if (results.length >= limit) break;
-    }
-  }
-
-  return results;
+  // Enumerate the words starting with the prefix directly from the trie,
+  // so the word list does not have to be kept in memory
+  return dict.predictiveSearchKeys(prefix, limit).map((result) => result.key);
 }
 
 // Interactive auto-complete demo
@@ -81,7 +95,7 @@ function prompt() {
       return;
     }
 
-    const completions = getCompletions(input);
+    const completions = hasCandidates(input) ? getCompletions(input) : [];
 
     if (completions.length > 0) {
       console.log('Completion candidates:');
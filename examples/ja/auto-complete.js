@@ -41,6 +41,29 @@ const words = [
 // TextDartsクラスを使用する方法
 const darts = TextDarts.build(words);
 
+// カーソルは前回の入力で到達したTrieのノードを覚えているため、
+// 入力が続く場合は新しく入力された文字だけをたどれば済みます
+const cursor = darts.createCursor();
+let typed = '';
+
+/**
+ * 入力から始まる単語があるかを調べる関数
+ * @param {string} input 現在の入力
+ * @returns {boolean} 入力から始まる辞書の単語がなければfalse
+ */
+function hasCandidates(input) {
+  if (input.startsWith(typed)) {
+    cursor.advance(input.substring(typed.length));
+  } else {
+    cursor.reset();
+    cursor.advance(input);
+  }
+  typed = input;
+
+  // -2 はTrieに入力の経路がないことを表します
+  return cursor.status !== -2;
+}
+
 /**
  * 自動補完候補を取得する関数
  * @param {string} prefix 入力された接頭辞
@@ -50,18 +73,9 @@ const darts = TextDarts.build(words);
 function getCompletions(prefix, limit = 5) {
   if (!prefix) return [];
 
-  // 共通接頭辞検索を使用して候補を取得
-  const results = [];
-
-  // 各単語について、prefixから始まるかチェック
-  for (let i = 0; i < words.length; i += 1) {
-    if (words[i].startsWith(prefix)) {
-      results.push(words[i]);
-      if (results.length >= limit) break;
-    }
-  }
-
-  return results;
+  // 予測検索でprefixから始まる単語をTrieから直接列挙する
+  // （単語リストをメモリに保持しておく必要はありません）
+  return darts.predictiveSearchKeys(prefix, limit).map((result) => result.key);
 }
 
 // インタラクティブな自動補完デモ
@@ -81,10 +95,7 @@ function prompt() {
       return;
     }
 
-    // TextDartsクラスを使用した共通接頭辞検索の例
-    // 注: この例では単純化のためにgetCompletions関数を使用していますが、
-    // 実際のアプリケーションではdarts.commonPrefixSearchを活用できます
-    const completions = getCompletions(input);
+    const completions = hasCandidates(input) ? getCompletions(input) : [];
 
     if (completions.length > 0) {
       console.log('補完候補:');
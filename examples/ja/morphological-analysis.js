@@ -39,36 +39,16 @@ console.log('辞書構築成功！');
  * @returns {Array<{word: string, pos: number}>} 解析結果
  */
 function analyzeText(text) {
+  // 1回のネイティブ呼び出しでテキスト全体を分割する：(開始, 長さ, 値) の三つ組で、
+  // 各位置で最長の単語を取り、一致しない位置は未知の1文字（値 -1）になる
+  const tokens = dict.tokenize(text, 'longest');
   const result = [];
-  let position = 0;
-
-  while (position < text.length) {
-    let found = false;
-
-    // 現在位置から始まる最長の単語を探す
-    for (let len = Math.min(10, text.length - position); len > 0; len--) {
-      const substr = text.substring(position, position + len);
-      const value = dict.exactMatchSearch(substr);
-
-      if (value !== -1) {
-        result.push({
-          word: substr,
-          pos: value,
-        });
-        position += len;
-        found = true;
-        break;
-      }
-    }
-
-    // 辞書に見つからない場合は1文字進める
-    if (!found) {
-      result.push({
-        word: text[position],
-        pos: -1, // 未知語
-      });
-      position++;
-    }
+
+  for (let i = 0; i < tokens.length; i += 3) {
+    result.push({
+      word: text.substring(tokens[i], tokens[i] + tokens[i + 1]),
+      pos: tokens[i + 2],
+    });
   }
 
   return result;
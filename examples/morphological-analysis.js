@@ -52,36 +52,16 @@ console.log('Dictionary built successfully!');
  * @returns {Array<{word: string, pos: number}>} Analysis results
  */
 function analyzeText(text) {
+  // One native call splits the whole text: (start, length, value) triples, taking the
+  // longest word at each position and one unknown character (value -1) where none matches
+  const tokens = dict.tokenize(text, 'longest');
   const result = [];
-  let position = 0;
-
-  while (position < text.length) {
-    let found = false;
-
-    // Find the longest word starting from the current position
-    for (let len = Math.min(10, text.length - position); len > 0; len -= 1) {
-      const substr = text.substring(position, position + len);
-      const value = dict.exactMatchSearch(substr);
-
-      if (value !== -1) {
-        result.push({
-          word: substr,
-          pos: value,
-        });
-        position += len;
-        found = true;
-        break;
-      }
-    }
-
-    // If not found in the dictionary, advance by one character
-    if (!found) {
-      result.push({
-        word: text[position],
-        pos: -1, // Unknown word
-      });
-      position += 1;
-    }
+
+  for (let i = 0; i < tokens.length; i += 3) {
+    result.push({
+      word: text.substring(tokens[i], tokens[i] + tokens[i + 1]),
+      pos: tokens[i + 2],
+    });
   }
 
   return result;
@@ -1,6 +1,7 @@
 import { dartsNative } from './native';
 import Dictionary from './dictionary';
-import { BuildOptions } from './types';
+import StreamBuilder from './stream-builder';
+import { BuildOptions, NativeBuildOptions, NativeCancelToken, StreamBuildOptions } from './types';
 import { BuildError } from './errors';
 
 /**
@@ -27,7 +28,7 @@ export default class Builder {
 
     // Create local variables to avoid modifying function parameters
     let keys = inputKeys;
-    let values = inputValues;
+    let values = Builder.tableRowValues(inputKeys, inputValues, options);
 
     // Sort keys
     if (!Builder.isSorted(keys)) {
@@ -54,28 +55,125 @@ export default class Builder {
       values = sortedValues;
     }
 
-    // If there is a progress callback, use a dummy implementation (progress callback is not supported in the current native implementation)
-    if (options?.progressCallback) {
-      const total = keys.length;
-      let current = 0;
-      const interval = setInterval(() => {
-        current = Math.min(current + Math.floor(total / 10), total);
-        options.progressCallback!(current, total);
-        if (current >= total) {
-          clearInterval(interval);
-        }
-      }, 100);
-    }
-
+    // Progress is reported by the native build as keys are placed
+    const cancellation = Builder.linkSignal(options?.signal);
     try {
-      const handle = dartsNative.build(keys, values);
-      return new Dictionary(handle, keys);
+      const handle = dartsNative.build(keys, values, {
+        threads: options?.threads,
+        placement: options?.placement,
+        unitFormat: options?.unitFormat,
+        keyIndex: options?.keyIndex,
+        scanTable: options?.scanTable,
+        valueTable: options?.valueTable,
+        progress: options?.progressCallback,
+        progressInterval: options?.progressInterval,
+        cancelToken: cancellation.token,
+      });
+      return new Dictionary(handle);
     } catch (error) {
       if (error instanceof BuildError) {
         throw error;
       }
       throw new BuildError(error instanceof Error ? error.message : String(error));
+    } finally {
+      cancellation.unlink();
+    }
+  }
+
+  /**
+   * Builds a Double-Array from keys and values asynchronously
+   * Keys are sorted and the Double-Array is constructed on a background thread,
+   * so the event loop is not blocked by large builds
+   * @param keys array of keys (need not be sorted)
+   * @param values array of values (indices are used if omitted)
+   * @param options build options
+   * @returns promise resolving to the constructed Dictionary object
+   * @throws {BuildError} if the build fails
+   */
+  public async buildAsync(
+    keys: string[],
+    values?: number[],
+    options?: BuildOptions
+  ): Promise<Dictionary> {
+    // Use this to reference the class instance (to satisfy ESLint rule)
+    // eslint-disable-next-line @typescript-eslint/no-unused-vars
+    const builderName = this.name;
+    Builder.validateInput(keys, values);
+
+    const progressCallback = options?.progressCallback;
+    let settled = false;
+    let lastCurrent = -1;
+    let lastTotal = keys.length;
+    const nativeOptions: NativeBuildOptions = {
+      threads: options?.threads,
+      placement: options?.placement,
+      unitFormat: options?.unitFormat,
+      keyIndex: options?.keyIndex,
+      scanTable: options?.scanTable,
+      progressInterval: options?.progressInterval,
+      valueTable: options?.valueTable,
+    };
+    if (progressCallback) {
+      // Updates are queued from the build thread and may arrive after the build has finished
+      nativeOptions.progress = (current, total) => {
+        if (!settled) {
+          lastCurrent = current;
+          lastTotal = total;
+          progressCallback(current, total);
+        }
+      };
+    }
+
+    const cancellation = Builder.linkSignal(options?.signal);
+    nativeOptions.cancelToken = cancellation.token;
+    let handle: number;
+    try {
+      handle = await dartsNative.buildAsync(
+        keys,
+        Builder.tableRowValues(keys, values, options),
+        nativeOptions
+      );
+    } finally {
+      settled = true;
+      cancellation.unlink();
+    }
+
+    // Make sure the final update is seen before the promise resolves
+    if (progressCallback && lastCurrent !== lastTotal) {
+      progressCallback(lastTotal, lastTotal);
     }
+
+    return new Dictionary(handle);
+  }
+
+  /**
+   * Creates a streaming builder for key sets too large for a JS array
+   * @param options streaming build options
+   * @returns a StreamBuilder fed with chunks of `key` or `key\tvalue` lines
+   */
+  public createStream(options?: StreamBuildOptions): StreamBuilder {
+    // Use this to reference the class instance (to satisfy ESLint rule)
+    // eslint-disable-next-line @typescript-eslint/no-unused-vars
+    const builderName = this.name;
+    return new StreamBuilder(options);
+  }
+
+  /**
+   * Builds a Double-Array from a file of `key` or `key\tvalue` lines
+   * The file is read, sorted and built on a background thread without loading the keys into
+   * JS; it need not be sorted.
+   * @param filePath path to the key file
+   * @param options streaming build options
+   * @returns promise resolving to the constructed Dictionary object
+   * @throws {FileNotFoundError} if the file is not found
+   * @throws {BuildError} if the build fails
+   */
+  public async buildFromFile(filePath: string, options?: StreamBuildOptions): Promise<Dictionary> {
+    // Use this to reference the class instance (to satisfy ESLint rule)
+    // eslint-disable-next-line @typescript-eslint/no-unused-vars
+    const builderName = this.name;
+    const handle = await dartsNative.buildFromFileAsync(filePath, options?.memoryLimit);
+    return new Dictionary(handle);
   }
 
   /**
@@ -93,14 +191,12 @@ export default class Builder {
     values?: number[],
     options?: BuildOptions
   ): Promise<boolean> {
-    return new Promise((resolve, reject) => {
-      try {
-        const result = this.buildAndSaveSync(keys, filePath, values, options);
-        resolve(result);
-      } catch (error) {
-        reject(error);
-      }
-    });
+    const dictionary = await this.buildAsync(keys, values, options);
+    try {
+      return await dictionary.save(filePath);
+    } finally {
+      dictionary.dispose();
+    }
   }
 
   /**
@@ -127,6 +223,24 @@ export default class Builder {
     }
   }
 
+  /**
+   * Gets the values to build with: with a value table, each key's value is its row
+   * @throws {BuildError} if values are given along with a value table
+   */
+  private static tableRowValues(
+    keys: string[],
+    values: number[] | undefined,
+    options: BuildOptions | undefined
+  ): number[] | undefined {
+    if (!options?.valueTable) {
+      return values;
+    }
+    if (values !== undefined) {
+      throw new BuildError('Values cannot be combined with a value table');
+    }
+    return keys.map((_, i) => i);
+  }
+
   /**
    * Validates the input values
    * @param keys array of keys
@@ -159,6 +273,29 @@ export default class Builder {
     }
   }
 
+  /**
+   * Creates a native cancel token that follows an abort signal
+   * @param signal abort signal, if any
+   * @returns the token and a function that stops following the signal
+   * @throws {BuildError} if the signal has already been aborted
+   */
+  private static linkSignal(signal?: AbortSignal): {
+    token?: NativeCancelToken;
+    unlink: () => void;
+  } {
+    if (!signal) {
+      return { unlink: () => {} };
+    }
+    if (signal.aborted) {
+      throw new BuildError('Build cancelled');
+    }
+
+    const token = dartsNative.createCancelToken();
+    const onAbort = () => token.cancel();
+    signal.addEventListener('abort', onAbort, { once: true });
+    return { token, unlink: () => signal.removeEventListener('abort', onAbort) };
+  }
+
   /**
    * Checks if an array is sorted
    * @param arr array to check
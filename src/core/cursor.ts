@@ -0,0 +1,72 @@
+import { NativeTraverseCursor } from './types';
+import { DartsError } from './errors';
+
+/**
+ * Resumable trie traversal
+ * Keeps the reached node between calls so that a key can be fed incrementally,
+ * e.g. one keystroke at a time, without walking the prefix again.
+ */
+export default class TraverseCursor {
+  private readonly cursor: NativeTraverseCursor;
+
+  /**
+   * Constructor
+   * @param cursor native cursor
+   */
+  constructor(cursor: NativeTraverseCursor) {
+    this.cursor = cursor;
+  }
+
+  /**
+   * Continues the traversal with the next key fragment
+   * @param key key fragment; strings are encoded as UTF-8
+   * @returns the value if the key read so far is in the dictionary, -1 if it is only a prefix
+   * of a dictionary key, -2 if no dictionary key starts with it
+   * @throws {DartsError} if the fragment is not a string or Uint8Array
+   */
+  public advance(key: string | Uint8Array): number {
+    try {
+      return this.cursor.advance(key);
+    } catch (error) {
+      throw new DartsError(
+        `Failed to advance cursor: ${error instanceof Error ? error.message : String(error)}`
+      );
+    }
+  }
+
+  /**
+   * Returns the cursor to the root
+   */
+  public reset(): void {
+    this.cursor.reset();
+  }
+
+  /**
+   * Copies the cursor, e.g. to explore several continuations of the same prefix
+   * @returns an independent cursor at the same position
+   */
+  public clone(): TraverseCursor {
+    return new TraverseCursor(this.cursor.clone());
+  }
+
+  /**
+   * Status of the last advance (-1 at the root)
+   */
+  public get status(): number {
+    return this.cursor.status;
+  }
+
+  /**
+   * Node position in the Double-Array
+   */
+  public get nodePos(): number {
+    return this.cursor.nodePos;
+  }
+
+  /**
+   * Number of UTF-8 bytes consumed since the last reset
+   */
+  public get keyPos(): number {
+    return this.cursor.keyPos;
+  }
+}
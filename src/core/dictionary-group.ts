@@ -0,0 +1,78 @@
+import { dartsNative } from './native';
+import Dictionary from './dictionary';
+import { DictionaryGroupOptions, NativeDictionaryGroup, TokenizeMode } from './types';
+import { DartsError } from './errors';
+
+/**
+ * Several dictionaries searched as one
+ * Each lookup runs against every member in a single native call, e.g. a system, a domain
+ * and a user dictionary at every position of a text, and returns one flat array in which
+ * each match is tagged with the index of the member it comes from. Members are in priority
+ * order; see `DictionaryGroupOptions.duplicates` for keys held by several of them.
+ */
+export default class DictionaryGroup {
+  private readonly group: NativeDictionaryGroup;
+
+  /**
+   * Constructor
+   * The group keeps reading the members as they are now: they may be disposed, swapped or
+   * reloaded afterwards without affecting it.
+   * @param members dictionaries to search, highest priority first
+   * @param options how keys held by several members are reported
+   * @throws {DartsError} if there are no members, a member is disposed or an option is invalid
+   */
+  constructor(members: Dictionary[], options?: DictionaryGroupOptions) {
+    this.group = dartsNative.createDictionaryGroup(
+      members.map((member) => member.getHandle()),
+      options
+    );
+  }
+
+  /**
+   * Looks a key up in every member
+   * @param key search key
+   * @returns flat array of (source, value) pairs in member order: at most one pair, from
+   * the first member holding the key, unless duplicates are kept
+   */
+  public exactMatchSearch(key: string): Int32Array {
+    return this.group.exactMatchSearch(key);
+  }
+
+  /**
+   * Finds the keys of every member that are prefixes of a key
+   * @param key search key
+   * @returns flat array of (source, value, length) triples ordered by length and then by
+   * member, with lengths in UTF-16 code units
+   */
+  public commonPrefixSearch(key: string): Int32Array {
+    return this.group.commonPrefixSearch(key);
+  }
+
+  /**
+   * Splits a text into tokens found in any member, see `TokenizeMode`
+   * In 'longest' mode the longest match wins whichever member it comes from, and the
+   * first member holding it among matches of the same length.
+   * @param text text to split
+   * @param mode how the text is split (default 'longest')
+   * @returns flat array of (start, length, value, source) quadruples ordered by start, then
+   * by length and then by member, with positions in UTF-16 code units, and value and
+   * source -1 for unknown code points
+   * @throws {DartsError} if the mode is invalid
+   */
+  public tokenize(text: string, mode: TokenizeMode = 'longest'): Int32Array {
+    try {
+      return this.group.tokenize(text, mode);
+    } catch (error) {
+      throw new DartsError(
+        `Failed to tokenize: ${error instanceof Error ? error.message : String(error)}`
+      );
+    }
+  }
+
+  /**
+   * Number of member dictionaries
+   */
+  public get size(): number {
+    return this.group.size;
+  }
+}
@@ -1,6 +1,18 @@
 import { dartsNative } from './native';
-import { TraverseCallback, WordReplacer } from './types';
+import {
+  BufferLoadOptions,
+  DictionaryStats,
+  EntryRange,
+  LoadOptions,
+  PredictiveSearchResult,
+  SaveOptions,
+  TokenizeMode,
+  TraverseCallback,
+  ValueTable,
+  WordReplacer,
+} from './types';
 import { DartsError } from './errors';
+import TraverseCursor from './cursor';
 
 /**
  * Darts Dictionary class
@@ -11,17 +23,13 @@ export default class Dictionary {
 
   private isDisposed: boolean;
 
-  private words: string[];
-
   /**
    * Constructor
    * @param handle Dictionary handle (optional)
-   * @param words Array of words (optional)
    */
-  constructor(handle?: number, words?: string[]) {
+  constructor(handle?: number) {
     this.handle = handle !== undefined ? handle : dartsNative.createDictionary();
     this.isDisposed = false;
-    this.words = words || [];
   }
 
   /**
@@ -33,79 +41,320 @@ export default class Dictionary {
     return this.handle;
   }
 
+  /**
+   * Publishes the dictionary so that other worker threads can use it without loading a copy
+   * The token is a number and can be sent with postMessage or workerData; pass it to
+   * `attachDictionary` in the other thread. The array stays in memory until every thread
+   * that attached to it has disposed its dictionary.
+   * @returns token identifying the dictionary within this process
+   * @throws {DartsError} if the dictionary cannot be shared
+   */
+  public share(): number {
+    this.ensureNotDisposed();
+    return dartsNative.shareDictionary(this.handle);
+  }
+
   /**
    * Performs an exact match search
-   * @param key search key
+   * @param key search key, or its UTF-8 bytes (e.g. a Buffer), which are read in place
+   * @param offset start of the key when it is a Uint8Array (default 0)
+   * @param length bytes of the key when it is a Uint8Array (default: to the end)
    * @returns the corresponding value if found, -1 otherwise
    * @throws {DartsError} if the search fails
    */
-  public exactMatchSearch(key: string): number {
+  public exactMatchSearch(key: string | Uint8Array, offset?: number, length?: number): number {
     this.ensureNotDisposed();
+    return dartsNative.exactMatchSearch(this.handle, key, offset, length);
+  }
 
-    // Return -1 if the dictionary is empty
-    if (this.size() === 0) {
-      return -1;
-    }
+  /**
+   * Performs exact match searches for many keys in a single native call
+   * @param keys search keys, as strings or UTF-8 bytes
+   * @param results optional array to write the values into, reused across calls to avoid allocations
+   * @returns the values for each key, -1 where not found
+   * @throws {DartsError} if the search fails
+   */
+  public exactMatchSearchBatch(keys: (string | Uint8Array)[], results?: Int32Array): Int32Array {
+    this.ensureNotDisposed();
+    return dartsNative.exactMatchSearchBatch(this.handle, keys, results);
+  }
 
-    return dartsNative.exactMatchSearch(this.handle, key);
+  /**
+   * Performs exact match searches for keys concatenated in one UTF-8 buffer (see `encodeKeys`)
+   * @param keys UTF-8 encoded keys
+   * @param offsets key boundaries; key i spans offsets[i] to offsets[i + 1]
+   * @param results optional array to write the values into, reused across calls to avoid allocations
+   * @returns the values for each key, -1 where not found
+   * @throws {DartsError} if the search fails
+   */
+  public exactMatchSearchBuffer(
+    keys: Uint8Array,
+    offsets: Uint32Array,
+    results?: Int32Array
+  ): Int32Array {
+    this.ensureNotDisposed();
+    return dartsNative.exactMatchSearchBuffer(this.handle, keys, offsets, results);
   }
 
   /**
    * Performs a common prefix search
-   * @param key search key
+   * @param key search key, or its UTF-8 bytes (e.g. a Buffer), which are read in place
+   * @param offset start of the key when it is a Uint8Array (default 0)
+   * @param length bytes of the key when it is a Uint8Array (default: to the end)
    * @returns array of found values
    * @throws {DartsError} if the search fails
    */
-  public commonPrefixSearch(key: string): number[] {
+  public commonPrefixSearch(key: string | Uint8Array, offset?: number, length?: number): number[] {
     this.ensureNotDisposed();
+    return dartsNative.commonPrefixSearch(this.handle, key, offset, length);
+  }
 
-    // Return an empty array if the dictionary is empty
-    if (this.size() === 0) {
-      return [];
-    }
+  /**
+   * Performs a common prefix search returning the length of each match
+   * @param key search key, or its UTF-8 bytes (e.g. a Buffer), which are read in place
+   * @param offset start of the key when it is a Uint8Array (default 0)
+   * @param length bytes of the key when it is a Uint8Array (default: to the end)
+   * @returns flat (value, length) pairs ordered by length, lengths in UTF-16 code units, or in
+   * bytes for a Uint8Array key
+   * @throws {DartsError} if the search fails
+   */
+  public commonPrefixSearchPairs(
+    key: string | Uint8Array,
+    offset?: number,
+    length?: number
+  ): Int32Array {
+    this.ensureNotDisposed();
+    return dartsNative.commonPrefixSearchPairs(this.handle, key, offset, length);
+  }
 
-    return dartsNative.commonPrefixSearch(this.handle, key);
+  /**
+   * Performs a common prefix search into a caller-supplied array without allocating
+   * @param key search key, or its UTF-8 bytes (e.g. a Buffer), which are read in place
+   * @param results array receiving flat (value, length) pairs, reused across calls; lengths are
+   * in UTF-16 code units, or in bytes for a Uint8Array key
+   * @param offset start of the key when it is a Uint8Array (default 0)
+   * @param length bytes of the key when it is a Uint8Array (default: to the end)
+   * @returns total number of matches; if it exceeds results.length / 2, only the shortest fit
+   * @throws {DartsError} if the search fails
+   */
+  public commonPrefixSearchInto(
+    key: string | Uint8Array,
+    results: Int32Array,
+    offset?: number,
+    length?: number
+  ): number {
+    this.ensureNotDisposed();
+    return dartsNative.commonPrefixSearchInto(this.handle, key, results, offset, length);
+  }
+
+  /**
+   * Finds the entries of a key in the value table, see `BuildOptions.valueTable`
+   * @param key search key, or its UTF-8 bytes (e.g. a Buffer), which are read in place
+   * @param offset start of the key when it is a Uint8Array (default 0)
+   * @param length bytes of the key when it is a Uint8Array (default: to the end)
+   * @returns the range of the key's entries in `getValueTable().entries`, or null if the key
+   * is not found
+   * @throws {DartsError} if the dictionary has no value table
+   */
+  public exactMatchEntries(
+    key: string | Uint8Array,
+    offset?: number,
+    length?: number
+  ): EntryRange | null {
+    this.ensureNotDisposed();
+    return dartsNative.exactMatchEntries(this.handle, key, offset, length);
+  }
+
+  /**
+   * Finds the entries of every dictionary key that is a prefix of the key
+   * @param key search key, or its UTF-8 bytes (e.g. a Buffer), which are read in place
+   * @param offset start of the key when it is a Uint8Array (default 0)
+   * @param length bytes of the key when it is a Uint8Array (default: to the end)
+   * @returns flat (offset, count, length) triples, shortest prefix first; lengths are in
+   * UTF-16 code units, or in bytes for a Uint8Array key
+   * @throws {DartsError} if the dictionary has no value table
+   */
+  public commonPrefixSearchEntries(
+    key: string | Uint8Array,
+    offset?: number,
+    length?: number
+  ): Float64Array {
+    this.ensureNotDisposed();
+    return dartsNative.commonPrefixSearchEntries(this.handle, key, offset, length);
+  }
+
+  /**
+   * Gets the value table without copying it
+   * The entries stay valid after the dictionary is disposed or reloaded.
+   * @returns the value table, or undefined if the dictionary has none
+   * @throws {DartsError} if the table cannot be read
+   */
+  public getValueTable(): ValueTable | undefined {
+    this.ensureNotDisposed();
+    return dartsNative.getValueTable(this.handle);
+  }
+
+  /**
+   * Restores the key that has the value, see `BuildOptions.keyIndex`
+   * Keys are read from native memory (or the mapped file), so this also works on
+   * dictionaries loaded from a file. Takes time proportional to the key length when the
+   * values are the key indices, as they are by default.
+   * @param value value of the key
+   * @returns the key, the first one in byte order if several keys share the value, or
+   * undefined if no key has the value
+   * @throws {DartsError} if the dictionary was built or saved without a key index
+   */
+  public restoreKey(value: number): string | undefined {
+    this.ensureNotDisposed();
+    return dartsNative.restoreKey(this.handle, value);
+  }
+
+  /**
+   * Performs a predictive search, enumerating the keys that start with the prefix
+   * @param prefix search prefix
+   * @param limit maximum number of results (0 or omitted for all)
+   * @returns values of the matching keys, in key (UTF-8 byte) order
+   * @throws {DartsError} if the search fails
+   */
+  public predictiveSearch(prefix: string, limit?: number): number[] {
+    this.ensureNotDisposed();
+    return dartsNative.predictiveSearch(this.handle, prefix, limit);
+  }
+
+  /**
+   * Performs a predictive search, returning the matching keys with their values
+   * Keys are restored from the trie, so this also works on dictionaries loaded from a file.
+   * @param prefix search prefix
+   * @param limit maximum number of results (0 or omitted for all)
+   * @returns matching keys and values, in key (UTF-8 byte) order
+   * @throws {DartsError} if the search fails
+   */
+  public predictiveSearchKeys(prefix: string, limit?: number): PredictiveSearchResult[] {
+    this.ensureNotDisposed();
+    return dartsNative.predictiveSearchKeys(this.handle, prefix, limit);
   }
 
   /**
    * Traverses the trie
-   * @param key search key
+   * @param key search key, or its UTF-8 bytes (e.g. a Buffer), which are read in place
    * @param callback callback function
+   * @param offset start of the key when it is a Uint8Array (default 0)
+   * @param length bytes of the key when it is a Uint8Array (default: to the end)
    * @throws {DartsError} if the traversal fails
    */
-  public traverse(key: string, callback: TraverseCallback): void {
+  public traverse(
+    key: string | Uint8Array,
+    callback: TraverseCallback,
+    offset?: number,
+    length?: number
+  ): void {
+    this.ensureNotDisposed();
+    dartsNative.traverse(this.handle, key, callback, offset, length);
+  }
+
+  /**
+   * Creates a cursor for incremental traversal
+   * The cursor keeps working on the current contents even if the dictionary is reloaded.
+   * @returns a cursor positioned at the root
+   * @throws {DartsError} if the cursor cannot be created
+   */
+  public createCursor(): TraverseCursor {
     this.ensureNotDisposed();
-    dartsNative.traverse(this.handle, key, callback);
+    return new TraverseCursor(dartsNative.createCursor(this.handle));
   }
 
   /**
    * Loads a dictionary file asynchronously
+   * The loaded contents replace the current ones at once, so this also reloads a dictionary
+   * in use without stalling its lookups.
    * @param filePath path to the dictionary file
+   * @param options load options
    * @returns true if successful, false otherwise
    * @throws {FileNotFoundError} if the file is not found
    * @throws {InvalidDictionaryError} if the dictionary file is invalid
+   * @throws {DartsError} if the dictionary is disposed or swapped before the load completes
    */
-  public async load(filePath: string): Promise<boolean> {
-    return new Promise((resolve, reject) => {
-      try {
-        const result = this.loadSync(filePath);
-        resolve(result);
-      } catch (error) {
-        reject(error);
-      }
-    });
+  public async load(filePath: string, options?: LoadOptions): Promise<boolean> {
+    this.ensureNotDisposed();
+    // File I/O runs on a background thread; lookups see the old contents until it completes
+    return dartsNative.loadDictionaryAsync(this.handle, filePath, options);
   }
 
   /**
    * Loads a dictionary file synchronously
    * @param filePath path to the dictionary file
+   * @param options load options
    * @returns true if successful, false otherwise
    * @throws {FileNotFoundError} if the file is not found
    * @throws {InvalidDictionaryError} if the dictionary file is invalid
    */
-  public loadSync(filePath: string): boolean {
+  public loadSync(filePath: string, options?: LoadOptions): boolean {
+    this.ensureNotDisposed();
+    return dartsNative.loadDictionary(this.handle, filePath, options);
+  }
+
+  /**
+   * Loads a dictionary serialized in a buffer, e.g. one made by saveToBuffer, fetched over
+   * the network or bundled with the application; compressed dictionaries are recognized too
+   * @param buffer serialized dictionary
+   * @param options buffer load options
+   * @returns true if successful
+   * @throws {InvalidDictionaryError} if the buffer does not hold a valid dictionary
+   */
+  public loadFromBuffer(buffer: ArrayBuffer | Uint8Array, options?: BufferLoadOptions): boolean {
+    this.ensureNotDisposed();
+    return dartsNative.loadDictionaryFromBuffer(this.handle, buffer, options);
+  }
+
+  /**
+   * Exchanges the contents of two dictionaries
+   * Both switch over at once, so a dictionary can be replaced under the code using it, e.g.
+   * with one built or loaded in the background; afterwards the other dictionary holds the
+   * previous contents and can be disposed. Work still running on them (asynchronous saves,
+   * cursors, layered dictionaries) keeps its own reference, so the previous array is only
+   * freed once that work is done. Handles attached in other threads are not affected.
+   * @param other dictionary to exchange contents with
+   * @throws {DartsError} if either dictionary has been disposed
+   */
+  public swap(other: Dictionary): void {
+    this.ensureNotDisposed();
+    dartsNative.swapDictionaries(this.handle, other.getHandle());
+  }
+
+  /**
+   * Saves the dictionary to a file asynchronously
+   * @param filePath destination file path
+   * @param options save options
+   * @returns true if successful
+   * @throws {DartsError} if saving fails
+   */
+  public async save(filePath: string, options?: SaveOptions): Promise<boolean> {
+    this.ensureNotDisposed();
+    return dartsNative.saveDictionaryAsync(this.handle, filePath, options);
+  }
+
+  /**
+   * Saves the dictionary to a file synchronously
+   * @param filePath destination file path
+   * @param options save options
+   * @returns true if successful
+   * @throws {DartsError} if saving fails
+   */
+  public saveSync(filePath: string, options?: SaveOptions): boolean {
     this.ensureNotDisposed();
-    return dartsNative.loadDictionary(this.handle, filePath);
+    return dartsNative.saveDictionary(this.handle, filePath, options);
+  }
+
+  /**
+   * Serializes the dictionary into a buffer holding what saveSync would write to a file
+   * The buffer owns the serialized bytes; no copy is made to hand them to JS.
+   * @param options save options
+   * @returns the serialized dictionary
+   * @throws {DartsError} if serializing fails
+   */
+  public saveToBuffer(options?: SaveOptions): ArrayBuffer {
+    this.ensureNotDisposed();
+    return dartsNative.saveDictionaryToBuffer(this.handle, options);
   }
 
   /**
@@ -118,6 +367,96 @@ export default class Dictionary {
     return dartsNative.size(this.handle);
   }
 
+  /**
+   * Gets the number of keys in the dictionary
+   * @returns number of unique keys, or 0 for files saved without a header
+   * @throws {DartsError} if getting the count fails
+   */
+  public numKeys(): number {
+    this.ensureNotDisposed();
+    return dartsNative.numKeys(this.handle);
+  }
+
+  /**
+   * Gets runtime statistics: array size and fill ratio, bytes in memory, key count,
+   * how long the build or load took, and the lookup counters if they are enabled
+   * @returns a snapshot of the statistics
+   * @throws {DartsError} if getting the statistics fails
+   */
+  public stats(): DictionaryStats {
+    this.ensureNotDisposed();
+    return dartsNative.stats(this.handle);
+  }
+
+  /**
+   * Turns the lookup counters and latency histograms on or off
+   * Counters are sharded by thread (16 shards of atomics, so threads rarely contend) and
+   * cost two clock reads per native call, so they can stay on in production. Loading a file replaces the dictionary and its counters.
+   * @param enabled whether lookups are counted (default true)
+   */
+  public enableStats(enabled = true): void {
+    this.ensureNotDisposed();
+    dartsNative.setStatsEnabled(this.handle, enabled);
+  }
+
+  /**
+   * Clears the lookup counters
+   */
+  public resetStats(): void {
+    this.ensureNotDisposed();
+    dartsNative.resetStats(this.handle);
+  }
+
+  /**
+   * Splits a text into tokens in a single native call, see `TokenizeMode`
+   * The text is matched at each code point boundary in native code, instead of one
+   * `commonPrefixSearch` call per position.
+   * @param text text to split, or its UTF-8 bytes (e.g. a Buffer), which are read in place
+   * @param mode how the text is split (default 'longest')
+   * @param offset start of the text when it is a Uint8Array (default 0)
+   * @param length bytes of the text when it is a Uint8Array (default: to the end)
+   * @returns flat array of (start, length, value) triples ordered by start and then by
+   * length, with positions in UTF-16 code units (bytes for a Uint8Array text) and value -1
+   * for unknown code points
+   * @throws {DartsError} if the mode is invalid
+   */
+  public tokenize(
+    text: string | Uint8Array,
+    mode: TokenizeMode = 'longest',
+    offset?: number,
+    length?: number
+  ): Int32Array {
+    this.ensureNotDisposed();
+    return dartsNative.tokenize(this.handle, text, mode, offset, length);
+  }
+
+  /**
+   * Finds every occurrence of every key in a text, overlapping ones included, in a single
+   * pass of an Aho-Corasick automaton built on the trie. The failure links it needs are
+   * computed on the first scan unless the dictionary was built with `scanTable: true` or
+   * loaded from a file saved with them; they are saved with the dictionary once computed.
+   * @param text text to scan, or its UTF-8 bytes (e.g. a Buffer), which are read in place
+   * @param offset start of the text when it is a Uint8Array (default 0)
+   * @param length bytes of the text when it is a Uint8Array (default: to the end)
+   * @returns flat array of (start, length, value) triples ordered by end and then longest
+   * first, with positions in UTF-16 code units (bytes for a Uint8Array text)
+   */
+  public scan(text: string | Uint8Array, offset?: number, length?: number): Int32Array {
+    this.ensureNotDisposed();
+    return dartsNative.scan(this.handle, text, offset, length);
+  }
+
+  /**
+   * Finds the longest non-overlapping dictionary words in a text
+   * The text is scanned once in native code, preferring the longest match at each position
+   * @param text The text to search in
+   * @returns flat array of (start, length, value) triples, with positions in UTF-16 code units
+   */
+  public findMatches(text: string): Int32Array {
+    this.ensureNotDisposed();
+    return dartsNative.findMatches(this.handle, text);
+  }
+
   /**
    * Searches for dictionary words in a text and replaces them
    * @param text The text to search in
@@ -127,55 +466,24 @@ export default class Dictionary {
   public replaceWords(text: string, replacer: WordReplacer): string {
     this.ensureNotDisposed();
 
+    // A replacement map can be applied entirely in native code
+    if (typeof replacer !== 'function') {
+      return dartsNative.replaceWords(this.handle, text, replacer);
+    }
+
+    const matches = dartsNative.findMatches(this.handle, text);
     let result = '';
     let position = 0;
 
-    while (position < text.length) {
-      let matchFound = false;
-
-      // Try to match words at the current position
-      for (let len = Math.min(50, text.length - position); len > 0; len -= 1) {
-        const word = text.substring(position, position + len);
-        const value = this.exactMatchSearch(word);
-
-        if (value !== -1) {
-          // Word found in dictionary
-          let replacement;
-          if (typeof replacer === 'function') {
-            // If it's a callback function
-            replacement = replacer(word);
-          } else {
-            // If it's a replacement map (object)
-            replacement = replacer[word] || word;
-          }
-
-          result += replacement;
-          position += len;
-          matchFound = true;
-          break;
-        }
-      }
-
-      if (!matchFound) {
-        // No match found, advance by 1 character
-        result += text[position];
-        position += 1;
-      }
+    for (let i = 0; i < matches.length; i += 3) {
+      const start = matches[i];
+      const end = start + matches[i + 1];
+      result += text.substring(position, start);
+      result += replacer(text.substring(start, end));
+      position = end;
     }
 
-    return result;
-  }
-
-  /**
-   * Gets a word by its value
-   * @param value The value to look up
-   * @returns The corresponding word or undefined if not found
-   */
-  private getWordByValue(value: number): string | undefined {
-    if (this.words.length > value && value >= 0) {
-      return this.words[value];
-    }
-    return undefined;
+    return result + text.substring(position);
   }
 
   /**
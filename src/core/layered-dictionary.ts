@@ -0,0 +1,117 @@
+import { dartsNative } from './native';
+import Dictionary from './dictionary';
+import { NativeLayeredDictionary, PredictiveSearchResult } from './types';
+import { DartsError } from './errors';
+
+/**
+ * Updatable dictionary
+ * Keys set and deleted are kept in a small native delta layer on top of an immutable base
+ * dictionary, and every lookup consults both. `compact` merges the changes into a new base
+ * on a background thread; updates made meanwhile are kept in a new layer and stay visible.
+ */
+export default class LayeredDictionary {
+  private readonly layered: NativeLayeredDictionary;
+
+  /**
+   * Constructor
+   * The base dictionary is not modified, and may be disposed afterwards.
+   * @param base dictionary to start from; it must not have a value table
+   * @throws {DartsError} if the base is disposed or has a value table
+   */
+  constructor(base: Dictionary) {
+    this.layered = dartsNative.createLayeredDictionary(base.getHandle());
+  }
+
+  /**
+   * Adds a key, or gives an existing key a new value
+   * @param key key to set
+   * @param value non-negative 32-bit integer
+   * @throws {DartsError} if the key is empty or the value is not a non-negative integer
+   */
+  public set(key: string, value: number): void {
+    try {
+      this.layered.set(key, value);
+    } catch (error) {
+      throw new DartsError(
+        `Failed to set key: ${error instanceof Error ? error.message : String(error)}`
+      );
+    }
+  }
+
+  /**
+   * Removes a key
+   * @param key key to remove
+   * @returns true if the key was present
+   */
+  public delete(key: string): boolean {
+    return this.layered.delete(key);
+  }
+
+  /**
+   * Performs an exact match search
+   * @param key search key
+   * @returns the corresponding value if found, -1 otherwise
+   */
+  public exactMatchSearch(key: string): number {
+    return this.layered.exactMatchSearch(key);
+  }
+
+  /**
+   * Performs a common prefix search
+   * @param key search key
+   * @returns the values of the keys that are prefixes of the key, shortest first
+   */
+  public commonPrefixSearch(key: string): number[] {
+    return this.layered.commonPrefixSearch(key);
+  }
+
+  /**
+   * Enumerates the keys starting with a prefix, in UTF-8 byte order
+   * @param prefix search prefix
+   * @param limit maximum number of results (all of them if omitted or 0)
+   * @returns the keys found together with their values
+   */
+  public predictiveSearchKeys(prefix: string, limit?: number): PredictiveSearchResult[] {
+    return this.layered.predictiveSearchKeys(prefix, limit);
+  }
+
+  /**
+   * Merges the pending changes into a new base on a background thread
+   * Lookups and updates keep working while it runs. If it fails, the changes stay pending.
+   * @returns promise resolving once the new base is in use
+   * @throws {DartsError} if a compaction is already running or the merge fails
+   */
+  public async compact(): Promise<void> {
+    try {
+      await this.layered.compact();
+    } catch (error) {
+      throw new DartsError(
+        `Failed to compact dictionary: ${error instanceof Error ? error.message : String(error)}`
+      );
+    }
+  }
+
+  /**
+   * Gets the current base, without the pending changes
+   * The returned Dictionary keeps reading this base after later compactions, and must be
+   * disposed separately, e.g. after saving it.
+   * @returns a new Dictionary object for the base
+   */
+  public base(): Dictionary {
+    return new Dictionary(this.layered.base());
+  }
+
+  /**
+   * Number of changes not merged into the base yet
+   */
+  public get pendingChanges(): number {
+    return this.layered.pendingChanges;
+  }
+
+  /**
+   * Whether a compaction is running
+   */
+  public get compacting(): boolean {
+    return this.layered.compacting;
+  }
+}
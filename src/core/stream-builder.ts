@@ -0,0 +1,58 @@
+import { dartsNative } from './native';
+import Dictionary from './dictionary';
+import { NativeStreamBuilder, StreamBuildOptions } from './types';
+import { BuildError } from './errors';
+
+/**
+ * Streaming dictionary builder
+ * Accepts the keys as chunks of newline-separated `key` or `key\tvalue` lines, for example
+ * straight from a file stream. Keys are kept in native memory and need not be sorted; past
+ * the memory limit, sorted runs are spilled to temporary files and merged when finishing.
+ * Duplicate keys keep their first value, and keys without a value get their index.
+ */
+export default class StreamBuilder {
+  private readonly builder: NativeStreamBuilder;
+
+  /**
+   * Constructor
+   * @param options streaming build options
+   */
+  constructor(options?: StreamBuildOptions) {
+    this.builder = dartsNative.createStreamBuilder(options?.memoryLimit);
+  }
+
+  /**
+   * Adds a chunk of lines; a line may continue in the next chunk
+   * @param chunk UTF-8 bytes or a string
+   * @throws {BuildError} if a line is invalid or a sorted run cannot be spilled
+   */
+  public add(chunk: string | Uint8Array): void {
+    try {
+      this.builder.add(chunk);
+    } catch (error) {
+      throw new BuildError(error instanceof Error ? error.message : String(error));
+    }
+  }
+
+  /**
+   * Number of keys added so far, including duplicates
+   */
+  public get size(): number {
+    return this.builder.size;
+  }
+
+  /**
+   * Builds the Double-Array on a background thread
+   * The builder cannot be used afterwards.
+   * @returns promise resolving to the constructed Dictionary object
+   * @throws {BuildError} if the build fails
+   */
+  public async finish(): Promise<Dictionary> {
+    try {
+      const handle = await this.builder.finish();
+      return new Dictionary(handle);
+    } catch (error) {
+      throw new BuildError(error instanceof Error ? error.message : String(error));
+    }
+  }
+}
@@ -16,6 +16,243 @@ export interface TraverseResult {
  */
 export type TraverseCallback = (result: TraverseResult) => boolean | void;
 
+/**
+ * Key found by a predictive search
+ */
+export interface PredictiveSearchResult {
+  /** dictionary key starting with the prefix */
+  key: string;
+  /** value */
+  value: number;
+}
+
+/**
+ * Entries to store alongside a dictionary, see `BuildOptions.valueTable`
+ */
+export interface ValueTableInput {
+  /** 64-bit fields per entry (default 1) */
+  stride?: number;
+  /**
+   * one row per key, in the order of the keys, holding `stride` fields for each of the
+   * key's entries (a row may be empty)
+   */
+  entries: Array<Array<number | bigint> | BigInt64Array>;
+}
+
+/**
+ * Entries of a key in the value table: `count` entries starting at entry `offset`
+ */
+export interface EntryRange {
+  offset: number;
+  count: number;
+}
+
+/**
+ * Value table of a dictionary
+ * Field `f` of entry `i` is `entries[i * stride + f]`.
+ */
+export interface ValueTable {
+  /** fields per entry */
+  stride: number;
+  /** every field, sharing the dictionary's memory; must not be modified */
+  entries: BigInt64Array;
+}
+
+/**
+ * Lookup counters of one kind of lookup, see `DictionaryStats.lookups`
+ */
+export interface LookupCounters {
+  /** native calls */
+  calls: number;
+  /** keys looked up; batch calls look up several keys per call */
+  keys: number;
+  /** total time spent in the calls, in nanoseconds */
+  totalNs: number;
+  /** calls per latency bucket: `histogram[i]` counts calls that took [2^i, 2^(i+1)) ns */
+  histogram: Float64Array;
+}
+
+/**
+ * Runtime statistics of a dictionary, see `Dictionary.stats`
+ */
+export interface DictionaryStats {
+  /** number of keys, or 0 if unknown */
+  keys: number;
+  /** number of units in the array */
+  units: number;
+  /** units in use */
+  nonzeroUnits: number;
+  /** nonzeroUnits / units */
+  fillRatio: number;
+  unitFormat: 'darts' | 'compact';
+  /** bytes per unit */
+  unitBytes: number;
+  /** bytes of the units */
+  arrayBytes: number;
+  /** bytes of the value table, 0 without one */
+  valueTableBytes: number;
+  /** bytes of the key index, 0 without one */
+  keyIndexBytes: number;
+  /** bytes of the scan table, 0 until it is loaded or computed */
+  scanTableBytes: number;
+  /** bytes in physical memory; for a mapped file, only the pages in the page cache */
+  residentBytes: number;
+  /** whether the dictionary is read from a mapped file */
+  mapped: boolean;
+  /** huge pages requested for the array, see `LoadOptions.hugePages` */
+  hugePages: 'none' | 'transparent' | 'explicit';
+  /** NUMA node the array is bound to, or -1 if the OS places it */
+  numaNode: number;
+  /** how the dictionary was created: 'build', 'load', or 'empty' before either */
+  source: 'build' | 'load' | 'empty';
+  /** time the build or load took, in milliseconds */
+  durationMs: number;
+  /** lookup counters, which stay at 0 unless enabled with `Dictionary.enableStats` */
+  lookups: {
+    enabled: boolean;
+    /** exactMatchSearch and its batch and entry variants */
+    exactMatch: LookupCounters;
+    /** commonPrefixSearch and its variants */
+    commonPrefix: LookupCounters;
+    /** predictiveSearch and predictiveSearchKeys */
+    predictive: LookupCounters;
+    /** traverse and cursor steps */
+    traverse: LookupCounters;
+    /** findMatches and replaceWords */
+    text: LookupCounters;
+  };
+}
+
+/**
+ * Native resumable traversal state, see `TraverseCursor`
+ * This interface is for internal implementation and is not intended to be used directly
+ */
+export interface NativeTraverseCursor {
+  /** Continues the traversal with a key fragment and returns the status */
+  advance(key: string | Uint8Array): number;
+  /** Returns the cursor to the root */
+  reset(): void;
+  /** Copies the cursor */
+  clone(): NativeTraverseCursor;
+  /** status of the last advance */
+  readonly status: number;
+  /** node position */
+  readonly nodePos: number;
+  /** number of UTF-8 bytes consumed since the last reset */
+  readonly keyPos: number;
+}
+
+/**
+ * Native streaming builder, see `StreamBuilder`
+ * This interface is for internal implementation and is not intended to be used directly
+ */
+export interface NativeStreamBuilder {
+  /** Adds a chunk of "key[\tvalue]" lines */
+  add(chunk: string | Uint8Array): void;
+  /** Builds the Double-Array on a background thread and resolves with its handle */
+  finish(): Promise<number>;
+  /** number of keys added so far, including duplicates */
+  readonly size: number;
+}
+
+/**
+ * Native updatable dictionary, see `LayeredDictionary`
+ * This interface is for internal implementation and is not intended to be used directly
+ */
+export interface NativeLayeredDictionary {
+  /** Adds a key or gives it a new value */
+  set(key: string, value: number): void;
+  /** Removes a key and returns whether it was present */
+  delete(key: string): boolean;
+  /** Looks a key up through the pending changes */
+  exactMatchSearch(key: string): number;
+  /** Finds the values of the keys that are prefixes of a key */
+  commonPrefixSearch(key: string): number[];
+  /** Enumerates the keys starting with a prefix together with their values */
+  predictiveSearchKeys(prefix: string, limit?: number): PredictiveSearchResult[];
+  /** Merges the pending changes into a new base on a background thread */
+  compact(): Promise<void>;
+  /** Creates a handle to the current base */
+  base(): number;
+  /** number of changes not merged into the base yet */
+  readonly pendingChanges: number;
+  /** whether a compaction is running */
+  readonly compacting: boolean;
+}
+
+/**
+ * Native group of dictionaries searched together, see `DictionaryGroup`
+ * This interface is for internal implementation and is not intended to be used directly
+ */
+export interface NativeDictionaryGroup {
+  /** Looks a key up in every member, as (source, value) pairs */
+  exactMatchSearch(key: string): Int32Array;
+  /** Finds the keys of every member that are prefixes of a key */
+  commonPrefixSearch(key: string): Int32Array;
+  /** Splits a text into (start, length, value, source) quadruples */
+  tokenize(text: string, mode?: TokenizeMode): Int32Array;
+  /** number of member dictionaries */
+  readonly size: number;
+}
+
+/**
+ * Options of a `DictionaryGroup`
+ */
+export interface DictionaryGroupOptions {
+  /**
+   * Which members' matches are reported when several of them hold the same key
+   * (default 'first'). `first` keeps only the match of the first member holding it, so
+   * earlier members take priority; `all` keeps every member's match, in member order.
+   */
+  duplicates?: 'first' | 'all';
+}
+
+/**
+ * Native build cancellation flag, see `BuildOptions.signal`
+ * This interface is for internal implementation and is not intended to be used directly
+ */
+export interface NativeCancelToken {
+  /** Makes the builds this token was passed to stop at the next key */
+  cancel(): void;
+  /** whether cancel() has been called */
+  readonly cancelled: boolean;
+}
+
+/**
+ * Native build options
+ * This interface is for internal implementation and is not intended to be used directly
+ */
+export interface NativeBuildOptions {
+  /** threads building the Double-Array (0 for one per core) */
+  threads?: number;
+  /** how free cells are found for a node's children */
+  placement?: 'scan' | 'freelist';
+  /** layout of the Double-Array units */
+  unitFormat?: 'darts' | 'compact';
+  /** whether to keep the keys so they can be restored from their values */
+  keyIndex?: boolean;
+  /** whether to compute the scan table right after the build */
+  scanTable?: boolean;
+  /** called with the number of keys placed so far and the number of unique keys */
+  progress?: (current: number, total: number) => void;
+  /** minimum milliseconds between two progress calls */
+  progressInterval?: number;
+  /** cancels the build when cancelled */
+  cancelToken?: NativeCancelToken;
+  /** entries stored alongside the dictionary; row i belongs to the key whose value is i */
+  valueTable?: ValueTableInput;
+}
+
+/**
+ * How `Dictionary.tokenize` splits a text
+ * - `longest`: greedy segmentation taking the longest match at each position, or one
+ *   unknown code point where nothing matches
+ * - `all-matches`: every match starting at every position, possibly overlapping
+ * - `lattice`: every match, plus one unknown code point where no match starts, so that
+ *   every position of the text can be reached
+ */
+export type TokenizeMode = 'longest' | 'all-matches' | 'lattice';
+
 /**
  * Word replacement function or mapping
  * Used for replacing words in text
@@ -26,8 +263,127 @@ export type WordReplacer = ((match: string) => string) | Record<string, string>;
  * Interface for build options
  */
 export interface BuildOptions {
-  /** progress callback function */
+  /**
+   * progress callback function, called with the number of keys placed so far and the number
+   * of unique keys
+   */
   progressCallback?: (current: number, total: number) => void;
+  /**
+   * threads building the Double-Array (default 1). Above 1, the sub-tries below the first two
+   * key bytes are built concurrently and merged into one array in the same file format;
+   * 0 uses one thread per core
+   */
+  threads?: number;
+  /**
+   * how free cells are found while placing keys (default 'scan'). 'scan' walks the array cell by
+   * cell as Darts does; 'freelist' walks a list of the empty cells only, which is faster and
+   * smaller on dense dictionaries. Both produce the same lookups and file format
+   */
+  placement?: 'scan' | 'freelist';
+  /**
+   * layout of the Double-Array units (default 'darts'). 'compact' packs each unit into
+   * 4 bytes instead of 8, roughly halving the memory and file size; it is built on one
+   * thread (threads and placement are ignored) and keys must not contain U+0000
+   */
+  unitFormat?: 'darts' | 'compact';
+  /**
+   * whether to keep the keys ordered by value, in native memory and in the saved file
+   * (default true), so that `Dictionary.restoreKey` works after the dictionary is loaded
+   */
+  keyIndex?: boolean;
+  /**
+   * whether to compute the links used by `Dictionary.scan` as part of the build (default false),
+   * so that they are saved with the dictionary instead of being computed on the first scan
+   * after every load
+   */
+  scanTable?: boolean;
+  /** minimum milliseconds between two progress callbacks (default 100) */
+  progressInterval?: number;
+  /** aborts the build; the build rejects or throws with a BuildError */
+  signal?: AbortSignal;
+  /**
+   * entries of 64-bit fields stored alongside the dictionary and saved in the same file,
+   * for payloads that do not fit in one 31-bit value. Each key's value becomes the index
+   * of its row, so values cannot be given as well
+   */
+  valueTable?: ValueTableInput;
+}
+
+/**
+ * Interface for streaming build options
+ */
+export interface StreamBuildOptions {
+  /**
+   * Bytes of key data held in native memory before a sorted run is spilled to a temporary
+   * file (default 256 MiB)
+   */
+  memoryLimit?: number;
+}
+
+/**
+ * Interface for load options
+ */
+export interface LoadOptions {
+  /**
+   * Memory-maps the file instead of reading it into the heap.
+   * Pages are shared through the page cache across processes and workers, and loading takes
+   * constant time. The file must not be modified while the dictionary is in use.
+   */
+  mmap?: boolean;
+  /** Asks the OS to read the mapped file ahead of time (`MADV_WILLNEED`, mmap only) */
+  prewarm?: boolean;
+  /** Disables read-ahead for lookup-heavy workloads (`MADV_RANDOM`, mmap only) */
+  randomAccess?: boolean;
+  /**
+   * Backs the array with huge pages, so that lookups across a large dictionary miss the TLB
+   * less. A file read into memory uses pages from the reserved pool (`MAP_HUGETLB`) while it
+   * has room, and transparent huge pages (`MADV_HUGEPAGE`) otherwise; a mapped file asks for
+   * transparent huge pages. Falls back to ordinary pages where the OS has none (Linux only).
+   */
+  hugePages?: boolean;
+  /**
+   * Places the dictionary on the NUMA node of the loading thread, and gives each thread that
+   * attaches it (`attachDictionary`) from another node a copy on that node, made on first
+   * attach. Costs one copy of the file per node in use. Linux only; not for mmap.
+   */
+  numaReplicas?: boolean;
+}
+
+/**
+ * Interface for save options
+ */
+export interface SaveOptions {
+  /**
+   * Renumbers the nodes in the file for the cache: the top levels of the trie first, so that
+   * the nodes every lookup reads share a few cache lines and pages, then each subtrie depth
+   * first. The loaded dictionary finds the same values. Applies to the default unit format;
+   * `compact` dictionaries are saved as they are.
+   */
+  relayout?: boolean;
+  /**
+   * Writes a compressed dictionary file: the file is cut into chunks compressed with deflate,
+   * which loading inflates on every core. Such files are recognized by `load` and always read
+   * into memory, even with `mmap`.
+   */
+  compress?: boolean;
+  /**
+   * Deflate level from 1 (fastest, the default) to 9 (smallest); implies `compress`
+   */
+  compressionLevel?: number;
+}
+
+/**
+ * Interface for options of loading a dictionary from a buffer
+ */
+export interface BufferLoadOptions {
+  /**
+   * Copies the buffer (default `true`). With `false` a buffer made by `saveToBuffer` is read
+   * in place: the dictionary shares its bytes, which stay valid even if the ArrayBuffer is
+   * transferred or collected, but must not be modified while the dictionary is in use. Any
+   * other buffer belongs to JS, which may detach it, so it is copied all the same, as are
+   * views not aligned to 8 bytes; compressed dictionaries are always inflated into new memory.
+   */
+  copy?: boolean;
 }
 
 /**
@@ -39,18 +395,138 @@ export interface DartsNative {
   createDictionary(): number;
   /** Destroys a dictionary object */
   destroyDictionary(handle: number): void;
+  /** Publishes a dictionary for other worker threads and returns its token */
+  shareDictionary(handle: number): number;
+  /** Creates a handle to a dictionary published by shareDictionary */
+  attachDictionary(token: number): number;
+  /** Exchanges the dictionaries of two handles */
+  swapDictionaries(handle: number, otherHandle: number): void;
   /** Loads a dictionary file */
-  loadDictionary(handle: number, filePath: string): boolean;
+  loadDictionary(handle: number, filePath: string, options?: LoadOptions): boolean;
   /** Saves a dictionary file */
-  saveDictionary(handle: number, filePath: string): boolean;
+  saveDictionary(handle: number, filePath: string, options?: SaveOptions): boolean;
+  /** Loads a dictionary file on a background thread */
+  loadDictionaryAsync(handle: number, filePath: string, options?: LoadOptions): Promise<boolean>;
+  /** Saves a dictionary file on a background thread */
+  saveDictionaryAsync(handle: number, filePath: string, options?: SaveOptions): Promise<boolean>;
+  /** Serializes a dictionary into a buffer, as it would be saved to a file */
+  saveDictionaryToBuffer(handle: number, options?: SaveOptions): ArrayBuffer;
+  /** Loads a dictionary serialized in a buffer */
+  loadDictionaryFromBuffer(
+    handle: number,
+    buffer: ArrayBuffer | Uint8Array,
+    options?: BufferLoadOptions
+  ): boolean;
   /** Performs an exact match search */
-  exactMatchSearch(handle: number, key: string): number;
+  exactMatchSearch(
+    handle: number,
+    key: string | Uint8Array,
+    offset?: number,
+    length?: number
+  ): number;
+  /** Performs exact match searches for an array of keys */
+  exactMatchSearchBatch(
+    handle: number,
+    keys: (string | Uint8Array)[],
+    results?: Int32Array
+  ): Int32Array;
+  /** Performs exact match searches for keys concatenated in a UTF-8 buffer */
+  exactMatchSearchBuffer(
+    handle: number,
+    keys: Uint8Array,
+    offsets: Uint32Array,
+    results?: Int32Array
+  ): Int32Array;
   /** Performs a common prefix search */
-  commonPrefixSearch(handle: number, key: string): number[];
+  commonPrefixSearch(
+    handle: number,
+    key: string | Uint8Array,
+    offset?: number,
+    length?: number
+  ): number[];
+  /** Performs a common prefix search returning flat (value, length) pairs */
+  commonPrefixSearchPairs(
+    handle: number,
+    key: string | Uint8Array,
+    offset?: number,
+    length?: number
+  ): Int32Array;
+  /** Writes (value, length) pairs into a caller-supplied array and returns the match count */
+  commonPrefixSearchInto(
+    handle: number,
+    key: string | Uint8Array,
+    results: Int32Array,
+    offset?: number,
+    length?: number
+  ): number;
+  /** Finds the value table entries of a key */
+  exactMatchEntries(
+    handle: number,
+    key: string | Uint8Array,
+    offset?: number,
+    length?: number
+  ): EntryRange | null;
+  /** Finds the value table entries of every prefix of a key, as (offset, count, length) */
+  commonPrefixSearchEntries(
+    handle: number,
+    key: string | Uint8Array,
+    offset?: number,
+    length?: number
+  ): Float64Array;
+  /** Gets the value table, if the dictionary has one */
+  getValueTable(handle: number): ValueTable | undefined;
+  /** Restores the key of a value from the key index */
+  restoreKey(handle: number, value: number): string | undefined;
+  /** Enumerates the values of the keys starting with a prefix */
+  predictiveSearch(handle: number, prefix: string, limit?: number): number[];
+  /** Enumerates the keys starting with a prefix together with their values */
+  predictiveSearchKeys(handle: number, prefix: string, limit?: number): PredictiveSearchResult[];
   /** Traverses the trie */
-  traverse(handle: number, key: string, callback: TraverseCallback): void;
+  traverse(
+    handle: number,
+    key: string | Uint8Array,
+    callback: TraverseCallback,
+    offset?: number,
+    length?: number
+  ): void;
+  /** Creates a resumable traversal cursor */
+  createCursor(handle: number): NativeTraverseCursor;
+  /** Creates an updatable dictionary on top of a dictionary */
+  createLayeredDictionary(handle: number): NativeLayeredDictionary;
+  /** Creates a group searching several dictionaries in one call */
+  createDictionaryGroup(handles: number[], options?: DictionaryGroupOptions): NativeDictionaryGroup;
   /** Builds a Double-Array */
-  build(keys: string[], values?: number[]): number;
+  build(keys: string[], values?: number[], options?: NativeBuildOptions): number;
+  /** Builds a Double-Array on a background thread */
+  buildAsync(keys: string[], values?: number[], options?: NativeBuildOptions): Promise<number>;
+  /** Creates a flag that cancels the builds it is passed to */
+  createCancelToken(): NativeCancelToken;
+  /** Creates a builder fed with chunks of "key[\tvalue]" lines */
+  createStreamBuilder(memoryLimit?: number): NativeStreamBuilder;
+  /** Builds a Double-Array from a file of "key[\tvalue]" lines on a background thread */
+  buildFromFileAsync(filePath: string, memoryLimit?: number): Promise<number>;
   /** Gets the size of the dictionary */
   size(handle: number): number;
+  /** Gets the number of keys, or 0 if unknown */
+  numKeys(handle: number): number;
+  /** Gets the runtime statistics of the dictionary */
+  stats(handle: number): DictionaryStats;
+  /** Turns the lookup counters on or off */
+  setStatsEnabled(handle: number, enabled: boolean): void;
+  /** Clears the lookup counters */
+  resetStats(handle: number): void;
+  /** Splits a text into (start, length, value) triples */
+  tokenize(
+    handle: number,
+    text: string | Uint8Array,
+    mode?: TokenizeMode,
+    offset?: number,
+    length?: number
+  ): Int32Array;
+  /** Finds every occurrence of every key in a text */
+  scan(handle: number, text: string | Uint8Array, offset?: number, length?: number): Int32Array;
+  /** Finds the longest non-overlapping matches in a text */
+  findMatches(handle: number, text: string): Int32Array;
+  /** Replaces the longest non-overlapping matches in a text using a replacement map */
+  replaceWords(handle: number, text: string, replacements: Record<string, string>): string;
 }
@@ -63,3 +63,25 @@ export function uniqueArray<T>(arr: T[]): T[] {
 export function sortAndUniqueStrings(arr: string[]): string[] {
   return uniqueArray(sortStrings(arr));
 }
+
+/**
+ * Encodes keys into one concatenated UTF-8 buffer for batch lookups
+ * Key i spans `offsets[i]` to `offsets[i + 1]` in the buffer
+ * @param keys keys to encode
+ * @returns the UTF-8 buffer and the key offsets (one more than the number of keys)
+ */
+export function encodeKeys(keys: string[]): { buffer: Buffer; offsets: Uint32Array } {
+  const offsets = new Uint32Array(keys.length + 1);
+  let total = 0;
+  for (let i = 0; i < keys.length; i += 1) {
+    total += Buffer.byteLength(keys[i], 'utf8');
+    offsets[i + 1] = total;
+  }
+
+  const buffer = Buffer.allocUnsafe(total);
+  for (let i = 0; i < keys.length; i += 1) {
+    buffer.write(keys[i], offsets[i], 'utf8');
+  }
+
+  return { buffer, offsets };
+}
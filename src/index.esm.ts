@@ -7,7 +7,25 @@
 
 import * as fs from 'fs';
 import * as path from 'path';
-import { DartsNative, TraverseCallback } from './core/types';
+import {
+  BufferLoadOptions,
+  DartsNative,
+  DictionaryGroupOptions,
+  DictionaryStats,
+  EntryRange,
+  LoadOptions,
+  NativeBuildOptions,
+  NativeCancelToken,
+  NativeDictionaryGroup,
+  NativeLayeredDictionary,
+  NativeStreamBuilder,
+  NativeTraverseCursor,
+  PredictiveSearchResult,
+  SaveOptions,
+  TokenizeMode,
+  TraverseCallback,
+  ValueTable,
+} from './core/types';
 import { DartsError, FileNotFoundError, InvalidDictionaryError, BuildError } from './core/errors';
 
 // Load native module with more robust error handling
@@ -152,17 +170,65 @@ export class DartsNativeWrapper implements DartsNative {
       );
     }
   }
+  /**
+   * Publishes a dictionary so that other worker threads can attach to it
+   * @param handle dictionary handle
+   * @returns token to pass to attachDictionary
+   */
+  // eslint-disable-next-line class-methods-use-this
+  shareDictionary(handle: number): number {
+    try {
+      return native.shareDictionary(handle);
+    } catch (error) {
+      throw new DartsError(
+        `Failed to share dictionary: ${error instanceof Error ? error.message : String(error)}`
+      );
+    }
+  }
+
+  /**
+   * Attaches to a dictionary published by shareDictionary
+   * @param token token returned by shareDictionary
+   * @returns dictionary handle
+   */
+  // eslint-disable-next-line class-methods-use-this
+  attachDictionary(token: number): number {
+    try {
+      return native.attachDictionary(token);
+    } catch (error) {
+      throw new DartsError(
+        `Failed to attach dictionary: ${error instanceof Error ? error.message : String(error)}`
+      );
+    }
+  }
+
+  /**
+   * Exchanges the dictionaries of two handles
+   * @param handle dictionary handle
+   * @param otherHandle handle of the other dictionary
+   */
+  // eslint-disable-next-line class-methods-use-this
+  swapDictionaries(handle: number, otherHandle: number): void {
+    try {
+      native.swapDictionaries(handle, otherHandle);
+    } catch (error) {
+      throw new DartsError(
+        `Failed to swap dictionaries: ${error instanceof Error ? error.message : String(error)}`
+      );
+    }
+  }
 
   /**
    * Loads a dictionary file
    * @param handle dictionary handle
    * @param filePath path to the dictionary file
+   * @param options load options
    * @returns true if successful, false otherwise
    */
   // eslint-disable-next-line class-methods-use-this
-  loadDictionary(handle: number, filePath: string): boolean {
+  loadDictionary(handle: number, filePath: string, options?: LoadOptions): boolean {
     try {
-      const result = native.loadDictionary(handle, filePath);
+      const result = native.loadDictionary(handle, filePath, options);
       if (result === false) {
         throw new InvalidDictionaryError(`Failed to load dictionary from ${filePath}`);
       }
@@ -184,12 +250,13 @@ export class DartsNativeWrapper implements DartsNative {
    * Saves a dictionary file
    * @param handle dictionary handle
    * @param filePath destination file path
+   * @param options save options
    * @returns true if successful, false otherwise
    */
   // eslint-disable-next-line class-methods-use-this
-  saveDictionary(handle: number, filePath: string): boolean {
+  saveDictionary(handle: number, filePath: string, options?: SaveOptions): boolean {
     try {
-      const result = native.saveDictionary(handle, filePath);
+      const result = native.saveDictionary(handle, filePath, options);
       if (result === false) {
         throw new DartsError(`Failed to save dictionary to ${filePath}`);
       }
@@ -204,16 +271,156 @@ export class DartsNativeWrapper implements DartsNative {
     }
   }
 
+  /**
+   * Loads a dictionary file on a background thread
+   * The handle keeps serving the previous dictionary until loading completes
+   * @param handle dictionary handle
+   * @param filePath path to the dictionary file
+   * @param options load options
+   * @returns promise resolving to true if successful
+   */
+  // eslint-disable-next-line class-methods-use-this
+  async loadDictionaryAsync(
+    handle: number,
+    filePath: string,
+    options?: LoadOptions
+  ): Promise<boolean> {
+    try {
+      return await native.loadDictionaryAsync(handle, filePath, options);
+    } catch (error) {
+      if (error instanceof DartsError) {
+        throw error;
+      }
+      // Detect file not found error from error message
+      const errorMessage = error instanceof Error ? error.message : String(error);
+      if (errorMessage.includes('not found') || errorMessage.includes('No such file')) {
+        throw new FileNotFoundError(filePath);
+      }
+      throw new InvalidDictionaryError(errorMessage);
+    }
+  }
+
+  /**
+   * Saves a dictionary file on a background thread
+   * @param handle dictionary handle
+   * @param filePath destination file path
+   * @param options save options
+   * @returns promise resolving to true if successful
+   */
+  // eslint-disable-next-line class-methods-use-this
+  async saveDictionaryAsync(
+    handle: number,
+    filePath: string,
+    options?: SaveOptions
+  ): Promise<boolean> {
+    try {
+      return await native.saveDictionaryAsync(handle, filePath, options);
+    } catch (error) {
+      throw new DartsError(
+        `Failed to save dictionary: ${error instanceof Error ? error.message : String(error)}`
+      );
+    }
+  }
+  /**
+   * Serializes a dictionary into a buffer
+   * @param handle dictionary handle
+   * @param options save options
+   * @returns the serialized dictionary
+   */
+  // eslint-disable-next-line class-methods-use-this
+  saveDictionaryToBuffer(handle: number, options?: SaveOptions): ArrayBuffer {
+    try {
+      return native.saveDictionaryToBuffer(handle, options);
+    } catch (error) {
+      throw new DartsError(
+        `Failed to save dictionary: ${error instanceof Error ? error.message : String(error)}`
+      );
+    }
+  }
+
+  /**
+   * Loads a dictionary serialized in a buffer
+   * @param handle dictionary handle
+   * @param buffer serialized dictionary
+   * @param options buffer load options
+   * @returns true if successful
+   */
+  // eslint-disable-next-line class-methods-use-this
+  loadDictionaryFromBuffer(
+    handle: number,
+    buffer: ArrayBuffer | Uint8Array,
+    options?: BufferLoadOptions
+  ): boolean {
+    try {
+      return native.loadDictionaryFromBuffer(handle, buffer, options);
+    } catch (error) {
+      throw new InvalidDictionaryError(error instanceof Error ? error.message : String(error));
+    }
+  }
+
   /**
    * Performs an exact match search
    * @param handle dictionary handle
-   * @param key search key
+   * @param key search key, as a string or UTF-8 bytes read in place
+   * @param offset start of the key in a Uint8Array key (default 0)
+   * @param length bytes of the key in a Uint8Array key (default: to the end)
    * @returns the corresponding value if found, -1 otherwise
    */
   // eslint-disable-next-line class-methods-use-this
-  exactMatchSearch(handle: number, key: string): number {
+  exactMatchSearch(
+    handle: number,
+    key: string | Uint8Array,
+    offset?: number,
+    length?: number
+  ): number {
+    try {
+      return native.exactMatchSearch(handle, key, offset, length);
+    } catch (error) {
+      throw new DartsError(
+        `Failed to perform exact match search: ${error instanceof Error ? error.message : String(error)}`
+      );
+    }
+  }
+
+  /**
+   * Performs exact match searches for an array of keys in a single native call
+   * @param handle dictionary handle
+   * @param keys search keys, as strings or UTF-8 bytes
+   * @param results optional array to write the values into (allocated if omitted)
+   * @returns the values for each key, -1 where not found
+   */
+  // eslint-disable-next-line class-methods-use-this
+  exactMatchSearchBatch(
+    handle: number,
+    keys: (string | Uint8Array)[],
+    results?: Int32Array
+  ): Int32Array {
     try {
-      return native.exactMatchSearch(handle, key);
+      return native.exactMatchSearchBatch(handle, keys, results);
+    } catch (error) {
+      throw new DartsError(
+        `Failed to perform exact match search: ${error instanceof Error ? error.message : String(error)}`
+      );
+    }
+  }
+
+  /**
+   * Performs exact match searches for keys concatenated in a UTF-8 buffer in a single native call
+   * @param handle dictionary handle
+   * @param keys UTF-8 encoded keys
+   * @param offsets key boundaries; key i spans offsets[i] to offsets[i + 1]
+   * @param results optional array to write the values into (allocated if omitted)
+   * @returns the values for each key, -1 where not found
+   */
+  // eslint-disable-next-line class-methods-use-this
+  exactMatchSearchBuffer(
+    handle: number,
+    keys: Uint8Array,
+    offsets: Uint32Array,
+    results?: Int32Array
+  ): Int32Array {
+    try {
+      return native.exactMatchSearchBuffer(handle, keys, offsets, results);
     } catch (error) {
       throw new DartsError(
         `Failed to perform exact match search: ${error instanceof Error ? error.message : String(error)}`
@@ -224,13 +431,69 @@ export class DartsNativeWrapper implements DartsNative {
   /**
    * Performs a common prefix search
    * @param handle dictionary handle
-   * @param key search key
+   * @param key search key, as a string or UTF-8 bytes read in place
+   * @param offset start of the key in a Uint8Array key (default 0)
+   * @param length bytes of the key in a Uint8Array key (default: to the end)
    * @returns array of found values
    */
   // eslint-disable-next-line class-methods-use-this
-  commonPrefixSearch(handle: number, key: string): number[] {
+  commonPrefixSearch(
+    handle: number,
+    key: string | Uint8Array,
+    offset?: number,
+    length?: number
+  ): number[] {
+    try {
+      return native.commonPrefixSearch(handle, key, offset, length);
+    } catch (error) {
+      throw new DartsError(
+        `Failed to perform common prefix search: ${error instanceof Error ? error.message : String(error)}`
+      );
+    }
+  }
+  /**
+   * Performs a common prefix search returning match lengths
+   * @param handle dictionary handle
+   * @param key search key, as a string or UTF-8 bytes read in place
+   * @param offset start of the key in a Uint8Array key (default 0)
+   * @param length bytes of the key in a Uint8Array key (default: to the end)
+   * @returns flat (value, length) pairs, lengths in UTF-16 code units (bytes for a Uint8Array key)
+   */
+  // eslint-disable-next-line class-methods-use-this
+  commonPrefixSearchPairs(
+    handle: number,
+    key: string | Uint8Array,
+    offset?: number,
+    length?: number
+  ): Int32Array {
+    try {
+      return native.commonPrefixSearchPairs(handle, key, offset, length);
+    } catch (error) {
+      throw new DartsError(
+        `Failed to perform common prefix search: ${error instanceof Error ? error.message : String(error)}`
+      );
+    }
+  }
+
+  /**
+   * Performs a common prefix search into a caller-supplied array
+   * @param handle dictionary handle
+   * @param key search key, as a string or UTF-8 bytes read in place
+   * @param results array receiving (value, length) pairs
+   * @param offset start of the key in a Uint8Array key (default 0)
+   * @param length bytes of the key in a Uint8Array key (default: to the end)
+   * @returns total number of matches, which may exceed the pairs written
+   */
+  // eslint-disable-next-line class-methods-use-this
+  commonPrefixSearchInto(
+    handle: number,
+    key: string | Uint8Array,
+    results: Int32Array,
+    offset?: number,
+    length?: number
+  ): number {
     try {
-      return native.commonPrefixSearch(handle, key);
+      return native.commonPrefixSearchInto(handle, key, results, offset, length);
     } catch (error) {
       throw new DartsError(
         `Failed to perform common prefix search: ${error instanceof Error ? error.message : String(error)}`
@@ -238,57 +501,242 @@ export class DartsNativeWrapper implements DartsNative {
     }
   }
 
+  /**
+   * Finds the value table entries of a key
+   * @param handle dictionary handle
+   * @param key search key, as a string or UTF-8 bytes read in place
+   * @param offset start of the key in a Uint8Array key (default 0)
+   * @param length bytes of the key in a Uint8Array key (default: to the end)
+   * @returns the key's entries, or null if the key is not found
+   */
+  // eslint-disable-next-line class-methods-use-this
+  exactMatchEntries(
+    handle: number,
+    key: string | Uint8Array,
+    offset?: number,
+    length?: number
+  ): EntryRange | null {
+    try {
+      return native.exactMatchEntries(handle, key, offset, length);
+    } catch (error) {
+      throw new DartsError(
+        `Failed to find entries: ${error instanceof Error ? error.message : String(error)}`
+      );
+    }
+  }
+
+  /**
+   * Finds the value table entries of every prefix of a key
+   * @param handle dictionary handle
+   * @param key search key, as a string or UTF-8 bytes read in place
+   * @param offset start of the key in a Uint8Array key (default 0)
+   * @param length bytes of the key in a Uint8Array key (default: to the end)
+   * @returns flat (offset, count, length) triples, shortest prefix first
+   */
+  // eslint-disable-next-line class-methods-use-this
+  commonPrefixSearchEntries(
+    handle: number,
+    key: string | Uint8Array,
+    offset?: number,
+    length?: number
+  ): Float64Array {
+    try {
+      return native.commonPrefixSearchEntries(handle, key, offset, length);
+    } catch (error) {
+      throw new DartsError(
+        `Failed to find entries: ${error instanceof Error ? error.message : String(error)}`
+      );
+    }
+  }
+
+  /**
+   * Gets the value table of a dictionary
+   * @param handle dictionary handle
+   * @returns the table, or undefined if the dictionary has none
+   */
+  // eslint-disable-next-line class-methods-use-this
+  getValueTable(handle: number): ValueTable | undefined {
+    try {
+      return native.getValueTable(handle);
+    } catch (error) {
+      throw new DartsError(
+        `Failed to get value table: ${error instanceof Error ? error.message : String(error)}`
+      );
+    }
+  }
+
+  /**
+   * Restores the key of a value
+   * @param handle dictionary handle
+   * @param value value of the key
+   * @returns the key, or undefined if no key has the value
+   */
+  // eslint-disable-next-line class-methods-use-this
+  restoreKey(handle: number, value: number): string | undefined {
+    try {
+      return native.restoreKey(handle, value);
+    } catch (error) {
+      throw new DartsError(
+        `Failed to restore key: ${error instanceof Error ? error.message : String(error)}`
+      );
+    }
+  }
+
+  /**
+   * Performs a predictive search
+   * @param handle dictionary handle
+   * @param prefix search prefix
+   * @param limit maximum number of results (0 or omitted for all)
+   * @returns values of the keys starting with the prefix, in key order
+   */
+  // eslint-disable-next-line class-methods-use-this
+  predictiveSearch(handle: number, prefix: string, limit?: number): number[] {
+    try {
+      return native.predictiveSearch(handle, prefix, limit);
+    } catch (error) {
+      throw new DartsError(
+        `Failed to perform predictive search: ${error instanceof Error ? error.message : String(error)}`
+      );
+    }
+  }
+
+  /**
+   * Performs a predictive search that also returns the keys
+   * @param handle dictionary handle
+   * @param prefix search prefix
+   * @param limit maximum number of results (0 or omitted for all)
+   * @returns keys starting with the prefix and their values, in key order
+   */
+  // eslint-disable-next-line class-methods-use-this
+  predictiveSearchKeys(handle: number, prefix: string, limit?: number): PredictiveSearchResult[] {
+    try {
+      return native.predictiveSearchKeys(handle, prefix, limit);
+    } catch (error) {
+      throw new DartsError(
+        `Failed to perform predictive search: ${error instanceof Error ? error.message : String(error)}`
+      );
+    }
+  }
+
   /**
    * Traverses the trie
    * @param handle dictionary handle
-   * @param key search key
+   * @param key search key, as a string or UTF-8 bytes read in place
    * @param callback callback function
+   * @param offset start of the key in a Uint8Array key (default 0)
+   * @param length bytes of the key in a Uint8Array key (default: to the end)
    */
   // eslint-disable-next-line class-methods-use-this
-  traverse(handle: number, key: string, callback: TraverseCallback): void {
+  traverse(
+    handle: number,
+    key: string | Uint8Array,
+    callback: TraverseCallback,
+    offset?: number,
+    length?: number
+  ): void {
     try {
-      native.traverse(handle, key, callback);
+      native.traverse(handle, key, callback, offset, length);
     } catch (error) {
       throw new DartsError(
         `Failed to traverse: ${error instanceof Error ? error.message : String(error)}`
       );
     }
   }
+  /**
+   * Creates a resumable traversal cursor
+   * @param handle dictionary handle
+   * @returns native cursor positioned at the root
+   */
+  // eslint-disable-next-line class-methods-use-this
+  createCursor(handle: number): NativeTraverseCursor {
+    try {
+      return native.createCursor(handle);
+    } catch (error) {
+      throw new DartsError(
+        `Failed to create cursor: ${error instanceof Error ? error.message : String(error)}`
+      );
+    }
+  }
+
+  /**
+   * Creates an updatable dictionary on top of a dictionary
+   * @param handle handle of the base dictionary
+   * @returns native layered dictionary with no pending changes
+   */
+  // eslint-disable-next-line class-methods-use-this
+  createLayeredDictionary(handle: number): NativeLayeredDictionary {
+    try {
+      return native.createLayeredDictionary(handle);
+    } catch (error) {
+      throw new DartsError(
+        `Failed to create layered dictionary: ${error instanceof Error ? error.message : String(error)}`
+      );
+    }
+  }
+
+  /**
+   * Creates a group searching several dictionaries in one call
+   * @param handles handles of the member dictionaries, in priority order
+   * @param options how keys held by several members are reported
+   * @returns native dictionary group
+   */
+  // eslint-disable-next-line class-methods-use-this
+  createDictionaryGroup(
+    handles: number[],
+    options?: DictionaryGroupOptions
+  ): NativeDictionaryGroup {
+    try {
+      return native.createDictionaryGroup(handles, options);
+    } catch (error) {
+      throw new DartsError(
+        `Failed to create dictionary group: ${error instanceof Error ? error.message : String(error)}`
+      );
+    }
+  }
 
   /**
    * Builds a Double-Array
    * @param keys array of keys
    * @param values array of values (indices are used if omitted)
+   * @param options progress and cancellation options
    * @returns dictionary handle
    */
   // eslint-disable-next-line class-methods-use-this
-  build(keys: string[], values?: number[]): number {
+  build(keys: string[], values?: number[], options?: NativeBuildOptions): number {
     try {
-      if (!Array.isArray(keys) || keys.length === 0) {
-        throw new BuildError('Empty keys array');
-      }
+      DartsNativeWrapper.validateBuildInput(keys, values);
 
-      // Ensure keys are strings
-      keys.forEach((key) => {
-        if (typeof key !== 'string') {
-          throw new BuildError('All keys must be strings');
-        }
-      });
-
-      // Ensure values are numbers
-      if (values !== undefined) {
-        if (!Array.isArray(values) || values.length !== keys.length) {
-          throw new BuildError('Values array length must match keys array length');
-        }
-
-        values.forEach((value) => {
-          if (typeof value !== 'number') {
-            throw new BuildError('All values must be numbers');
-          }
-        });
+      const handle = native.build(keys, values, options);
+      if (handle === null || handle === undefined) {
+        throw new BuildError('Failed to build dictionary');
+      }
+      return handle;
+    } catch (error) {
+      if (error instanceof DartsError) {
+        throw error;
       }
+      throw new BuildError(error instanceof Error ? error.message : String(error));
+    }
+  }
+
+  /**
+   * Builds a Double-Array on a background thread
+   * Keys are copied synchronously; sorting and construction do not block the event loop
+   * @param keys array of keys
+   * @param values array of values (indices are used if omitted)
+   * @param options progress and cancellation options
+   * @returns promise resolving to the dictionary handle
+   */
+  // eslint-disable-next-line class-methods-use-this
+  async buildAsync(
+    keys: string[],
+    values?: number[],
+    options?: NativeBuildOptions
+  ): Promise<number> {
+    try {
+      DartsNativeWrapper.validateBuildInput(keys, values);
 
-      const handle = native.build(keys, values);
+      const handle = await native.buildAsync(keys, values, options);
       if (handle === null || handle === undefined) {
         throw new BuildError('Failed to build dictionary');
       }
@@ -300,6 +748,86 @@ export class DartsNativeWrapper implements DartsNative {
       throw new BuildError(error instanceof Error ? error.message : String(error));
     }
   }
+  /**
+   * Creates a flag that cancels the builds it is passed to
+   * @returns native cancel token
+   */
+  // eslint-disable-next-line class-methods-use-this
+  createCancelToken(): NativeCancelToken {
+    try {
+      return native.createCancelToken();
+    } catch (error) {
+      throw new BuildError(error instanceof Error ? error.message : String(error));
+    }
+  }
+
+  /**
+   * Creates a builder fed with chunks of "key[\tvalue]" lines
+   * @param memoryLimit bytes of key data held before a sorted run is spilled to disk
+   * @returns native stream builder
+   */
+  // eslint-disable-next-line class-methods-use-this
+  createStreamBuilder(memoryLimit?: number): NativeStreamBuilder {
+    try {
+      return native.createStreamBuilder(memoryLimit);
+    } catch (error) {
+      throw new BuildError(error instanceof Error ? error.message : String(error));
+    }
+  }
+
+  /**
+   * Builds a Double-Array from a file of "key[\tvalue]" lines on a background thread
+   * @param filePath path to the key file; it need not be sorted
+   * @param memoryLimit bytes of key data held before a sorted run is spilled to disk
+   * @returns promise resolving to the handle of the constructed Double-Array
+   */
+  // eslint-disable-next-line class-methods-use-this
+  async buildFromFileAsync(filePath: string, memoryLimit?: number): Promise<number> {
+    if (!fs.existsSync(filePath)) {
+      throw new FileNotFoundError(filePath);
+    }
+
+    try {
+      return await native.buildFromFileAsync(filePath, memoryLimit);
+    } catch (error) {
+      if (error instanceof DartsError) {
+        throw error;
+      }
+      throw new BuildError(error instanceof Error ? error.message : String(error));
+    }
+  }
+
+  /**
+   * Validates the input of a build
+   * @param keys array of keys
+   * @param values array of values
+   * @throws {BuildError} if the input values are invalid
+   */
+  private static validateBuildInput(keys: string[], values?: number[]): void {
+    if (!Array.isArray(keys) || keys.length === 0) {
+      throw new BuildError('Empty keys array');
+    }
+
+    // Ensure keys are strings
+    keys.forEach((key) => {
+      if (typeof key !== 'string') {
+        throw new BuildError('All keys must be strings');
+      }
+    });
+
+    // Ensure values are numbers
+    if (values !== undefined) {
+      if (!Array.isArray(values) || values.length !== keys.length) {
+        throw new BuildError('Values array length must match keys array length');
+      }
+
+      values.forEach((value) => {
+        if (typeof value !== 'number') {
+          throw new BuildError('All values must be numbers');
+        }
+      });
+    }
+  }
 
   /**
    * Gets the size of the dictionary
@@ -316,6 +844,149 @@ export class DartsNativeWrapper implements DartsNative {
       );
     }
   }
+
+  /**
+   * Gets the number of keys in the dictionary
+   * @param handle dictionary handle
+   * @returns number of keys, or 0 if unknown
+   */
+  // eslint-disable-next-line class-methods-use-this
+  numKeys(handle: number): number {
+    try {
+      return native.numKeys(handle);
+    } catch (error) {
+      throw new DartsError(
+        `Failed to get key count: ${error instanceof Error ? error.message : String(error)}`
+      );
+    }
+  }
+
+  /**
+   * Gets the runtime statistics of the dictionary
+   * @param handle dictionary handle
+   * @returns sizes, origin and lookup counters
+   */
+  // eslint-disable-next-line class-methods-use-this
+  stats(handle: number): DictionaryStats {
+    try {
+      return native.stats(handle);
+    } catch (error) {
+      throw new DartsError(
+        `Failed to get dictionary stats: ${error instanceof Error ? error.message : String(error)}`
+      );
+    }
+  }
+
+  /**
+   * Turns the lookup counters on or off
+   * @param handle dictionary handle
+   * @param enabled whether lookups are counted
+   */
+  // eslint-disable-next-line class-methods-use-this
+  setStatsEnabled(handle: number, enabled: boolean): void {
+    try {
+      native.setStatsEnabled(handle, enabled);
+    } catch (error) {
+      throw new DartsError(
+        `Failed to enable stats: ${error instanceof Error ? error.message : String(error)}`
+      );
+    }
+  }
+
+  /**
+   * Clears the lookup counters
+   * @param handle dictionary handle
+   */
+  // eslint-disable-next-line class-methods-use-this
+  resetStats(handle: number): void {
+    try {
+      native.resetStats(handle);
+    } catch (error) {
+      throw new DartsError(
+        `Failed to reset stats: ${error instanceof Error ? error.message : String(error)}`
+      );
+    }
+  }
+
+  /**
+   * Splits a text at code point boundaries using the dictionary
+   * @param handle dictionary handle
+   * @param text text to split, as a string or UTF-8 bytes read in place
+   * @param mode how the text is split (default 'longest')
+   * @param offset start of the text in a Uint8Array (default 0)
+   * @param length bytes of the text in a Uint8Array (default: to the end)
+   * @returns flat array of (start, length, value) triples, value -1 for unknown code points
+   */
+  // eslint-disable-next-line class-methods-use-this
+  tokenize(
+    handle: number,
+    text: string | Uint8Array,
+    mode?: TokenizeMode,
+    offset?: number,
+    length?: number
+  ): Int32Array {
+    try {
+      return native.tokenize(handle, text, mode, offset, length);
+    } catch (error) {
+      throw new DartsError(
+        `Failed to tokenize: ${error instanceof Error ? error.message : String(error)}`
+      );
+    }
+  }
+
+  /**
+   * Finds every occurrence of every key in a text in one pass
+   * @param handle dictionary handle
+   * @param text text to scan, a string or UTF-8 bytes
+   * @param offset start of the bytes to read (Uint8Array texts only)
+   * @param length number of bytes to read (Uint8Array texts only)
+   * @returns flat array of (start, length, value) triples, ordered by end and longest first
+   */
+  // eslint-disable-next-line class-methods-use-this
+  scan(handle: number, text: string | Uint8Array, offset?: number, length?: number): Int32Array {
+    try {
+      return native.scan(handle, text, offset, length);
+    } catch (error) {
+      throw new DartsError(
+        `Failed to scan text: ${error instanceof Error ? error.message : String(error)}`
+      );
+    }
+  }
+
+  /**
+   * Finds the longest non-overlapping matches in a text
+   * @param handle dictionary handle
+   * @param text text to scan
+   * @returns flat array of (start, length, value) triples in UTF-16 code units
+   */
+  // eslint-disable-next-line class-methods-use-this
+  findMatches(handle: number, text: string): Int32Array {
+    try {
+      return native.findMatches(handle, text);
+    } catch (error) {
+      throw new DartsError(
+        `Failed to find matches: ${error instanceof Error ? error.message : String(error)}`
+      );
+    }
+  }
+
+  /**
+   * Replaces the longest non-overlapping matches in a text using a replacement map
+   * @param handle dictionary handle
+   * @param text text to scan
+   * @param replacements replacement map (words without an entry are kept)
+   * @returns the text after replacement
+   */
+  // eslint-disable-next-line class-methods-use-this
+  replaceWords(handle: number, text: string, replacements: Record<string, string>): string {
+    try {
+      return native.replaceWords(handle, text, replacements);
+    } catch (error) {
+      throw new DartsError(
+        `Failed to replace words: ${error instanceof Error ? error.message : String(error)}`
+      );
+    }
+  }
 }
 
 // Export singleton instance
@@ -325,6 +996,10 @@ export const dartsNative = new DartsNativeWrapper();
 export { default as Dictionary } from './core/dictionary';
 export { default as Builder } from './core/builder';
 export { default as TextDarts } from './text-darts';
+export { default as TraverseCursor } from './core/cursor';
+export { default as StreamBuilder } from './core/stream-builder';
+export { default as LayeredDictionary } from './core/layered-dictionary';
+export { default as DictionaryGroup } from './core/dictionary-group';
 
 // Re-export all other exports
 export * from './core/types';
@@ -336,6 +1011,8 @@ export {
   createDictionary,
   createBuilder,
   loadDictionary,
+  attachDictionary,
+  createGroup,
   buildDictionary,
   buildAndSaveDictionary,
   buildAndSaveDictionarySync,
@@ -10,11 +10,13 @@
 // Import classes
 import Dictionary from './core/dictionary';
 import Builder from './core/builder';
+import DictionaryGroup from './core/dictionary-group';
 import TextDarts from './text-darts';
+import { dartsNative } from './core/native';
 
 // Import type definitions
 // import { TraverseResult, TraverseCallback, BuildOptions, WordReplacer } from './core/types';
-import { BuildOptions } from './core/types';
+import { BuildOptions, DictionaryGroupOptions, LoadOptions } from './core/types';
 /*
 // Import error classes
 import { DartsError, FileNotFoundError, InvalidDictionaryError, BuildError } from './core/errors';
@@ -27,6 +29,7 @@ import {
   sortStrings,
   uniqueArray,
   sortAndUniqueStrings,
+  encodeKeys,
 } from './core/utils';
 */
 
@@ -34,9 +37,30 @@ import {
 export { default as Dictionary } from './core/dictionary';
 export { default as Builder } from './core/builder';
 export { default as TextDarts } from './text-darts';
+export { default as TraverseCursor } from './core/cursor';
+export { default as StreamBuilder } from './core/stream-builder';
+export { default as LayeredDictionary } from './core/layered-dictionary';
+export { default as DictionaryGroup } from './core/dictionary-group';
 
 // Export type definitions
-export { TraverseResult, TraverseCallback, BuildOptions, WordReplacer } from './core/types';
+export {
+  TraverseResult,
+  TraverseCallback,
+  BuildOptions,
+  BufferLoadOptions,
+  DictionaryGroupOptions,
+  DictionaryStats,
+  EntryRange,
+  LoadOptions,
+  LookupCounters,
+  PredictiveSearchResult,
+  SaveOptions,
+  StreamBuildOptions,
+  TokenizeMode,
+  ValueTable,
+  ValueTableInput,
+  WordReplacer,
+} from './core/types';
 
 // Export error classes
 export { DartsError, FileNotFoundError, InvalidDictionaryError, BuildError } from './core/errors';
@@ -49,6 +73,7 @@ export {
   sortStrings,
   uniqueArray,
   sortAndUniqueStrings,
+  encodeKeys,
 } from './core/utils';
 
 /**
@@ -86,6 +111,7 @@ export function createBuilder(): Builder {
 /**
  * Loads a dictionary file
  * @param filePath path to the dictionary file
+ * @param options load options
  * @returns the loaded Dictionary object
  * @throws {FileNotFoundError} if the file is not found
  * @throws {InvalidDictionaryError} if the dictionary file is invalid
@@ -97,12 +123,56 @@ export function createBuilder(): Builder {
  * const result = dict.exactMatchSearch('hello');
  * ```
  */
-export function loadDictionary(filePath: string): Dictionary {
+export function loadDictionary(filePath: string, options?: LoadOptions): Dictionary {
   const dict = new Dictionary();
-  dict.loadSync(filePath);
+  dict.loadSync(filePath, options);
   return dict;
 }
 
+/**
+ * Attaches to a dictionary shared by another thread
+ * The returned Dictionary reads the same array as the sharing thread; no copy is made,
+ * except for a dictionary loaded with `numaReplicas` attached from another NUMA node.
+ * @param token token returned by `Dictionary#share`
+ * @returns a Dictionary object for this thread
+ * @throws {DartsError} if every thread has already disposed the shared dictionary
+ * @example
+ * ```typescript
+ * import { attachDictionary } from 'node-darts';
+ * import { workerData } from 'worker_threads';
+ *
+ * const dict = attachDictionary(workerData.token);
+ * const result = dict.exactMatchSearch('hello');
+ * ```
+ */
+export function attachDictionary(token: number): Dictionary {
+  return new Dictionary(dartsNative.attachDictionary(token));
+}
+
+/**
+ * Creates a group searching several dictionaries in one call
+ * @param dictionaries member dictionaries, highest priority first
+ * @param options how keys held by several members are reported
+ * @returns a new DictionaryGroup object
+ * @throws {DartsError} if there are no dictionaries or one of them is disposed
+ * @example
+ * ```typescript
+ * import { createGroup, loadDictionary } from 'node-darts';
+ *
+ * const group = createGroup([
+ *   loadDictionary('/path/to/system.darts'),
+ *   loadDictionary('/path/to/user.darts'),
+ * ]);
+ * const tokens = group.tokenize('東京都庁'); // (start, length, value, source) quadruples
+ * ```
+ */
+export function createGroup(
+  dictionaries: Dictionary[],
+  options?: DictionaryGroupOptions
+): DictionaryGroup {
+  return new DictionaryGroup(dictionaries, options);
+}
+
 /**
  * Builds a dictionary from keys and values
  * @param keys array of keys
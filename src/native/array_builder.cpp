@@ -0,0 +1,522 @@
+#include "array_builder.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <limits>
+#include <mutex>
+#include <thread>
+
+namespace node_darts {
+
+static_assert(sizeof(DoubleArrayUnit) == 8, "DoubleArrayUnit must match the Darts unit layout");
+
+namespace {
+
+// Darts leaves room past the last unit so that any byte can be probed from any base
+const size_t kUnitPadding = 257;
+
+// Nodes at this depth (key bytes) become the roots of the sub-tries built concurrently.
+// Two bytes give enough sub-tries to spread UTF-8 text, whose first bytes vary little.
+const size_t kSplitDepth = 2;
+
+const size_t kNoSplit = std::numeric_limits<size_t>::max();
+
+// Keys per group of sub-tries when there are few keys per thread
+const size_t kMinGroupKeys = 4096;
+
+// Keys placed by a thread before its count is published
+const size_t kProgressBatch = 256;
+
+// Failed placements at a free cell before it is no longer tried as the first sibling's cell
+const uint8_t kMaxFreeCellTrials = 32;
+const uint8_t kRetiredFreeCell = 0xff;
+
+const uint32_t kNoCell = 0xffffffff;
+
+// Time between two progress reports while the threads run
+const std::chrono::milliseconds kPollInterval(10);
+
+// One of a node's children, as Darts fetches them
+struct Node {
+  // Key byte + 1, or 0 for the end of a key
+  size_t code;
+  size_t depth;
+  // Range of the keys below the node
+  size_t left;
+  size_t right;
+};
+
+// Node at the split depth whose children are built into a separate array
+struct SubtrieTask {
+  // Unit of the node in the top-level array
+  size_t pos;
+  size_t left;
+  size_t right;
+  size_t depth;
+};
+
+// Input and state shared by every thread of one build
+struct BuildContext {
+  const char* const* keys;
+  const size_t* lengths;
+  const int* values;
+  size_t num_keys;
+  Placement placement;
+  std::atomic<size_t> progress{0};
+  std::atomic<bool> cancelled{false};
+};
+
+// Places a trie into its own unit array, in the unit format Darts uses.
+// Without a split depth this is a whole build; with one, nodes at that depth are
+// recorded as tasks instead of being descended into.
+class TrieBuilder {
+ public:
+  // The monitor, if any, is called from the thread running this builder
+  TrieBuilder(BuildContext* context, size_t split_depth, BuildMonitor* monitor)
+      : context_(context), keys_(context->keys), lengths_(context->lengths),
+        values_(context->values), split_depth_(split_depth), monitor_(monitor) {}
+
+  // Places the children of the node covering [left, right) at depth and everything
+  // below them, returning the base of the children (0 on failure)
+  size_t Insert(size_t left, size_t right, size_t depth) {
+    struct Frame {
+      std::vector<Node> siblings;
+      size_t begin;
+      size_t next;
+    };
+
+    std::vector<Frame> stack;
+    stack.push_back({Fetch(left, right, depth), 0, 0});
+    size_t root_begin = Place(stack.back().siblings);
+    stack.back().begin = root_begin;
+
+    // Depth-first in the same order as DoubleArrayImpl::insert
+    while (!stack.empty() && !failed_) {
+      Frame& frame = stack.back();
+      if (frame.next == frame.siblings.size()) {
+        stack.pop_back();
+        continue;
+      }
+
+      const Node node = frame.siblings[frame.next++];
+      size_t pos = frame.begin + node.code;
+      if (node.code == 0) {
+        PlaceValue(pos, node.left);
+        continue;
+      }
+      if (node.depth == split_depth_) {
+        tasks_.push_back({pos, node.left, node.right, node.depth});
+        continue;
+      }
+
+      std::vector<Node> children = Fetch(node.left, node.right, node.depth);
+      size_t begin = Place(children);
+      units_[pos].base = static_cast<int>(begin);
+      stack.push_back({std::move(children), begin, 0});
+    }
+
+    FlushProgress();
+    return failed_ ? 0 : root_begin;
+  }
+
+  const std::vector<DoubleArrayUnit>& units() const { return units_; }
+  // Units in use, from 0
+  size_t size() const { return size_; }
+  const std::vector<SubtrieTask>& tasks() const { return tasks_; }
+  bool failed() const { return failed_; }
+
+ private:
+  // Groups the keys of [left, right) by their byte at depth
+  std::vector<Node> Fetch(size_t left, size_t right, size_t depth) const {
+    std::vector<Node> siblings;
+    for (size_t i = left; i < right; i++) {
+      size_t code = lengths_[i] == depth ? 0
+                                         : static_cast<unsigned char>(keys_[i][depth]) + 1;
+      if (siblings.empty() || siblings.back().code != code) {
+        if (!siblings.empty()) {
+          siblings.back().right = i;
+        }
+        siblings.push_back({code, depth + 1, i, right});
+      }
+    }
+    return siblings;
+  }
+
+  // Finds a base at which every sibling fits and takes the siblings' cells
+  size_t Place(const std::vector<Node>& siblings) {
+    size_t begin = context_->placement == Placement::kFreeList ? FindFreeListBase(siblings)
+                                                               : FindScanBase(siblings);
+    used_[begin] = 1;
+    size_ = std::max(size_, begin + siblings.back().code + 1);
+    for (const Node& sibling : siblings) {
+      size_t pos = begin + sibling.code;
+      units_[pos].check = static_cast<unsigned int>(begin);
+      UnlinkFreeCell(pos);
+    }
+    return begin;
+  }
+
+  // Scans from the first cell that may be free, as DoubleArrayImpl::insert does
+  size_t FindScanBase(const std::vector<Node>& siblings) {
+    size_t first_code = siblings.front().code;
+    size_t last_code = siblings.back().code;
+    size_t pos = std::max(first_code + 1, next_check_pos_) - 1;
+    size_t nonzero_num = 0;
+    bool first = true;
+    size_t begin;
+
+    while (true) {
+      pos++;
+      Reserve(pos + 1);
+      if (units_[pos].check) {
+        nonzero_num++;
+        continue;
+      }
+      if (first) {
+        next_check_pos_ = pos;
+        first = false;
+      }
+
+      begin = pos - first_code;
+      Reserve(begin + last_code + 1);
+      if (used_[begin]) {
+        continue;
+      }
+
+      if (Fits(siblings, begin)) {
+        break;
+      }
+    }
+
+    // Skip the densely filled region from now on
+    if (1.0 * nonzero_num / (pos - next_check_pos_ + 1) >= 0.95) {
+      next_check_pos_ = pos;
+    }
+    return begin;
+  }
+
+  // Tries only empty cells for the first sibling, skipping occupied runs entirely.
+  // A cell that keeps failing is retired from the list so that the walk stays short;
+  // it can still be taken by a later sibling.
+  size_t FindFreeListBase(const std::vector<Node>& siblings) {
+    size_t first_code = siblings.front().code;
+    size_t last_code = siblings.back().code;
+    uint32_t cell = free_head_;
+
+    while (true) {
+      if (cell == kNoCell) {
+        // Every listed cell failed; carry on past the end of the array
+        size_t end = std::max(units_.size(), static_cast<size_t>(1));
+        Reserve(end + 1);
+        cell = static_cast<uint32_t>(end);
+      }
+
+      // The base must be positive, as a check of 0 marks an empty cell
+      bool tried = cell > first_code;
+      if (tried) {
+        size_t begin = cell - first_code;
+        Reserve(begin + last_code + 1);
+        if (!used_[begin] && Fits(siblings, begin)) {
+          return begin;
+        }
+      }
+
+      // Read after Reserve, which links any new cells behind the last one
+      uint32_t next = next_free_[cell];
+      if (tried && ++free_trials_[cell] >= kMaxFreeCellTrials) {
+        UnlinkFreeCell(cell);
+      }
+      cell = next;
+    }
+  }
+
+  bool Fits(const std::vector<Node>& siblings, size_t begin) const {
+    for (size_t i = 1; i < siblings.size(); i++) {
+      if (units_[begin + siblings[i].code].check) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  void PlaceValue(size_t pos, size_t key) {
+    // Darts rejects negative values the same way
+    if (values_[key] < 0 || context_->cancelled.load(std::memory_order_relaxed)) {
+      failed_ = true;
+      return;
+    }
+    units_[pos].base = -values_[key] - 1;
+
+    if (++pending_progress_ == kProgressBatch) {
+      FlushProgress();
+    }
+  }
+
+  void Reserve(size_t size) {
+    if (size <= units_.size()) {
+      return;
+    }
+    size_t old_size = units_.size();
+    size_t new_size = std::max(size, std::max(old_size * 2, static_cast<size_t>(1024)));
+    units_.resize(new_size, DoubleArrayUnit{0, 0});
+    used_.resize(new_size, 0);
+    if (context_->placement == Placement::kFreeList) {
+      LinkFreeCells(old_size, new_size);
+    }
+  }
+
+  // Appends the new cells, which are all empty, to the free list; cell 0 is never free
+  void LinkFreeCells(size_t begin, size_t end) {
+    next_free_.resize(end, kNoCell);
+    prev_free_.resize(end, kNoCell);
+    free_trials_.resize(end, 0);
+    if (begin == 0) {
+      free_trials_[0] = kRetiredFreeCell;
+      begin = 1;
+    }
+    for (size_t cell = begin; cell < end; cell++) {
+      prev_free_[cell] = free_tail_;
+      if (free_tail_ == kNoCell) {
+        free_head_ = static_cast<uint32_t>(cell);
+      } else {
+        next_free_[free_tail_] = static_cast<uint32_t>(cell);
+      }
+      free_tail_ = static_cast<uint32_t>(cell);
+    }
+  }
+
+  void UnlinkFreeCell(size_t cell) {
+    if (context_->placement != Placement::kFreeList || free_trials_[cell] == kRetiredFreeCell) {
+      return;
+    }
+    uint32_t prev = prev_free_[cell];
+    uint32_t next = next_free_[cell];
+    if (prev == kNoCell) {
+      free_head_ = next;
+    } else {
+      next_free_[prev] = next;
+    }
+    if (next == kNoCell) {
+      free_tail_ = prev;
+    } else {
+      prev_free_[next] = prev;
+    }
+    free_trials_[cell] = kRetiredFreeCell;
+  }
+
+  void FlushProgress() {
+    size_t progress = context_->progress.fetch_add(pending_progress_, std::memory_order_relaxed) +
+                      pending_progress_;
+    pending_progress_ = 0;
+    // The final update is left to BuildDoubleArray, once the array is complete
+    if (monitor_ && progress < context_->num_keys &&
+        !monitor_->OnProgress(progress, context_->num_keys)) {
+      context_->cancelled.store(true);
+    }
+  }
+
+  BuildContext* context_;
+  const char* const* keys_;
+  const size_t* lengths_;
+  const int* values_;
+  size_t split_depth_;
+  BuildMonitor* monitor_;
+
+  std::vector<DoubleArrayUnit> units_;
+  // Bases already taken by a node
+  std::vector<unsigned char> used_;
+  size_t size_ = 0;
+  size_t next_check_pos_ = 0;
+  size_t pending_progress_ = 0;
+  // Free list of the empty cells, in ascending order, for Placement::kFreeList
+  std::vector<uint32_t> next_free_;
+  std::vector<uint32_t> prev_free_;
+  // Failed placements at each listed cell, or kRetiredFreeCell for cells not in the list
+  std::vector<uint8_t> free_trials_;
+  uint32_t free_head_ = kNoCell;
+  uint32_t free_tail_ = kNoCell;
+  std::vector<SubtrieTask> tasks_;
+  bool failed_ = false;
+};
+
+// Consecutive sub-tries built into one array, which is relocated into the final array
+// once every group is done. Grouping keeps small sub-tries from each leaving a mostly
+// empty array behind.
+struct SubtrieGroup {
+  size_t first_task;
+  size_t last_task;
+  size_t num_keys;
+  std::unique_ptr<TrieBuilder> builder;
+  // Base of the children of each task's node, local to the group's array
+  std::vector<size_t> begins;
+};
+
+}  // namespace
+
+std::unique_ptr<DartsDict> BuildDoubleArray(size_t num_keys, const char* const* keys,
+                                            const size_t* lengths, const int* values,
+                                            const ArrayBuildOptions& options,
+                                            BuildMonitor* monitor, std::string* error) {
+  BuildContext context;
+  context.keys = keys;
+  context.lengths = lengths;
+  context.values = values;
+  context.num_keys = num_keys;
+  context.placement = options.placement;
+  size_t num_threads = options.threads == 0 ? std::thread::hardware_concurrency() : options.threads;
+  num_threads = std::max(num_threads, static_cast<size_t>(1));
+
+  // The top of the trie is placed on this thread, stopping at the split depth.
+  // Built by one thread, the top is the whole trie.
+  TrieBuilder top(&context, num_threads > 1 ? kSplitDepth : kNoSplit, monitor);
+  size_t root_begin = top.Insert(0, num_keys, 0);
+  if (top.failed()) {
+    *error = context.cancelled.load() ? "Build cancelled" : "Failed to build dictionary";
+    return nullptr;
+  }
+  const std::vector<SubtrieTask>& tasks = top.tasks();
+
+  // Split the sub-tries into a few groups per thread
+  size_t group_keys = std::max(num_keys / (num_threads * 8), kMinGroupKeys);
+  std::vector<SubtrieGroup> groups;
+  for (size_t i = 0; i < tasks.size(); i++) {
+    if (groups.empty() || groups.back().num_keys >= group_keys) {
+      groups.emplace_back();
+      groups.back().first_task = i;
+      groups.back().num_keys = 0;
+    }
+    groups.back().last_task = i + 1;
+    groups.back().num_keys += tasks[i].right - tasks[i].left;
+  }
+
+  // Largest groups first, so that the threads finish at about the same time
+  std::vector<size_t> order(groups.size());
+  for (size_t i = 0; i < order.size(); i++) {
+    order[i] = i;
+  }
+  std::sort(order.begin(), order.end(), [&groups](size_t a, size_t b) {
+    return groups[a].num_keys > groups[b].num_keys;
+  });
+
+  std::atomic<size_t> next_task{0};
+  std::atomic<bool> failed{false};
+  std::mutex mutex;
+  std::condition_variable done;
+  size_t running = std::min(num_threads, groups.size());
+  std::string thread_error;
+
+  auto run = [&]() {
+    try {
+      size_t i;
+      while (!context.cancelled.load(std::memory_order_relaxed) &&
+             (i = next_task.fetch_add(1)) < order.size()) {
+        SubtrieGroup& group = groups[order[i]];
+        group.builder.reset(new TrieBuilder(&context, kNoSplit, nullptr));
+        for (size_t t = group.first_task; t < group.last_task && !group.builder->failed(); t++) {
+          const SubtrieTask& task = tasks[t];
+          group.begins.push_back(group.builder->Insert(task.left, task.right, task.depth));
+        }
+        if (group.builder->failed()) {
+          failed.store(true);
+          context.cancelled.store(true);
+        }
+      }
+    } catch (const std::exception& e) {
+      std::lock_guard<std::mutex> lock(mutex);
+      thread_error = e.what();
+      failed.store(true);
+      context.cancelled.store(true);
+    }
+    std::lock_guard<std::mutex> lock(mutex);
+    running--;
+    done.notify_one();
+  };
+
+  std::vector<std::thread> threads;
+  threads.reserve(num_threads);
+  for (size_t i = 0; i < std::min(num_threads, groups.size()); i++) {
+    threads.emplace_back(run);
+  }
+
+  // Progress is reported from this thread only, so the monitor need not be thread-safe
+  bool cancelled = false;
+  {
+    std::unique_lock<std::mutex> lock(mutex);
+    while (running > 0) {
+      done.wait_for(lock, kPollInterval);
+      if (monitor && !cancelled && running > 0) {
+        lock.unlock();
+        cancelled = !monitor->OnProgress(context.progress.load(std::memory_order_relaxed),
+                                          num_keys);
+        if (cancelled) {
+          context.cancelled.store(true);
+        }
+        lock.lock();
+      }
+    }
+  }
+  for (std::thread& thread : threads) {
+    thread.join();
+  }
+
+  if (cancelled || (context.cancelled.load() && !failed.load())) {
+    *error = "Build cancelled";
+    return nullptr;
+  }
+  if (failed.load()) {
+    *error = thread_error.empty() ? "Failed to build dictionary" : thread_error;
+    return nullptr;
+  }
+
+  // Lay the groups out one after another behind the top of the trie
+  size_t total_size = top.size();
+  std::vector<size_t> offsets(groups.size());
+  for (size_t i = 0; i < groups.size(); i++) {
+    offsets[i] = total_size;
+    total_size += groups[i].builder->size();
+  }
+  total_size += kUnitPadding;
+  if (total_size > static_cast<size_t>(std::numeric_limits<int>::max())) {
+    *error = "Dictionary is too large";
+    return nullptr;
+  }
+
+  std::vector<DoubleArrayUnit> units(total_size, DoubleArrayUnit{0, 0});
+  std::copy(top.units().begin(), top.units().begin() + top.size(), units.begin());
+  units[0].base = static_cast<int>(root_begin);
+
+  for (size_t i = 0; i < groups.size(); i++) {
+    // Every base and check of a group moves by its offset; values stay as they are
+    const TrieBuilder& builder = *groups[i].builder;
+    const std::vector<DoubleArrayUnit>& local = groups[i].builder->units();
+    size_t offset = offsets[i];
+    for (size_t pos = 0; pos < builder.size(); pos++) {
+      if (!local[pos].check) {
+        continue;
+      }
+      DoubleArrayUnit& unit = units[offset + pos];
+      unit.check = static_cast<unsigned int>(local[pos].check + offset);
+      unit.base = local[pos].base < 0 ? local[pos].base
+                                      : static_cast<int>(local[pos].base + offset);
+    }
+    for (size_t t = groups[i].first_task; t < groups[i].last_task; t++) {
+      size_t begin = groups[i].begins[t - groups[i].first_task];
+      units[tasks[t].pos].base = static_cast<int>(begin + offset);
+    }
+    groups[i].builder.reset();
+  }
+
+  if (monitor && !monitor->OnProgress(num_keys, num_keys)) {
+    *error = "Build cancelled";
+    return nullptr;
+  }
+
+  std::unique_ptr<DartsDict> dict(new DartsDict());
+  dict->attach(std::unique_ptr<ArrayStorage>(new UnitArrayStorage(std::move(units))),
+               UnitFormat::kDarts, num_keys);
+  return dict;
+}
+
+}  // namespace node_darts
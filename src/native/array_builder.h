@@ -0,0 +1,77 @@
+#ifndef DARTS_ARRAY_BUILDER_H_
+#define DARTS_ARRAY_BUILDER_H_
+
+// Include standard library header files first
+#include <cstdint>
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "common.h"
+#include "storage.h"
+
+namespace node_darts {
+
+// Observes a Darts build on the thread that runs it
+class BuildMonitor {
+ public:
+  virtual ~BuildMonitor() {}
+  // Called each time a key is placed in the Double-Array; returning false cancels the build
+  virtual bool OnProgress(size_t current, size_t total) = 0;
+};
+
+// One Double-Array unit in the Darts 0.32 layout
+struct DoubleArrayUnit {
+  int base;
+  unsigned int check;
+};
+
+// Units built by BuildDoubleArray, owned by the dictionary that reads them
+class UnitArrayStorage : public ArrayStorage {
+ public:
+  explicit UnitArrayStorage(std::vector<DoubleArrayUnit> units) : units_(std::move(units)) {}
+
+  const void* data() const override { return units_.data(); }
+  size_t size() const override { return units_.size() * sizeof(DoubleArrayUnit); }
+
+ private:
+  std::vector<DoubleArrayUnit> units_;
+};
+
+// How a free base is found for a node's children
+enum class Placement {
+  // Scan the array cell by cell from the first cell that may be free, as Darts does
+  kScan,
+  // Walk a doubly-linked list of the empty cells only
+  kFreeList,
+};
+
+struct ArrayBuildOptions {
+  // Threads building the sub-tries below the first two key bytes (0 for one per core).
+  // One thread with Placement::kScan uses the Darts builder itself.
+  size_t threads = 1;
+  Placement placement = Placement::kScan;
+  // UnitFormat::kCompact is built sequentially by BuildCompactArray; threads and placement
+  // only apply to the Darts layout
+  UnitFormat format = UnitFormat::kDarts;
+  // Keep a KeyIndex so that keys can be restored from their values
+  bool key_index = true;
+  // Compute the ScanTable right away, so that it is saved along with the dictionary
+  bool scan_table = false;
+};
+
+// Builds the Double-Array with our own builder, e.g. in parallel.
+// The keys must be unique and sorted in byte order. The units are in the format Darts uses
+// and form an equivalent trie, so lookups, save() and open() work on the result unchanged,
+// but nodes may sit at other positions than the Darts builder would put them: subtries
+// built in parallel are placed in ranges of their own before being merged, and the free
+// list fills cells in another order than a scan.
+std::unique_ptr<DartsDict> BuildDoubleArray(size_t num_keys, const char* const* keys,
+                                            const size_t* lengths, const int* values,
+                                            const ArrayBuildOptions& options,
+                                            BuildMonitor* monitor, std::string* error);
+
+}  // namespace node_darts
+
+#endif  // DARTS_ARRAY_BUILDER_H_
@@ -0,0 +1,122 @@
+#ifndef DARTS_BATCH_LOOKUP_H_
+#define DARTS_BATCH_LOOKUP_H_
+
+// Include standard library header files first
+#include <cstddef>
+#include <cstdint>
+
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+#include <xmmintrin.h>
+#endif
+
+namespace node_darts {
+
+// Exact match lookups of many keys at once in a Darts Double-Array.
+// A single lookup is a chain of dependent loads, one unit per key byte, and on a large
+// array nearly every one of them misses the cache. Walking several keys in turn and
+// prefetching the unit each one reads next keeps that many misses in flight at once,
+// so their latencies overlap instead of adding up.
+
+// Keys walked side by side; enough to cover the memory latency with the few instructions
+// each step takes, while the lanes' state stays in registers and L1
+const size_t kBatchLanes = 16;
+
+inline void PrefetchUnit(const void* unit) {
+#if defined(__GNUC__) || defined(__clang__)
+  __builtin_prefetch(unit, 0, 3);
+#elif defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+  _mm_prefetch(static_cast<const char*>(unit), _MM_HINT_T0);
+#else
+  (void)unit;
+#endif
+}
+
+// Looks up keys [0, num_keys) in the units, in the layout Darts uses ({int base;
+// unsigned check;}), writing each key's value or -1 to results[i], as exactMatchSearch
+// would. key_at(i, &data, &length) gives the bytes of key i.
+// Unlike Darts, every probe is checked against num_units.
+template <class Unit, class KeyAt>
+void ExactMatchBatch(const Unit* units, size_t num_units, size_t num_keys, KeyAt key_at,
+                     int32_t* results) {
+  struct Lane {
+    const unsigned char* key;
+    size_t length;
+    size_t pos;
+    unsigned int base;
+    size_t index;
+  };
+
+  if (num_units == 0) {
+    for (size_t i = 0; i < num_keys; i++) {
+      results[i] = -1;
+    }
+    return;
+  }
+
+  // Fetches the unit read by the lane's next step: its child for the next byte, or its
+  // value. Bases past the array can come from a damaged file, so only units in range are.
+  auto prefetch_next = [units, num_units](const Lane& lane) {
+    size_t label = lane.pos < lane.length ? lane.key[lane.pos] + 1 : 0;
+    size_t p = static_cast<size_t>(lane.base) + label;
+    if (p < num_units) {
+      PrefetchUnit(units + p);
+    }
+  };
+
+  Lane lanes[kBatchLanes];
+  size_t num_active = 0;
+  size_t next_key = 0;
+  auto start = [&](Lane* lane) {
+    const char* data;
+    key_at(next_key, &data, &lane->length);
+    lane->key = reinterpret_cast<const unsigned char*>(data);
+    lane->pos = 0;
+    lane->base = static_cast<unsigned int>(units[0].base);
+    lane->index = next_key++;
+    prefetch_next(*lane);
+  };
+
+  while (num_active < kBatchLanes && next_key < num_keys) {
+    start(&lanes[num_active++]);
+  }
+
+  while (num_active > 0) {
+    for (size_t i = 0; i < num_active;) {
+      Lane& lane = lanes[i];
+      bool done;
+      if (lane.pos < lane.length) {
+        // The same step as Darts: the child for a byte is at base + byte + 1
+        size_t p = static_cast<size_t>(lane.base) + lane.key[lane.pos] + 1;
+        if (p < num_units && units[p].check == lane.base) {
+          lane.base = static_cast<unsigned int>(units[p].base);
+          lane.pos++;
+          done = false;
+        } else {
+          results[lane.index] = -1;
+          done = true;
+        }
+      } else {
+        // The end of the key; its value is in the unit at the node's base, stored negated
+        size_t p = lane.base;
+        int value = p < num_units && units[p].check == lane.base ? units[p].base : 0;
+        results[lane.index] = value < 0 ? -value - 1 : -1;
+        done = true;
+      }
+
+      if (!done) {
+        prefetch_next(lane);
+        i++;
+      } else if (next_key < num_keys) {
+        start(&lane);
+        i++;
+      } else {
+        // The lane is retired; the last active one takes its place
+        lane = lanes[--num_active];
+      }
+    }
+  }
+}
+
+}  // namespace node_darts
+
+#endif  // DARTS_BATCH_LOOKUP_H_
@@ -7,58 +7,184 @@
 #include <cstddef>
 #include <vector>
 #include <string>
+#include <memory>
+#include <utility>
+#include <mutex>
+#include <unordered_map>
 
 #include <napi.h>
 #include "dictionary.h"
 #include "builder.h"
+#include "cursor.h"
+#include "stream_builder.h"
+#include "layered_dictionary.h"
+#include "dictionary_group.h"
 
 namespace node_darts {
 
-// Definition of global variables
-std::vector<DartsDict*> g_dictionaries;
-
 // Implementation of utility functions
-DartsDict* GetDictionaryFromHandle(uint32_t handle) {
-  if (handle < g_dictionaries.size() && g_dictionaries[handle] != nullptr) {
-    return g_dictionaries[handle];
+AddonData* GetAddonData(Napi::Env env) {
+  return env.GetInstanceData<AddonData>();
+}
+
+DartsDict* GetDictionaryFromHandle(Napi::Env env, uint32_t handle) {
+  AddonData* data = GetAddonData(env);
+  if (handle < data->dictionaries.size()) {
+    return data->dictionaries[handle].get();
+  }
+  return nullptr;
+}
+
+std::shared_ptr<DartsDict> GetSharedDictionary(Napi::Env env, uint32_t handle) {
+  AddonData* data = GetAddonData(env);
+  if (handle < data->dictionaries.size()) {
+    return data->dictionaries[handle];
   }
   return nullptr;
 }
 
-uint32_t AddDictionary(DartsDict* dict) {
-  // Find an empty slot
-  for (uint32_t i = 0; i < g_dictionaries.size(); i++) {
-    if (g_dictionaries[i] == nullptr) {
-      g_dictionaries[i] = dict;
-      return i;
+uint32_t AddDictionary(Napi::Env env, DartsDict* dict) {
+  return AddDictionary(env, std::shared_ptr<DartsDict>(dict));
+}
+
+uint32_t AddDictionary(Napi::Env env, std::shared_ptr<DartsDict> dict) {
+  AddonData* data = GetAddonData(env);
+  
+  // Reuse a destroyed handle if there is one
+  if (!data->free_handles.empty()) {
+    uint32_t handle = data->free_handles.back();
+    data->free_handles.pop_back();
+    data->dictionaries[handle] = std::move(dict);
+    return handle;
+  }
+  
+  data->dictionaries.push_back(std::move(dict));
+  return static_cast<uint32_t>(data->dictionaries.size() - 1);
+}
+
+bool ReplaceDictionary(Napi::Env env, uint32_t handle, const DartsDict* expected,
+                       std::shared_ptr<DartsDict> dict) {
+  AddonData* data = GetAddonData(env);
+  
+  // The slot may have been destroyed, or even reused, since the caller looked it up
+  if (handle < data->dictionaries.size() && data->dictionaries[handle] != nullptr &&
+      data->dictionaries[handle].get() == expected) {
+    data->dictionaries[handle] = std::move(dict);
+    return true;
+  }
+  return false;
+}
+
+bool ExchangeDictionaries(Napi::Env env, uint32_t handle, uint32_t other) {
+  AddonData* data = GetAddonData(env);
+  if (handle >= data->dictionaries.size() || data->dictionaries[handle] == nullptr ||
+      other >= data->dictionaries.size() || data->dictionaries[other] == nullptr) {
+    return false;
+  }
+  
+  // Lookups run on this thread and see one array or the other; work in flight holds its own
+  // reference to the array it started on, which is freed once the last of it finishes
+  std::swap(data->dictionaries[handle], data->dictionaries[other]);
+  return true;
+}
+
+void RemoveDictionary(Napi::Env env, uint32_t handle) {
+  AddonData* data = GetAddonData(env);
+  if (handle < data->dictionaries.size() && data->dictionaries[handle] != nullptr) {
+    data->dictionaries[handle].reset();
+    data->free_handles.push_back(handle);
+  }
+}
+
+namespace {
+
+// Shared by every environment in the process, hence the lock
+std::mutex g_published_mutex;
+std::unordered_map<uint32_t, std::weak_ptr<DartsDict>> g_published;
+uint32_t g_next_token = 1;
+
+}  // namespace
+
+uint32_t PublishDictionary(std::shared_ptr<DartsDict> dict) {
+  std::lock_guard<std::mutex> lock(g_published_mutex);
+  
+  // Drop entries whose dictionaries have been freed everywhere
+  for (auto it = g_published.begin(); it != g_published.end();) {
+    if (it->second.expired()) {
+      it = g_published.erase(it);
+    } else {
+      ++it;
     }
   }
   
-  // Add a new one if no empty slot is found
-  g_dictionaries.push_back(dict);
-  return static_cast<uint32_t>(g_dictionaries.size() - 1);
+  uint32_t token = g_next_token++;
+  g_published[token] = dict;
+  return token;
 }
 
-void RemoveDictionary(uint32_t handle) {
-  if (handle < g_dictionaries.size() && g_dictionaries[handle] != nullptr) {
-    delete g_dictionaries[handle];
-    g_dictionaries[handle] = nullptr;
+std::shared_ptr<DartsDict> FindPublishedDictionary(uint32_t token) {
+  std::lock_guard<std::mutex> lock(g_published_mutex);
+  
+  auto it = g_published.find(token);
+  if (it == g_published.end()) {
+    return nullptr;
   }
+  return it->second.lock();
 }
 
 Napi::Object Init(Napi::Env env, Napi::Object exports) {
+  // Released automatically when the environment shuts down
+  env.SetInstanceData(new AddonData());
+  TraverseCursor::Init(env);
+  StreamBuilder::Init(env);
+  BuildCancelToken::Init(env);
+  LayeredDictionary::Init(env);
+  DictionaryGroup::Init(env);
+  
   // Dictionary related
   exports.Set("createDictionary", Napi::Function::New(env, CreateDictionary));
   exports.Set("destroyDictionary", Napi::Function::New(env, DestroyDictionary));
+  exports.Set("shareDictionary", Napi::Function::New(env, ShareDictionary));
+  exports.Set("attachDictionary", Napi::Function::New(env, AttachDictionary));
+  exports.Set("swapDictionaries", Napi::Function::New(env, SwapDictionaries));
   exports.Set("loadDictionary", Napi::Function::New(env, LoadDictionary));
   exports.Set("saveDictionary", Napi::Function::New(env, SaveDictionary));
+  exports.Set("loadDictionaryAsync", Napi::Function::New(env, LoadDictionaryAsync));
+  exports.Set("saveDictionaryAsync", Napi::Function::New(env, SaveDictionaryAsync));
+  exports.Set("saveDictionaryToBuffer", Napi::Function::New(env, SaveDictionaryToBuffer));
+  exports.Set("loadDictionaryFromBuffer", Napi::Function::New(env, LoadDictionaryFromBuffer));
   exports.Set("exactMatchSearch", Napi::Function::New(env, ExactMatchSearch));
+  exports.Set("exactMatchSearchBatch", Napi::Function::New(env, ExactMatchSearchBatch));
+  exports.Set("exactMatchSearchBuffer", Napi::Function::New(env, ExactMatchSearchBuffer));
   exports.Set("commonPrefixSearch", Napi::Function::New(env, CommonPrefixSearch));
+  exports.Set("commonPrefixSearchPairs", Napi::Function::New(env, CommonPrefixSearchPairs));
+  exports.Set("commonPrefixSearchInto", Napi::Function::New(env, CommonPrefixSearchInto));
+  exports.Set("exactMatchEntries", Napi::Function::New(env, ExactMatchEntries));
+  exports.Set("commonPrefixSearchEntries", Napi::Function::New(env, CommonPrefixSearchEntries));
+  exports.Set("getValueTable", Napi::Function::New(env, GetValueTable));
+  exports.Set("restoreKey", Napi::Function::New(env, RestoreKey));
+  exports.Set("numKeys", Napi::Function::New(env, NumKeys));
+  exports.Set("stats", Napi::Function::New(env, Stats));
+  exports.Set("setStatsEnabled", Napi::Function::New(env, SetStatsEnabled));
+  exports.Set("resetStats", Napi::Function::New(env, ResetStats));
+  exports.Set("predictiveSearch", Napi::Function::New(env, PredictiveSearch));
+  exports.Set("predictiveSearchKeys", Napi::Function::New(env, PredictiveSearchKeys));
   exports.Set("traverse", Napi::Function::New(env, Traverse));
+  exports.Set("createCursor", Napi::Function::New(env, CreateCursor));
+  exports.Set("createLayeredDictionary", Napi::Function::New(env, CreateLayeredDictionary));
+  exports.Set("createDictionaryGroup", Napi::Function::New(env, CreateDictionaryGroup));
   exports.Set("size", Napi::Function::New(env, Size));
+  exports.Set("tokenize", Napi::Function::New(env, Tokenize));
+  exports.Set("scan", Napi::Function::New(env, Scan));
+  exports.Set("findMatches", Napi::Function::New(env, FindMatches));
+  exports.Set("replaceWords", Napi::Function::New(env, ReplaceWords));
   
   // Builder related
   exports.Set("build", Napi::Function::New(env, Build));
+  exports.Set("buildAsync", Napi::Function::New(env, BuildAsync));
+  exports.Set("createCancelToken", Napi::Function::New(env, CreateCancelToken));
+  exports.Set("createStreamBuilder", Napi::Function::New(env, CreateStreamBuilder));
+  exports.Set("buildFromFileAsync", Napi::Function::New(env, BuildFromFileAsync));
   
   return exports;
 }
@@ -1,100 +1,496 @@
 #include "builder.h"
 #include <vector>
 #include <string>
-#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <memory>
 #include <stdexcept>
+#include <utility>
+#include "key_arena.h"
 
 namespace node_darts {
 
-Napi::Value Build(const Napi::CallbackInfo& info) {
+namespace {
+
+// Reads (keys, values?) arguments into the arena, throwing a JS exception and returning
+// false on error. Each key is encoded straight into the arena, so the build needs no
+// per-key allocation and can run off the main thread.
+bool ReadBuildInput(const Napi::CallbackInfo& info, KeyArena* arena) {
   Napi::Env env = info.Env();
-  
-  try {
-    if (info.Length() < 1 || !info[0].IsArray()) {
-      Napi::TypeError::New(env, "First argument must be an array of keys").ThrowAsJavaScriptException();
-      return env.Null();
+
+  if (info.Length() < 1 || !info[0].IsArray()) {
+    Napi::TypeError::New(env, "First argument must be an array of keys").ThrowAsJavaScriptException();
+    return false;
+  }
+
+  Napi::Array keys_array = info[0].As<Napi::Array>();
+  uint32_t num_keys = keys_array.Length();
+
+  if (num_keys == 0) {
+    Napi::Error::New(env, "Empty keys array").ThrowAsJavaScriptException();
+    return false;
+  }
+
+  arena->Reserve(num_keys, 0);
+  for (uint32_t i = 0; i < num_keys; i++) {
+    Napi::Value key_val = keys_array[i];
+    if (!key_val.IsString()) {
+      Napi::TypeError::New(env, "All keys must be strings").ThrowAsJavaScriptException();
+      return false;
     }
-    
-    Napi::Array keys_array = info[0].As<Napi::Array>();
-    uint32_t num_keys = keys_array.Length();
-    
-    if (num_keys == 0) {
-      Napi::Error::New(env, "Empty keys array").ThrowAsJavaScriptException();
-      return env.Null();
+
+    // The first call measures the UTF-8 length, the second writes the key in place
+    size_t length = 0;
+    napi_status status = napi_get_value_string_utf8(env, key_val, nullptr, 0, &length);
+    if (status == napi_ok) {
+      char* dest = arena->BeginKey(length);
+      status = napi_get_value_string_utf8(env, key_val, dest, length + 1, &length);
+      arena->EndKey(length, kAutoValue);
+    }
+    if (status != napi_ok) {
+      Napi::Error::New(env, "Failed to read key").ThrowAsJavaScriptException();
+      return false;
     }
-    
-    // Create an array of keys
-    std::vector<std::string> keys;
-    keys.reserve(num_keys);
-    
+  }
+
+  if (info.Length() >= 2 && info[1].IsArray()) {
+    Napi::Array values_array = info[1].As<Napi::Array>();
+
+    if (values_array.Length() != num_keys) {
+      Napi::Error::New(env, "Values array length must match keys array length").ThrowAsJavaScriptException();
+      return false;
+    }
+
     for (uint32_t i = 0; i < num_keys; i++) {
-      Napi::Value key_val = keys_array[i];
-      if (!key_val.IsString()) {
-        Napi::TypeError::New(env, "All keys must be strings").ThrowAsJavaScriptException();
-        return env.Null();
+      Napi::Value value_val = values_array[i];
+      if (!value_val.IsNumber()) {
+        Napi::TypeError::New(env, "All values must be numbers").ThrowAsJavaScriptException();
+        return false;
       }
-      keys.push_back(key_val.As<Napi::String>().Utf8Value());
-    }
-    
-    // Sort the keys
-    std::sort(keys.begin(), keys.end());
-    
-    // Remove duplicates
-    auto last = std::unique(keys.begin(), keys.end());
-    keys.erase(last, keys.end());
-    
-    // Actual number of keys to use
-    num_keys = static_cast<uint32_t>(keys.size());
-    
-    // Create an array of key pointers
-    std::vector<const char*> key_ptrs;
-    key_ptrs.reserve(num_keys);
-    
-    for (const auto& key : keys) {
-      key_ptrs.push_back(key.c_str());
-    }
-    
-    // Create an array of values
-    std::vector<int> values;
-    
-    if (info.Length() >= 2 && info[1].IsArray()) {
-      Napi::Array values_array = info[1].As<Napi::Array>();
-      
-      if (values_array.Length() != num_keys) {
-        Napi::Error::New(env, "Values array length must match keys array length").ThrowAsJavaScriptException();
-        return env.Null();
+      // Darts cannot store negative values, and -1 would be taken for kAutoValue
+      int value = value_val.As<Napi::Number>().Int32Value();
+      if (value < 0) {
+        Napi::Error::New(env, "Values must not be negative").ThrowAsJavaScriptException();
+        return false;
       }
-      
-      values.reserve(num_keys);
-      
-      for (uint32_t i = 0; i < num_keys; i++) {
-        Napi::Value value_val = values_array[i];
-        if (!value_val.IsNumber()) {
-          Napi::TypeError::New(env, "All values must be numbers").ThrowAsJavaScriptException();
-          return env.Null();
+      arena->set_value(i, value);
+    }
+  }
+
+  return true;
+}
+
+// Default minimum time between two progress updates
+const double kDefaultProgressInterval = 100;
+
+// Limits progress updates to one per interval, plus the final one
+class ProgressThrottle {
+ public:
+  explicit ProgressThrottle(double interval_ms)
+      : interval_(std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+            std::chrono::duration<double, std::milli>(interval_ms))),
+        last_(std::chrono::steady_clock::now()) {}
+
+  bool Due(size_t current, size_t total) {
+    if (current == total) {
+      return true;
+    }
+    // Darts reports every key, so the clock is only sampled every so many keys
+    if (current < sampled_ + 256) {
+      return false;
+    }
+    sampled_ = current;
+    std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+    if (now - last_ < interval_) {
+      return false;
+    }
+    last_ = now;
+    return true;
+  }
+
+ private:
+  std::chrono::steady_clock::duration interval_;
+  std::chrono::steady_clock::time_point last_;
+  size_t sampled_ = 0;
+};
+
+// Optional third argument of build and buildAsync
+struct BuildOptions {
+  ArrayBuildOptions array;
+  Napi::Function progress;
+  double progress_interval = kDefaultProgressInterval;
+  std::shared_ptr<std::atomic<bool>> cancelled;
+  std::unique_ptr<ValueTable> table;
+};
+
+// Largest integer a JS number holds exactly
+const double kMaxSafeInteger = 9007199254740991.0;
+
+// Reads { stride?, entries } with one row of stride * count fields per key, throwing a JS
+// exception and returning false on error. Group i of the table holds the entries of key i.
+bool ReadValueTable(Napi::Env env, const Napi::Value& value, uint32_t num_keys,
+                    std::unique_ptr<ValueTable>* table) {
+  if (!value.IsObject()) {
+    Napi::TypeError::New(env, "valueTable must be an object").ThrowAsJavaScriptException();
+    return false;
+  }
+  Napi::Object obj = value.As<Napi::Object>();
+
+  size_t stride = 1;
+  Napi::Value stride_val = obj.Get("stride");
+  double stride_number = stride_val.IsNumber() ? stride_val.As<Napi::Number>().DoubleValue() : 0;
+  if (stride_number >= 1 && stride_number <= UINT32_MAX &&
+      stride_number == std::floor(stride_number)) {
+    stride = static_cast<size_t>(stride_number);
+  } else if (!stride_val.IsUndefined()) {
+    Napi::TypeError::New(env, "valueTable.stride must be a positive integer").ThrowAsJavaScriptException();
+    return false;
+  }
+
+  Napi::Value entries_val = obj.Get("entries");
+  if (!entries_val.IsArray() || entries_val.As<Napi::Array>().Length() != num_keys) {
+    Napi::TypeError::New(env, "valueTable.entries must be an array with one row per key").ThrowAsJavaScriptException();
+    return false;
+  }
+  Napi::Array entries = entries_val.As<Napi::Array>();
+
+  std::vector<uint64_t> offsets;
+  std::vector<int64_t> fields;
+  offsets.reserve(num_keys + 1);
+  offsets.push_back(0);
+  for (uint32_t i = 0; i < num_keys; i++) {
+    Napi::Value row = entries[i];
+    if (row.IsTypedArray() && row.As<Napi::TypedArray>().TypedArrayType() == napi_bigint64_array) {
+      Napi::BigInt64Array typed = row.As<Napi::BigInt64Array>();
+      fields.insert(fields.end(), typed.Data(), typed.Data() + typed.ElementLength());
+    } else if (row.IsArray()) {
+      Napi::Array array = row.As<Napi::Array>();
+      for (uint32_t j = 0; j < array.Length(); j++) {
+        Napi::Value field = array[j];
+        bool lossless = true;
+        if (field.IsBigInt()) {
+          fields.push_back(field.As<Napi::BigInt>().Int64Value(&lossless));
+        } else if (field.IsNumber() && std::trunc(field.As<Napi::Number>().DoubleValue()) ==
+                                           field.As<Napi::Number>().DoubleValue() &&
+                   std::fabs(field.As<Napi::Number>().DoubleValue()) <= kMaxSafeInteger) {
+          fields.push_back(field.As<Napi::Number>().Int64Value());
+        } else {
+          lossless = false;
+        }
+        if (!lossless) {
+          Napi::TypeError::New(env, "valueTable fields must be 64-bit integers").ThrowAsJavaScriptException();
+          return false;
         }
-        values.push_back(value_val.As<Napi::Number>().Int32Value());
       }
     } else {
-      // If no values are specified, use indices as values
-      values.resize(num_keys);
-      for (uint32_t i = 0; i < num_keys; i++) {
-        values[i] = i;
+      Napi::TypeError::New(env, "valueTable rows must be arrays or BigInt64Arrays").ThrowAsJavaScriptException();
+      return false;
+    }
+
+    if ((fields.size() - offsets.back() * stride) % stride != 0) {
+      Napi::TypeError::New(env, "valueTable rows must hold a multiple of stride fields").ThrowAsJavaScriptException();
+      return false;
+    }
+    offsets.push_back(fields.size() / stride);
+  }
+
+  table->reset(new ValueTable(stride, std::move(offsets), std::move(fields)));
+  return true;
+}
+
+// Reads { threads?, placement?, unitFormat?, keyIndex?, scanTable?, progress?,
+// progressInterval?, cancelToken?, valueTable? }, throwing a JS exception and returning false on error
+bool ReadBuildOptions(const Napi::CallbackInfo& info, BuildOptions* options) {
+  Napi::Env env = info.Env();
+
+  if (info.Length() < 3 || info[2].IsUndefined() || info[2].IsNull()) {
+    return true;
+  }
+  if (!info[2].IsObject()) {
+    Napi::TypeError::New(env, "Build options must be an object").ThrowAsJavaScriptException();
+    return false;
+  }
+  Napi::Object obj = info[2].As<Napi::Object>();
+
+  Napi::Value threads = obj.Get("threads");
+  if (threads.IsNumber() && threads.As<Napi::Number>().DoubleValue() >= 0) {
+    options->array.threads = static_cast<size_t>(threads.As<Napi::Number>().DoubleValue());
+  } else if (!threads.IsUndefined()) {
+    Napi::TypeError::New(env, "threads must be a non-negative number").ThrowAsJavaScriptException();
+    return false;
+  }
+
+  Napi::Value placement = obj.Get("placement");
+  if (placement.IsString() && placement.As<Napi::String>().Utf8Value() == "scan") {
+    options->array.placement = Placement::kScan;
+  } else if (placement.IsString() && placement.As<Napi::String>().Utf8Value() == "freelist") {
+    options->array.placement = Placement::kFreeList;
+  } else if (!placement.IsUndefined()) {
+    Napi::TypeError::New(env, "placement must be 'scan' or 'freelist'").ThrowAsJavaScriptException();
+    return false;
+  }
+
+  Napi::Value unit_format = obj.Get("unitFormat");
+  if (unit_format.IsString() && unit_format.As<Napi::String>().Utf8Value() == "darts") {
+    options->array.format = UnitFormat::kDarts;
+  } else if (unit_format.IsString() && unit_format.As<Napi::String>().Utf8Value() == "compact") {
+    options->array.format = UnitFormat::kCompact;
+  } else if (!unit_format.IsUndefined()) {
+    Napi::TypeError::New(env, "unitFormat must be 'darts' or 'compact'").ThrowAsJavaScriptException();
+    return false;
+  }
+
+  Napi::Value key_index = obj.Get("keyIndex");
+  if (key_index.IsBoolean()) {
+    options->array.key_index = key_index.As<Napi::Boolean>().Value();
+  } else if (!key_index.IsUndefined()) {
+    Napi::TypeError::New(env, "keyIndex must be a boolean").ThrowAsJavaScriptException();
+    return false;
+  }
+
+  Napi::Value scan_table = obj.Get("scanTable");
+  if (scan_table.IsBoolean()) {
+    options->array.scan_table = scan_table.As<Napi::Boolean>().Value();
+  } else if (!scan_table.IsUndefined()) {
+    Napi::TypeError::New(env, "scanTable must be a boolean").ThrowAsJavaScriptException();
+    return false;
+  }
+
+  Napi::Value progress = obj.Get("progress");
+  if (progress.IsFunction()) {
+    options->progress = progress.As<Napi::Function>();
+  } else if (!progress.IsUndefined()) {
+    Napi::TypeError::New(env, "progress must be a function").ThrowAsJavaScriptException();
+    return false;
+  }
+
+  Napi::Value interval = obj.Get("progressInterval");
+  if (interval.IsNumber() && interval.As<Napi::Number>().DoubleValue() >= 0) {
+    options->progress_interval = interval.As<Napi::Number>().DoubleValue();
+  } else if (!interval.IsUndefined()) {
+    Napi::TypeError::New(env, "progressInterval must be a non-negative number").ThrowAsJavaScriptException();
+    return false;
+  }
+
+  Napi::Value token = obj.Get("cancelToken");
+  if (!token.IsUndefined()) {
+    BuildCancelToken* cancel_token = BuildCancelToken::FromValue(env, token);
+    if (!cancel_token) {
+      Napi::TypeError::New(env, "cancelToken must be created by createCancelToken").ThrowAsJavaScriptException();
+      return false;
+    }
+    options->cancelled = cancel_token->flag();
+  }
+
+  Napi::Value table = obj.Get("valueTable");
+  if (!table.IsUndefined() &&
+      !ReadValueTable(env, table, info[0].As<Napi::Array>().Length(), &options->table)) {
+    return false;
+  }
+
+  return true;
+}
+
+// Calls the progress callback directly; the build runs on the JS thread.
+// An exception thrown by the callback cancels the build and is left pending.
+class SyncBuildMonitor : public BuildMonitor {
+ public:
+  SyncBuildMonitor(Napi::Env env, const BuildOptions& options)
+      : env_(env), options_(options), throttle_(options.progress_interval) {}
+
+  bool OnProgress(size_t current, size_t total) override {
+    if (options_.cancelled && options_.cancelled->load(std::memory_order_relaxed)) {
+      return false;
+    }
+    if (!options_.progress.IsEmpty() && throttle_.Due(current, total)) {
+      options_.progress.Call({Napi::Number::New(env_, static_cast<double>(current)),
+                              Napi::Number::New(env_, static_cast<double>(total))});
+      if (env_.IsExceptionPending()) {
+        return false;
       }
     }
-    
-    // Build the Double-Array
-    DartsDict* dict = new DartsDict();
-    int result = dict->build(num_keys, key_ptrs.data(), nullptr, values.data());
-    
-    if (result != 0) {
-      delete dict;
-      Napi::Error::New(env, "Failed to build dictionary").ThrowAsJavaScriptException();
+    return true;
+  }
+
+ private:
+  Napi::Env env_;
+  const BuildOptions& options_;
+  ProgressThrottle throttle_;
+};
+
+// Builds a dictionary on the libuv threadpool and resolves with its handle.
+// Progress is posted to the JS thread through a thread-safe function.
+class BuildWorker : public Napi::AsyncWorker, public BuildMonitor {
+ public:
+  BuildWorker(Napi::Env env, KeyArena arena, BuildOptions options)
+      : Napi::AsyncWorker(env, "node_darts:build"),
+        deferred_(Napi::Promise::Deferred::New(env)),
+        arena_(std::move(arena)),
+        array_options_(options.array),
+        cancelled_(options.cancelled),
+        throttle_(options.progress_interval),
+        table_(std::move(options.table)) {
+    if (!options.progress.IsEmpty()) {
+      progress_ = Napi::ThreadSafeFunction::New(env, options.progress, "node_darts:buildProgress", 0, 1);
+      has_progress_ = true;
+    }
+  }
+
+  Napi::Promise Promise() const { return deferred_.Promise(); }
+
+  void Execute() override {
+    try {
+      std::string error;
+      if (IsCancelled()) {
+        error = "Build cancelled";
+      } else {
+        dict_ = arena_.Build(&error, this, array_options_);
+      }
+      if (!dict_) {
+        SetError(error);
+      } else if (table_) {
+        dict_->set_value_table(std::move(table_));
+      }
+    } catch (const std::exception& e) {
+      SetError(e.what());
+    }
+    // No more updates; lets the event loop exit once the queued ones have run
+    if (has_progress_) {
+      progress_.Release();
+    }
+  }
+
+  bool OnProgress(size_t current, size_t total) override {
+    if (IsCancelled()) {
+      return false;
+    }
+    if (has_progress_ && throttle_.Due(current, total)) {
+      ProgressUpdate* update = new ProgressUpdate{current, total};
+      if (progress_.NonBlockingCall(update, CallProgress) != napi_ok) {
+        delete update;
+      }
+    }
+    return true;
+  }
+
+  void OnOK() override {
+    // Handles are only ever published from the main thread
+    uint32_t handle = AddDictionary(Env(), dict_.release());
+    deferred_.Resolve(Napi::Number::New(Env(), handle));
+  }
+
+  void OnError(const Napi::Error& e) override {
+    deferred_.Reject(e.Value());
+  }
+
+ private:
+  struct ProgressUpdate {
+    size_t current;
+    size_t total;
+  };
+
+  static void CallProgress(Napi::Env env, Napi::Function callback, ProgressUpdate* update) {
+    // env is null if the environment is shutting down
+    if (env != nullptr && callback != nullptr) {
+      callback.Call({Napi::Number::New(env, static_cast<double>(update->current)),
+                     Napi::Number::New(env, static_cast<double>(update->total))});
+    }
+    delete update;
+  }
+
+  bool IsCancelled() const {
+    return cancelled_ && cancelled_->load(std::memory_order_relaxed);
+  }
+
+  Napi::Promise::Deferred deferred_;
+  KeyArena arena_;
+  ArrayBuildOptions array_options_;
+  std::shared_ptr<std::atomic<bool>> cancelled_;
+  ProgressThrottle throttle_;
+  Napi::ThreadSafeFunction progress_;
+  bool has_progress_ = false;
+  std::unique_ptr<ValueTable> table_;
+  std::unique_ptr<DartsDict> dict_;
+};
+
+}  // namespace
+
+void BuildCancelToken::Init(Napi::Env env) {
+  Napi::Function func = DefineClass(env, "BuildCancelToken", {
+    InstanceMethod("cancel", &BuildCancelToken::Cancel),
+    InstanceAccessor("cancelled", &BuildCancelToken::GetCancelled, nullptr),
+  });
+
+  // The constructor is not exported; tokens are only created through createCancelToken
+  GetAddonData(env)->cancel_token_constructor = Napi::Persistent(func);
+}
+
+Napi::Value BuildCancelToken::New(Napi::Env env) {
+  return GetAddonData(env)->cancel_token_constructor.New({});
+}
+
+BuildCancelToken* BuildCancelToken::FromValue(Napi::Env env, const Napi::Value& value) {
+  if (!value.IsObject() ||
+      !value.As<Napi::Object>().InstanceOf(GetAddonData(env)->cancel_token_constructor.Value())) {
+    return nullptr;
+  }
+  return Unwrap(value.As<Napi::Object>());
+}
+
+BuildCancelToken::BuildCancelToken(const Napi::CallbackInfo& info)
+    : Napi::ObjectWrap<BuildCancelToken>(info), cancelled_(std::make_shared<std::atomic<bool>>(false)) {}
+
+Napi::Value BuildCancelToken::Cancel(const Napi::CallbackInfo& info) {
+  cancelled_->store(true, std::memory_order_relaxed);
+  return info.Env().Undefined();
+}
+
+Napi::Value BuildCancelToken::GetCancelled(const Napi::CallbackInfo& info) {
+  return Napi::Boolean::New(info.Env(), cancelled_->load(std::memory_order_relaxed));
+}
+
+Napi::Value CreateCancelToken(const Napi::CallbackInfo& info) {
+  Napi::Env env = info.Env();
+
+  try {
+    return BuildCancelToken::New(env);
+  } catch (const std::exception& e) {
+    Napi::Error::New(env, e.what()).ThrowAsJavaScriptException();
+    return env.Null();
+  }
+}
+
+Napi::Value Build(const Napi::CallbackInfo& info) {
+  Napi::Env env = info.Env();
+
+  try {
+    KeyArena arena;
+    BuildOptions options;
+    if (!ReadBuildInput(info, &arena) || !ReadBuildOptions(info, &options)) {
       return env.Null();
     }
-    
+
+    std::string error;
+    std::unique_ptr<DartsDict> dict;
+    if (options.progress.IsEmpty() && !options.cancelled) {
+      dict = arena.Build(&error, nullptr, options.array);
+    } else {
+      SyncBuildMonitor monitor(env, options);
+      dict = arena.Build(&error, &monitor, options.array);
+    }
+    if (!dict) {
+      // An exception thrown by the progress callback is rethrown as is
+      if (!env.IsExceptionPending()) {
+        Napi::Error::New(env, error).ThrowAsJavaScriptException();
+      }
+      return env.Null();
+    }
+    if (options.table) {
+      dict->set_value_table(std::move(options.table));
+    }
+
     // Return the handle
-    uint32_t handle = AddDictionary(dict);
+    uint32_t handle = AddDictionary(env, dict.release());
     return Napi::Number::New(env, handle);
   } catch (const std::exception& e) {
     Napi::Error::New(env, e.what()).ThrowAsJavaScriptException();
@@ -102,4 +498,25 @@ Napi::Value Build(const Napi::CallbackInfo& info) {
   }
 }
 
-}  // namespace node_darts
\ No newline at end of file
+Napi::Value BuildAsync(const Napi::CallbackInfo& info) {
+  Napi::Env env = info.Env();
+
+  try {
+    // Keys are copied out of JS here; sorting and building happen on the threadpool
+    KeyArena arena;
+    BuildOptions options;
+    if (!ReadBuildInput(info, &arena) || !ReadBuildOptions(info, &options)) {
+      return env.Null();
+    }
+
+    BuildWorker* worker = new BuildWorker(env, std::move(arena), std::move(options));
+    Napi::Promise promise = worker->Promise();
+    worker->Queue();
+    return promise;
+  } catch (const std::exception& e) {
+    Napi::Error::New(env, e.what()).ThrowAsJavaScriptException();
+    return env.Null();
+  }
+}
+
+}  // namespace node_darts
@@ -4,13 +4,37 @@
 // Include standard library header files first
 #include <cstdint>
 #include <cstddef>
+#include <atomic>
+#include <memory>
 
 #include <napi.h>
 #include "common.h"
 
 namespace node_darts {
 
+// Cancels the background builds it is passed to.
+// The flag is shared with each build, so it may be cancelled from JS at any time.
+class BuildCancelToken : public Napi::ObjectWrap<BuildCancelToken> {
+ public:
+  static void Init(Napi::Env env);
+  static Napi::Value New(Napi::Env env);
+  // Returns nullptr if the value is not a cancel token
+  static BuildCancelToken* FromValue(Napi::Env env, const Napi::Value& value);
+
+  explicit BuildCancelToken(const Napi::CallbackInfo& info);
+
+  std::shared_ptr<std::atomic<bool>> flag() const { return cancelled_; }
+
+ private:
+  Napi::Value Cancel(const Napi::CallbackInfo& info);
+  Napi::Value GetCancelled(const Napi::CallbackInfo& info);
+
+  std::shared_ptr<std::atomic<bool>> cancelled_;
+};
+
+Napi::Value CreateCancelToken(const Napi::CallbackInfo& info);
 Napi::Value Build(const Napi::CallbackInfo& info);
+Napi::Value BuildAsync(const Napi::CallbackInfo& info);
 
 }  // namespace node_darts
 
@@ -6,24 +6,543 @@
 #include <cstddef>
 #include <vector>
 #include <string>
+#include <memory>
+#include <utility>
+#include <mutex>
+#include <unordered_map>
+#include <climits>
+#include <cstring>
 
 #include <napi.h>
 // C++17互換性のために修正されたdarts.hを使用
 #include "third_party/darts/darts.h"
+#include "batch_lookup.h"
+#include "compact_array.h"
+#include "file_format.h"
+#include "key_index.h"
+#include "lookup_stats.h"
+#include "relayout.h"
+#include "scan_table.h"
+#include "storage.h"
+#include "value_table.h"
 
-// Dartsのエイリアス定義
-typedef Darts::DoubleArray DartsDict;
+// Double-Array that can also read its units in place from external storage, in either
+// the Darts layout or the compact layout
+class DartsDict : public Darts::DoubleArray {
+ public:
+  typedef node_darts::UnitFormat UnitFormat;
+
+  // Uses the units held by the storage without copying them
+  void attach(std::unique_ptr<node_darts::ArrayStorage> storage,
+              UnitFormat format = UnitFormat::kDarts, size_t num_keys = 0) {
+    node_darts::FileLayout layout;
+    layout.format = format;
+    layout.num_units = storage->size() / node_darts::UnitSize(format);
+    layout.num_keys = num_keys;
+    attachUnits(std::move(storage), layout);
+  }
+
+  // Uses a serialized dictionary held by the storage, with or without a file header,
+  // along with its value table and key index if it has them.
+  // Returns false and sets error if the storage does not hold a valid dictionary.
+  bool attachFile(std::unique_ptr<node_darts::ArrayStorage> storage, bool verify,
+                  std::string* error) {
+    node_darts::FileLayout layout;
+    if (!node_darts::ParseDictionaryFile(storage->data(), storage->size(), verify, &layout,
+                                         error)) {
+      return false;
+    }
+    const char* data = static_cast<const char*>(storage->data());
+    std::unique_ptr<node_darts::ValueTable> table;
+    if (layout.table.size > 0) {
+      table = node_darts::ValueTable::Parse(data + layout.table.offset, layout.table.size,
+                                            verify, error);
+      if (!table) {
+        return false;
+      }
+    }
+    std::unique_ptr<node_darts::KeyIndex> keys;
+    if (layout.keys.size > 0) {
+      keys = node_darts::KeyIndex::Parse(data + layout.keys.offset, layout.keys.size, verify,
+                                         error);
+      if (!keys) {
+        return false;
+      }
+    }
+    std::unique_ptr<node_darts::ScanTable> scan;
+    if (layout.scan.size > 0) {
+      scan = node_darts::ScanTable::Parse(data + layout.scan.offset, layout.scan.size,
+                                          layout.num_units, verify, error);
+      if (!scan) {
+        return false;
+      }
+    }
+    attachUnits(std::move(storage), layout);
+    table_ = std::move(table);
+    keys_ = std::move(keys);
+    scan_ = std::move(scan);
+    sections_in_storage_ = true;
+    scan_in_storage_ = scan_ != nullptr;
+    return true;
+  }
+
+  // Attaches entries found through the values of the keys, see ValueTable
+  void set_value_table(std::unique_ptr<node_darts::ValueTable> table) {
+    table_ = std::move(table);
+  }
+  // nullptr if the dictionary has no value table
+  const node_darts::ValueTable* value_table() const { return table_.get(); }
+
+  // Attaches the keys the dictionary was built from, see KeyIndex
+  void set_key_index(std::unique_ptr<node_darts::KeyIndex> keys) {
+    keys_ = std::move(keys);
+  }
+  // nullptr if the keys cannot be restored, as for files saved without them
+  const node_darts::KeyIndex* key_index() const { return keys_.get(); }
+
+  // Failure links for scanning texts, see ScanTable. They are read from the file if it has
+  // them, or computed on first use (or by build_scan_table) and saved with the dictionary.
+  // nullptr if the dictionary is empty.
+  const node_darts::ScanTable* scan_table() const {
+    std::lock_guard<std::mutex> lock(scan_mutex_);
+    if (!scan_) {
+      scan_ = node_darts::ScanTable::Build(*this);
+    }
+    return scan_.get();
+  }
+  void build_scan_table() { scan_table(); }
+  // Bytes of the scan table, or 0 if it has not been read or computed
+  size_t scan_table_bytes() const {
+    std::lock_guard<std::mutex> lock(scan_mutex_);
+    return scan_ ? scan_->byte_size() : 0;
+  }
+
+  int build(size_t key_size, const key_type** key, const size_t* length = 0,
+            const value_type* value = 0, int (*progress_func)(size_t, size_t) = 0) {
+    // The base class would reallocate (and delete) an attached array in place
+    detach();
+    int result = Darts::DoubleArray::build(key_size, key, length, value, progress_func);
+    num_keys_ = key_size;
+    return result;
+  }
+
+  // Writes the units behind a versioned file header, followed by the value table, the key
+  // index and the scan table if the dictionary has them.
+  // relayout writes the nodes renumbered for the cache instead (Darts layout only, see
+  // RelayoutForCache); the dictionary itself keeps its units. A compression_level from 1
+  // to 9 writes a compressed dictionary file (see CompressDictionaryFile).
+  bool save(const char* file, std::string* error, bool relayout = false,
+            int compression_level = 0) const {
+    return serializeWith(relayout, error, [&](const void* units, size_t num_units,
+                                              const node_darts::ScanTable* scan) {
+      return node_darts::WriteDictionaryFile(file, format_, num_keys_, units, num_units,
+                                             table_.get(), keys_.get(), scan, error,
+                                             compression_level);
+    });
+  }
+
+  // Serializes the dictionary into bytes, as save writes it to a file
+  bool serialize(std::vector<char>* bytes, std::string* error, bool relayout = false,
+                 int compression_level = 0) const {
+    return serializeWith(relayout, error, [&](const void* units, size_t num_units,
+                                              const node_darts::ScanTable* scan) {
+      return node_darts::SerializeDictionary(format_, num_keys_, units, num_units, table_.get(),
+                                             keys_.get(), scan, compression_level, bytes, error);
+    });
+  }
+
+  // Records where the dictionary comes from ("build" or "load") and how long that took
+  void set_origin(const char* source, double duration_ms) {
+    source_ = source;
+    duration_ms_ = duration_ms;
+  }
+  const char* source() const { return source_; }
+  double duration_ms() const { return duration_ms_; }
+
+  // Lookup counters, which callers update through a LookupTimer
+  node_darts::LookupStats* lookup_stats() const { return &stats_; }
+
+  // Number of units in use
+  size_t nonzero_size() const {
+    return format_ == UnitFormat::kCompact ? compact_.nonzero_size()
+                                           : Darts::DoubleArray::nonzero_size();
+  }
+  // Bytes of the dictionary in physical memory: the units and the sections, counting only
+  // the pages of a mapped file that are in the page cache
+  size_t resident_size() const {
+    size_t bytes = storage_ ? storage_->resident_size() : Darts::DoubleArray::total_size();
+    if (!sections_in_storage_) {
+      bytes += (table_ ? table_->byte_size() : 0) + (keys_ ? keys_->byte_size() : 0);
+    }
+    std::lock_guard<std::mutex> lock(scan_mutex_);
+    if (scan_ && !scan_in_storage_) {
+      bytes += scan_->byte_size();
+    }
+    return bytes;
+  }
+  bool mapped() const { return storage_ && storage_->mapped(); }
+  node_darts::HugePages huge_pages() const {
+    return storage_ ? storage_->huge_pages() : node_darts::HugePages::kNone;
+  }
+  // NUMA node the array is bound to, or -1
+  int numa_node() const { return storage_ ? storage_->numa_node() : -1; }
+
+  // Keeps a copy of the dictionary for each NUMA node it is attached from, see
+  // local_replica. Only meant for a dictionary read from a file onto a node, as its storage
+  // then holds the whole file; attaching other units turns it off.
+  void set_numa_replicas(bool enabled) { numa_replicas_ = enabled; }
+
+  // The copy of the dictionary on the NUMA node of the calling thread, made on first use,
+  // or nullptr if this dictionary is the one to read: replication is off, the thread runs
+  // on the dictionary's own node, or no memory could be bound to the thread's node.
+  // Safe to call from any thread.
+  std::shared_ptr<DartsDict> local_replica() const {
+    int home = numa_node();
+    int node = node_darts::CurrentNumaNode();
+    if (!numa_replicas_ || home < 0 || node < 0 || node == home) {
+      return nullptr;
+    }
+
+    std::lock_guard<std::mutex> lock(replica_mutex_);
+    size_t index = static_cast<size_t>(node);
+    if (index < replicas_.size() && replicas_[index]) {
+      return replicas_[index];
+    }
+
+    node_darts::PageOptions options;
+    options.huge_pages = huge_pages() != node_darts::HugePages::kNone;
+    options.numa_node = node;
+    std::string error;
+    std::unique_ptr<node_darts::PageStorage> copy =
+        node_darts::PageStorage::Allocate(storage_->size(), options, &error);
+    if (!copy || copy->numa_node() != node) {
+      return nullptr;
+    }
+    std::memcpy(copy->mutable_data(), storage_->data(), storage_->size());
+    std::shared_ptr<DartsDict> replica = std::make_shared<DartsDict>();
+    // The bytes were checked when the dictionary was loaded
+    if (!replica->attachFile(std::move(copy), false, &error)) {
+      return nullptr;
+    }
+    replica->set_origin(source_, duration_ms_);
+    if (index >= replicas_.size()) {
+      replicas_.resize(index + 1);
+    }
+    replicas_[index] = replica;
+    return replica;
+  }
+
+  UnitFormat format() const { return format_; }
+  // Number of keys, or 0 if unknown (for files saved without a header)
+  size_t num_keys() const { return num_keys_; }
+  // Number of units
+  size_t size() const {
+    return format_ == UnitFormat::kCompact ? compact_.size() : Darts::DoubleArray::size();
+  }
+
+  // Looks up keys [0, num_keys) and writes each value or -1 to results[i];
+  // key_at(i, &data, &length) gives the bytes of key i. The Darts layout walks the keys
+  // interleaved with prefetching, see ExactMatchBatch.
+  template <class KeyAt>
+  void exactMatchBatch(size_t num_keys, KeyAt key_at, int32_t* results) const {
+    if (format_ == UnitFormat::kDarts) {
+      node_darts::ExactMatchBatch(static_cast<const Unit*>(array()), size(), num_keys, key_at,
+                                  results);
+      return;
+    }
+    for (size_t i = 0; i < num_keys; i++) {
+      const char* key;
+      size_t length;
+      key_at(i, &key, &length);
+      // Darts treats a zero length as "use strlen"
+      results[i] = size() == 0 ? -1 : exactMatchSearch<int>(length == 0 ? "" : key, length);
+    }
+  }
+
+  template <class T>
+  T exactMatchSearch(const key_type* key, size_t len = 0, size_t node_pos = 0) const {
+    if (format_ == UnitFormat::kCompact) {
+      T result;
+      int value = compact_.exactMatchSearch(key, len);
+      set_result(&result, value, value < 0 ? 0 : len);
+      return result;
+    }
+    return Darts::DoubleArray::exactMatchSearch<T>(key, len, node_pos);
+  }
+
+  template <class T>
+  size_t commonPrefixSearch(const key_type* key, T* result, size_t result_len, size_t len = 0,
+                            size_t node_pos = 0) const {
+    if (format_ == UnitFormat::kCompact) {
+      return compact_.commonPrefixSearch(key, result, result_len, len,
+                                         [this](T* x, int value, size_t length) {
+                                           set_result(x, value, length);
+                                         });
+    }
+    return Darts::DoubleArray::commonPrefixSearch(key, result, result_len, len, node_pos);
+  }
+
+  value_type traverse(const key_type* key, size_t& node_pos, size_t& key_pos,
+                      size_t len = 0) const {
+    if (format_ == UnitFormat::kCompact) {
+      return compact_.traverse(key, node_pos, key_pos, len);
+    }
+    return Darts::DoubleArray::traverse(key, node_pos, key_pos, len);
+  }
+
+  // Calls visit(byte, child_pos) for each child of the node at node_pos, in byte order
+  template <class Visitor>
+  void forEachChild(size_t node_pos, Visitor visit) const {
+    if (format_ == UnitFormat::kCompact) {
+      compact_.forEachChild(node_pos, visit);
+      return;
+    }
+    // The child for a byte is at base + byte + 1, the node's value at base itself, so a
+    // NUL byte (keys built with explicit lengths may hold one) is a child like any other
+    const Unit* units = static_cast<const Unit*>(array());
+    size_t base = static_cast<size_t>(units[node_pos].base);
+    for (size_t byte = 0; byte < 256 && base + byte + 1 < size(); byte++) {
+      if (units[base + byte + 1].check == base) {
+        visit(static_cast<unsigned char>(byte), base + byte + 1);
+      }
+    }
+  }
+
+  // Enumerates, in byte order, the keys starting with the prefix and calls
+  // visit(value, key) for each of them. Stops after limit keys (0 for no limit).
+  // Returns the number of keys visited.
+  template <class Visitor>
+  size_t predictiveSearch(const char* prefix, size_t len, size_t limit, Visitor visit) const {
+    if (size() == 0) {
+      return 0;
+    }
+    
+    size_t node_pos = 0;
+    size_t key_pos = 0;
+    if (len > 0 && traverse(prefix, node_pos, key_pos, len) == -2) {
+      return 0;
+    }
+    if (format_ == UnitFormat::kCompact) {
+      return compact_.predictiveSearch(node_pos, std::string(prefix, len), limit, visit);
+    }
+    
+    // Depth-first walk below the prefix node; the label of a child is its byte + 1,
+    // and label 0 is the terminal unit holding the value of the key ending here
+    struct Frame {
+      size_t base;
+      size_t next_label;
+    };
+    const Unit* units = static_cast<const Unit*>(array());
+    std::vector<Frame> stack;
+    std::string key(prefix, len);
+    size_t num_results = 0;
+    
+    stack.push_back({static_cast<size_t>(units[node_pos].base), 0});
+    while (!stack.empty()) {
+      Frame& frame = stack.back();
+      if (frame.next_label > 256) {
+        stack.pop_back();
+        if (!stack.empty()) {
+          key.pop_back();
+        }
+        continue;
+      }
+      
+      size_t label = frame.next_label++;
+      size_t pos = frame.base + label;
+      if (pos >= size() || units[pos].check != frame.base) {
+        continue;
+      }
+      
+      if (label == 0) {
+        if (units[pos].base < 0) {
+          visit(-units[pos].base - 1, key);
+          if (++num_results == limit) {
+            break;
+          }
+        }
+        continue;
+      }
+      
+      key.push_back(static_cast<char>(label - 1));
+      stack.push_back({static_cast<size_t>(units[pos].base), 0});
+    }
+    return num_results;
+  }
+
+ private:
+  void attachUnits(std::unique_ptr<node_darts::ArrayStorage> storage,
+                   const node_darts::FileLayout& layout) {
+    detach();
+    const char* units = static_cast<const char*>(storage->data()) + layout.offset;
+    if (layout.format == UnitFormat::kCompact) {
+      compact_.set_units(reinterpret_cast<const node_darts::CompactArray::Unit*>(units),
+                         layout.num_units);
+    } else {
+      set_array(const_cast<char*>(units), layout.num_units);
+    }
+    format_ = layout.format;
+    num_keys_ = layout.num_keys;
+    storage_ = std::move(storage);
+  }
+
+  // Calls write(units, num_units, scan) with what save and serialize write
+  template <class Write>
+  bool serializeWith(bool relayout, std::string* error, Write write) const {
+    if (size() == 0) {
+      *error = "Dictionary is empty";
+      return false;
+    }
+    if (!relayout || format_ != UnitFormat::kDarts) {
+      const void* units = format_ == UnitFormat::kCompact
+                              ? static_cast<const void*>(compact_.units())
+                              : array();
+      std::lock_guard<std::mutex> lock(scan_mutex_);
+      return write(units, size(), scan_.get());
+    }
+
+    // Darts leaves room past the last unit so that any byte can be probed from any base
+    std::vector<Unit> units = node_darts::RelayoutForCache(
+        static_cast<const Unit*>(array()), size(), node_darts::kRelayoutHotDepth, 257);
+    if (units.empty()) {
+      *error = "Dictionary is damaged";
+      return false;
+    }
+    if (units.size() > static_cast<size_t>(INT_MAX)) {
+      *error = "Dictionary is too large";
+      return false;
+    }
+
+    // The scan table is indexed by unit position, so it is computed again for the new units
+    std::unique_ptr<node_darts::ScanTable> scan;
+    if (scan_table_bytes() > 0) {
+      DartsDict relaid;
+      relaid.set_array(units.data(), units.size());
+      scan = node_darts::ScanTable::Build(relaid);
+    }
+    return write(units.data(), units.size(), scan.get());
+  }
+
+  // Drops the units and the storage holding them
+  void detach() {
+    clear();
+    compact_.set_units(nullptr, 0);
+    format_ = UnitFormat::kDarts;
+    num_keys_ = 0;
+    // The table and the key index may point into the storage
+    table_.reset();
+    keys_.reset();
+    {
+      std::lock_guard<std::mutex> lock(scan_mutex_);
+      scan_.reset();
+    }
+    sections_in_storage_ = false;
+    scan_in_storage_ = false;
+    numa_replicas_ = false;
+    {
+      std::lock_guard<std::mutex> lock(replica_mutex_);
+      replicas_.clear();
+    }
+    storage_.reset();
+  }
+
+  // Layout of one serialized Double-Array unit
+  struct Unit {
+    int base;
+    unsigned int check;
+  };
+  
+  node_darts::CompactArray compact_;
+  UnitFormat format_ = UnitFormat::kDarts;
+  size_t num_keys_ = 0;
+  std::unique_ptr<node_darts::ArrayStorage> storage_;
+  // May point into the storage, so they are declared (and destroyed) after it
+  std::unique_ptr<node_darts::ValueTable> table_;
+  std::unique_ptr<node_darts::KeyIndex> keys_;
+  // Computed lazily by lookups, which only read the dictionary otherwise
+  mutable std::unique_ptr<node_darts::ScanTable> scan_;
+  mutable std::mutex scan_mutex_;
+  // Whether the table and the key index are read in place from the storage
+  bool sections_in_storage_ = false;
+  // Whether the scan table is, rather than computed after the dictionary was loaded
+  bool scan_in_storage_ = false;
+  // Copies for other NUMA nodes, indexed by node and made as threads there attach
+  bool numa_replicas_ = false;
+  mutable std::vector<std::shared_ptr<DartsDict>> replicas_;
+  mutable std::mutex replica_mutex_;
+  const char* source_ = "empty";
+  double duration_ms_ = 0;
+  // Lookups only read the dictionary, but count themselves
+  mutable node_darts::LookupStats stats_;
+};
 
 // node_darts名前空間
 namespace node_darts {
 
-// ハンドル管理のためのグローバル変数
-extern std::vector<DartsDict*> g_dictionaries;
+// Per-addon-instance state.
+// Every environment that loads the addon (the main thread and each worker thread) gets
+// its own copy, and it is only touched from that environment's JS thread.
+struct AddonData {
+  // Dictionaries by numeric handle. Handles are kept rather than wrapping each dictionary
+  // in a Napi::ObjectWrap: they are part of the public surface (Dictionary#getHandle, the
+  // handle-taking Dictionary constructor, the DartsNative interface and its tests), a
+  // lookup costs one bounds-checked index, and TextDarts relies on its
+  // FinalizationRegistry to destroy them. Moving to ObjectWrap means changing all of these.
+  // Entries are shared so that background workers keep a dictionary alive
+  // even if its handle is destroyed or replaced while they run
+  std::vector<std::shared_ptr<DartsDict>> dictionaries;
+  // Destroyed handles, reused before the vector grows
+  std::vector<uint32_t> free_handles;
+  Napi::FunctionReference cursor_constructor;
+  Napi::FunctionReference stream_builder_constructor;
+  Napi::FunctionReference cancel_token_constructor;
+  Napi::FunctionReference layered_dictionary_constructor;
+  Napi::FunctionReference dictionary_group_constructor;
+};
+
+// How Tokenize splits a text
+enum class TokenizeMode {
+  // Greedy segmentation: the longest match at each position, or one unknown code point
+  kLongest,
+  // Every match starting at every code point boundary
+  kAllMatches,
+  // Every match, plus one unknown code point where no match starts, so that every
+  // position has an outgoing edge
+  kLattice,
+};
+
+const char* const kTokenizeModeUsage = "mode must be 'longest', 'all-matches' or 'lattice'";
+
+// Reads a mode name; returns false if there is no such mode
+inline bool ParseTokenizeMode(const std::string& name, TokenizeMode* mode) {
+  if (name == "longest") {
+    *mode = TokenizeMode::kLongest;
+  } else if (name == "all-matches") {
+    *mode = TokenizeMode::kAllMatches;
+  } else if (name == "lattice") {
+    *mode = TokenizeMode::kLattice;
+  } else {
+    return false;
+  }
+  return true;
+}
 
 // ユーティリティ関数
-DartsDict* GetDictionaryFromHandle(uint32_t handle);
-uint32_t AddDictionary(DartsDict* dict);
-void RemoveDictionary(uint32_t handle);
+AddonData* GetAddonData(Napi::Env env);
+DartsDict* GetDictionaryFromHandle(Napi::Env env, uint32_t handle);
+std::shared_ptr<DartsDict> GetSharedDictionary(Napi::Env env, uint32_t handle);
+uint32_t AddDictionary(Napi::Env env, DartsDict* dict);
+uint32_t AddDictionary(Napi::Env env, std::shared_ptr<DartsDict> dict);
+bool ReplaceDictionary(Napi::Env env, uint32_t handle, const DartsDict* expected,
+                       std::shared_ptr<DartsDict> dict);
+// Exchanges the dictionaries of two handles; returns false if either handle is invalid
+bool ExchangeDictionaries(Napi::Env env, uint32_t handle, uint32_t other);
+void RemoveDictionary(Napi::Env env, uint32_t handle);
+
+// Process-wide table of dictionaries published for other environments (worker threads).
+// Entries are weak: a dictionary lives as long as some environment holds a handle to it.
+uint32_t PublishDictionary(std::shared_ptr<DartsDict> dict);
+std::shared_ptr<DartsDict> FindPublishedDictionary(uint32_t token);
 
 } // namespace node_darts
 
@@ -0,0 +1,303 @@
+#include "compact_array.h"
+
+#include "array_builder.h"
+
+namespace node_darts {
+
+namespace {
+
+typedef CompactArray::Unit Unit;
+
+// Free cells are only tracked in the last few blocks; older blocks are fixed for good
+const uint32_t kBlockSize = 256;
+const uint32_t kNumExtraBlocks = 16;
+const uint32_t kNumExtras = kBlockSize * kNumExtraBlocks;
+
+// An offset must fit in 21 bits, or have its lower 8 bits clear and fit in 29 bits
+const uint32_t kLowerMask = 0xFF;
+const uint32_t kUpperMask = 0xFF << 21;
+const uint32_t kMaxOffset = 1U << 29;
+
+void SetHasLeaf(Unit* unit) { *unit |= 1U << 8; }
+void SetValue(Unit* unit, int value) { *unit = static_cast<Unit>(value) | (1U << 31); }
+void SetLabel(Unit* unit, unsigned char label) { *unit = (*unit & ~0xFFU) | label; }
+
+bool SetOffset(Unit* unit, uint32_t offset) {
+  if (offset >= kMaxOffset) {
+    return false;
+  }
+  *unit &= (1U << 31) | (1U << 8) | 0xFF;
+  if (offset < (1U << 21)) {
+    *unit |= offset << 10;
+  } else {
+    *unit |= (offset << 2) | (1U << 9);
+  }
+  return true;
+}
+
+// Port of the darts-clone keyset builder: each node's children are placed with one
+// XOR offset, taken from a circular list of the cells not yet in use
+class CompactBuilder {
+ public:
+  CompactBuilder(size_t num_keys, const char* const* keys, const size_t* lengths,
+                 const int* values, BuildMonitor* monitor)
+      : num_keys_(num_keys),
+        keys_(keys),
+        lengths_(lengths),
+        values_(values),
+        monitor_(monitor) {}
+
+  bool Build(std::vector<Unit>* units, std::string* error) {
+    size_t num_units = 1;
+    while (num_units < num_keys_) {
+      num_units <<= 1;
+    }
+    units_.reserve(num_units);
+    extras_.resize(kNumExtras);
+
+    ReserveId(0);
+    extras(0).is_used = true;
+    SetOffset(&units_[0], 1);
+    SetLabel(&units_[0], 0);
+
+    if (!BuildNode(0, num_keys_, 0, 0)) {
+      *error = error_;
+      return false;
+    }
+    FixAllBlocks();
+
+    units->swap(units_);
+    return true;
+  }
+
+ private:
+  struct Extra {
+    uint32_t prev = 0;
+    uint32_t next = 0;
+    bool is_fixed = false;
+    bool is_used = false;
+  };
+
+  // The byte of key i at depth, or 0 where the key ends
+  unsigned char Label(size_t i, size_t depth) const {
+    return depth < lengths_[i] ? static_cast<unsigned char>(keys_[i][depth]) : 0;
+  }
+
+  Extra& extras(uint32_t id) { return extras_[id % kNumExtras]; }
+  const Extra& extras(uint32_t id) const { return extras_[id % kNumExtras]; }
+  uint32_t num_units() const { return static_cast<uint32_t>(units_.size()); }
+
+  bool BuildNode(size_t begin, size_t end, size_t depth, uint32_t dic_id) {
+    uint32_t offset;
+    if (!Arrange(begin, end, depth, dic_id, &offset)) {
+      return false;
+    }
+
+    // Skip the key ending at this node, which Arrange stored as the leaf
+    while (begin < end && Label(begin, depth) == 0) {
+      ++begin;
+    }
+    if (begin == end) {
+      return true;
+    }
+
+    size_t last_begin = begin;
+    unsigned char last_label = Label(begin, depth);
+    while (++begin < end) {
+      unsigned char label = Label(begin, depth);
+      if (label != last_label) {
+        if (!BuildNode(last_begin, begin, depth + 1, offset ^ last_label)) {
+          return false;
+        }
+        last_begin = begin;
+        last_label = label;
+      }
+    }
+    return BuildNode(last_begin, end, depth + 1, offset ^ last_label);
+  }
+
+  // Places the children of the node at dic_id and returns their offset
+  bool Arrange(size_t begin, size_t end, size_t depth, uint32_t dic_id, uint32_t* offset) {
+    labels_.clear();
+    int value = -1;
+    for (size_t i = begin; i < end; ++i) {
+      unsigned char label = Label(i, depth);
+      if (label == 0) {
+        if (depth < lengths_[i]) {
+          error_ = "Keys containing NUL bytes cannot use the compact unit format";
+          return false;
+        }
+        if (values_[i] < 0) {
+          error_ = "Failed to build dictionary";
+          return false;
+        }
+        value = values_[i];
+        ++progress_;
+        if (monitor_ && !monitor_->OnProgress(progress_, num_keys_)) {
+          error_ = "Build cancelled";
+          return false;
+        }
+      }
+      if (labels_.empty() || label != labels_.back()) {
+        labels_.push_back(label);
+      }
+    }
+
+    *offset = FindValidOffset(dic_id);
+    if (!SetOffset(&units_[dic_id], dic_id ^ *offset)) {
+      error_ = "Dictionary is too large";
+      return false;
+    }
+
+    for (unsigned char label : labels_) {
+      uint32_t child_id = *offset ^ label;
+      ReserveId(child_id);
+      if (label == 0) {
+        SetHasLeaf(&units_[dic_id]);
+        SetValue(&units_[child_id], value);
+      } else {
+        SetLabel(&units_[child_id], label);
+      }
+    }
+    extras(*offset).is_used = true;
+    return true;
+  }
+
+  uint32_t FindValidOffset(uint32_t id) const {
+    if (extras_head_ >= num_units()) {
+      return num_units() | (id & kLowerMask);
+    }
+
+    uint32_t unfixed_id = extras_head_;
+    do {
+      uint32_t offset = unfixed_id ^ labels_[0];
+      if (IsValidOffset(id, offset)) {
+        return offset;
+      }
+      unfixed_id = extras(unfixed_id).next;
+    } while (unfixed_id != extras_head_);
+
+    return num_units() | (id & kLowerMask);
+  }
+
+  bool IsValidOffset(uint32_t id, uint32_t offset) const {
+    if (extras(offset).is_used) {
+      return false;
+    }
+    uint32_t relative_offset = id ^ offset;
+    if ((relative_offset & kLowerMask) && (relative_offset & kUpperMask)) {
+      return false;
+    }
+    for (size_t i = 1; i < labels_.size(); ++i) {
+      if (extras(offset ^ labels_[i]).is_fixed) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  // Takes the cell out of the list of free cells, growing the array if needed
+  void ReserveId(uint32_t id) {
+    if (id >= num_units()) {
+      ExpandUnits();
+    }
+
+    if (id == extras_head_) {
+      extras_head_ = extras(id).next;
+      if (extras_head_ == id) {
+        extras_head_ = num_units();
+      }
+    }
+    extras(extras(id).prev).next = extras(id).next;
+    extras(extras(id).next).prev = extras(id).prev;
+    extras(id).is_fixed = true;
+  }
+
+  // Appends one block and links its cells into the list of free cells
+  void ExpandUnits() {
+    uint32_t src_num_units = num_units();
+    uint32_t src_num_blocks = src_num_units / kBlockSize;
+    uint32_t dest_num_units = src_num_units + kBlockSize;
+    uint32_t dest_num_blocks = src_num_blocks + 1;
+
+    if (dest_num_blocks > kNumExtraBlocks) {
+      FixBlock(src_num_blocks - kNumExtraBlocks);
+    }
+
+    units_.resize(dest_num_units, 0);
+
+    if (dest_num_blocks > kNumExtraBlocks) {
+      for (uint32_t id = src_num_units; id < dest_num_units; ++id) {
+        extras(id).is_used = false;
+        extras(id).is_fixed = false;
+      }
+    }
+
+    for (uint32_t i = src_num_units + 1; i < dest_num_units; ++i) {
+      extras(i - 1).next = i;
+      extras(i).prev = i - 1;
+    }
+
+    extras(src_num_units).prev = dest_num_units - 1;
+    extras(dest_num_units - 1).next = src_num_units;
+
+    extras(src_num_units).prev = extras(extras_head_).prev;
+    extras(dest_num_units - 1).next = extras_head_;
+
+    extras(extras(extras_head_).prev).next = src_num_units;
+    extras(extras_head_).prev = dest_num_units - 1;
+  }
+
+  void FixAllBlocks() {
+    uint32_t num_blocks = num_units() / kBlockSize;
+    uint32_t begin = num_blocks > kNumExtraBlocks ? num_blocks - kNumExtraBlocks : 0;
+    for (uint32_t block_id = begin; block_id != num_blocks; ++block_id) {
+      FixBlock(block_id);
+    }
+  }
+
+  // Gives the unused cells of a block labels that no lookup can match
+  void FixBlock(uint32_t block_id) {
+    uint32_t begin = block_id * kBlockSize;
+    uint32_t end = begin + kBlockSize;
+
+    uint32_t unused_offset = 0;
+    for (uint32_t offset = begin; offset != end; ++offset) {
+      if (!extras(offset).is_used) {
+        unused_offset = offset;
+        break;
+      }
+    }
+
+    for (uint32_t id = begin; id != end; ++id) {
+      if (!extras(id).is_fixed) {
+        ReserveId(id);
+        SetLabel(&units_[id], static_cast<unsigned char>(id ^ unused_offset));
+      }
+    }
+  }
+
+  size_t num_keys_;
+  const char* const* keys_;
+  const size_t* lengths_;
+  const int* values_;
+  BuildMonitor* monitor_;
+
+  std::vector<Unit> units_;
+  std::vector<Extra> extras_;
+  std::vector<unsigned char> labels_;
+  uint32_t extras_head_ = 0;
+  size_t progress_ = 0;
+  const char* error_ = "";
+};
+
+}  // namespace
+
+bool BuildCompactArray(size_t num_keys, const char* const* keys, const size_t* lengths,
+                       const int* values, BuildMonitor* monitor,
+                       std::vector<CompactArray::Unit>* units, std::string* error) {
+  CompactBuilder builder(num_keys, keys, lengths, values, monitor);
+  return builder.Build(units, error);
+}
+
+}  // namespace node_darts
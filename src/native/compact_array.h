@@ -0,0 +1,200 @@
+#ifndef DARTS_COMPACT_ARRAY_H_
+#define DARTS_COMPACT_ARRAY_H_
+
+// Include standard library header files first
+#include <cstdint>
+#include <cstddef>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "storage.h"
+
+namespace node_darts {
+
+class BuildMonitor;
+
+// Double-Array with 4-byte units in the darts-clone layout, half the size of a Darts unit.
+// A node's children live at (node ^ offset ^ byte) and carry the byte as their label;
+// a node with a value has a leaf child at (node ^ offset) holding it. Keys cannot contain
+// NUL bytes, since the leaf takes the place of the child for byte 0.
+//
+// Unit bits: 0-7 label, 8 has-leaf, 9 offset is shifted by 8, 10-30 offset, 31 is a leaf.
+// A leaf unit holds a 31-bit value instead.
+class CompactArray {
+ public:
+  typedef uint32_t Unit;
+
+  void set_units(const Unit* units, size_t size) {
+    units_ = units;
+    size_ = size;
+  }
+  const Unit* units() const { return units_; }
+  size_t size() const { return size_; }
+  // Number of units in use; free units are all zero
+  size_t nonzero_size() const {
+    size_t result = 0;
+    for (size_t i = 0; i < size_; ++i) {
+      result += units_[i] != 0;
+    }
+    return result;
+  }
+
+  int exactMatchSearch(const char* key, size_t len) const {
+    size_t node_pos = 0;
+    Unit unit = units_[0];
+    for (size_t i = 0; i < len; ++i) {
+      unsigned char byte = static_cast<unsigned char>(key[i]);
+      node_pos ^= offset(unit) ^ byte;
+      unit = units_[node_pos];
+      if (label(unit) != byte) {
+        return -1;
+      }
+    }
+    if (!has_leaf(unit)) {
+      return -1;
+    }
+    return value(units_[node_pos ^ offset(unit)]);
+  }
+
+  // Same contract as Darts: fills up to result_len results and returns how many prefixes
+  // of the key are in the dictionary
+  template <class Result, class SetResult>
+  size_t commonPrefixSearch(const char* key, Result* result, size_t result_len, size_t len,
+                            SetResult set_result) const {
+    size_t node_pos = 0;
+    size_t num = 0;
+    Unit unit = units_[0];
+    for (size_t i = 0;; ++i) {
+      if (has_leaf(unit)) {
+        if (num < result_len) {
+          set_result(&result[num], value(units_[node_pos ^ offset(unit)]), i);
+        }
+        ++num;
+      }
+      if (i == len) {
+        break;
+      }
+      unsigned char byte = static_cast<unsigned char>(key[i]);
+      node_pos ^= offset(unit) ^ byte;
+      unit = units_[node_pos];
+      if (label(unit) != byte) {
+        break;
+      }
+    }
+    return num;
+  }
+
+  // Same contract as Darts: -2 if the path leaves the trie, -1 if it ends without a value
+  int traverse(const char* key, size_t& node_pos, size_t& key_pos, size_t len) const {
+    if (node_pos >= size_) {
+      return -2;
+    }
+    size_t id = node_pos;
+    Unit unit = units_[id];
+    for (; key_pos < len; ++key_pos) {
+      unsigned char byte = static_cast<unsigned char>(key[key_pos]);
+      id ^= offset(unit) ^ byte;
+      unit = units_[id];
+      if (label(unit) != byte) {
+        return -2;
+      }
+      node_pos = id;
+    }
+    if (!has_leaf(unit)) {
+      return -1;
+    }
+    return value(units_[id ^ offset(unit)]);
+  }
+
+  // Calls visit(byte, child_pos) for each child of the node, in byte order
+  template <class Visitor>
+  void forEachChild(size_t node_pos, Visitor visit) const {
+    size_t base = node_pos ^ offset(units_[node_pos]);
+    // Byte 0 is the leaf; children stay in the block of the base
+    for (size_t byte = 1; byte < 256; ++byte) {
+      size_t child_pos = base ^ byte;
+      if (label(units_[child_pos]) == byte) {
+        visit(static_cast<unsigned char>(byte), child_pos);
+      }
+    }
+  }
+
+  // Calls visit(value, key) in byte order for the keys below node_pos, whose key is the
+  // given prefix. Stops after limit keys (0 for no limit) and returns the number visited.
+  template <class Visitor>
+  size_t predictiveSearch(size_t node_pos, std::string key, size_t limit, Visitor visit) const {
+    // Label 0 stands for the leaf, so the key ending at a node comes before its children
+    struct Frame {
+      size_t node_pos;
+      size_t next_label;
+    };
+    std::vector<Frame> stack;
+    size_t num_results = 0;
+
+    stack.push_back({node_pos, 0});
+    while (!stack.empty()) {
+      Frame& frame = stack.back();
+      if (frame.next_label > 255) {
+        stack.pop_back();
+        if (!stack.empty()) {
+          key.pop_back();
+        }
+        continue;
+      }
+
+      size_t byte = frame.next_label++;
+      Unit unit = units_[frame.node_pos];
+      if (byte == 0) {
+        if (has_leaf(unit)) {
+          visit(value(units_[frame.node_pos ^ offset(unit)]), key);
+          if (++num_results == limit) {
+            break;
+          }
+        }
+        continue;
+      }
+
+      size_t child_pos = frame.node_pos ^ offset(unit) ^ byte;
+      if (label(units_[child_pos]) != byte) {
+        continue;
+      }
+      key.push_back(static_cast<char>(byte));
+      stack.push_back({child_pos, 0});
+    }
+    return num_results;
+  }
+
+ private:
+  static bool has_leaf(Unit unit) { return ((unit >> 8) & 1) == 1; }
+  static int value(Unit unit) { return static_cast<int>(unit & ((1U << 31) - 1)); }
+  // Keeps the leaf bit, so that a leaf never matches a byte
+  static Unit label(Unit unit) { return unit & ((1U << 31) | 0xFF); }
+  static size_t offset(Unit unit) { return (unit >> 10) << ((unit & (1U << 9)) >> 6); }
+
+  const Unit* units_ = nullptr;
+  size_t size_ = 0;
+};
+
+// Units built by BuildCompactArray, owned by the dictionary that reads them
+class CompactUnitStorage : public ArrayStorage {
+ public:
+  explicit CompactUnitStorage(std::vector<CompactArray::Unit> units) : units_(std::move(units)) {}
+
+  const void* data() const override { return units_.data(); }
+  size_t size() const override { return units_.size() * sizeof(CompactArray::Unit); }
+
+ private:
+  std::vector<CompactArray::Unit> units_;
+};
+
+// Builds compact units from keys that are unique and sorted in byte order.
+// Values must not be negative. A monitor, if given, receives progress and may cancel
+// the build. Returns false and sets error on failure.
+bool BuildCompactArray(size_t num_keys, const char* const* keys, const size_t* lengths,
+                       const int* values, BuildMonitor* monitor,
+                       std::vector<CompactArray::Unit>* units, std::string* error);
+
+}  // namespace node_darts
+
+#endif  // DARTS_COMPACT_ARRAY_H_
@@ -0,0 +1,197 @@
+#include "compressed_file.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstring>
+#include <limits>
+#include <thread>
+
+// zlib comes with the Node.js headers, and Node.js exports its symbols to addons
+#include <zlib.h>
+
+#include "file_format.h"
+
+namespace node_darts {
+
+namespace {
+
+const char kCompressedMagic[8] = {'D', 'A', 'R', 'T', 'S', 'Z', 'I', 'P'};
+
+// Chunk sizes must fit zlib's uLong, which has 32 bits on Windows
+const uint64_t kMaxChunkSize = static_cast<uint64_t>(1) << 30;
+
+size_t ThreadCount(size_t num_threads, size_t num_chunks) {
+  if (num_threads == 0) {
+    num_threads = std::thread::hardware_concurrency();
+  }
+  return std::max<size_t>(1, std::min(num_threads, num_chunks));
+}
+
+// Runs work(i) for each i in [0, count) on num_threads threads, the calling one included
+template <class Work>
+void RunParallel(size_t count, size_t num_threads, Work work) {
+  std::atomic<size_t> next(0);
+  auto run = [&next, count, &work]() {
+    for (size_t i = next++; i < count; i = next++) {
+      work(i);
+    }
+  };
+  std::vector<std::thread> threads;
+  for (size_t i = 1; i < num_threads; i++) {
+    threads.emplace_back(run);
+  }
+  run();
+  for (std::thread& thread : threads) {
+    thread.join();
+  }
+}
+
+// CRC-32 of the header fields before the checksum, then of the chunk table
+uint32_t Checksum(const CompressedHeader& header, const void* table) {
+  uint32_t crc = Crc32(&header, offsetof(CompressedHeader, checksum));
+  return Crc32(table, static_cast<size_t>(header.num_chunks) * sizeof(uint64_t), crc);
+}
+
+}  // namespace
+
+bool IsCompressedFile(const void* data, size_t size) {
+  return size >= sizeof(kCompressedMagic) &&
+         std::memcmp(data, kCompressedMagic, sizeof(kCompressedMagic)) == 0;
+}
+
+bool ParseCompressedFile(const void* data, size_t size, CompressedLayout* layout,
+                         std::string* error) {
+  CompressedHeader header;
+  if (!IsCompressedFile(data, size) || size < sizeof(header)) {
+    *error = "Invalid compressed dictionary file";
+    return false;
+  }
+  std::memcpy(&header, data, sizeof(header));
+  if (header.version != kCompressedVersion) {
+    *error = "Unsupported compressed dictionary file version " + std::to_string(header.version);
+    return false;
+  }
+  if (header.codec != kDeflateCodec) {
+    *error = "Unsupported compression codec " + std::to_string(header.codec);
+    return false;
+  }
+  if (header.header_size < sizeof(header) || header.header_size % 8 != 0 ||
+      header.header_size > size || header.chunk_size == 0 ||
+      header.chunk_size > kMaxChunkSize ||
+      header.raw_size > std::numeric_limits<size_t>::max()) {
+    *error = "Invalid compressed dictionary file header";
+    return false;
+  }
+
+  // The table of chunk sizes, then the chunks, must fit in the data
+  uint64_t expected_chunks =
+      header.raw_size == 0 ? 0 : (header.raw_size - 1) / header.chunk_size + 1;
+  size_t available = size - header.header_size;
+  if (header.num_chunks != expected_chunks ||
+      header.num_chunks > available / sizeof(uint64_t)) {
+    *error = "Compressed dictionary file size does not match its header";
+    return false;
+  }
+  const char* bytes = static_cast<const char*>(data);
+  size_t num_chunks = static_cast<size_t>(header.num_chunks);
+  size_t table_size = num_chunks * sizeof(uint64_t);
+  if (Checksum(header, bytes + header.header_size) != header.checksum) {
+    *error = "Compressed dictionary file checksum mismatch";
+    return false;
+  }
+
+  layout->raw_size = static_cast<size_t>(header.raw_size);
+  layout->chunk_size = static_cast<size_t>(header.chunk_size);
+  layout->offsets.assign(1, header.header_size + table_size);
+  for (size_t i = 0; i < num_chunks; i++) {
+    uint64_t chunk_size;
+    std::memcpy(&chunk_size, bytes + header.header_size + i * sizeof(uint64_t),
+                sizeof(chunk_size));
+    size_t offset = layout->offsets.back();
+    if (chunk_size > size - offset) {
+      *error = "Compressed dictionary file size does not match its header";
+      return false;
+    }
+    layout->offsets.push_back(offset + static_cast<size_t>(chunk_size));
+  }
+  return true;
+}
+
+bool InflateCompressedFile(const void* data, const CompressedLayout& layout, void* out,
+                           size_t num_threads, std::string* error) {
+  const Bytef* bytes = static_cast<const Bytef*>(data);
+  size_t num_chunks = layout.offsets.size() - 1;
+  std::atomic<bool> failed(false);
+  RunParallel(num_chunks, ThreadCount(num_threads, num_chunks), [&](size_t i) {
+    if (failed) {
+      return;
+    }
+    size_t raw_offset = i * layout.chunk_size;
+    size_t raw_size = std::min(layout.chunk_size, layout.raw_size - raw_offset);
+    uLongf length = static_cast<uLongf>(raw_size);
+    int result = uncompress(static_cast<Bytef*>(out) + raw_offset, &length,
+                            bytes + layout.offsets[i],
+                            static_cast<uLong>(layout.offsets[i + 1] - layout.offsets[i]));
+    if (result != Z_OK || length != raw_size) {
+      failed = true;
+    }
+  });
+  if (failed) {
+    *error = "Compressed dictionary file is damaged";
+    return false;
+  }
+  return true;
+}
+
+bool CompressDictionaryFile(const void* data, size_t size, int level, std::vector<char>* out,
+                            std::string* error) {
+  const Bytef* bytes = static_cast<const Bytef*>(data);
+  size_t num_chunks = size == 0 ? 0 : (size - 1) / kCompressedChunkSize + 1;
+
+  std::vector<std::vector<Bytef>> chunks(num_chunks);
+  std::vector<uint64_t> sizes(num_chunks);
+  std::atomic<bool> failed(false);
+  RunParallel(num_chunks, ThreadCount(0, num_chunks), [&](size_t i) {
+    size_t offset = i * kCompressedChunkSize;
+    uLong raw_size = static_cast<uLong>(std::min(kCompressedChunkSize, size - offset));
+    chunks[i].resize(compressBound(raw_size));
+    uLongf length = static_cast<uLongf>(chunks[i].size());
+    if (compress2(chunks[i].data(), &length, bytes + offset, raw_size, level) != Z_OK) {
+      failed = true;
+    }
+    sizes[i] = length;
+  });
+  if (failed) {
+    *error = "Failed to compress dictionary";
+    return false;
+  }
+
+  CompressedHeader header;
+  std::memset(&header, 0, sizeof(header));
+  std::memcpy(header.magic, kCompressedMagic, sizeof(kCompressedMagic));
+  header.version = kCompressedVersion;
+  header.codec = kDeflateCodec;
+  header.raw_size = size;
+  header.chunk_size = kCompressedChunkSize;
+  header.num_chunks = num_chunks;
+  header.checksum = Checksum(header, sizes.data());
+  header.header_size = sizeof(header);
+
+  size_t total = sizeof(header) + num_chunks * sizeof(uint64_t);
+  for (uint64_t chunk_size : sizes) {
+    total += static_cast<size_t>(chunk_size);
+  }
+  out->clear();
+  out->reserve(total);
+  const char* header_bytes = reinterpret_cast<const char*>(&header);
+  out->insert(out->end(), header_bytes, header_bytes + sizeof(header));
+  const char* table_bytes = reinterpret_cast<const char*>(sizes.data());
+  out->insert(out->end(), table_bytes, table_bytes + num_chunks * sizeof(uint64_t));
+  for (size_t i = 0; i < num_chunks; i++) {
+    out->insert(out->end(), chunks[i].begin(), chunks[i].begin() + sizes[i]);
+  }
+  return true;
+}
+
+}  // namespace node_darts
@@ -0,0 +1,67 @@
+#ifndef DARTS_COMPRESSED_FILE_H_
+#define DARTS_COMPRESSED_FILE_H_
+
+// Include standard library header files first
+#include <cstdint>
+#include <cstddef>
+#include <string>
+#include <vector>
+
+namespace node_darts {
+
+// Header of a compressed dictionary file.
+// The file holds a whole dictionary file (FileHeader, units and sections) cut into chunks
+// of chunk_size bytes, each compressed on its own as a zlib stream, so that chunks can be
+// inflated in parallel straight into the memory the dictionary is read from. The zlib
+// streams check their own bytes, and the inner file keeps its checksum of the units.
+// A table of compressed chunk sizes (uint64) follows the header, then the chunks.
+// Fields are stored in the byte order of the machine, like the units themselves.
+struct CompressedHeader {
+  char magic[8];
+  uint32_t version;
+  // Always kDeflateCodec for now
+  uint32_t codec;
+  // Size of the dictionary file inside
+  uint64_t raw_size;
+  uint64_t chunk_size;
+  uint64_t num_chunks;
+  // CRC-32 of the fields above and of the chunk table
+  uint32_t checksum;
+  uint32_t header_size;
+};
+
+const uint32_t kCompressedVersion = 1;
+const uint32_t kDeflateCodec = 1;
+// Bytes of the inner file per chunk: large enough for a good ratio, small enough that a
+// large dictionary keeps every core busy
+const size_t kCompressedChunkSize = static_cast<size_t>(4) << 20;
+
+// Where the chunks of a compressed dictionary file are
+struct CompressedLayout {
+  size_t raw_size = 0;
+  size_t chunk_size = 0;
+  // Offset of each chunk in the file, followed by the end of the last one
+  std::vector<size_t> offsets;
+};
+
+// Whether the data starts like a compressed dictionary file
+bool IsCompressedFile(const void* data, size_t size);
+
+// Reads the header and chunk table of a compressed dictionary file, checking them against
+// the data size. Returns false and sets error if the data is not a valid compressed file.
+bool ParseCompressedFile(const void* data, size_t size, CompressedLayout* layout,
+                         std::string* error);
+
+// Inflates the chunks into out, which must hold layout.raw_size bytes, on up to
+// num_threads threads (0 for one per core). Returns false and sets error on failure.
+bool InflateCompressedFile(const void* data, const CompressedLayout& layout, void* out,
+                           size_t num_threads, std::string* error);
+
+// Compresses size bytes of an uncompressed dictionary file into a compressed dictionary
+// file in out, at zlib level (1-9) on every core. Returns false and sets error on failure.
+bool CompressDictionaryFile(const void* data, size_t size, int level, std::vector<char>* out,
+                            std::string* error);
+
+}  // namespace node_darts
+
+#endif  // DARTS_COMPRESSED_FILE_H_
@@ -0,0 +1,128 @@
+#include "cursor.h"
+#include <string>
+#include <utility>
+
+namespace node_darts {
+
+void TraverseCursor::Init(Napi::Env env) {
+  Napi::Function func = DefineClass(env, "TraverseCursor", {
+    InstanceMethod("advance", &TraverseCursor::Advance),
+    InstanceMethod("reset", &TraverseCursor::Reset),
+    InstanceMethod("clone", &TraverseCursor::Clone),
+    InstanceAccessor("status", &TraverseCursor::GetStatus, nullptr),
+    InstanceAccessor("nodePos", &TraverseCursor::GetNodePos, nullptr),
+    InstanceAccessor("keyPos", &TraverseCursor::GetKeyPos, nullptr),
+  });
+  
+  // The constructor is not exported; cursors are only created through createCursor and clone
+  GetAddonData(env)->cursor_constructor = Napi::Persistent(func);
+}
+
+Napi::Value TraverseCursor::New(Napi::Env env, std::shared_ptr<DartsDict> dict) {
+  Napi::Object obj = GetAddonData(env)->cursor_constructor.New({});
+  TraverseCursor* cursor = Unwrap(obj);
+  cursor->dict_ = std::move(dict);
+  return obj;
+}
+
+TraverseCursor::TraverseCursor(const Napi::CallbackInfo& info)
+    : Napi::ObjectWrap<TraverseCursor>(info) {}
+
+Napi::Value TraverseCursor::Advance(const Napi::CallbackInfo& info) {
+  Napi::Env env = info.Env();
+  
+  try {
+    std::string key;
+    if (info.Length() >= 1 && info[0].IsString()) {
+      key = info[0].As<Napi::String>().Utf8Value();
+    } else if (info.Length() >= 1 && info[0].IsTypedArray() &&
+               info[0].As<Napi::TypedArray>().TypedArrayType() == napi_uint8_array) {
+      Napi::Uint8Array bytes = info[0].As<Napi::Uint8Array>();
+      key.assign(reinterpret_cast<const char*>(bytes.Data()), bytes.ElementLength());
+    } else {
+      Napi::TypeError::New(env, "Argument: (key: string | Uint8Array) expected").ThrowAsJavaScriptException();
+      return env.Null();
+    }
+    
+    // A failed cursor stays failed until it is reset; an empty key leaves it where it is
+    if (status_ == -2 || key.empty()) {
+      return Napi::Number::New(env, status_);
+    }
+    
+    if (!dict_ || dict_->size() == 0) {
+      status_ = -2;
+      return Napi::Number::New(env, status_);
+    }
+    
+    // Darts resumes from node_pos_ and consumes the whole fragment
+    LookupTimer timer(dict_->lookup_stats(), LookupKind::kTraverse);
+    size_t pos = 0;
+    status_ = dict_->traverse(key.c_str(), node_pos_, pos, key.length());
+    key_pos_ += pos;
+    
+    return Napi::Number::New(env, status_);
+  } catch (const std::exception& e) {
+    Napi::Error::New(env, e.what()).ThrowAsJavaScriptException();
+    return env.Null();
+  }
+}
+
+Napi::Value TraverseCursor::Reset(const Napi::CallbackInfo& info) {
+  node_pos_ = 0;
+  key_pos_ = 0;
+  status_ = -1;
+  return info.Env().Undefined();
+}
+
+Napi::Value TraverseCursor::Clone(const Napi::CallbackInfo& info) {
+  Napi::Env env = info.Env();
+  
+  try {
+    Napi::Value copy = New(env, dict_);
+    TraverseCursor* cursor = Unwrap(copy.As<Napi::Object>());
+    cursor->node_pos_ = node_pos_;
+    cursor->key_pos_ = key_pos_;
+    cursor->status_ = status_;
+    return copy;
+  } catch (const std::exception& e) {
+    Napi::Error::New(env, e.what()).ThrowAsJavaScriptException();
+    return env.Null();
+  }
+}
+
+Napi::Value TraverseCursor::GetStatus(const Napi::CallbackInfo& info) {
+  return Napi::Number::New(info.Env(), status_);
+}
+
+Napi::Value TraverseCursor::GetNodePos(const Napi::CallbackInfo& info) {
+  return Napi::Number::New(info.Env(), static_cast<double>(node_pos_));
+}
+
+Napi::Value TraverseCursor::GetKeyPos(const Napi::CallbackInfo& info) {
+  return Napi::Number::New(info.Env(), static_cast<double>(key_pos_));
+}
+
+Napi::Value CreateCursor(const Napi::CallbackInfo& info) {
+  Napi::Env env = info.Env();
+  
+  try {
+    if (info.Length() < 1 || !info[0].IsNumber()) {
+      Napi::TypeError::New(env, "Number expected").ThrowAsJavaScriptException();
+      return env.Null();
+    }
+    
+    uint32_t handle = info[0].As<Napi::Number>().Uint32Value();
+    std::shared_ptr<DartsDict> dict = GetSharedDictionary(env, handle);
+    if (!dict) {
+      Napi::Error::New(env, "Invalid dictionary handle").ThrowAsJavaScriptException();
+      return env.Null();
+    }
+    
+    return TraverseCursor::New(env, std::move(dict));
+  } catch (const std::exception& e) {
+    Napi::Error::New(env, e.what()).ThrowAsJavaScriptException();
+    return env.Null();
+  }
+}
+
+}  // namespace node_darts
@@ -0,0 +1,43 @@
+#ifndef DARTS_CURSOR_H_
+#define DARTS_CURSOR_H_
+
+// Include standard library header files first
+#include <cstdint>
+#include <cstddef>
+#include <memory>
+
+#include <napi.h>
+#include "common.h"
+
+namespace node_darts {
+
+// Resumable trie traversal state.
+// Each advance() continues from the node reached by the previous call, so keys can be
+// fed one fragment (e.g. one keystroke) at a time without re-walking the prefix.
+class TraverseCursor : public Napi::ObjectWrap<TraverseCursor> {
+ public:
+  static void Init(Napi::Env env);
+  static Napi::Value New(Napi::Env env, std::shared_ptr<DartsDict> dict);
+
+  explicit TraverseCursor(const Napi::CallbackInfo& info);
+
+ private:
+  Napi::Value Advance(const Napi::CallbackInfo& info);
+  Napi::Value Reset(const Napi::CallbackInfo& info);
+  Napi::Value Clone(const Napi::CallbackInfo& info);
+  Napi::Value GetStatus(const Napi::CallbackInfo& info);
+  Napi::Value GetNodePos(const Napi::CallbackInfo& info);
+  Napi::Value GetKeyPos(const Napi::CallbackInfo& info);
+
+  // Keeps the traversed array alive even if its handle is destroyed or reloaded
+  std::shared_ptr<DartsDict> dict_;
+  size_t node_pos_ = 0;
+  size_t key_pos_ = 0;
+  int status_ = -1;
+};
+
+Napi::Value CreateCursor(const Napi::CallbackInfo& info);
+
+}  // namespace node_darts
+
+#endif  // DARTS_CURSOR_H_
@@ -0,0 +1,140 @@
+#include "delta_layer.h"
+
+#include <algorithm>
+#include <climits>
+#include <utility>
+
+#include "key_arena.h"
+
+namespace node_darts {
+
+LayeredDict::LayeredDict(std::shared_ptr<DartsDict> base)
+    : base_(std::move(base)), live_(std::make_shared<DeltaLayer>()) {}
+
+int LayeredDict::ExactMatch(std::string_view key) const {
+  int value = live_->Find(key);
+  if (value == DeltaLayer::kUnchanged && frozen_) {
+    value = frozen_->Find(key);
+  }
+  if (value != DeltaLayer::kUnchanged) {
+    return value;
+  }
+
+  if (base_->size() == 0) {
+    return -1;
+  }
+  // Darts treats a zero length as "use strlen"
+  return base_->exactMatchSearch<int>(key.empty() ? "" : key.data(), key.length());
+}
+
+void LayeredDict::CommonPrefix(std::string_view key,
+                               std::vector<std::pair<int, size_t>>* matches) const {
+  // (length, value) by length; each layer overrides the older ones
+  std::vector<std::pair<size_t, int>> resolved;
+  auto apply = [&resolved](size_t length, int value) {
+    auto it = std::lower_bound(resolved.begin(), resolved.end(), std::make_pair(length, INT_MIN));
+    if (it != resolved.end() && it->first == length) {
+      it->second = value;
+    } else {
+      resolved.insert(it, std::make_pair(length, value));
+    }
+  };
+
+  if (base_->size() > 0) {
+    std::vector<DartsDict::result_pair_type> results(16);
+    const char* data = key.empty() ? "" : key.data();
+    size_t num_results =
+        base_->commonPrefixSearch(data, results.data(), results.size(), key.length());
+    if (num_results > results.size()) {
+      results.resize(num_results);
+      num_results = base_->commonPrefixSearch(data, results.data(), results.size(), key.length());
+    }
+    for (size_t i = 0; i < num_results; i++) {
+      apply(results[i].length, results[i].value);
+    }
+  }
+  if (frozen_) {
+    frozen_->VisitPrefixes(key, apply);
+  }
+  live_->VisitPrefixes(key, apply);
+
+  matches->clear();
+  for (const auto& match : resolved) {
+    if (match.second >= 0) {
+      matches->push_back(std::make_pair(match.second, match.first));
+    }
+  }
+}
+
+void LayeredDict::Predictive(std::string_view prefix, size_t limit,
+                             std::vector<std::pair<std::string, int>>* matches) const {
+  // Value of each key found, from the newest layer that mentions it
+  std::map<std::string, int, std::less<>> found;
+  auto add = [&found](const std::string& key, int value) { found.emplace(key, value); };
+  live_->VisitPredictive(prefix, add);
+  if (frozen_) {
+    frozen_->VisitPredictive(prefix, add);
+  }
+
+  // The changes hide at most as many base keys as there are changes, so the first
+  // limit + pending base keys hold every base key among the first limit results
+  size_t base_limit = limit == 0 ? 0 : limit + pending();
+  const char* data = prefix.empty() ? "" : prefix.data();
+  base_->predictiveSearch(data, prefix.length(), base_limit,
+                          [&add](int value, const std::string& key) { add(key, value); });
+
+  matches->clear();
+  for (const auto& entry : found) {
+    if (limit != 0 && matches->size() == limit) {
+      break;
+    }
+    if (entry.second >= 0) {
+      matches->push_back(entry);
+    }
+  }
+}
+
+std::shared_ptr<const DeltaLayer> LayeredDict::BeginCompaction() {
+  frozen_ = std::move(live_);
+  live_ = std::make_shared<DeltaLayer>();
+  return frozen_;
+}
+
+void LayeredDict::FinishCompaction(std::shared_ptr<DartsDict> merged) {
+  base_ = std::move(merged);
+  frozen_.reset();
+}
+
+void LayeredDict::AbortCompaction() {
+  if (frozen_) {
+    live_->MergeOlder(*frozen_);
+    frozen_.reset();
+  }
+}
+
+std::unique_ptr<DartsDict> LayeredDict::Merge(const DartsDict& base, const DeltaLayer& delta,
+                                              BuildMonitor* monitor, std::string* error) {
+  KeyArena arena;
+  base.predictiveSearch("", 0, 0, [&arena, &delta](int value, const std::string& key) {
+    if (delta.Find(key) == DeltaLayer::kUnchanged) {
+      arena.Add(key.data(), key.length(), value);
+    }
+  });
+  delta.VisitPredictive("", [&arena](const std::string& key, int value) {
+    if (value >= 0) {
+      arena.Add(key.data(), key.length(), value);
+    }
+  });
+  if (arena.size() == 0) {
+    // Every key was removed
+    return std::unique_ptr<DartsDict>(new DartsDict());
+  }
+
+  ArrayBuildOptions options;
+  options.format = base.format();
+  options.key_index = base.key_index() != nullptr;
+  options.scan_table = base.scan_table_bytes() > 0;
+  return arena.Build(error, monitor, options);
+}
+
+}  // namespace node_darts
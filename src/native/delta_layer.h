@@ -0,0 +1,121 @@
+#ifndef DARTS_DELTA_LAYER_H_
+#define DARTS_DELTA_LAYER_H_
+
+// Include standard library header files first
+#include <cstdint>
+#include <cstddef>
+#include <functional>
+#include <map>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "array_builder.h"
+#include "common.h"
+
+namespace node_darts {
+
+// Changes made on top of a dictionary: keys added or given a new value, and keys removed
+// (tombstones). Kept in byte order, so that lookups can read exact, prefix and predictive
+// matches straight from the ordered map; a delta is meant to stay small until it is merged.
+class DeltaLayer {
+ public:
+  // What Find returns for a removed key, and for a key the layer does not mention
+  static const int kRemoved = -1;
+  static const int kUnchanged = -2;
+
+  // value must not be negative
+  void Set(std::string key, int value) { changes_[std::move(key)] = value; }
+  void Remove(std::string key) { changes_[std::move(key)] = kRemoved; }
+
+  size_t size() const { return changes_.size(); }
+  bool empty() const { return changes_.empty(); }
+
+  // The key's value, kRemoved or kUnchanged
+  int Find(std::string_view key) const {
+    auto it = changes_.find(key);
+    return it == changes_.end() ? kUnchanged : it->second;
+  }
+
+  // Calls visit(length, value) for each change whose key is a prefix of the key, shortest
+  // first; value is kRemoved for a removal
+  template <class Visitor>
+  void VisitPrefixes(std::string_view key, Visitor visit) const {
+    for (size_t length = 0; length <= key.length(); length++) {
+      auto it = changes_.find(key.substr(0, length));
+      if (it != changes_.end()) {
+        visit(length, it->second);
+      }
+    }
+  }
+
+  // Calls visit(key, value) for each change whose key starts with the prefix, in byte order
+  template <class Visitor>
+  void VisitPredictive(std::string_view prefix, Visitor visit) const {
+    for (auto it = changes_.lower_bound(prefix);
+         it != changes_.end() && std::string_view(it->first).substr(0, prefix.length()) == prefix;
+         ++it) {
+      visit(it->first, it->second);
+    }
+  }
+
+  // Adds the changes of an older layer that this one does not override
+  void MergeOlder(const DeltaLayer& older) {
+    changes_.insert(older.changes_.begin(), older.changes_.end());
+  }
+
+ private:
+  // Transparent, so that lookups need no std::string; std::string orders by unsigned bytes
+  std::map<std::string, int, std::less<>> changes_;
+};
+
+// A dictionary read through its pending changes: an immutable base and up to two delta
+// layers, the live one taking updates and, while the two are being merged into a new base,
+// a frozen one. The newest layer mentioning a key decides its value.
+// Only the JS thread updates the layers; a merge reads the base and the frozen layer,
+// which do not change until it finishes.
+class LayeredDict {
+ public:
+  explicit LayeredDict(std::shared_ptr<DartsDict> base);
+
+  std::shared_ptr<DartsDict> base() const { return base_; }
+  // Number of changes not merged into the base yet
+  size_t pending() const { return live_->size() + (frozen_ ? frozen_->size() : 0); }
+  bool compacting() const { return frozen_ != nullptr; }
+
+  void Set(std::string key, int value) { live_->Set(std::move(key), value); }
+  void Remove(std::string key) { live_->Remove(std::move(key)); }
+
+  // Value of the key, or -1
+  int ExactMatch(std::string_view key) const;
+  // (value, length in bytes) of each key that is a prefix of the key, shortest first
+  void CommonPrefix(std::string_view key, std::vector<std::pair<int, size_t>>* matches) const;
+  // (key, value) of the keys starting with the prefix in byte order, at most limit of them
+  // (0 for no limit)
+  void Predictive(std::string_view prefix, size_t limit,
+                  std::vector<std::pair<std::string, int>>* matches) const;
+
+  // Freezes the live layer for a merge and starts a new one on top of it
+  std::shared_ptr<const DeltaLayer> BeginCompaction();
+  // Replaces the base and drops the frozen layer it was merged from
+  void FinishCompaction(std::shared_ptr<DartsDict> merged);
+  // Puts the frozen changes back under the live ones after a failed merge
+  void AbortCompaction();
+
+  // Builds a new base from the base and a layer; runs on a background thread.
+  // The result keeps the base's unit format, key index and scan table.
+  // Returns nullptr and sets error on failure.
+  static std::unique_ptr<DartsDict> Merge(const DartsDict& base, const DeltaLayer& delta,
+                                          BuildMonitor* monitor, std::string* error);
+
+ private:
+  std::shared_ptr<DartsDict> base_;
+  std::shared_ptr<DeltaLayer> live_;
+  std::shared_ptr<const DeltaLayer> frozen_;
+};
+
+}  // namespace node_darts
+
+#endif  // DARTS_DELTA_LAYER_H_
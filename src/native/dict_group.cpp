@@ -0,0 +1,104 @@
+#include "dict_group.h"
+
+#include <algorithm>
+
+#include "utf16_search.h"
+
+namespace node_darts {
+
+void DictGroup::ExactMatch(std::string_view key, std::vector<int32_t>* out) const {
+  for (size_t i = 0; i < members_.size(); i++) {
+    const DartsDict& dict = *members_[i];
+    if (dict.size() == 0) {
+      continue;
+    }
+    // Darts treats a zero length as "use strlen"
+    int value = dict.exactMatchSearch<int>(key.empty() ? "" : key.data(), key.length());
+    if (value >= 0) {
+      out->push_back(static_cast<int32_t>(i));
+      out->push_back(value);
+      if (!keep_duplicates_) {
+        return;
+      }
+    }
+  }
+}
+
+size_t DictGroup::PrefixMatches(const char16_t* text, size_t length,
+                                std::vector<GroupMatch>* matches) const {
+  matches->clear();
+  for (size_t i = 0; i < members_.size(); i++) {
+    if (members_[i]->size() == 0) {
+      continue;
+    }
+    int32_t source = static_cast<int32_t>(i);
+    CommonPrefixSearchUtf16(*members_[i], text, length,
+                            [matches, source](int value, size_t units) {
+                              matches->push_back(GroupMatch{source, value, units});
+                            });
+  }
+
+  // Each member's matches are shortest first; a stable sort keeps the members in priority
+  // order among matches of the same length
+  std::stable_sort(matches->begin(), matches->end(),
+                   [](const GroupMatch& a, const GroupMatch& b) { return a.length < b.length; });
+  if (!keep_duplicates_) {
+    matches->erase(std::unique(matches->begin(), matches->end(),
+                               [](const GroupMatch& a, const GroupMatch& b) {
+                                 return a.length == b.length;
+                               }),
+                   matches->end());
+  }
+  return matches->size();
+}
+
+void DictGroup::Tokenize(const char16_t* text, size_t length, TokenizeMode mode,
+                         std::vector<int32_t>* tokens) const {
+  std::vector<GroupMatch> prefixes;
+  auto emit = [tokens](size_t start, size_t units, int32_t value, int32_t source) {
+    tokens->push_back(static_cast<int32_t>(start));
+    tokens->push_back(static_cast<int32_t>(units));
+    tokens->push_back(value);
+    tokens->push_back(source);
+  };
+
+  size_t pos = 0;
+  while (pos < length) {
+    size_t step = CodePointUnits(text, length, pos);
+
+    // Matches are ordered by length, and an empty key never counts as a match
+    size_t num_prefixes = PrefixMatches(text + pos, length - pos, &prefixes);
+    size_t first = 0;
+    while (first < num_prefixes && prefixes[first].length == 0) {
+      first++;
+    }
+
+    if (mode == TokenizeMode::kLongest) {
+      if (num_prefixes > first) {
+        size_t longest = prefixes[num_prefixes - 1].length;
+        size_t i = num_prefixes - 1;
+        while (i > first && prefixes[i - 1].length == longest) {
+          i--;
+        }
+        for (; i < num_prefixes; i++) {
+          emit(pos, longest, prefixes[i].value, prefixes[i].source);
+        }
+        pos += longest;
+      } else {
+        emit(pos, step, -1, -1);
+        pos += step;
+      }
+      continue;
+    }
+
+    for (size_t i = first; i < num_prefixes; i++) {
+      emit(pos, prefixes[i].length, prefixes[i].value, prefixes[i].source);
+    }
+    if (mode == TokenizeMode::kLattice && num_prefixes == first) {
+      emit(pos, step, -1, -1);
+    }
+    pos += step;
+  }
+}
+
+}  // namespace node_darts
@@ -0,0 +1,56 @@
+#ifndef DARTS_DICT_GROUP_H_
+#define DARTS_DICT_GROUP_H_
+
+// Include standard library header files first
+#include <cstdint>
+#include <cstddef>
+#include <memory>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "common.h"
+
+namespace node_darts {
+
+// A key found in every member of a group at once, tagged with the member it comes from
+struct GroupMatch {
+  int32_t source;
+  int32_t value;
+  // In UTF-16 code units
+  size_t length;
+};
+
+// Several dictionaries searched as one, e.g. a system, a domain and a user dictionary.
+// Members are in priority order: where two of them hold the same key, the first one wins,
+// unless duplicates are kept, in which case every member's match is reported in that order.
+// The members are held as they were when the group was made, so a handle swapped or
+// destroyed afterwards does not change the group.
+class DictGroup {
+ public:
+  DictGroup(std::vector<std::shared_ptr<DartsDict>> members, bool keep_duplicates)
+      : members_(std::move(members)), keep_duplicates_(keep_duplicates) {}
+
+  size_t size() const { return members_.size(); }
+
+  // Appends (source, value) pairs for the members holding the key
+  void ExactMatch(std::string_view key, std::vector<int32_t>* out) const;
+  // Collects the keys of every member that are prefixes of the text, shortest first and
+  // then by priority, including an empty key. Returns the number of matches.
+  size_t PrefixMatches(const char16_t* text, size_t length,
+                       std::vector<GroupMatch>* matches) const;
+  // Splits the text into (start, length, value, source) quadruples appended to tokens, as
+  // Tokenize does for one dictionary. Unknown code points have value and source -1.
+  // In longest mode, a match that is as long as the longest one from another member is
+  // only reported alongside it when duplicates are kept.
+  void Tokenize(const char16_t* text, size_t length, TokenizeMode mode,
+                std::vector<int32_t>* tokens) const;
+
+ private:
+  std::vector<std::shared_ptr<DartsDict>> members_;
+  bool keep_duplicates_;
+};
+
+}  // namespace node_darts
+
+#endif  // DARTS_DICT_GROUP_H_
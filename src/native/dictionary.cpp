@@ -1,158 +1,1837 @@
 #include "dictionary.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
 #include <fstream>
+#include <iterator>
+#include <map>
+#include <memory>
+#include <mutex>
 #include <stdexcept>
+#include <utility>
+#include "compressed_file.h"
+#include "utf16_search.h"
 
 namespace node_darts {
 
+namespace {
+
+// A key found in a text, with its position and length in the text's units
+struct TextMatch {
+  size_t begin;
+  size_t length;
+  int value;
+};
+
+// A key that is a prefix of a text, with its length in the text's units
+struct PrefixMatch {
+  int value;
+  size_t length;
+};
+
+// Returns true if the byte starts a UTF-8 code point
+inline bool IsUtf8LeadByte(unsigned char c) {
+  return (c & 0xC0) != 0x80;
+}
+
+// Exact match over an explicit byte range.
+// Darts treats a zero length as "use strlen", so empty keys get a terminated string.
+inline int ExactMatch(const DartsDict* dict, const char* key, size_t len) {
+  if (dict->size() == 0) {
+    return -1;
+  }
+  if (len == 0) {
+    key = "";
+  }
+  return dict->exactMatchSearch<int>(key, len);
+}
+
+// Returns true if the value is a typed array of the given element type
+bool IsTypedArrayOf(const Napi::Value& value, napi_typedarray_type type) {
+  return value.IsTypedArray() && value.As<Napi::TypedArray>().TypedArrayType() == type;
+}
+
+// Returns true if the value can be passed as a key: a string or UTF-8 bytes
+bool IsKey(const Napi::Value& value) {
+  return value.IsString() || IsTypedArrayOf(value, napi_uint8_array);
+}
+
+// Bytes of a key argument
+struct KeyBytes {
+  const char* data = nullptr;
+  size_t length = 0;
+};
+
+// A text to search: the UTF-16 code units of a string, or the UTF-8 bytes of a Uint8Array.
+// Positions and lengths in either are counted in the text's own units, so offsets into a
+// string index the JS string directly.
+struct SearchText {
+  const char16_t* units = nullptr;
+  const char* bytes = nullptr;
+  size_t length = 0;
+};
+
+// Returns true if (offset, length) arguments are present at info[slice_index]
+bool HasSlice(const Napi::CallbackInfo& info, size_t slice_index) {
+  return (info.Length() > slice_index && !info[slice_index].IsUndefined()) ||
+         (info.Length() > slice_index + 1 && !info[slice_index + 1].IsUndefined());
+}
+
+// Reads the Uint8Array (or Buffer) at info[index] in place, sliced by optional
+// (offset, length) arguments at info[slice_index].
+// Throws a JS exception and returns false if the slice is invalid.
+bool ReadByteSlice(const Napi::CallbackInfo& info, size_t index, size_t slice_index,
+                   const char** data, size_t* length) {
+  Napi::Env env = info.Env();
+  bool has_offset = info.Length() > slice_index && !info[slice_index].IsUndefined();
+  bool has_length = info.Length() > slice_index + 1 && !info[slice_index + 1].IsUndefined();
+  
+  Napi::Uint8Array bytes = info[index].As<Napi::Uint8Array>();
+  size_t size = bytes.ElementLength();
+  size_t offset = 0;
+  *length = size;
+  if ((has_offset && !info[slice_index].IsNumber()) ||
+      (has_length && !info[slice_index + 1].IsNumber())) {
+    Napi::TypeError::New(env, "Offset and length must be numbers").ThrowAsJavaScriptException();
+    return false;
+  }
+  if (has_offset) {
+    double value = info[slice_index].As<Napi::Number>().DoubleValue();
+    if (!(value >= 0 && value <= static_cast<double>(size))) {
+      Napi::RangeError::New(env, "Key offset is out of bounds").ThrowAsJavaScriptException();
+      return false;
+    }
+    offset = static_cast<size_t>(value);
+    *length = size - offset;
+  }
+  if (has_length) {
+    double value = info[slice_index + 1].As<Napi::Number>().DoubleValue();
+    if (!(value >= 0 && value <= static_cast<double>(size - offset))) {
+      Napi::RangeError::New(env, "Key length is out of bounds").ThrowAsJavaScriptException();
+      return false;
+    }
+    *length = static_cast<size_t>(value);
+  }
+  *data = reinterpret_cast<const char*>(bytes.Data()) + offset;
+  return true;
+}
+
+// Reads the key at info[index], which must satisfy IsKey. A Uint8Array (or Buffer) is read
+// in place, sliced by optional (offset, length) arguments at info[slice_index]; a string
+// is encoded into a buffer reused by the calling thread, so a lookup allocates nothing.
+// The bytes stay valid until the next key is read on the same thread.
+// Throws a JS exception and returns false if the slice is invalid.
+bool ReadKey(const Napi::CallbackInfo& info, size_t index, size_t slice_index, KeyBytes* key) {
+  Napi::Env env = info.Env();
+  
+  if (info[index].IsString()) {
+    if (HasSlice(info, slice_index)) {
+      Napi::TypeError::New(env, "Offset and length require a Uint8Array key").ThrowAsJavaScriptException();
+      return false;
+    }
+    thread_local std::vector<char> buffer(64);
+    size_t length = 0;
+    napi_get_value_string_utf8(env, info[index], nullptr, 0, &length);
+    if (length + 1 > buffer.size()) {
+      buffer.resize(length + 1);
+    }
+    napi_get_value_string_utf8(env, info[index], buffer.data(), buffer.size(), &length);
+    key->data = buffer.data();
+    key->length = length;
+    return true;
+  }
+  
+  return ReadByteSlice(info, index, slice_index, &key->data, &key->length);
+}
+
+// Reads the text at info[index], which must satisfy IsKey, like ReadKey. A string is read
+// as UTF-16 into a buffer reused by the calling thread rather than encoded to UTF-8, so
+// that the search can report positions in code units without counting them afterwards.
+bool ReadText(const Napi::CallbackInfo& info, size_t index, size_t slice_index, SearchText* text) {
+  Napi::Env env = info.Env();
+  
+  if (info[index].IsString()) {
+    if (HasSlice(info, slice_index)) {
+      Napi::TypeError::New(env, "Offset and length require a Uint8Array key").ThrowAsJavaScriptException();
+      return false;
+    }
+    thread_local std::vector<char16_t> buffer(64);
+    size_t length = 0;
+    napi_get_value_string_utf16(env, info[index], nullptr, 0, &length);
+    if (length + 1 > buffer.size()) {
+      buffer.resize(length + 1);
+    }
+    napi_get_value_string_utf16(env, info[index], buffer.data(), buffer.size(), &length);
+    text->units = buffer.data();
+    text->bytes = nullptr;
+    text->length = length;
+    return true;
+  }
+  
+  text->units = nullptr;
+  return ReadByteSlice(info, index, slice_index, &text->bytes, &text->length);
+}
+
+// Gets the caller-supplied Int32Array for results, or allocates one when it is omitted.
+// Throws a JS exception and returns false if the supplied array is unusable.
+bool GetResultArray(const Napi::CallbackInfo& info, size_t index, size_t length, Napi::Int32Array* out) {
+  Napi::Env env = info.Env();
+  
+  if (info.Length() <= index || info[index].IsUndefined()) {
+    *out = Napi::Int32Array::New(env, length);
+    return true;
+  }
+  
+  if (!IsTypedArrayOf(info[index], napi_int32_array)) {
+    Napi::TypeError::New(env, "Results must be an Int32Array").ThrowAsJavaScriptException();
+    return false;
+  }
+  
+  *out = info[index].As<Napi::Int32Array>();
+  if (out->ElementLength() < length) {
+    Napi::RangeError::New(env, "Results array is too small").ThrowAsJavaScriptException();
+    return false;
+  }
+  return true;
+}
+
+// Result buffer reused by every prefix search on the calling thread
+std::vector<DartsDict::result_pair_type>& PrefixResultBuffer() {
+  thread_local std::vector<DartsDict::result_pair_type> buffer(64);
+  return buffer;
+}
+
+// Runs a common prefix search, growing the buffer so that no result is truncated.
+// Results are ordered by length; returns the number of results.
+size_t CommonPrefixMatches(const DartsDict* dict, const char* key, size_t len,
+                           std::vector<DartsDict::result_pair_type>* results) {
+  if (dict->size() == 0) {
+    return 0;
+  }
+  // As for ExactMatch, a zero length would make Darts read a terminator
+  if (len == 0) {
+    key = "";
+  }
+  
+  size_t num_results = dict->commonPrefixSearch(key, results->data(), results->size(), len);
+  if (num_results > results->size()) {
+    results->resize(num_results);
+    num_results = dict->commonPrefixSearch(key, results->data(), results->size(), len);
+  }
+  return num_results;
+}
+
+// Length in bytes of the UTF-8 code point at text, counting a stray continuation byte alone
+inline size_t CodePointLength(const char* text, size_t remaining) {
+  size_t length = 1;
+  while (length < remaining && !IsUtf8LeadByte(static_cast<unsigned char>(text[length]))) {
+    length++;
+  }
+  return length;
+}
+
+// Length in the text's units of the code point at pos
+inline size_t CodePointAt(const SearchText& text, size_t pos) {
+  return text.units ? CodePointUnits(text.units, text.length, pos)
+                    : CodePointLength(text.bytes + pos, text.length - pos);
+}
+
+// Collects the keys that are prefixes of the text from pos, shortest first, including an
+// empty key. Strings are walked code unit by code unit, so lengths are in UTF-16 code units
+// without a second pass over the bytes; for bytes they are in bytes. Returns the number of
+// matches, which are written to the front of a buffer reused across calls.
+size_t PrefixMatchesAt(const DartsDict* dict, const SearchText& text, size_t pos,
+                       std::vector<PrefixMatch>* matches) {
+  matches->clear();
+  if (dict->size() == 0) {
+    return 0;
+  }
+  
+  if (text.units) {
+    CommonPrefixSearchUtf16(*dict, text.units + pos, text.length - pos,
+                            [matches](int value, size_t length) {
+                              matches->push_back(PrefixMatch{value, length});
+                            });
+    return matches->size();
+  }
+  
+  std::vector<DartsDict::result_pair_type>& results = PrefixResultBuffer();
+  size_t num_results = CommonPrefixMatches(dict, text.bytes + pos, text.length - pos, &results);
+  for (size_t i = 0; i < num_results; i++) {
+    matches->push_back(PrefixMatch{results[i].value, results[i].length});
+  }
+  return num_results;
+}
+
+// Match buffer reused by every text search on the calling thread
+std::vector<PrefixMatch>& PrefixMatchBuffer() {
+  thread_local std::vector<PrefixMatch> buffer;
+  return buffer;
+}
+
+// Writes (value, length) pairs for the first num_pairs matches
+void WritePrefixPairs(const std::vector<PrefixMatch>& matches, size_t num_pairs, int32_t* out) {
+  for (size_t i = 0; i < num_pairs; i++) {
+    out[i * 2] = matches[i].value;
+    out[i * 2 + 1] = static_cast<int32_t>(matches[i].length);
+  }
+}
+
+// Scans the text once and collects the longest match at each code point boundary.
+// The scan resumes right after a match, so the returned matches never overlap.
+std::vector<TextMatch> FindLongestMatches(const DartsDict* dict, const SearchText& text) {
+  std::vector<TextMatch> matches;
+  std::vector<PrefixMatch>& prefixes = PrefixMatchBuffer();
+  size_t pos = 0;
+
+  while (pos < text.length) {
+    size_t num_prefixes = PrefixMatchesAt(dict, text, pos, &prefixes);
+
+    // Matches are ordered by length, and an empty key never counts as a match
+    if (num_prefixes > 0 && prefixes[num_prefixes - 1].length > 0) {
+      const PrefixMatch& longest = prefixes[num_prefixes - 1];
+      matches.push_back(TextMatch{pos, longest.length, longest.value});
+      pos += longest.length;
+    } else {
+      pos += CodePointAt(text, pos);
+    }
+  }
+
+  return matches;
+}
+
+// Splits the text into (start, length, value) triples appended to tokens, ordered by start
+// and then by length. Unknown code points have value -1. Positions are in the text's units.
+void TokenizeText(const DartsDict* dict, const SearchText& text, TokenizeMode mode,
+                  std::vector<int32_t>* tokens) {
+  std::vector<PrefixMatch>& prefixes = PrefixMatchBuffer();
+  auto emit = [tokens](size_t start, size_t length, int value) {
+    tokens->push_back(static_cast<int32_t>(start));
+    tokens->push_back(static_cast<int32_t>(length));
+    tokens->push_back(value);
+  };
+  
+  size_t pos = 0;
+  while (pos < text.length) {
+    size_t step = CodePointAt(text, pos);
+    
+    // Matches are ordered by length, and an empty key never counts as a match
+    size_t num_prefixes = PrefixMatchesAt(dict, text, pos, &prefixes);
+    size_t first = num_prefixes > 0 && prefixes[0].length == 0 ? 1 : 0;
+    
+    if (mode == TokenizeMode::kLongest) {
+      if (num_prefixes > first) {
+        const PrefixMatch& longest = prefixes[num_prefixes - 1];
+        emit(pos, longest.length, longest.value);
+        pos += longest.length;
+      } else {
+        emit(pos, step, -1);
+        pos += step;
+      }
+      continue;
+    }
+    
+    for (size_t i = first; i < num_prefixes; i++) {
+      emit(pos, prefixes[i].length, prefixes[i].value);
+    }
+    if (mode == TokenizeMode::kLattice && num_prefixes == first) {
+      emit(pos, step, -1);
+    }
+    pos += step;
+  }
+}
+
+// Appends every occurrence of every non-empty key in the text to tokens as (start, length,
+// value) triples, ordered by end and then longest first. The text is read once through the
+// dictionary's automaton, whatever the number of overlapping keys. Positions are in the
+// text's units; in a string, only keys starting and ending at code point boundaries match.
+void ScanText(const DartsDict* dict, const ScanTable& scan, const SearchText& text,
+              std::vector<int32_t>* tokens) {
+  auto emit = [tokens](size_t start, size_t length, int value) {
+    tokens->push_back(static_cast<int32_t>(start));
+    tokens->push_back(static_cast<int32_t>(length));
+    tokens->push_back(value);
+  };
+  uint32_t state = 0;
+  
+  if (!text.units) {
+    for (size_t pos = 0; pos < text.length; pos++) {
+      state = scan.Next(*dict, state, static_cast<unsigned char>(text.bytes[pos]));
+      scan.VisitMatches(state, [&emit, pos](int value, size_t length) {
+        emit(pos + 1 - length, length, value);
+      });
+    }
+    return;
+  }
+  
+  // Code points are encoded as they are read. The last code point boundaries, as far back
+  // as the longest key, map the byte where a match starts back to its code unit.
+  struct Boundary {
+    size_t byte_pos;
+    size_t unit_pos;
+  };
+  size_t max_bytes = std::min(scan.max_length(), text.length * 3);
+  size_t ring_size = 1;
+  while (ring_size <= max_bytes) {
+    ring_size <<= 1;
+  }
+  std::vector<Boundary> ring(ring_size, Boundary{SIZE_MAX, 0});
+  
+  size_t byte_pos = 0;
+  size_t pos = 0;
+  char bytes[4];
+  while (pos < text.length) {
+    ring[byte_pos & (ring_size - 1)] = Boundary{byte_pos, pos};
+    size_t units = 0;
+    size_t num_bytes = EncodeCodePoint(text.units, text.length, pos, bytes, &units);
+    for (size_t i = 0; i < num_bytes; i++) {
+      state = scan.Next(*dict, state, static_cast<unsigned char>(bytes[i]));
+    }
+    byte_pos += num_bytes;
+    pos += units;
+    
+    scan.VisitMatches(state, [&](int value, size_t length) {
+      // A table read in place may hold lengths longer than the text read so far
+      if (length > byte_pos) {
+        return;
+      }
+      const Boundary& start = ring[(byte_pos - length) & (ring_size - 1)];
+      if (start.byte_pos == byte_pos - length) {
+        emit(start.unit_pos, pos - start.unit_pos, value);
+      }
+    });
+  }
+}
+
+// Where and how to load a dictionary file
+struct LoadRequest {
+  std::string path;
+  bool mmap = false;
+  MapOptions map_options;
+  // For a file read into memory; ordinary heap memory is used unless one of them is set
+  PageOptions page_options;
+  bool numa_replicas = false;
+};
+
+// Reads (handle, filePath, options?) arguments that have already been type-checked.
+// Options: { mmap?: boolean, prewarm?: boolean, randomAccess?: boolean,
+//            hugePages?: boolean, numaReplicas?: boolean }
+LoadRequest ReadLoadRequest(const Napi::CallbackInfo& info) {
+  LoadRequest request;
+  request.path = info[1].As<Napi::String>().Utf8Value();
+  
+  if (info.Length() >= 3 && info[2].IsObject()) {
+    Napi::Object options = info[2].As<Napi::Object>();
+    request.mmap = options.Get("mmap").ToBoolean().Value();
+    request.map_options.prewarm = options.Get("prewarm").ToBoolean().Value();
+    request.map_options.random_access = options.Get("randomAccess").ToBoolean().Value();
+    bool huge_pages = options.Get("hugePages").ToBoolean().Value();
+    request.map_options.huge_pages = huge_pages;
+    request.page_options.huge_pages = huge_pages;
+    request.numa_replicas = options.Get("numaReplicas").ToBoolean().Value();
+    if (request.numa_replicas) {
+      // The dictionary goes on the node of the thread asking for it, not on that of the
+      // threadpool thread an asynchronous load reads it on
+      request.page_options.numa_node = CurrentNumaNode();
+    }
+  }
+  
+  return request;
+}
+
+// How to save a dictionary file
+struct SaveRequest {
+  bool relayout = false;
+  // 0 for a plain file
+  int compression_level = 0;
+};
+
+// Reads save's options object at info[index], if any:
+// { relayout?: boolean, compress?: boolean, compressionLevel?: number }
+// compressionLevel (1-9) implies compress, which uses level 1 otherwise.
+// Throws a TypeError and returns false if the options are invalid.
+bool ReadSaveRequest(const Napi::CallbackInfo& info, size_t index, SaveRequest* request) {
+  if (info.Length() <= index || !info[index].IsObject()) {
+    return true;
+  }
+  Napi::Object options = info[index].As<Napi::Object>();
+  request->relayout = options.Get("relayout").ToBoolean().Value();
+  Napi::Value level = options.Get("compressionLevel");
+  if (!level.IsUndefined()) {
+    double number = level.IsNumber() ? level.As<Napi::Number>().DoubleValue() : 0;
+    if (number != std::floor(number) || number < 1 || number > 9) {
+      Napi::TypeError::New(info.Env(), "compressionLevel must be an integer from 1 to 9").ThrowAsJavaScriptException();
+      return false;
+    }
+    request->compression_level = static_cast<int>(number);
+  } else if (options.Get("compress").ToBoolean().Value()) {
+    // Deflate's fastest level compresses dictionaries nearly as well as its best
+    request->compression_level = 1;
+  }
+  return true;
+}
+
+// Makes a dictionary of the serialized one held by storage; verify checks its units against
+// their checksum. A compressed dictionary is inflated into new memory allocated as
+// page_options asks, and always verified, as inflating reads all of it anyway.
+std::unique_ptr<DartsDict> OpenDictionary(std::unique_ptr<ArrayStorage> storage, bool verify,
+                                          const PageOptions& page_options, std::string* error) {
+  if (IsCompressedFile(storage->data(), storage->size())) {
+    CompressedLayout layout;
+    std::unique_ptr<PageStorage> inflated;
+    if (!ParseCompressedFile(storage->data(), storage->size(), &layout, error) ||
+        !(inflated = PageStorage::Allocate(layout.raw_size, page_options, error)) ||
+        !InflateCompressedFile(storage->data(), layout, inflated->mutable_data(), 0, error)) {
+      return nullptr;
+    }
+    storage = std::move(inflated);
+    verify = true;
+  }
+  
+  std::unique_ptr<DartsDict> dict(new DartsDict());
+  if (!dict->attachFile(std::move(storage), verify, error)) {
+    return nullptr;
+  }
+  return dict;
+}
+
+// Buffers made by SaveDictionaryToBuffer, by the address of their bytes.
+// Their bytes are owned here rather than by the ArrayBuffer, which only holds a reference
+// to them, so a dictionary reading one in place keeps reading valid memory whatever JS
+// does with the ArrayBuffer (detaching or transferring it included), on any thread.
+// Entries are weak, and expired ones are dropped as new buffers are made.
+std::mutex g_buffers_mutex;
+std::map<const char*, std::weak_ptr<std::vector<char>>> g_buffers;
+
+void RegisterSerializedBuffer(const std::shared_ptr<std::vector<char>>& bytes) {
+  std::lock_guard<std::mutex> lock(g_buffers_mutex);
+  for (auto it = g_buffers.begin(); it != g_buffers.end();) {
+    it = it->second.expired() ? g_buffers.erase(it) : std::next(it);
+  }
+  g_buffers[bytes->data()] = bytes;
+}
+
+// The bytes of a buffer made by SaveDictionaryToBuffer holding [data, data + size), or
+// nullptr if the range belongs to no such buffer
+std::shared_ptr<std::vector<char>> FindSerializedBuffer(const char* data, size_t size) {
+  std::lock_guard<std::mutex> lock(g_buffers_mutex);
+  auto it = g_buffers.upper_bound(data);
+  if (it == g_buffers.begin()) {
+    return nullptr;
+  }
+  std::shared_ptr<std::vector<char>> bytes = (--it)->second.lock();
+  // The range may lie in unrelated memory, so addresses are compared as integers
+  size_t offset = reinterpret_cast<uintptr_t>(data) - reinterpret_cast<uintptr_t>(it->first);
+  if (!bytes || offset > bytes->size() || size > bytes->size() - offset) {
+    return nullptr;
+  }
+  return bytes;
+}
+
+// Serialized dictionary read in place from the bytes of a buffer made by
+// SaveDictionaryToBuffer, which it shares with the ArrayBuffer
+class SerializedBufferStorage : public ArrayStorage {
+ public:
+  SerializedBufferStorage(std::shared_ptr<std::vector<char>> bytes, const char* data,
+                          size_t size)
+      : bytes_(std::move(bytes)), data_(data), size_(size) {}
+  
+  const void* data() const override { return data_; }
+  size_t size() const override { return size_; }
+  
+ private:
+  std::shared_ptr<std::vector<char>> bytes_;
+  const char* data_;
+  size_t size_;
+};
+
+// Loads a dictionary file into a new dictionary.
+// Touches no JS values, so it is safe to call from a worker thread.
+std::unique_ptr<DartsDict> LoadDictionaryFile(const LoadRequest& request, std::string* error) {
+  std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+  std::unique_ptr<ArrayStorage> storage;
+  if (request.mmap) {
+    storage = MappedFileStorage::Open(request.path, request.map_options, error);
+    if (!storage) {
+      *error = "Failed to map dictionary: " + *error;
+      return nullptr;
+    }
+  } else if (request.page_options.huge_pages || request.page_options.numa_node >= 0) {
+    storage = PageStorage::ReadFile(request.path, request.page_options, error);
+    if (!storage) {
+      *error = "Failed to load dictionary: " + *error;
+      return nullptr;
+    }
+  } else {
+    storage = BufferStorage::ReadFile(request.path, error);
+    if (!storage) {
+      *error = "Failed to load dictionary: " + *error;
+      return nullptr;
+    }
+  }
+  
+  // A mapped file is only checked against its header, so that nothing is read up front
+  std::unique_ptr<DartsDict> dict =
+      OpenDictionary(std::move(storage), !request.mmap, request.page_options, error);
+  if (!dict) {
+    *error = "Failed to load dictionary: " + *error;
+    return nullptr;
+  }
+  dict->set_origin("load", MillisecondsSince(start));
+  dict->set_numa_replicas(request.numa_replicas);
+  
+  return dict;
+}
+
+// Loads a dictionary file on the libuv threadpool, then publishes it under the handle
+class LoadWorker : public Napi::AsyncWorker {
+ public:
+  LoadWorker(Napi::Env env, uint32_t handle, std::shared_ptr<DartsDict> target, LoadRequest request)
+      : Napi::AsyncWorker(env, "node_darts:load"),
+        deferred_(Napi::Promise::Deferred::New(env)),
+        handle_(handle),
+        target_(std::move(target)),
+        request_(std::move(request)) {}
+  
+  Napi::Promise Promise() const { return deferred_.Promise(); }
+  
+  void Execute() override {
+    try {
+      std::string error;
+      dict_ = LoadDictionaryFile(request_, &error);
+      if (!dict_) {
+        SetError(error);
+      }
+    } catch (const std::exception& e) {
+      SetError(e.what());
+    }
+  }
+  
+  void OnOK() override {
+    // Holding the target keeps its address from being reused by another dictionary
+    if (!ReplaceDictionary(Env(), handle_, target_.get(), std::move(dict_))) {
+      deferred_.Reject(Napi::Error::New(Env(), "Dictionary was destroyed or swapped while loading").Value());
+      return;
+    }
+    deferred_.Resolve(Napi::Boolean::New(Env(), true));
+  }
+  
+  void OnError(const Napi::Error& e) override {
+    deferred_.Reject(e.Value());
+  }
+  
+ private:
+  Napi::Promise::Deferred deferred_;
+  uint32_t handle_;
+  std::shared_ptr<DartsDict> target_;
+  LoadRequest request_;
+  std::unique_ptr<DartsDict> dict_;
+};
+
+// Saves a dictionary on the libuv threadpool.
+// The worker shares ownership, so destroying the handle meanwhile is safe.
+class SaveWorker : public Napi::AsyncWorker {
+ public:
+  SaveWorker(Napi::Env env, std::shared_ptr<DartsDict> dict, std::string path, SaveRequest request)
+      : Napi::AsyncWorker(env, "node_darts:save"),
+        deferred_(Napi::Promise::Deferred::New(env)),
+        dict_(std::move(dict)),
+        path_(std::move(path)),
+        request_(request) {}
+  
+  Napi::Promise Promise() const { return deferred_.Promise(); }
+  
+  void Execute() override {
+    std::string error;
+    if (!dict_->save(path_.c_str(), &error, request_.relayout, request_.compression_level)) {
+      SetError("Failed to save dictionary: " + error);
+    }
+  }
+  
+  void OnOK() override {
+    deferred_.Resolve(Napi::Boolean::New(Env(), true));
+  }
+  
+  void OnError(const Napi::Error& e) override {
+    deferred_.Reject(e.Value());
+  }
+  
+ private:
+  Napi::Promise::Deferred deferred_;
+  std::shared_ptr<DartsDict> dict_;
+  std::string path_;
+  SaveRequest request_;
+};
+
+// Shared by predictiveSearch (values) and predictiveSearchKeys ({key, value} objects)
+Napi::Value RunPredictiveSearch(const Napi::CallbackInfo& info, bool with_keys) {
+  Napi::Env env = info.Env();
+  
+  try {
+    if (info.Length() < 2 || !info[0].IsNumber() || !info[1].IsString()) {
+      Napi::TypeError::New(env, "Arguments: (handle: number, prefix: string, limit?: number) expected").ThrowAsJavaScriptException();
+      return env.Null();
+    }
+    
+    uint32_t handle = info[0].As<Napi::Number>().Uint32Value();
+    std::string prefix = info[1].As<Napi::String>().Utf8Value();
+    size_t limit = 0;
+    if (info.Length() >= 3 && info[2].IsNumber()) {
+      limit = info[2].As<Napi::Number>().Uint32Value();
+    }
+    
+    DartsDict* dict = GetDictionaryFromHandle(env, handle);
+    if (!dict) {
+      Napi::Error::New(env, "Invalid dictionary handle").ThrowAsJavaScriptException();
+      return env.Null();
+    }
+    
+    LookupTimer timer(dict->lookup_stats(), LookupKind::kPredictive);
+    std::vector<int> values;
+    std::vector<std::string> keys;
+    dict->predictiveSearch(prefix.c_str(), prefix.length(), limit,
+                           [&values, &keys, with_keys](int value, const std::string& key) {
+      values.push_back(value);
+      if (with_keys) {
+        keys.push_back(key);
+      }
+    });
+    
+    Napi::Array result_array = Napi::Array::New(env, values.size());
+    for (size_t i = 0; i < values.size(); i++) {
+      if (with_keys) {
+        Napi::Object result_obj = Napi::Object::New(env);
+        result_obj.Set("key", Napi::String::New(env, keys[i]));
+        result_obj.Set("value", Napi::Number::New(env, values[i]));
+        result_array[i] = result_obj;
+      } else {
+        result_array[i] = Napi::Number::New(env, values[i]);
+      }
+    }
+    
+    return result_array;
+  } catch (const std::exception& e) {
+    Napi::Error::New(env, e.what()).ThrowAsJavaScriptException();
+    return env.Null();
+  }
+}
+
+}  // namespace
+
 Napi::Value CreateDictionary(const Napi::CallbackInfo& info) {
   Napi::Env env = info.Env();
   
   try {
-    DartsDict* dict = new DartsDict();
-    uint32_t handle = AddDictionary(dict);
-    return Napi::Number::New(env, handle);
+    DartsDict* dict = new DartsDict();
+    uint32_t handle = AddDictionary(env, dict);
+    return Napi::Number::New(env, handle);
+  } catch (const std::exception& e) {
+    Napi::Error::New(env, e.what()).ThrowAsJavaScriptException();
+    return env.Null();
+  }
+}
+
+Napi::Value DestroyDictionary(const Napi::CallbackInfo& info) {
+  Napi::Env env = info.Env();
+  
+  try {
+    if (info.Length() < 1 || !info[0].IsNumber()) {
+      Napi::TypeError::New(env, "Number expected").ThrowAsJavaScriptException();
+      return env.Null();
+    }
+    
+    uint32_t handle = info[0].As<Napi::Number>().Uint32Value();
+    RemoveDictionary(env, handle);
+    
+    return env.Undefined();
+  } catch (const std::exception& e) {
+    Napi::Error::New(env, e.what()).ThrowAsJavaScriptException();
+    return env.Null();
+  }
+}
+
+Napi::Value ShareDictionary(const Napi::CallbackInfo& info) {
+  Napi::Env env = info.Env();
+  
+  try {
+    if (info.Length() < 1 || !info[0].IsNumber()) {
+      Napi::TypeError::New(env, "Number expected").ThrowAsJavaScriptException();
+      return env.Null();
+    }
+    
+    uint32_t handle = info[0].As<Napi::Number>().Uint32Value();
+    std::shared_ptr<DartsDict> dict = GetSharedDictionary(env, handle);
+    if (!dict) {
+      Napi::Error::New(env, "Invalid dictionary handle").ThrowAsJavaScriptException();
+      return env.Null();
+    }
+    
+    // The token is a plain number so that it can be posted to other threads
+    uint32_t token = PublishDictionary(std::move(dict));
+    return Napi::Number::New(env, token);
+  } catch (const std::exception& e) {
+    Napi::Error::New(env, e.what()).ThrowAsJavaScriptException();
+    return env.Null();
+  }
+}
+
+Napi::Value AttachDictionary(const Napi::CallbackInfo& info) {
+  Napi::Env env = info.Env();
+  
+  try {
+    if (info.Length() < 1 || !info[0].IsNumber()) {
+      Napi::TypeError::New(env, "Number expected").ThrowAsJavaScriptException();
+      return env.Null();
+    }
+    
+    uint32_t token = info[0].As<Napi::Number>().Uint32Value();
+    std::shared_ptr<DartsDict> dict = FindPublishedDictionary(token);
+    if (!dict) {
+      Napi::Error::New(env, "Shared dictionary is no longer available").ThrowAsJavaScriptException();
+      return env.Null();
+    }
+    
+    // The new handle shares the array, or its copy on this thread's NUMA node if the
+    // dictionary keeps them; lookups are const and need no locking
+    std::shared_ptr<DartsDict> local = dict->local_replica();
+    uint32_t handle = AddDictionary(env, local ? std::move(local) : std::move(dict));
+    return Napi::Number::New(env, handle);
+  } catch (const std::exception& e) {
+    Napi::Error::New(env, e.what()).ThrowAsJavaScriptException();
+    return env.Null();
+  }
+}
+
+Napi::Value SwapDictionaries(const Napi::CallbackInfo& info) {
+  Napi::Env env = info.Env();
+  
+  try {
+    if (info.Length() < 2 || !info[0].IsNumber() || !info[1].IsNumber()) {
+      Napi::TypeError::New(env, "Arguments: (handle: number, otherHandle: number) expected").ThrowAsJavaScriptException();
+      return env.Null();
+    }
+    
+    uint32_t handle = info[0].As<Napi::Number>().Uint32Value();
+    uint32_t other = info[1].As<Napi::Number>().Uint32Value();
+    if (!ExchangeDictionaries(env, handle, other)) {
+      Napi::Error::New(env, "Invalid dictionary handle").ThrowAsJavaScriptException();
+      return env.Null();
+    }
+    
+    return env.Undefined();
+  } catch (const std::exception& e) {
+    Napi::Error::New(env, e.what()).ThrowAsJavaScriptException();
+    return env.Null();
+  }
+}
+
+Napi::Value LoadDictionary(const Napi::CallbackInfo& info) {
+  Napi::Env env = info.Env();
+  
+  try {
+    if (info.Length() < 2 || !info[0].IsNumber() || !info[1].IsString()) {
+      Napi::TypeError::New(env, "Arguments: (handle: number, filePath: string) expected").ThrowAsJavaScriptException();
+      return env.Null();
+    }
+    
+    uint32_t handle = info[0].As<Napi::Number>().Uint32Value();
+    LoadRequest request = ReadLoadRequest(info);
+    
+    DartsDict* dict = GetDictionaryFromHandle(env, handle);
+    if (!dict) {
+      Napi::Error::New(env, "Invalid dictionary handle").ThrowAsJavaScriptException();
+      return env.Null();
+    }
+    
+    std::string error;
+    std::unique_ptr<DartsDict> loaded = LoadDictionaryFile(request, &error);
+    if (!loaded) {
+      Napi::Error::New(env, error).ThrowAsJavaScriptException();
+      return Napi::Boolean::New(env, false);
+    }
+    
+    ReplaceDictionary(env, handle, dict, std::move(loaded));
+    return Napi::Boolean::New(env, true);
+  } catch (const std::exception& e) {
+    Napi::Error::New(env, e.what()).ThrowAsJavaScriptException();
+    return env.Null();
+  }
+}
+
+Napi::Value SaveDictionary(const Napi::CallbackInfo& info) {
+  Napi::Env env = info.Env();
+  
+  try {
+    if (info.Length() < 2 || !info[0].IsNumber() || !info[1].IsString()) {
+      Napi::TypeError::New(env, "Arguments: (handle: number, filePath: string, options?: object) expected").ThrowAsJavaScriptException();
+      return env.Null();
+    }
+    
+    uint32_t handle = info[0].As<Napi::Number>().Uint32Value();
+    std::string filePath = info[1].As<Napi::String>().Utf8Value();
+    SaveRequest request;
+    if (!ReadSaveRequest(info, 2, &request)) {
+      return env.Null();
+    }
+    
+    DartsDict* dict = GetDictionaryFromHandle(env, handle);
+    if (!dict) {
+      Napi::Error::New(env, "Invalid dictionary handle").ThrowAsJavaScriptException();
+      return env.Null();
+    }
+    
+    std::string error;
+    if (!dict->save(filePath.c_str(), &error, request.relayout, request.compression_level)) {
+      Napi::Error::New(env, "Failed to save dictionary: " + error).ThrowAsJavaScriptException();
+      return Napi::Boolean::New(env, false);
+    }
+    
+    return Napi::Boolean::New(env, true);
+  } catch (const std::exception& e) {
+    Napi::Error::New(env, e.what()).ThrowAsJavaScriptException();
+    return env.Null();
+  }
+}
+
+Napi::Value LoadDictionaryAsync(const Napi::CallbackInfo& info) {
+  Napi::Env env = info.Env();
+  
+  try {
+    if (info.Length() < 2 || !info[0].IsNumber() || !info[1].IsString()) {
+      Napi::TypeError::New(env, "Arguments: (handle: number, filePath: string) expected").ThrowAsJavaScriptException();
+      return env.Null();
+    }
+    
+    uint32_t handle = info[0].As<Napi::Number>().Uint32Value();
+    LoadRequest request = ReadLoadRequest(info);
+    
+    std::shared_ptr<DartsDict> dict = GetSharedDictionary(env, handle);
+    if (!dict) {
+      Napi::Error::New(env, "Invalid dictionary handle").ThrowAsJavaScriptException();
+      return env.Null();
+    }
+    
+    LoadWorker* worker = new LoadWorker(env, handle, std::move(dict), std::move(request));
+    Napi::Promise promise = worker->Promise();
+    worker->Queue();
+    return promise;
+  } catch (const std::exception& e) {
+    Napi::Error::New(env, e.what()).ThrowAsJavaScriptException();
+    return env.Null();
+  }
+}
+
+Napi::Value SaveDictionaryAsync(const Napi::CallbackInfo& info) {
+  Napi::Env env = info.Env();
+  
+  try {
+    if (info.Length() < 2 || !info[0].IsNumber() || !info[1].IsString()) {
+      Napi::TypeError::New(env, "Arguments: (handle: number, filePath: string, options?: object) expected").ThrowAsJavaScriptException();
+      return env.Null();
+    }
+    
+    uint32_t handle = info[0].As<Napi::Number>().Uint32Value();
+    std::string filePath = info[1].As<Napi::String>().Utf8Value();
+    SaveRequest request;
+    if (!ReadSaveRequest(info, 2, &request)) {
+      return env.Null();
+    }
+    
+    std::shared_ptr<DartsDict> dict = GetSharedDictionary(env, handle);
+    if (!dict) {
+      Napi::Error::New(env, "Invalid dictionary handle").ThrowAsJavaScriptException();
+      return env.Null();
+    }
+    
+    SaveWorker* worker = new SaveWorker(env, std::move(dict), std::move(filePath), request);
+    Napi::Promise promise = worker->Promise();
+    worker->Queue();
+    return promise;
+  } catch (const std::exception& e) {
+    Napi::Error::New(env, e.what()).ThrowAsJavaScriptException();
+    return env.Null();
+  }
+}
+
+Napi::Value SaveDictionaryToBuffer(const Napi::CallbackInfo& info) {
+  Napi::Env env = info.Env();
+  
+  try {
+    if (info.Length() < 1 || !info[0].IsNumber()) {
+      Napi::TypeError::New(env, "Arguments: (handle: number, options?: object) expected").ThrowAsJavaScriptException();
+      return env.Null();
+    }
+    
+    uint32_t handle = info[0].As<Napi::Number>().Uint32Value();
+    SaveRequest request;
+    if (!ReadSaveRequest(info, 1, &request)) {
+      return env.Null();
+    }
+    
+    DartsDict* dict = GetDictionaryFromHandle(env, handle);
+    if (!dict) {
+      Napi::Error::New(env, "Invalid dictionary handle").ThrowAsJavaScriptException();
+      return env.Null();
+    }
+    
+    std::shared_ptr<std::vector<char>> bytes = std::make_shared<std::vector<char>>();
+    std::string error;
+    if (!dict->serialize(bytes.get(), &error, request.relayout, request.compression_level)) {
+      Napi::Error::New(env, "Failed to save dictionary: " + error).ThrowAsJavaScriptException();
+      return env.Null();
+    }
+    
+    // The buffer references the serialized bytes rather than copying them
+    std::unique_ptr<std::shared_ptr<std::vector<char>>> owner(
+        new std::shared_ptr<std::vector<char>>(bytes));
+    Napi::ArrayBuffer buffer = Napi::ArrayBuffer::New(
+        env, bytes->data(), bytes->size(),
+        [](Napi::Env, void*, std::shared_ptr<std::vector<char>>* hint) { delete hint; },
+        owner.get());
+    if (env.IsExceptionPending()) {
+      // Runtimes that forbid external buffers get a copy instead, which is never read in place
+      env.GetAndClearPendingException();
+      buffer = Napi::ArrayBuffer::New(env, bytes->size());
+      std::memcpy(buffer.Data(), bytes->data(), bytes->size());
+    } else {
+      owner.release();
+      RegisterSerializedBuffer(bytes);
+    }
+    return buffer;
+  } catch (const std::exception& e) {
+    Napi::Error::New(env, e.what()).ThrowAsJavaScriptException();
+    return env.Null();
+  }
+}
+
+Napi::Value LoadDictionaryFromBuffer(const Napi::CallbackInfo& info) {
+  Napi::Env env = info.Env();
+  
+  try {
+    if (info.Length() < 2 || !info[0].IsNumber() ||
+        !(info[1].IsArrayBuffer() || info[1].IsTypedArray())) {
+      Napi::TypeError::New(env, "Arguments: (handle: number, buffer: ArrayBuffer | Uint8Array, options?: object) expected").ThrowAsJavaScriptException();
+      return env.Null();
+    }
+    
+    uint32_t handle = info[0].As<Napi::Number>().Uint32Value();
+    // Options: { copy?: boolean }, copying by default
+    Napi::Value copy_option = info.Length() >= 3 && info[2].IsObject()
+                                  ? info[2].As<Napi::Object>().Get("copy")
+                                  : env.Undefined();
+    bool copy = copy_option.IsUndefined() || copy_option.ToBoolean().Value();
+    
+    const char* data;
+    size_t size;
+    if (info[1].IsArrayBuffer()) {
+      Napi::ArrayBuffer buffer = info[1].As<Napi::ArrayBuffer>();
+      data = static_cast<const char*>(buffer.Data());
+      size = buffer.ByteLength();
+    } else {
+      Napi::TypedArray array = info[1].As<Napi::TypedArray>();
+      data = static_cast<const char*>(array.ArrayBuffer().Data()) + array.ByteOffset();
+      size = array.ByteLength();
+    }
+    
+    DartsDict* dict = GetDictionaryFromHandle(env, handle);
+    if (!dict) {
+      Napi::Error::New(env, "Invalid dictionary handle").ThrowAsJavaScriptException();
+      return env.Null();
+    }
+    
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    // Only the bytes of a buffer made by saveToBuffer are read in place: the memory of any
+    // other ArrayBuffer belongs to JS, which may detach it at any time. Units are read in
+    // place, so a view that is not aligned for them is copied all the same; a compressed
+    // dictionary is inflated into its own memory.
+    std::shared_ptr<std::vector<char>> bytes;
+    if (!copy && reinterpret_cast<uintptr_t>(data) % 8 == 0) {
+      bytes = FindSerializedBuffer(data, size);
+    }
+    std::unique_ptr<ArrayStorage> storage;
+    if (bytes) {
+      storage.reset(new SerializedBufferStorage(std::move(bytes), data, size));
+    } else {
+      storage.reset(new BufferStorage(std::vector<char>(data, data + size)));
+    }
+    
+    std::string error;
+    std::unique_ptr<DartsDict> loaded =
+        OpenDictionary(std::move(storage), true, PageOptions(), &error);
+    if (!loaded) {
+      Napi::Error::New(env, "Failed to load dictionary: " + error).ThrowAsJavaScriptException();
+      return Napi::Boolean::New(env, false);
+    }
+    loaded->set_origin("load", MillisecondsSince(start));
+    
+    ReplaceDictionary(env, handle, dict, std::move(loaded));
+    return Napi::Boolean::New(env, true);
+  } catch (const std::exception& e) {
+    Napi::Error::New(env, e.what()).ThrowAsJavaScriptException();
+    return env.Null();
+  }
+}
+
+Napi::Value ExactMatchSearch(const Napi::CallbackInfo& info) {
+  Napi::Env env = info.Env();
+  
+  try {
+    if (info.Length() < 2 || !info[0].IsNumber() || !IsKey(info[1])) {
+      Napi::TypeError::New(env, "Arguments: (handle: number, key: string | Uint8Array, offset?: number, length?: number) expected").ThrowAsJavaScriptException();
+      return env.Null();
+    }
+    
+    uint32_t handle = info[0].As<Napi::Number>().Uint32Value();
+    KeyBytes key;
+    if (!ReadKey(info, 1, 2, &key)) {
+      return env.Null();
+    }
+    
+    DartsDict* dict = GetDictionaryFromHandle(env, handle);
+    if (!dict) {
+      Napi::Error::New(env, "Invalid dictionary handle").ThrowAsJavaScriptException();
+      return env.Null();
+    }
+    
+    LookupTimer timer(dict->lookup_stats(), LookupKind::kExactMatch);
+    int result = ExactMatch(dict, key.data, key.length);
+    return Napi::Number::New(env, result);
+  } catch (const std::exception& e) {
+    Napi::Error::New(env, e.what()).ThrowAsJavaScriptException();
+    return env.Null();
+  }
+}
+
+Napi::Value ExactMatchSearchBatch(const Napi::CallbackInfo& info) {
+  Napi::Env env = info.Env();
+  
+  try {
+    if (info.Length() < 2 || !info[0].IsNumber() || !info[1].IsArray()) {
+      Napi::TypeError::New(env, "Arguments: (handle: number, keys: (string | Uint8Array)[], results?: Int32Array) expected").ThrowAsJavaScriptException();
+      return env.Null();
+    }
+    
+    uint32_t handle = info[0].As<Napi::Number>().Uint32Value();
+    Napi::Array keys = info[1].As<Napi::Array>();
+    uint32_t num_keys = keys.Length();
+    
+    DartsDict* dict = GetDictionaryFromHandle(env, handle);
+    if (!dict) {
+      Napi::Error::New(env, "Invalid dictionary handle").ThrowAsJavaScriptException();
+      return env.Null();
+    }
+    
+    Napi::Int32Array results;
+    if (!GetResultArray(info, 2, num_keys, &results)) {
+      return env.Null();
+    }
+    
+    // Every key is encoded into the same buffer, so the batch makes no per-key allocations,
+    // and the keys are gathered first so that they can be looked up together
+    struct BatchKey {
+      // Bytes read in place, or nullptr for a key encoded at start in the buffer
+      const char* bytes;
+      size_t start;
+      size_t length;
+    };
+    std::vector<BatchKey> batch(num_keys);
+    std::vector<char> buffer(64);
+    size_t used = 0;
+    for (uint32_t i = 0; i < num_keys; i++) {
+      Napi::Value key = keys[i];
+      if (IsTypedArrayOf(key, napi_uint8_array)) {
+        Napi::Uint8Array bytes = key.As<Napi::Uint8Array>();
+        batch[i] = {reinterpret_cast<const char*>(bytes.Data()), 0, bytes.ElementLength()};
+        continue;
+      }
+      if (!key.IsString()) {
+        Napi::TypeError::New(env, "All keys must be strings or Uint8Arrays").ThrowAsJavaScriptException();
+        return env.Null();
+      }
+      
+      size_t length = 0;
+      napi_get_value_string_utf8(env, key, nullptr, 0, &length);
+      if (used + length + 1 > buffer.size()) {
+        buffer.resize(std::max(used + length + 1, buffer.size() * 2));
+      }
+      napi_get_value_string_utf8(env, key, buffer.data() + used, length + 1, &length);
+      batch[i] = {nullptr, used, length};
+      used += length;
+    }
+    
+    LookupTimer timer(dict->lookup_stats(), LookupKind::kExactMatch, num_keys);
+    const char* encoded = buffer.data();
+    dict->exactMatchBatch(
+        num_keys,
+        [&batch, encoded](size_t i, const char** key, size_t* length) {
+          *key = batch[i].bytes ? batch[i].bytes : encoded + batch[i].start;
+          *length = batch[i].length;
+        },
+        results.Data());
+    
+    return results;
+  } catch (const std::exception& e) {
+    Napi::Error::New(env, e.what()).ThrowAsJavaScriptException();
+    return env.Null();
+  }
+}
+
+Napi::Value ExactMatchSearchBuffer(const Napi::CallbackInfo& info) {
+  Napi::Env env = info.Env();
+  
+  try {
+    if (info.Length() < 3 || !info[0].IsNumber() || !IsTypedArrayOf(info[1], napi_uint8_array) ||
+        !IsTypedArrayOf(info[2], napi_uint32_array)) {
+      Napi::TypeError::New(env, "Arguments: (handle: number, keys: Uint8Array, offsets: Uint32Array, results?: Int32Array) expected").ThrowAsJavaScriptException();
+      return env.Null();
+    }
+    
+    uint32_t handle = info[0].As<Napi::Number>().Uint32Value();
+    Napi::Uint8Array keys = info[1].As<Napi::Uint8Array>();
+    Napi::Uint32Array offsets = info[2].As<Napi::Uint32Array>();
+    
+    DartsDict* dict = GetDictionaryFromHandle(env, handle);
+    if (!dict) {
+      Napi::Error::New(env, "Invalid dictionary handle").ThrowAsJavaScriptException();
+      return env.Null();
+    }
+    
+    // Key i spans offsets[i] to offsets[i + 1]
+    size_t num_keys = offsets.ElementLength() > 0 ? offsets.ElementLength() - 1 : 0;
+    for (size_t i = 0; i < num_keys; i++) {
+      if (offsets[i] > offsets[i + 1] || offsets[i + 1] > keys.ElementLength()) {
+        Napi::RangeError::New(env, "Offsets must be ascending and within the keys buffer").ThrowAsJavaScriptException();
+        return env.Null();
+      }
+    }
+    
+    Napi::Int32Array results;
+    if (!GetResultArray(info, 3, num_keys, &results)) {
+      return env.Null();
+    }
+    
+    LookupTimer timer(dict->lookup_stats(), LookupKind::kExactMatch, num_keys);
+    const char* data = reinterpret_cast<const char*>(keys.Data());
+    const uint32_t* bounds = offsets.Data();
+    dict->exactMatchBatch(
+        num_keys,
+        [data, bounds](size_t i, const char** key, size_t* length) {
+          *key = data + bounds[i];
+          *length = bounds[i + 1] - bounds[i];
+        },
+        results.Data());
+    
+    return results;
+  } catch (const std::exception& e) {
+    Napi::Error::New(env, e.what()).ThrowAsJavaScriptException();
+    return env.Null();
+  }
+}
+
+Napi::Value CommonPrefixSearch(const Napi::CallbackInfo& info) {
+  Napi::Env env = info.Env();
+  
+  try {
+    if (info.Length() < 2 || !info[0].IsNumber() || !IsKey(info[1])) {
+      Napi::TypeError::New(env, "Arguments: (handle: number, key: string | Uint8Array, offset?: number, length?: number) expected").ThrowAsJavaScriptException();
+      return env.Null();
+    }
+    
+    uint32_t handle = info[0].As<Napi::Number>().Uint32Value();
+    KeyBytes key;
+    if (!ReadKey(info, 1, 2, &key)) {
+      return env.Null();
+    }
+    
+    DartsDict* dict = GetDictionaryFromHandle(env, handle);
+    if (!dict) {
+      Napi::Error::New(env, "Invalid dictionary handle").ThrowAsJavaScriptException();
+      return env.Null();
+    }
+    
+    LookupTimer timer(dict->lookup_stats(), LookupKind::kCommonPrefix);
+    std::vector<DartsDict::result_pair_type>& results = PrefixResultBuffer();
+    size_t num_results = CommonPrefixMatches(dict, key.data, key.length, &results);
+    
+    Napi::Array result_array = Napi::Array::New(env, num_results);
+    for (size_t i = 0; i < num_results; i++) {
+      result_array[i] = Napi::Number::New(env, results[i].value);
+    }
+    
+    return result_array;
+  } catch (const std::exception& e) {
+    Napi::Error::New(env, e.what()).ThrowAsJavaScriptException();
+    return env.Null();
+  }
+}
+
+Napi::Value CommonPrefixSearchPairs(const Napi::CallbackInfo& info) {
+  Napi::Env env = info.Env();
+  
+  try {
+    if (info.Length() < 2 || !info[0].IsNumber() || !IsKey(info[1])) {
+      Napi::TypeError::New(env, "Arguments: (handle: number, key: string | Uint8Array, offset?: number, length?: number) expected").ThrowAsJavaScriptException();
+      return env.Null();
+    }
+    
+    uint32_t handle = info[0].As<Napi::Number>().Uint32Value();
+    SearchText key;
+    if (!ReadText(info, 1, 2, &key)) {
+      return env.Null();
+    }
+    
+    DartsDict* dict = GetDictionaryFromHandle(env, handle);
+    if (!dict) {
+      Napi::Error::New(env, "Invalid dictionary handle").ThrowAsJavaScriptException();
+      return env.Null();
+    }
+    
+    LookupTimer timer(dict->lookup_stats(), LookupKind::kCommonPrefix);
+    std::vector<PrefixMatch>& matches = PrefixMatchBuffer();
+    size_t num_matches = PrefixMatchesAt(dict, key, 0, &matches);
+    
+    Napi::Int32Array result_array = Napi::Int32Array::New(env, num_matches * 2);
+    WritePrefixPairs(matches, num_matches, result_array.Data());
+    
+    return result_array;
+  } catch (const std::exception& e) {
+    Napi::Error::New(env, e.what()).ThrowAsJavaScriptException();
+    return env.Null();
+  }
+}
+
+Napi::Value CommonPrefixSearchInto(const Napi::CallbackInfo& info) {
+  Napi::Env env = info.Env();
+  
+  try {
+    if (info.Length() < 3 || !info[0].IsNumber() || !IsKey(info[1]) ||
+        !IsTypedArrayOf(info[2], napi_int32_array)) {
+      Napi::TypeError::New(env, "Arguments: (handle: number, key: string | Uint8Array, results: Int32Array, offset?: number, length?: number) expected").ThrowAsJavaScriptException();
+      return env.Null();
+    }
+    
+    uint32_t handle = info[0].As<Napi::Number>().Uint32Value();
+    SearchText key;
+    if (!ReadText(info, 1, 3, &key)) {
+      return env.Null();
+    }
+    Napi::Int32Array out = info[2].As<Napi::Int32Array>();
+    
+    DartsDict* dict = GetDictionaryFromHandle(env, handle);
+    if (!dict) {
+      Napi::Error::New(env, "Invalid dictionary handle").ThrowAsJavaScriptException();
+      return env.Null();
+    }
+    
+    LookupTimer timer(dict->lookup_stats(), LookupKind::kCommonPrefix);
+    std::vector<PrefixMatch>& matches = PrefixMatchBuffer();
+    size_t num_matches = PrefixMatchesAt(dict, key, 0, &matches);
+    
+    // Only as many pairs as fit are written; the total count lets callers detect truncation
+    size_t num_pairs = std::min(num_matches, out.ElementLength() / 2);
+    WritePrefixPairs(matches, num_pairs, out.Data());
+    
+    return Napi::Number::New(env, static_cast<double>(num_matches));
+  } catch (const std::exception& e) {
+    Napi::Error::New(env, e.what()).ThrowAsJavaScriptException();
+    return env.Null();
+  }
+}
+
+// Gets the dictionary behind the handle, throwing a JS exception and returning nullptr
+// if there is none or it has no value table
+std::shared_ptr<DartsDict> GetDictionaryWithTable(Napi::Env env, const Napi::Value& handle) {
+  std::shared_ptr<DartsDict> dict = GetSharedDictionary(env, handle.As<Napi::Number>().Uint32Value());
+  if (!dict) {
+    Napi::Error::New(env, "Invalid dictionary handle").ThrowAsJavaScriptException();
+    return nullptr;
+  }
+  if (!dict->value_table()) {
+    Napi::Error::New(env, "Dictionary has no value table").ThrowAsJavaScriptException();
+    return nullptr;
+  }
+  return dict;
+}
+
+Napi::Value ExactMatchEntries(const Napi::CallbackInfo& info) {
+  Napi::Env env = info.Env();
+  
+  try {
+    if (info.Length() < 2 || !info[0].IsNumber() || !IsKey(info[1])) {
+      Napi::TypeError::New(env, "Arguments: (handle: number, key: string | Uint8Array, offset?: number, length?: number) expected").ThrowAsJavaScriptException();
+      return env.Null();
+    }
+    
+    std::shared_ptr<DartsDict> dict = GetDictionaryWithTable(env, info[0]);
+    if (!dict) {
+      return env.Null();
+    }
+    KeyBytes key;
+    if (!ReadKey(info, 1, 2, &key)) {
+      return env.Null();
+    }
+    
+    LookupTimer timer(dict->lookup_stats(), LookupKind::kExactMatch);
+    int value = ExactMatch(dict.get(), key.data, key.length);
+    size_t offset = 0;
+    size_t count = 0;
+    if (value < 0 || !dict->value_table()->Find(value, &offset, &count)) {
+      return env.Null();
+    }
+    
+    Napi::Object range = Napi::Object::New(env);
+    range.Set("offset", Napi::Number::New(env, static_cast<double>(offset)));
+    range.Set("count", Napi::Number::New(env, static_cast<double>(count)));
+    return range;
   } catch (const std::exception& e) {
     Napi::Error::New(env, e.what()).ThrowAsJavaScriptException();
     return env.Null();
   }
 }
 
-Napi::Value DestroyDictionary(const Napi::CallbackInfo& info) {
+Napi::Value CommonPrefixSearchEntries(const Napi::CallbackInfo& info) {
   Napi::Env env = info.Env();
   
   try {
-    if (info.Length() < 1 || !info[0].IsNumber()) {
-      Napi::TypeError::New(env, "Number expected").ThrowAsJavaScriptException();
+    if (info.Length() < 2 || !info[0].IsNumber() || !IsKey(info[1])) {
+      Napi::TypeError::New(env, "Arguments: (handle: number, key: string | Uint8Array, offset?: number, length?: number) expected").ThrowAsJavaScriptException();
       return env.Null();
     }
     
-    uint32_t handle = info[0].As<Napi::Number>().Uint32Value();
-    RemoveDictionary(handle);
+    std::shared_ptr<DartsDict> dict = GetDictionaryWithTable(env, info[0]);
+    if (!dict) {
+      return env.Null();
+    }
+    SearchText key;
+    if (!ReadText(info, 1, 2, &key)) {
+      return env.Null();
+    }
     
-    return env.Undefined();
+    LookupTimer timer(dict->lookup_stats(), LookupKind::kCommonPrefix);
+    std::vector<PrefixMatch>& matches = PrefixMatchBuffer();
+    size_t num_matches = PrefixMatchesAt(dict.get(), key, 0, &matches);
+    
+    // (offset, count, length) triples; prefixes whose value has no group are left out
+    std::vector<double> triples;
+    triples.reserve(num_matches * 3);
+    for (size_t i = 0; i < num_matches; i++) {
+      size_t offset = 0;
+      size_t count = 0;
+      if (dict->value_table()->Find(matches[i].value, &offset, &count)) {
+        triples.push_back(static_cast<double>(offset));
+        triples.push_back(static_cast<double>(count));
+        triples.push_back(static_cast<double>(matches[i].length));
+      }
+    }
+    
+    Napi::Float64Array result_array = Napi::Float64Array::New(env, triples.size());
+    std::copy(triples.begin(), triples.end(), result_array.Data());
+    return result_array;
   } catch (const std::exception& e) {
     Napi::Error::New(env, e.what()).ThrowAsJavaScriptException();
     return env.Null();
   }
 }
 
-Napi::Value LoadDictionary(const Napi::CallbackInfo& info) {
+Napi::Value GetValueTable(const Napi::CallbackInfo& info) {
   Napi::Env env = info.Env();
   
   try {
-    if (info.Length() < 2 || !info[0].IsNumber() || !info[1].IsString()) {
-      Napi::TypeError::New(env, "Arguments: (handle: number, filePath: string) expected").ThrowAsJavaScriptException();
+    if (info.Length() < 1 || !info[0].IsNumber()) {
+      Napi::TypeError::New(env, "Arguments: (handle: number) expected").ThrowAsJavaScriptException();
       return env.Null();
     }
     
-    uint32_t handle = info[0].As<Napi::Number>().Uint32Value();
-    std::string filePath = info[1].As<Napi::String>().Utf8Value();
+    std::shared_ptr<DartsDict> dict = GetSharedDictionary(env, info[0].As<Napi::Number>().Uint32Value());
+    if (!dict) {
+      Napi::Error::New(env, "Invalid dictionary handle").ThrowAsJavaScriptException();
+      return env.Null();
+    }
+    const ValueTable* table = dict->value_table();
+    if (!table) {
+      return env.Undefined();
+    }
+    
+    size_t num_fields = table->num_entries() * table->stride();
+    size_t byte_length = num_fields * sizeof(int64_t);
+    Napi::ArrayBuffer buffer;
+    if (byte_length > 0) {
+      // The buffer shares the dictionary's memory and keeps the dictionary alive
+      std::shared_ptr<DartsDict>* owner = new std::shared_ptr<DartsDict>(dict);
+      buffer = Napi::ArrayBuffer::New(
+          env, const_cast<int64_t*>(table->fields()), byte_length,
+          [](Napi::Env, void*, std::shared_ptr<DartsDict>* hint) { delete hint; }, owner);
+      if (env.IsExceptionPending()) {
+        // Runtimes that forbid external buffers get a copy instead
+        env.GetAndClearPendingException();
+        delete owner;
+        buffer = Napi::ArrayBuffer::New(env, byte_length);
+        std::memcpy(buffer.Data(), table->fields(), byte_length);
+      }
+    } else {
+      buffer = Napi::ArrayBuffer::New(env, 0);
+    }
+    
+    Napi::Object result = Napi::Object::New(env);
+    result.Set("stride", Napi::Number::New(env, static_cast<double>(table->stride())));
+    result.Set("entries", Napi::BigInt64Array::New(env, num_fields, buffer, 0, napi_bigint64_array));
+    return result;
+  } catch (const std::exception& e) {
+    Napi::Error::New(env, e.what()).ThrowAsJavaScriptException();
+    return env.Null();
+  }
+}
+
+Napi::Value RestoreKey(const Napi::CallbackInfo& info) {
+  Napi::Env env = info.Env();
+  
+  try {
+    if (info.Length() < 2 || !info[0].IsNumber() || !info[1].IsNumber()) {
+      Napi::TypeError::New(env, "Arguments: (handle: number, value: number) expected").ThrowAsJavaScriptException();
+      return env.Null();
+    }
     
-    DartsDict* dict = GetDictionaryFromHandle(handle);
+    std::shared_ptr<DartsDict> dict = GetSharedDictionary(env, info[0].As<Napi::Number>().Uint32Value());
     if (!dict) {
       Napi::Error::New(env, "Invalid dictionary handle").ThrowAsJavaScriptException();
       return env.Null();
     }
+    const KeyIndex* keys = dict->key_index();
+    if (!keys) {
+      Napi::Error::New(env, "Dictionary has no key index").ThrowAsJavaScriptException();
+      return env.Null();
+    }
     
-    int result = dict->open(filePath.c_str());
-    if (result != 0) {
-      Napi::Error::New(env, "Failed to load dictionary").ThrowAsJavaScriptException();
-      return Napi::Boolean::New(env, false);
+    const char* key = nullptr;
+    size_t length = 0;
+    if (!keys->Find(info[1].As<Napi::Number>().Int32Value(), &key, &length)) {
+      return env.Undefined();
+    }
+    return Napi::String::New(env, key, length);
+  } catch (const std::exception& e) {
+    Napi::Error::New(env, e.what()).ThrowAsJavaScriptException();
+    return env.Null();
+  }
+}
+
+Napi::Value NumKeys(const Napi::CallbackInfo& info) {
+  Napi::Env env = info.Env();
+  
+  try {
+    if (info.Length() < 1 || !info[0].IsNumber()) {
+      Napi::TypeError::New(env, "Number expected").ThrowAsJavaScriptException();
+      return env.Null();
     }
     
-    return Napi::Boolean::New(env, true);
+    DartsDict* dict = GetDictionaryFromHandle(env, info[0].As<Napi::Number>().Uint32Value());
+    if (!dict) {
+      Napi::Error::New(env, "Invalid dictionary handle").ThrowAsJavaScriptException();
+      return env.Null();
+    }
+    return Napi::Number::New(env, static_cast<double>(dict->num_keys()));
   } catch (const std::exception& e) {
     Napi::Error::New(env, e.what()).ThrowAsJavaScriptException();
     return env.Null();
   }
 }
 
-Napi::Value SaveDictionary(const Napi::CallbackInfo& info) {
+Napi::Value PredictiveSearch(const Napi::CallbackInfo& info) {
+  return RunPredictiveSearch(info, false);
+}
+
+Napi::Value PredictiveSearchKeys(const Napi::CallbackInfo& info) {
+  return RunPredictiveSearch(info, true);
+}
+
+Napi::Value Traverse(const Napi::CallbackInfo& info) {
   Napi::Env env = info.Env();
   
   try {
-    if (info.Length() < 2 || !info[0].IsNumber() || !info[1].IsString()) {
-      Napi::TypeError::New(env, "Arguments: (handle: number, filePath: string) expected").ThrowAsJavaScriptException();
+    if (info.Length() < 3 || !info[0].IsNumber() || !IsKey(info[1]) || !info[2].IsFunction()) {
+      Napi::TypeError::New(env, "Arguments: (handle: number, key: string | Uint8Array, callback: function, offset?: number, length?: number) expected").ThrowAsJavaScriptException();
       return env.Null();
     }
     
     uint32_t handle = info[0].As<Napi::Number>().Uint32Value();
-    std::string filePath = info[1].As<Napi::String>().Utf8Value();
+    KeyBytes key;
+    if (!ReadKey(info, 1, 3, &key)) {
+      return env.Null();
+    }
+    Napi::Function callback = info[2].As<Napi::Function>();
     
-    DartsDict* dict = GetDictionaryFromHandle(handle);
+    DartsDict* dict = GetDictionaryFromHandle(env, handle);
     if (!dict) {
       Napi::Error::New(env, "Invalid dictionary handle").ThrowAsJavaScriptException();
       return env.Null();
     }
     
-    int result = dict->save(filePath.c_str());
-    if (result != 0) {
-      Napi::Error::New(env, "Failed to save dictionary").ThrowAsJavaScriptException();
-      return Napi::Boolean::New(env, false);
+    if (key.length == 0) {
+      return env.Undefined();
     }
     
-    return Napi::Boolean::New(env, true);
+    // Darts consumes the whole key in one call, stopping early only when the path ends;
+    // the callback therefore receives a single result for the reached node
+    size_t node_pos = 0;
+    size_t key_pos = 0;
+    int result;
+    {
+      // The callback is left out of the timing
+      LookupTimer timer(dict->lookup_stats(), LookupKind::kTraverse);
+      result = dict->size() == 0 ? -2 : dict->traverse(key.data, node_pos, key_pos, key.length);
+    }
+    
+    // Create result object
+    Napi::Object result_obj = Napi::Object::New(env);
+    result_obj.Set("node", Napi::Number::New(env, static_cast<int>(node_pos)));
+    result_obj.Set("key", Napi::Number::New(env, static_cast<int>(key_pos)));
+    result_obj.Set("value", Napi::Number::New(env, result));
+    
+    // Call the callback function
+    callback.Call({result_obj});
+    
+    return env.Undefined();
   } catch (const std::exception& e) {
     Napi::Error::New(env, e.what()).ThrowAsJavaScriptException();
     return env.Null();
   }
 }
 
-Napi::Value ExactMatchSearch(const Napi::CallbackInfo& info) {
+Napi::Value Size(const Napi::CallbackInfo& info) {
   Napi::Env env = info.Env();
   
   try {
-    if (info.Length() < 2 || !info[0].IsNumber() || !info[1].IsString()) {
-      Napi::TypeError::New(env, "Arguments: (handle: number, key: string) expected").ThrowAsJavaScriptException();
+    if (info.Length() < 1 || !info[0].IsNumber()) {
+      Napi::TypeError::New(env, "Number expected").ThrowAsJavaScriptException();
       return env.Null();
     }
     
     uint32_t handle = info[0].As<Napi::Number>().Uint32Value();
-    std::string key = info[1].As<Napi::String>().Utf8Value();
     
-    DartsDict* dict = GetDictionaryFromHandle(handle);
+    DartsDict* dict = GetDictionaryFromHandle(env, handle);
     if (!dict) {
       Napi::Error::New(env, "Invalid dictionary handle").ThrowAsJavaScriptException();
       return env.Null();
     }
     
-    int result = dict->exactMatchSearch<int>(key.c_str());
-    return Napi::Number::New(env, result);
+    size_t size = dict->size();
+    return Napi::Number::New(env, static_cast<double>(size));
   } catch (const std::exception& e) {
     Napi::Error::New(env, e.what()).ThrowAsJavaScriptException();
     return env.Null();
   }
 }
 
-Napi::Value CommonPrefixSearch(const Napi::CallbackInfo& info) {
+namespace {
+
+const char* HugePagesName(HugePages huge_pages) {
+  switch (huge_pages) {
+    case HugePages::kTransparent:
+      return "transparent";
+    case HugePages::kExplicit:
+      return "explicit";
+    default:
+      return "none";
+  }
+}
+
+Napi::Object LookupCountersToObject(Napi::Env env, const LookupStats::Counters& counters) {
+  Napi::Object result = Napi::Object::New(env);
+  result.Set("calls", Napi::Number::New(env, static_cast<double>(counters.calls)));
+  result.Set("keys", Napi::Number::New(env, static_cast<double>(counters.keys)));
+  result.Set("totalNs", Napi::Number::New(env, static_cast<double>(counters.total_ns)));
+  // Trailing empty buckets are left out
+  size_t num_buckets = LookupStats::kNumBuckets;
+  while (num_buckets > 0 && counters.buckets[num_buckets - 1] == 0) {
+    num_buckets--;
+  }
+  Napi::Float64Array histogram = Napi::Float64Array::New(env, num_buckets);
+  for (size_t i = 0; i < num_buckets; i++) {
+    histogram[i] = static_cast<double>(counters.buckets[i]);
+  }
+  result.Set("histogram", histogram);
+  return result;
+}
+
+}  // namespace
+
+Napi::Value Stats(const Napi::CallbackInfo& info) {
   Napi::Env env = info.Env();
   
   try {
-    if (info.Length() < 2 || !info[0].IsNumber() || !info[1].IsString()) {
-      Napi::TypeError::New(env, "Arguments: (handle: number, key: string) expected").ThrowAsJavaScriptException();
+    if (info.Length() < 1 || !info[0].IsNumber()) {
+      Napi::TypeError::New(env, "Number expected").ThrowAsJavaScriptException();
+      return env.Null();
+    }
+    
+    DartsDict* dict = GetDictionaryFromHandle(env, info[0].As<Napi::Number>().Uint32Value());
+    if (!dict) {
+      Napi::Error::New(env, "Invalid dictionary handle").ThrowAsJavaScriptException();
+      return env.Null();
+    }
+    
+    size_t units = dict->size();
+    size_t nonzero_units = dict->nonzero_size();
+    size_t unit_size = UnitSize(dict->format());
+    const ValueTable* table = dict->value_table();
+    const KeyIndex* keys = dict->key_index();
+    
+    Napi::Object result = Napi::Object::New(env);
+    result.Set("keys", Napi::Number::New(env, static_cast<double>(dict->num_keys())));
+    result.Set("units", Napi::Number::New(env, static_cast<double>(units)));
+    result.Set("nonzeroUnits", Napi::Number::New(env, static_cast<double>(nonzero_units)));
+    result.Set("fillRatio", Napi::Number::New(env, units == 0 ? 0.0 :
+        static_cast<double>(nonzero_units) / static_cast<double>(units)));
+    result.Set("unitFormat", Napi::String::New(env,
+        dict->format() == UnitFormat::kCompact ? "compact" : "darts"));
+    result.Set("unitBytes", Napi::Number::New(env, static_cast<double>(unit_size)));
+    result.Set("arrayBytes", Napi::Number::New(env, static_cast<double>(units * unit_size)));
+    result.Set("valueTableBytes",
+               Napi::Number::New(env, static_cast<double>(table ? table->byte_size() : 0)));
+    result.Set("keyIndexBytes",
+               Napi::Number::New(env, static_cast<double>(keys ? keys->byte_size() : 0)));
+    result.Set("scanTableBytes",
+               Napi::Number::New(env, static_cast<double>(dict->scan_table_bytes())));
+    result.Set("residentBytes", Napi::Number::New(env, static_cast<double>(dict->resident_size())));
+    result.Set("mapped", Napi::Boolean::New(env, dict->mapped()));
+    result.Set("hugePages", Napi::String::New(env, HugePagesName(dict->huge_pages())));
+    result.Set("numaNode", Napi::Number::New(env, dict->numa_node()));
+    result.Set("source", Napi::String::New(env, dict->source()));
+    result.Set("durationMs", Napi::Number::New(env, dict->duration_ms()));
+    
+    const LookupStats* stats = dict->lookup_stats();
+    Napi::Object lookups = Napi::Object::New(env);
+    lookups.Set("enabled", Napi::Boolean::New(env, stats->enabled()));
+    lookups.Set("exactMatch", LookupCountersToObject(env, stats->Get(LookupKind::kExactMatch)));
+    lookups.Set("commonPrefix", LookupCountersToObject(env, stats->Get(LookupKind::kCommonPrefix)));
+    lookups.Set("predictive", LookupCountersToObject(env, stats->Get(LookupKind::kPredictive)));
+    lookups.Set("traverse", LookupCountersToObject(env, stats->Get(LookupKind::kTraverse)));
+    lookups.Set("text", LookupCountersToObject(env, stats->Get(LookupKind::kText)));
+    result.Set("lookups", lookups);
+    return result;
+  } catch (const std::exception& e) {
+    Napi::Error::New(env, e.what()).ThrowAsJavaScriptException();
+    return env.Null();
+  }
+}
+
+Napi::Value SetStatsEnabled(const Napi::CallbackInfo& info) {
+  Napi::Env env = info.Env();
+  
+  try {
+    if (info.Length() < 2 || !info[0].IsNumber() || !info[1].IsBoolean()) {
+      Napi::TypeError::New(env, "Arguments: (handle: number, enabled: boolean) expected").ThrowAsJavaScriptException();
+      return env.Null();
+    }
+    
+    DartsDict* dict = GetDictionaryFromHandle(env, info[0].As<Napi::Number>().Uint32Value());
+    if (!dict) {
+      Napi::Error::New(env, "Invalid dictionary handle").ThrowAsJavaScriptException();
+      return env.Null();
+    }
+    dict->lookup_stats()->set_enabled(info[1].As<Napi::Boolean>().Value());
+    return env.Undefined();
+  } catch (const std::exception& e) {
+    Napi::Error::New(env, e.what()).ThrowAsJavaScriptException();
+    return env.Null();
+  }
+}
+
+Napi::Value ResetStats(const Napi::CallbackInfo& info) {
+  Napi::Env env = info.Env();
+  
+  try {
+    if (info.Length() < 1 || !info[0].IsNumber()) {
+      Napi::TypeError::New(env, "Number expected").ThrowAsJavaScriptException();
+      return env.Null();
+    }
+    
+    DartsDict* dict = GetDictionaryFromHandle(env, info[0].As<Napi::Number>().Uint32Value());
+    if (!dict) {
+      Napi::Error::New(env, "Invalid dictionary handle").ThrowAsJavaScriptException();
+      return env.Null();
+    }
+    dict->lookup_stats()->Reset();
+    return env.Undefined();
+  } catch (const std::exception& e) {
+    Napi::Error::New(env, e.what()).ThrowAsJavaScriptException();
+    return env.Null();
+  }
+}
+
+Napi::Value Tokenize(const Napi::CallbackInfo& info) {
+  Napi::Env env = info.Env();
+  
+  try {
+    if (info.Length() < 2 || !info[0].IsNumber() || !IsKey(info[1]) ||
+        (info.Length() >= 3 && !info[2].IsUndefined() && !info[2].IsString())) {
+      Napi::TypeError::New(env, "Arguments: (handle: number, text: string | Uint8Array, mode?: string, offset?: number, length?: number) expected").ThrowAsJavaScriptException();
       return env.Null();
     }
     
     uint32_t handle = info[0].As<Napi::Number>().Uint32Value();
-    std::string key = info[1].As<Napi::String>().Utf8Value();
+    TokenizeMode mode = TokenizeMode::kLongest;
+    if (info.Length() >= 3 && info[2].IsString() &&
+        !ParseTokenizeMode(info[2].As<Napi::String>().Utf8Value(), &mode)) {
+      Napi::TypeError::New(env, kTokenizeModeUsage).ThrowAsJavaScriptException();
+      return env.Null();
+    }
+    SearchText text;
+    if (!ReadText(info, 1, 3, &text)) {
+      return env.Null();
+    }
     
-    DartsDict* dict = GetDictionaryFromHandle(handle);
+    DartsDict* dict = GetDictionaryFromHandle(env, handle);
     if (!dict) {
       Napi::Error::New(env, "Invalid dictionary handle").ThrowAsJavaScriptException();
       return env.Null();
     }
     
-    // Allow storing up to 100 results
-    const size_t MAX_RESULTS = 100;
-    int results[MAX_RESULTS];
+    LookupTimer timer(dict->lookup_stats(), LookupKind::kText);
+    std::vector<int32_t> tokens;
+    TokenizeText(dict, text, mode, &tokens);
+    
+    Napi::Int32Array result_array = Napi::Int32Array::New(env, tokens.size());
+    std::copy(tokens.begin(), tokens.end(), result_array.Data());
+    return result_array;
+  } catch (const std::exception& e) {
+    Napi::Error::New(env, e.what()).ThrowAsJavaScriptException();
+    return env.Null();
+  }
+}
+
+Napi::Value Scan(const Napi::CallbackInfo& info) {
+  Napi::Env env = info.Env();
+  
+  try {
+    if (info.Length() < 2 || !info[0].IsNumber() || !IsKey(info[1])) {
+      Napi::TypeError::New(env, "Arguments: (handle: number, text: string | Uint8Array, offset?: number, length?: number) expected").ThrowAsJavaScriptException();
+      return env.Null();
+    }
     
-    size_t num_results = dict->commonPrefixSearch<int>(key.c_str(), results, MAX_RESULTS);
+    uint32_t handle = info[0].As<Napi::Number>().Uint32Value();
+    SearchText text;
+    if (!ReadText(info, 1, 2, &text)) {
+      return env.Null();
+    }
     
-    Napi::Array result_array = Napi::Array::New(env, num_results);
-    for (size_t i = 0; i < num_results; i++) {
-      result_array[i] = Napi::Number::New(env, results[i]);
+    DartsDict* dict = GetDictionaryFromHandle(env, handle);
+    if (!dict) {
+      Napi::Error::New(env, "Invalid dictionary handle").ThrowAsJavaScriptException();
+      return env.Null();
     }
     
+    // Computing the links on first use is left out of the timing
+    const ScanTable* scan = dict->scan_table();
+    LookupTimer timer(dict->lookup_stats(), LookupKind::kText);
+    std::vector<int32_t> tokens;
+    if (scan) {
+      ScanText(dict, *scan, text, &tokens);
+    }
+    
+    Napi::Int32Array result_array = Napi::Int32Array::New(env, tokens.size());
+    std::copy(tokens.begin(), tokens.end(), result_array.Data());
     return result_array;
   } catch (const std::exception& e) {
     Napi::Error::New(env, e.what()).ThrowAsJavaScriptException();
@@ -160,83 +1839,100 @@ Napi::Value CommonPrefixSearch(const Napi::CallbackInfo& info) {
   }
 }
 
-Napi::Value Traverse(const Napi::CallbackInfo& info) {
+Napi::Value FindMatches(const Napi::CallbackInfo& info) {
   Napi::Env env = info.Env();
   
   try {
-    if (info.Length() < 3 || !info[0].IsNumber() || !info[1].IsString() || !info[2].IsFunction()) {
-      Napi::TypeError::New(env, "Arguments: (handle: number, key: string, callback: function) expected").ThrowAsJavaScriptException();
+    if (info.Length() < 2 || !info[0].IsNumber() || !info[1].IsString()) {
+      Napi::TypeError::New(env, "Arguments: (handle: number, text: string) expected").ThrowAsJavaScriptException();
       return env.Null();
     }
     
     uint32_t handle = info[0].As<Napi::Number>().Uint32Value();
-    std::string key = info[1].As<Napi::String>().Utf8Value();
-    Napi::Function callback = info[2].As<Napi::Function>();
+    SearchText text;
+    if (!ReadText(info, 1, 2, &text)) {
+      return env.Null();
+    }
     
-    DartsDict* dict = GetDictionaryFromHandle(handle);
+    DartsDict* dict = GetDictionaryFromHandle(env, handle);
     if (!dict) {
       Napi::Error::New(env, "Invalid dictionary handle").ThrowAsJavaScriptException();
       return env.Null();
     }
     
-    // Starting position for traversal
-    size_t node_pos = 0;
-    size_t key_pos = 0;
-    bool continue_traverse = true;
+    LookupTimer timer(dict->lookup_stats(), LookupKind::kText);
+    std::vector<TextMatch> matches = FindLongestMatches(dict, text);
     
-    // Execute traversal for each character in the key
-    while (key_pos < key.length() && continue_traverse) {
-      int result = dict->traverse(key.c_str() + key_pos, node_pos, key_pos);
-      
-      // Create result object
-      Napi::Object result_obj = Napi::Object::New(env);
-      result_obj.Set("node", Napi::Number::New(env, static_cast<int>(node_pos)));
-      result_obj.Set("key", Napi::Number::New(env, static_cast<int>(key_pos)));
-      result_obj.Set("value", Napi::Number::New(env, result));
-      
-      // Call the callback function
-      Napi::Value callback_result = callback.Call({result_obj});
-      
-      // Stop traversal if callback returns false
-      if (callback_result.IsBoolean() && callback_result.As<Napi::Boolean>().Value() == false) {
-        continue_traverse = false;
-      }
-      
-      // Also stop if traversal fails
-      if (result < 0) {
-        continue_traverse = false;
-      }
-      
-      // Move to the next character
-      key_pos++;
+    // Flat (start, length, value) triples in UTF-16 code units
+    Napi::Int32Array result_array = Napi::Int32Array::New(env, matches.size() * 3);
+    for (size_t i = 0; i < matches.size(); i++) {
+      result_array[i * 3] = static_cast<int32_t>(matches[i].begin);
+      result_array[i * 3 + 1] = static_cast<int32_t>(matches[i].length);
+      result_array[i * 3 + 2] = matches[i].value;
     }
     
-    return env.Undefined();
+    return result_array;
   } catch (const std::exception& e) {
     Napi::Error::New(env, e.what()).ThrowAsJavaScriptException();
     return env.Null();
   }
 }
 
-Napi::Value Size(const Napi::CallbackInfo& info) {
+Napi::Value ReplaceWords(const Napi::CallbackInfo& info) {
   Napi::Env env = info.Env();
   
   try {
-    if (info.Length() < 1 || !info[0].IsNumber()) {
-      Napi::TypeError::New(env, "Number expected").ThrowAsJavaScriptException();
+    if (info.Length() < 3 || !info[0].IsNumber() || !info[1].IsString() || !info[2].IsObject()) {
+      Napi::TypeError::New(env, "Arguments: (handle: number, text: string, replacements: object) expected").ThrowAsJavaScriptException();
       return env.Null();
     }
     
     uint32_t handle = info[0].As<Napi::Number>().Uint32Value();
+    // The text is copied rather than read into the shared buffer: looking replacements up
+    // runs JS, which may search again on this thread
+    std::u16string text = info[1].As<Napi::String>().Utf16Value();
+    Napi::Object replacements = info[2].As<Napi::Object>();
     
-    DartsDict* dict = GetDictionaryFromHandle(handle);
+    DartsDict* dict = GetDictionaryFromHandle(env, handle);
     if (!dict) {
       Napi::Error::New(env, "Invalid dictionary handle").ThrowAsJavaScriptException();
       return env.Null();
     }
     
-    size_t size = dict->size();
-    return Napi::Number::New(env, static_cast<double>(size));
+    std::vector<TextMatch> matches;
+    {
+      // Replacements are looked up in JS, which is left out of the timing
+      LookupTimer timer(dict->lookup_stats(), LookupKind::kText);
+      SearchText search;
+      search.units = text.data();
+      search.length = text.length();
+      matches = FindLongestMatches(dict, search);
+    }
+    if (matches.empty()) {
+      return info[1];
+    }
+    
+    std::u16string result;
+    result.reserve(text.length());
+    size_t last = 0;
+    
+    for (const auto& match : matches) {
+      result.append(text, last, match.begin - last);
+      
+      // Words without a (truthy) replacement are kept as they are
+      std::u16string word = text.substr(match.begin, match.length);
+      Napi::Value replacement = replacements.Get(Napi::String::New(env, word));
+      if (replacement.ToBoolean().Value()) {
+        result += replacement.ToString().Utf16Value();
+      } else {
+        result += word;
+      }
+      
+      last = match.begin + match.length;
+    }
+    result.append(text, last, std::string::npos);
+    
+    return Napi::String::New(env, result);
   } catch (const std::exception& e) {
     Napi::Error::New(env, e.what()).ThrowAsJavaScriptException();
     return env.Null();
@@ -12,12 +12,37 @@ namespace node_darts {
 
 Napi::Value CreateDictionary(const Napi::CallbackInfo& info);
 Napi::Value DestroyDictionary(const Napi::CallbackInfo& info);
+Napi::Value ShareDictionary(const Napi::CallbackInfo& info);
+Napi::Value AttachDictionary(const Napi::CallbackInfo& info);
+Napi::Value SwapDictionaries(const Napi::CallbackInfo& info);
 Napi::Value LoadDictionary(const Napi::CallbackInfo& info);
 Napi::Value SaveDictionary(const Napi::CallbackInfo& info);
+Napi::Value LoadDictionaryAsync(const Napi::CallbackInfo& info);
+Napi::Value SaveDictionaryAsync(const Napi::CallbackInfo& info);
+Napi::Value SaveDictionaryToBuffer(const Napi::CallbackInfo& info);
+Napi::Value LoadDictionaryFromBuffer(const Napi::CallbackInfo& info);
 Napi::Value ExactMatchSearch(const Napi::CallbackInfo& info);
+Napi::Value ExactMatchSearchBatch(const Napi::CallbackInfo& info);
+Napi::Value ExactMatchSearchBuffer(const Napi::CallbackInfo& info);
 Napi::Value CommonPrefixSearch(const Napi::CallbackInfo& info);
+Napi::Value CommonPrefixSearchPairs(const Napi::CallbackInfo& info);
+Napi::Value CommonPrefixSearchInto(const Napi::CallbackInfo& info);
+Napi::Value ExactMatchEntries(const Napi::CallbackInfo& info);
+Napi::Value CommonPrefixSearchEntries(const Napi::CallbackInfo& info);
+Napi::Value GetValueTable(const Napi::CallbackInfo& info);
+Napi::Value RestoreKey(const Napi::CallbackInfo& info);
+Napi::Value NumKeys(const Napi::CallbackInfo& info);
+Napi::Value PredictiveSearch(const Napi::CallbackInfo& info);
+Napi::Value PredictiveSearchKeys(const Napi::CallbackInfo& info);
 Napi::Value Traverse(const Napi::CallbackInfo& info);
 Napi::Value Size(const Napi::CallbackInfo& info);
+Napi::Value Stats(const Napi::CallbackInfo& info);
+Napi::Value SetStatsEnabled(const Napi::CallbackInfo& info);
+Napi::Value ResetStats(const Napi::CallbackInfo& info);
+Napi::Value Tokenize(const Napi::CallbackInfo& info);
+Napi::Value Scan(const Napi::CallbackInfo& info);
+Napi::Value FindMatches(const Napi::CallbackInfo& info);
+Napi::Value ReplaceWords(const Napi::CallbackInfo& info);
 
 }  // namespace node_darts
 
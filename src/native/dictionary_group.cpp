@@ -0,0 +1,189 @@
+#include "dictionary_group.h"
+#include <algorithm>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace node_darts {
+
+namespace {
+
+// Reads a string argument; throws a TypeError and returns false otherwise
+bool ReadStringArgument(const Napi::CallbackInfo& info, const char* usage, std::string* value) {
+  if (info.Length() < 1 || !info[0].IsString()) {
+    Napi::TypeError::New(info.Env(), usage).ThrowAsJavaScriptException();
+    return false;
+  }
+  *value = info[0].As<Napi::String>().Utf8Value();
+  return true;
+}
+
+// Same, for text read as UTF-16
+bool ReadTextArgument(const Napi::CallbackInfo& info, const char* usage, std::u16string* text) {
+  if (info.Length() < 1 || !info[0].IsString()) {
+    Napi::TypeError::New(info.Env(), usage).ThrowAsJavaScriptException();
+    return false;
+  }
+  *text = info[0].As<Napi::String>().Utf16Value();
+  return true;
+}
+
+Napi::Int32Array ToInt32Array(Napi::Env env, const std::vector<int32_t>& values) {
+  Napi::Int32Array result_array = Napi::Int32Array::New(env, values.size());
+  std::copy(values.begin(), values.end(), result_array.Data());
+  return result_array;
+}
+
+}  // namespace
+
+void DictionaryGroup::Init(Napi::Env env) {
+  Napi::Function func = DefineClass(env, "DictionaryGroup", {
+    InstanceMethod("exactMatchSearch", &DictionaryGroup::ExactMatchSearch),
+    InstanceMethod("commonPrefixSearch", &DictionaryGroup::CommonPrefixSearch),
+    InstanceMethod("tokenize", &DictionaryGroup::Tokenize),
+    InstanceAccessor("size", &DictionaryGroup::GetSize, nullptr),
+  });
+
+  // The constructor is not exported; groups are only created through createDictionaryGroup
+  GetAddonData(env)->dictionary_group_constructor = Napi::Persistent(func);
+}
+
+Napi::Value DictionaryGroup::New(Napi::Env env, std::unique_ptr<DictGroup> group) {
+  Napi::Object obj = GetAddonData(env)->dictionary_group_constructor.New({});
+  Unwrap(obj)->group_ = std::move(group);
+  return obj;
+}
+
+DictionaryGroup::DictionaryGroup(const Napi::CallbackInfo& info)
+    : Napi::ObjectWrap<DictionaryGroup>(info) {}
+
+Napi::Value DictionaryGroup::ExactMatchSearch(const Napi::CallbackInfo& info) {
+  Napi::Env env = info.Env();
+
+  try {
+    std::string key;
+    if (!ReadStringArgument(info, "Argument: (key: string) expected", &key)) {
+      return env.Null();
+    }
+
+    std::vector<int32_t> pairs;
+    group_->ExactMatch(key, &pairs);
+    return ToInt32Array(env, pairs);
+  } catch (const std::exception& e) {
+    Napi::Error::New(env, e.what()).ThrowAsJavaScriptException();
+    return env.Null();
+  }
+}
+
+Napi::Value DictionaryGroup::CommonPrefixSearch(const Napi::CallbackInfo& info) {
+  Napi::Env env = info.Env();
+
+  try {
+    std::u16string key;
+    if (!ReadTextArgument(info, "Argument: (key: string) expected", &key)) {
+      return env.Null();
+    }
+
+    std::vector<GroupMatch> matches;
+    group_->PrefixMatches(key.data(), key.length(), &matches);
+
+    // (source, value, length) triples
+    Napi::Int32Array result_array = Napi::Int32Array::New(env, matches.size() * 3);
+    int32_t* out = result_array.Data();
+    for (size_t i = 0; i < matches.size(); i++) {
+      out[i * 3] = matches[i].source;
+      out[i * 3 + 1] = matches[i].value;
+      out[i * 3 + 2] = static_cast<int32_t>(matches[i].length);
+    }
+    return result_array;
+  } catch (const std::exception& e) {
+    Napi::Error::New(env, e.what()).ThrowAsJavaScriptException();
+    return env.Null();
+  }
+}
+
+Napi::Value DictionaryGroup::Tokenize(const Napi::CallbackInfo& info) {
+  Napi::Env env = info.Env();
+
+  try {
+    const char* usage = "Arguments: (text: string, mode?: string) expected";
+    std::u16string text;
+    if (!ReadTextArgument(info, usage, &text)) {
+      return env.Null();
+    }
+    if (info.Length() >= 2 && !info[1].IsUndefined() && !info[1].IsString()) {
+      Napi::TypeError::New(env, usage).ThrowAsJavaScriptException();
+      return env.Null();
+    }
+    TokenizeMode mode = TokenizeMode::kLongest;
+    if (info.Length() >= 2 && info[1].IsString() &&
+        !ParseTokenizeMode(info[1].As<Napi::String>().Utf8Value(), &mode)) {
+      Napi::TypeError::New(env, kTokenizeModeUsage).ThrowAsJavaScriptException();
+      return env.Null();
+    }
+
+    std::vector<int32_t> tokens;
+    group_->Tokenize(text.data(), text.length(), mode, &tokens);
+    return ToInt32Array(env, tokens);
+  } catch (const std::exception& e) {
+    Napi::Error::New(env, e.what()).ThrowAsJavaScriptException();
+    return env.Null();
+  }
+}
+
+Napi::Value DictionaryGroup::GetSize(const Napi::CallbackInfo& info) {
+  return Napi::Number::New(info.Env(), static_cast<double>(group_->size()));
+}
+
+Napi::Value CreateDictionaryGroup(const Napi::CallbackInfo& info) {
+  Napi::Env env = info.Env();
+
+  try {
+    const char* usage = "Arguments: (handles: number[], options?: object) expected";
+    if (info.Length() < 1 || !info[0].IsArray()) {
+      Napi::TypeError::New(env, usage).ThrowAsJavaScriptException();
+      return env.Null();
+    }
+    Napi::Array handles = info[0].As<Napi::Array>();
+    if (handles.Length() == 0) {
+      Napi::Error::New(env, "A dictionary group needs at least one dictionary").ThrowAsJavaScriptException();
+      return env.Null();
+    }
+
+    // Each member is shared, so that the group keeps reading it whatever becomes of its handle
+    std::vector<std::shared_ptr<DartsDict>> members;
+    for (uint32_t i = 0; i < handles.Length(); i++) {
+      Napi::Value handle = handles.Get(i);
+      if (!handle.IsNumber()) {
+        Napi::TypeError::New(env, usage).ThrowAsJavaScriptException();
+        return env.Null();
+      }
+      std::shared_ptr<DartsDict> dict =
+          GetSharedDictionary(env, handle.As<Napi::Number>().Uint32Value());
+      if (!dict) {
+        Napi::Error::New(env, "Invalid dictionary handle").ThrowAsJavaScriptException();
+        return env.Null();
+      }
+      members.push_back(std::move(dict));
+    }
+
+    bool keep_duplicates = false;
+    if (info.Length() >= 2 && info[1].IsObject()) {
+      Napi::Value duplicates = info[1].As<Napi::Object>().Get("duplicates");
+      std::string name = duplicates.IsString() ? duplicates.As<Napi::String>().Utf8Value() : "";
+      if (!duplicates.IsUndefined() && name != "first" && name != "all") {
+        Napi::TypeError::New(env, "duplicates must be 'first' or 'all'").ThrowAsJavaScriptException();
+        return env.Null();
+      }
+      keep_duplicates = name == "all";
+    }
+
+    return DictionaryGroup::New(
+        env, std::unique_ptr<DictGroup>(new DictGroup(std::move(members), keep_duplicates)));
+  } catch (const std::exception& e) {
+    Napi::Error::New(env, e.what()).ThrowAsJavaScriptException();
+    return env.Null();
+  }
+}
+
+}  // namespace node_darts
@@ -0,0 +1,37 @@
+#ifndef DARTS_DICTIONARY_GROUP_H_
+#define DARTS_DICTIONARY_GROUP_H_
+
+// Include standard library header files first
+#include <cstdint>
+#include <cstddef>
+#include <memory>
+
+#include <napi.h>
+#include "common.h"
+#include "dict_group.h"
+
+namespace node_darts {
+
+// Several dictionaries searched in one native call, each result tagged with the index of
+// the member it comes from, see DictGroup
+class DictionaryGroup : public Napi::ObjectWrap<DictionaryGroup> {
+ public:
+  static void Init(Napi::Env env);
+  static Napi::Value New(Napi::Env env, std::unique_ptr<DictGroup> group);
+
+  explicit DictionaryGroup(const Napi::CallbackInfo& info);
+
+ private:
+  Napi::Value ExactMatchSearch(const Napi::CallbackInfo& info);
+  Napi::Value CommonPrefixSearch(const Napi::CallbackInfo& info);
+  Napi::Value Tokenize(const Napi::CallbackInfo& info);
+  Napi::Value GetSize(const Napi::CallbackInfo& info);
+
+  std::unique_ptr<DictGroup> group_;
+};
+
+Napi::Value CreateDictionaryGroup(const Napi::CallbackInfo& info);
+
+}  // namespace node_darts
+
+#endif  // DARTS_DICTIONARY_GROUP_H_
@@ -0,0 +1,261 @@
+#include "file_format.h"
+
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <utility>
+
+#include "compressed_file.h"
+#include "key_index.h"
+#include "scan_table.h"
+#include "value_table.h"
+
+namespace node_darts {
+
+namespace {
+
+const char kFileMagic[8] = {'D', 'A', 'R', 'T', 'S', 'D', 'I', 'C'};
+const char kTableMagic[8] = {'D', 'A', 'R', 'T', 'S', 'V', 'A', 'L'};
+const char kKeysMagic[8] = {'D', 'A', 'R', 'T', 'S', 'K', 'E', 'Y'};
+const char kScanMagic[8] = {'D', 'A', 'R', 'T', 'S', 'A', 'C', 'M'};
+
+// Compact arrays are made of whole blocks, which keeps every child lookup in bounds
+const size_t kCompactBlockSize = 256;
+
+// Table for the reflected CRC-32 polynomial used by zlib
+class Crc32Table {
+ public:
+  Crc32Table() {
+    for (uint32_t i = 0; i < 256; i++) {
+      uint32_t crc = i;
+      for (int bit = 0; bit < 8; bit++) {
+        crc = (crc & 1) ? (crc >> 1) ^ 0xEDB88320u : crc >> 1;
+      }
+      entries_[i] = crc;
+    }
+  }
+
+  uint32_t operator[](size_t i) const { return entries_[i]; }
+
+ private:
+  uint32_t entries_[256];
+};
+
+std::string FileError(const char* message) {
+  return std::string(message) + ": " + std::strerror(errno);
+}
+
+// Finds the sections from offset to the end of the data
+bool ParseSections(const char* data, size_t offset, size_t size, FileLayout* layout,
+                   std::string* error) {
+  while (offset < size) {
+    SectionHeader header;
+    if (size - offset < sizeof(header)) {
+      *error = "Dictionary file size does not match its header";
+      return false;
+    }
+    std::memcpy(&header, data + offset, sizeof(header));
+    offset += sizeof(header);
+    if (header.size > size - offset || header.size % 8 != 0) {
+      *error = "Dictionary file size does not match its header";
+      return false;
+    }
+
+    FileSection* section = nullptr;
+    if (std::memcmp(header.magic, kTableMagic, sizeof(kTableMagic)) == 0) {
+      section = &layout->table;
+    } else if (std::memcmp(header.magic, kKeysMagic, sizeof(kKeysMagic)) == 0) {
+      section = &layout->keys;
+    } else if (std::memcmp(header.magic, kScanMagic, sizeof(kScanMagic)) == 0) {
+      section = &layout->scan;
+    }
+    // Each section may appear once
+    if (!section || section->offset != 0) {
+      *error = "Invalid dictionary file section";
+      return false;
+    }
+    section->offset = offset;
+    section->size = static_cast<size_t>(header.size);
+    offset += section->size;
+  }
+  return true;
+}
+
+bool WriteSection(ByteWriter* out, const char* magic, size_t size) {
+  SectionHeader header;
+  std::memcpy(header.magic, magic, sizeof(header.magic));
+  header.size = size;
+  return out->Write(&header, sizeof(header));
+}
+
+// Bytes WriteDictionary writes
+size_t DictionarySize(UnitFormat format, size_t num_units, const ValueTable* table,
+                      const KeyIndex* keys, const ScanTable* scan) {
+  return sizeof(FileHeader) + num_units * UnitSize(format) +
+         (table ? sizeof(SectionHeader) + table->byte_size() : 0) +
+         (keys ? sizeof(SectionHeader) + keys->byte_size() : 0) +
+         (scan ? sizeof(SectionHeader) + scan->byte_size() : 0);
+}
+
+// Writes the header followed by the units and the sections
+bool WriteDictionary(ByteWriter* out, UnitFormat format, size_t num_keys, const void* units,
+                     size_t num_units, const ValueTable* table, const KeyIndex* keys,
+                     const ScanTable* scan) {
+  size_t units_size = num_units * UnitSize(format);
+
+  FileHeader header;
+  std::memset(&header, 0, sizeof(header));
+  std::memcpy(header.magic, kFileMagic, sizeof(kFileMagic));
+  header.version = kFileVersion;
+  header.unit_format = static_cast<uint32_t>(format);
+  header.num_keys = num_keys;
+  header.num_units = num_units;
+  header.checksum = Crc32(units, units_size);
+  header.header_size = sizeof(header);
+
+  return out->Write(&header, sizeof(header)) && out->Write(units, units_size) &&
+         (!table || (WriteSection(out, kTableMagic, table->byte_size()) && table->Write(out))) &&
+         (!keys || (WriteSection(out, kKeysMagic, keys->byte_size()) && keys->Write(out))) &&
+         (!scan || (WriteSection(out, kScanMagic, scan->byte_size()) && scan->Write(out)));
+}
+
+}  // namespace
+
+size_t UnitSize(UnitFormat format) {
+  return format == UnitFormat::kCompact ? 4 : 8;
+}
+
+uint32_t Crc32(const void* data, size_t size, uint32_t crc) {
+  static const Crc32Table table;
+  const unsigned char* bytes = static_cast<const unsigned char*>(data);
+  crc ^= 0xFFFFFFFFu;
+  for (size_t i = 0; i < size; i++) {
+    crc = table[(crc ^ bytes[i]) & 0xFF] ^ (crc >> 8);
+  }
+  return crc ^ 0xFFFFFFFFu;
+}
+
+bool ParseDictionaryFile(const void* data, size_t size, bool verify, FileLayout* layout,
+                         std::string* error) {
+  if (size < sizeof(FileHeader) || std::memcmp(data, kFileMagic, sizeof(kFileMagic)) != 0) {
+    // A headerless Darts array, as written by Darts itself and by older versions
+    if (size == 0 || size % UnitSize(UnitFormat::kDarts) != 0) {
+      *error = "Invalid dictionary file";
+      return false;
+    }
+    layout->format = UnitFormat::kDarts;
+    layout->offset = 0;
+    layout->num_units = size / UnitSize(UnitFormat::kDarts);
+    layout->num_keys = 0;
+    layout->table = FileSection();
+    layout->keys = FileSection();
+    layout->scan = FileSection();
+    return true;
+  }
+
+  FileHeader header;
+  std::memcpy(&header, data, sizeof(header));
+  if (header.version != kFileVersion) {
+    *error = "Unsupported dictionary file version " + std::to_string(header.version);
+    return false;
+  }
+  if (header.unit_format != static_cast<uint32_t>(UnitFormat::kDarts) &&
+      header.unit_format != static_cast<uint32_t>(UnitFormat::kCompact)) {
+    *error = "Unsupported unit format " + std::to_string(header.unit_format);
+    return false;
+  }
+  UnitFormat format = static_cast<UnitFormat>(header.unit_format);
+
+  // Units stay aligned when the file is mapped
+  if (header.header_size < sizeof(FileHeader) || header.header_size % 8 != 0 ||
+      header.header_size > size) {
+    *error = "Invalid dictionary file header";
+    return false;
+  }
+  size_t available = size - header.header_size;
+  if (header.num_units == 0 || header.num_units > available / UnitSize(format)) {
+    *error = "Dictionary file size does not match its header";
+    return false;
+  }
+  size_t units_size = static_cast<size_t>(header.num_units) * UnitSize(format);
+  if (format == UnitFormat::kCompact && header.num_units % kCompactBlockSize != 0) {
+    *error = "Invalid dictionary file header";
+    return false;
+  }
+
+  if (verify &&
+      Crc32(static_cast<const char*>(data) + header.header_size, units_size) != header.checksum) {
+    *error = "Dictionary file checksum mismatch";
+    return false;
+  }
+
+  layout->format = format;
+  layout->offset = header.header_size;
+  layout->num_units = static_cast<size_t>(header.num_units);
+  layout->num_keys = static_cast<size_t>(header.num_keys);
+  // The caller parses the sections themselves
+  layout->table = FileSection();
+  layout->keys = FileSection();
+  layout->scan = FileSection();
+  return ParseSections(static_cast<const char*>(data), header.header_size + units_size, size,
+                       layout, error);
+}
+
+bool ByteWriter::Write(const void* data, size_t size) {
+  if (size == 0) {
+    return true;
+  }
+  if (file_) {
+    return std::fwrite(data, 1, size, file_) == size;
+  }
+  const char* bytes = static_cast<const char*>(data);
+  bytes_->insert(bytes_->end(), bytes, bytes + size);
+  return true;
+}
+
+bool SerializeDictionary(UnitFormat format, size_t num_keys, const void* units,
+                         size_t num_units, const ValueTable* table, const KeyIndex* keys,
+                         const ScanTable* scan, int compression_level,
+                         std::vector<char>* bytes, std::string* error) {
+  std::vector<char> plain;
+  plain.reserve(DictionarySize(format, num_units, table, keys, scan));
+  ByteWriter writer(&plain);
+  // Writing to memory only fails by throwing
+  WriteDictionary(&writer, format, num_keys, units, num_units, table, keys, scan);
+  if (compression_level == 0) {
+    *bytes = std::move(plain);
+    return true;
+  }
+  return CompressDictionaryFile(plain.data(), plain.size(), compression_level, bytes, error);
+}
+
+bool WriteDictionaryFile(const char* path, UnitFormat format, size_t num_keys,
+                         const void* units, size_t num_units, const ValueTable* table,
+                         const KeyIndex* keys, const ScanTable* scan, std::string* error,
+                         int compression_level) {
+  // A compressed file is made in memory first; a plain one is written as it is serialized
+  std::vector<char> compressed;
+  if (compression_level > 0 &&
+      !SerializeDictionary(format, num_keys, units, num_units, table, keys, scan,
+                           compression_level, &compressed, error)) {
+    return false;
+  }
+
+  FILE* file = std::fopen(path, "wb");
+  if (!file) {
+    *error = FileError("Failed to open dictionary file");
+    return false;
+  }
+  ByteWriter writer(file);
+  bool written = compression_level > 0
+                     ? writer.Write(compressed.data(), compressed.size())
+                     : WriteDictionary(&writer, format, num_keys, units, num_units, table, keys,
+                                       scan);
+  if (std::fclose(file) != 0 || !written) {
+    *error = FileError("Failed to write dictionary file");
+    return false;
+  }
+  return true;
+}
+
+}  // namespace node_darts
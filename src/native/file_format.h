@@ -0,0 +1,115 @@
+#ifndef DARTS_FILE_FORMAT_H_
+#define DARTS_FILE_FORMAT_H_
+
+// Include standard library header files first
+#include <cstdint>
+#include <cstddef>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+namespace node_darts {
+
+class KeyIndex;
+class ScanTable;
+class ValueTable;
+
+// Layout of the units of a Double-Array
+enum class UnitFormat : uint32_t {
+  // Darts 0.32: { int base; unsigned check; }, 8 bytes per unit
+  kDarts = 0,
+  // darts-clone style: label, leaf flag and offset (or value) packed into 4 bytes
+  kCompact = 1,
+};
+
+size_t UnitSize(UnitFormat format);
+
+// Header written in front of the units of a saved dictionary.
+// Files written before the header existed are raw Darts arrays; they are told apart
+// by the magic, which a Darts array cannot start with (its root unit is { 1, 0 }).
+// Fields are stored in the byte order of the machine, like the units themselves.
+// Optional sections, such as a value table, follow the units.
+struct FileHeader {
+  char magic[8];
+  uint32_t version;
+  uint32_t unit_format;
+  uint64_t num_keys;
+  uint64_t num_units;
+  // CRC-32 of the units
+  uint32_t checksum;
+  uint32_t header_size;
+};
+
+const uint32_t kFileVersion = 1;
+
+// Header of a section following the units; size bytes of data follow it.
+// Sizes are multiples of 8, so that every section stays aligned when the file is mapped.
+struct SectionHeader {
+  char magic[8];
+  uint64_t size;
+};
+
+// Where a section of a serialized dictionary is; size is 0 if the file has no such section
+struct FileSection {
+  size_t offset = 0;
+  size_t size = 0;
+};
+
+// Where the units and sections of a serialized dictionary are
+struct FileLayout {
+  UnitFormat format = UnitFormat::kDarts;
+  size_t offset = 0;
+  size_t num_units = 0;
+  // 0 when unknown, as for headerless files
+  size_t num_keys = 0;
+  // Serialized ValueTable
+  FileSection table;
+  // Serialized KeyIndex
+  FileSection keys;
+  // Serialized ScanTable
+  FileSection scan;
+};
+
+// CRC-32 as computed by zlib; pass the previous result to continue over another buffer
+uint32_t Crc32(const void* data, size_t size, uint32_t crc = 0);
+
+// Reads the header of a serialized dictionary, falling back to a headerless Darts array.
+// The header is checked against the data size, so truncated and foreign files are rejected
+// in constant time; verify also checks the units against the checksum.
+// Returns false and sets error if the data is not a valid dictionary.
+bool ParseDictionaryFile(const void* data, size_t size, bool verify, FileLayout* layout,
+                         std::string* error);
+
+// Where a dictionary is serialized to: a file, or memory that grows as it is written
+class ByteWriter {
+ public:
+  explicit ByteWriter(FILE* file) : file_(file) {}
+  explicit ByteWriter(std::vector<char>* bytes) : bytes_(bytes) {}
+
+  // Returns false if the file could not be written
+  bool Write(const void* data, size_t size);
+
+ private:
+  FILE* file_ = nullptr;
+  std::vector<char>* bytes_ = nullptr;
+};
+
+// Serializes a dictionary into bytes: the header followed by the units, the value table,
+// the key index and the scan table, if any. A compression_level from 1 to 9 makes it a
+// compressed dictionary file holding them instead (see CompressedHeader).
+// Returns false and sets error on failure.
+bool SerializeDictionary(UnitFormat format, size_t num_keys, const void* units,
+                         size_t num_units, const ValueTable* table, const KeyIndex* keys,
+                         const ScanTable* scan, int compression_level,
+                         std::vector<char>* bytes, std::string* error);
+
+// Writes a dictionary file, as serialized by SerializeDictionary.
+// Returns false and sets error on failure.
+bool WriteDictionaryFile(const char* path, UnitFormat format, size_t num_keys,
+                         const void* units, size_t num_units, const ValueTable* table,
+                         const KeyIndex* keys, const ScanTable* scan, std::string* error,
+                         int compression_level = 0);
+
+}  // namespace node_darts
+
+#endif  // DARTS_FILE_FORMAT_H_
@@ -0,0 +1,325 @@
+#include "key_arena.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <numeric>
+#include <queue>
+
+namespace node_darts {
+
+namespace {
+
+// Spilled record header; the key bytes follow
+struct RunRecordHeader {
+  uint32_t length;
+  int32_t value;
+};
+
+std::string FileError(const char* message) {
+  return std::string(message) + ": " + std::strerror(errno);
+}
+
+// Sequential reader over one spilled run
+class RunReader {
+ public:
+  explicit RunReader(FILE* file) : file_(file) {}
+
+  // Reads the next record, returning false at the end of the run or on error
+  bool Next(std::string* error) {
+    RunRecordHeader header;
+    if (std::fread(&header, sizeof(header), 1, file_) != 1) {
+      if (std::ferror(file_)) {
+        *error = FileError("Failed to read temporary file");
+      }
+      return false;
+    }
+    key_.resize(header.length);
+    if (header.length > 0 && std::fread(&key_[0], 1, header.length, file_) != header.length) {
+      *error = FileError("Failed to read temporary file");
+      return false;
+    }
+    value_ = header.value;
+    return true;
+  }
+
+  const std::string& key() const { return key_; }
+  int value() const { return value_; }
+
+ private:
+  FILE* file_;
+  std::string key_;
+  int value_ = 0;
+};
+
+// Darts reports progress through a plain function pointer, so the monitor of the build
+// running on this thread is kept here
+thread_local BuildMonitor* current_monitor = nullptr;
+
+// Thrown out of the progress callback to unwind a cancelled build
+struct BuildCancelled {};
+
+int ReportProgress(size_t current, size_t total) {
+  if (!current_monitor->OnProgress(current, total)) {
+    throw BuildCancelled();
+  }
+  return 0;
+}
+
+// Installs a monitor for the duration of one build
+class MonitorScope {
+ public:
+  explicit MonitorScope(BuildMonitor* monitor) : previous_(current_monitor) {
+    current_monitor = monitor;
+  }
+  ~MonitorScope() { current_monitor = previous_; }
+
+ private:
+  BuildMonitor* previous_;
+};
+
+}  // namespace
+
+void KeyArena::Add(const char* key, size_t length, int value) {
+  if (length > 0) {
+    std::memcpy(BeginKey(length), key, length);
+  } else {
+    BeginKey(0);
+  }
+  EndKey(length, value);
+}
+
+char* KeyArena::BeginKey(size_t length) {
+  size_t offset = bytes_.size();
+  bytes_.resize(offset + length + 1);
+  return bytes_.data() + offset;
+}
+
+void KeyArena::EndKey(size_t length, int value) {
+  // Drop the room left for the terminator
+  size_t offset = bytes_.size() - length - 1;
+  bytes_.resize(offset + length);
+
+  offsets_.push_back(offset);
+  lengths_.push_back(length);
+  values_.push_back(value);
+
+  if (sorted_unique_ && size() > 1 && Compare(size() - 2, size() - 1) >= 0) {
+    sorted_unique_ = false;
+  }
+}
+
+void KeyArena::Reserve(size_t num_keys, size_t num_bytes) {
+  offsets_.reserve(num_keys);
+  lengths_.reserve(num_keys);
+  values_.reserve(num_keys);
+  bytes_.reserve(num_bytes);
+}
+
+void KeyArena::Clear() {
+  // Release the memory as well; the arena is reused for the next run
+  std::vector<char>().swap(bytes_);
+  std::vector<size_t>().swap(offsets_);
+  std::vector<size_t>().swap(lengths_);
+  std::vector<int>().swap(values_);
+  sorted_unique_ = true;
+}
+
+int KeyArena::Compare(size_t a, size_t b) const {
+  // Byte order, as Darts requires
+  size_t length = std::min(lengths_[a], lengths_[b]);
+  int result = length > 0 ? std::memcmp(key(a), key(b), length) : 0;
+  if (result != 0) {
+    return result;
+  }
+  return lengths_[a] < lengths_[b] ? -1 : (lengths_[a] > lengths_[b] ? 1 : 0);
+}
+
+std::vector<size_t> KeyArena::SortedUniqueOrder() const {
+  std::vector<size_t> order(size());
+  std::iota(order.begin(), order.end(), 0);
+  if (sorted_unique_) {
+    return order;
+  }
+
+  // Stable, so that the first occurrence of a duplicate key comes first and is kept
+  std::stable_sort(order.begin(), order.end(), [this](size_t a, size_t b) {
+    return Compare(a, b) < 0;
+  });
+  auto last = std::unique(order.begin(), order.end(), [this](size_t a, size_t b) {
+    return Compare(a, b) == 0;
+  });
+  order.erase(last, order.end());
+  return order;
+}
+
+std::unique_ptr<DartsDict> KeyArena::Build(std::string* error, BuildMonitor* monitor,
+                                           const ArrayBuildOptions& options) const {
+  std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+  std::vector<size_t> order = SortedUniqueOrder();
+  size_t num_keys = order.size();
+  if (num_keys == 0) {
+    *error = "Empty keys array";
+    return nullptr;
+  }
+
+  std::vector<const char*> key_ptrs(num_keys);
+  std::vector<size_t> lengths(num_keys);
+  std::vector<int> values(num_keys);
+  for (size_t i = 0; i < num_keys; i++) {
+    key_ptrs[i] = key(order[i]);
+    lengths[i] = length(order[i]);
+    values[i] = value(order[i]) == kAutoValue ? static_cast<int>(i) : value(order[i]);
+  }
+
+  std::unique_ptr<DartsDict> dict;
+  if (options.format == UnitFormat::kCompact) {
+    std::vector<CompactArray::Unit> units;
+    if (!BuildCompactArray(num_keys, key_ptrs.data(), lengths.data(), values.data(), monitor,
+                           &units, error)) {
+      return nullptr;
+    }
+    dict.reset(new DartsDict());
+    dict->attach(std::unique_ptr<ArrayStorage>(new CompactUnitStorage(std::move(units))),
+                 UnitFormat::kCompact, num_keys);
+  } else if (options.threads != 1 || options.placement != Placement::kScan) {
+    // Anything but a sequential scan needs our own builder
+    dict = BuildDoubleArray(num_keys, key_ptrs.data(), lengths.data(), values.data(), options,
+                            monitor, error);
+  } else {
+    dict.reset(new DartsDict());
+    int result;
+    try {
+      MonitorScope scope(monitor);
+      result = dict->build(num_keys, key_ptrs.data(), lengths.data(), values.data(),
+                           monitor ? ReportProgress : nullptr);
+    } catch (const BuildCancelled&) {
+      // Unwinding leaves the partial array to the dictionary, which frees it
+      *error = "Build cancelled";
+      return nullptr;
+    }
+    if (result != 0) {
+      *error = "Failed to build dictionary";
+      return nullptr;
+    }
+  }
+
+  if (dict && options.key_index) {
+    dict->set_key_index(KeyIndex::Build(num_keys, key_ptrs.data(), lengths.data(), values.data()));
+  }
+  if (dict && options.scan_table) {
+    dict->build_scan_table();
+  }
+  if (dict) {
+    dict->set_origin("build", MillisecondsSince(start));
+  }
+  return dict;
+}
+
+ExternalKeySorter::ExternalKeySorter(size_t memory_limit) : memory_limit_(memory_limit) {}
+
+ExternalKeySorter::~ExternalKeySorter() {
+  for (FILE* run : runs_) {
+    std::fclose(run);
+  }
+}
+
+bool ExternalKeySorter::Add(const char* key, size_t length, int value, std::string* error) {
+  arena_.Add(key, length, value);
+  num_keys_++;
+  if (arena_.byte_size() >= memory_limit_) {
+    return SpillRun(error);
+  }
+  return true;
+}
+
+bool ExternalKeySorter::SpillRun(std::string* error) {
+  FILE* run = std::tmpfile();
+  if (!run) {
+    *error = FileError("Failed to create temporary file");
+    return false;
+  }
+  runs_.push_back(run);
+
+  std::vector<size_t> order = arena_.SortedUniqueOrder();
+  for (size_t index : order) {
+    RunRecordHeader header;
+    header.length = static_cast<uint32_t>(arena_.length(index));
+    header.value = arena_.value(index);
+    if (std::fwrite(&header, sizeof(header), 1, run) != 1 ||
+        std::fwrite(arena_.key(index), 1, header.length, run) != header.length) {
+      *error = FileError("Failed to write temporary file");
+      return false;
+    }
+  }
+  if (std::fflush(run) != 0 || std::fseek(run, 0, SEEK_SET) != 0) {
+    *error = FileError("Failed to write temporary file");
+    return false;
+  }
+
+  arena_.Clear();
+  return true;
+}
+
+bool ExternalKeySorter::MergeRuns(KeyArena* merged, std::string* error) {
+  std::vector<RunReader> readers;
+  readers.reserve(runs_.size());
+  for (FILE* run : runs_) {
+    readers.emplace_back(run);
+  }
+
+  // Smallest key first; among equal keys the earliest run, which holds the first occurrence
+  auto greater = [&readers](size_t a, size_t b) {
+    int result = readers[a].key().compare(readers[b].key());
+    return result != 0 ? result > 0 : a > b;
+  };
+  std::priority_queue<size_t, std::vector<size_t>, decltype(greater)> heads(greater);
+  for (size_t i = 0; i < readers.size(); i++) {
+    if (readers[i].Next(error)) {
+      heads.push(i);
+    } else if (!error->empty()) {
+      return false;
+    }
+  }
+
+  std::string last_key;
+  bool has_last = false;
+  while (!heads.empty()) {
+    size_t i = heads.top();
+    heads.pop();
+
+    const std::string& key = readers[i].key();
+    if (!has_last || key != last_key) {
+      merged->Add(key.data(), key.length(), readers[i].value());
+      last_key = key;
+      has_last = true;
+    }
+
+    if (readers[i].Next(error)) {
+      heads.push(i);
+    } else if (!error->empty()) {
+      return false;
+    }
+  }
+  return true;
+}
+
+std::unique_ptr<DartsDict> ExternalKeySorter::Finish(std::string* error) {
+  if (runs_.empty()) {
+    return arena_.Build(error);
+  }
+
+  if (arena_.size() > 0 && !SpillRun(error)) {
+    return nullptr;
+  }
+
+  // Runs are merged in byte order, so the merged arena needs no further sorting
+  KeyArena merged;
+  if (!MergeRuns(&merged, error)) {
+    return nullptr;
+  }
+  return merged.Build(error);
+}
+
+}  // namespace node_darts
@@ -0,0 +1,92 @@
+#ifndef DARTS_KEY_ARENA_H_
+#define DARTS_KEY_ARENA_H_
+
+// Include standard library header files first
+#include <cstdint>
+#include <cstddef>
+#include <cstdio>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "array_builder.h"
+#include "common.h"
+
+namespace node_darts {
+
+// Value that is replaced by the key's index in the built dictionary. Callers must reject
+// negative values given for a key, so that this marker never stands for one of them.
+const int kAutoValue = -1;
+
+// Keys packed back to back into one buffer, with explicit lengths for Darts.
+// Costs one allocation per buffer growth instead of one per key, and lets the
+// build skip strlen on every key at every depth.
+class KeyArena {
+ public:
+  void Add(const char* key, size_t length, int value);
+  // Appends a key written in place: BeginKey returns room for length + 1 bytes (so that
+  // APIs writing a terminator can fill it directly), EndKey commits the first length bytes
+  char* BeginKey(size_t length);
+  void EndKey(size_t length, int value);
+  void Reserve(size_t num_keys, size_t num_bytes);
+  void Clear();
+
+  size_t size() const { return lengths_.size(); }
+  size_t byte_size() const { return bytes_.size(); }
+  const char* key(size_t i) const { return bytes_.data() + offsets_[i]; }
+  size_t length(size_t i) const { return lengths_[i]; }
+  int value(size_t i) const { return values_[i]; }
+  void set_value(size_t i, int value) { values_[i] = value; }
+
+  // Indices of the keys in byte order, keeping only the first occurrence of each key
+  std::vector<size_t> SortedUniqueOrder() const;
+
+  // Builds a Double-Array from the keys; kAutoValue values become the key's index.
+  // A monitor, if given, receives progress and may cancel the build.
+  std::unique_ptr<DartsDict> Build(std::string* error, BuildMonitor* monitor = nullptr,
+                                   const ArrayBuildOptions& options = ArrayBuildOptions()) const;
+
+ private:
+  int Compare(size_t a, size_t b) const;
+
+  std::vector<char> bytes_;
+  std::vector<size_t> offsets_;
+  std::vector<size_t> lengths_;
+  std::vector<int> values_;
+  // Whether the keys were added in strictly ascending order, so no sort is needed
+  bool sorted_unique_ = true;
+};
+
+// Collects keys without holding more than a bounded amount of key data in memory.
+// When the arena reaches the limit it is sorted and spilled to a temporary file;
+// Finish() merges the runs back into a single sorted, deduplicated arena.
+class ExternalKeySorter {
+ public:
+  explicit ExternalKeySorter(size_t memory_limit);
+  ~ExternalKeySorter();
+
+  // Returns false and sets error if a run cannot be spilled
+  bool Add(const char* key, size_t length, int value, std::string* error);
+
+  // Builds the Double-Array from every key added so far
+  std::unique_ptr<DartsDict> Finish(std::string* error);
+
+  size_t size() const { return num_keys_; }
+
+ private:
+  ExternalKeySorter(const ExternalKeySorter&) = delete;
+  ExternalKeySorter& operator=(const ExternalKeySorter&) = delete;
+
+  bool SpillRun(std::string* error);
+  bool MergeRuns(KeyArena* merged, std::string* error);
+
+  KeyArena arena_;
+  // Sorted runs in the order they were spilled; std::tmpfile removes them on close
+  std::vector<FILE*> runs_;
+  size_t memory_limit_;
+  size_t num_keys_ = 0;
+};
+
+}  // namespace node_darts
+
+#endif  // DARTS_KEY_ARENA_H_
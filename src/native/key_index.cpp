@@ -0,0 +1,157 @@
+#include "key_index.h"
+
+#include <algorithm>
+#include <cstring>
+#include <numeric>
+#include <utility>
+
+#include "file_format.h"
+
+namespace node_darts {
+
+namespace {
+
+struct KeyIndexHeader {
+  // CRC-32 of everything after the header
+  uint32_t checksum;
+  uint32_t reserved;
+  uint64_t num_keys;
+  uint64_t num_bytes;
+};
+
+// Zero bytes that keep the next section aligned
+size_t Padding(size_t size) {
+  return (8 - size % 8) % 8;
+}
+
+}  // namespace
+
+KeyIndex::KeyIndex(std::vector<uint64_t> offsets, std::vector<int32_t> values,
+                   std::vector<char> bytes)
+    : num_keys_(values.size()),
+      num_bytes_(bytes.size()),
+      owned_offsets_(std::move(offsets)),
+      owned_values_(std::move(values)),
+      owned_bytes_(std::move(bytes)) {
+  offsets_ = owned_offsets_.data();
+  values_ = owned_values_.data();
+  bytes_ = owned_bytes_.data();
+}
+
+std::unique_ptr<KeyIndex> KeyIndex::Build(size_t num_keys, const char* const* keys,
+                                          const size_t* lengths, const int* values) {
+  std::vector<size_t> order(num_keys);
+  std::iota(order.begin(), order.end(), 0);
+  // Stable, so that keys sharing a value stay in byte order
+  if (!std::is_sorted(values, values + num_keys)) {
+    std::stable_sort(order.begin(), order.end(),
+                     [values](size_t a, size_t b) { return values[a] < values[b]; });
+  }
+
+  size_t num_bytes = 0;
+  for (size_t i = 0; i < num_keys; i++) {
+    num_bytes += lengths[i];
+  }
+
+  std::vector<uint64_t> offsets;
+  std::vector<int32_t> sorted_values;
+  std::vector<char> bytes;
+  offsets.reserve(num_keys + 1);
+  sorted_values.reserve(num_keys);
+  bytes.reserve(num_bytes);
+  offsets.push_back(0);
+  for (size_t index : order) {
+    bytes.insert(bytes.end(), keys[index], keys[index] + lengths[index]);
+    offsets.push_back(bytes.size());
+    sorted_values.push_back(values[index]);
+  }
+  return std::unique_ptr<KeyIndex>(
+      new KeyIndex(std::move(offsets), std::move(sorted_values), std::move(bytes)));
+}
+
+std::unique_ptr<KeyIndex> KeyIndex::Parse(const void* data, size_t size, bool verify,
+                                          std::string* error) {
+  KeyIndexHeader header;
+  if (size < sizeof(header)) {
+    *error = "Invalid key index";
+    return nullptr;
+  }
+  std::memcpy(&header, data, sizeof(header));
+
+  // Sizes are checked in steps so that a forged header cannot overflow them
+  size_t available = size - sizeof(header);
+  size_t entry_size = sizeof(uint64_t) + sizeof(int32_t);
+  if (header.num_keys >= available / entry_size || header.num_bytes > available ||
+      available != (header.num_keys + 1) * sizeof(uint64_t) + header.num_keys * sizeof(int32_t) +
+                       header.num_bytes + Padding(header.num_keys * sizeof(int32_t) +
+                                                  header.num_bytes)) {
+    *error = "Key index size does not match its header";
+    return nullptr;
+  }
+
+  const char* body = static_cast<const char*>(data) + sizeof(header);
+  if (verify && Crc32(body, available) != header.checksum) {
+    *error = "Key index checksum mismatch";
+    return nullptr;
+  }
+
+  std::unique_ptr<KeyIndex> index(new KeyIndex());
+  index->num_keys_ = static_cast<size_t>(header.num_keys);
+  index->num_bytes_ = static_cast<size_t>(header.num_bytes);
+  index->offsets_ = reinterpret_cast<const uint64_t*>(body);
+  index->values_ = reinterpret_cast<const int32_t*>(index->offsets_ + index->num_keys_ + 1);
+  index->bytes_ = reinterpret_cast<const char*>(index->values_ + index->num_keys_);
+  return index;
+}
+
+bool KeyIndex::Find(int value, const char** key, size_t* length) const {
+  size_t i;
+  if (value >= 0 && static_cast<size_t>(value) < num_keys_ && values_[value] == value &&
+      (value == 0 || values_[value - 1] != value)) {
+    i = static_cast<size_t>(value);
+  } else {
+    i = std::lower_bound(values_, values_ + num_keys_, value) - values_;
+    if (i == num_keys_ || values_[i] != value) {
+      return false;
+    }
+  }
+  // Offsets read in place are not trusted to be ordered
+  uint64_t begin = offsets_[i];
+  uint64_t end = offsets_[i + 1];
+  if (begin > end || end > num_bytes_) {
+    return false;
+  }
+  *key = bytes_ + begin;
+  *length = static_cast<size_t>(end - begin);
+  return true;
+}
+
+size_t KeyIndex::byte_size() const {
+  size_t tail_size = num_keys_ * sizeof(int32_t) + num_bytes_;
+  return sizeof(KeyIndexHeader) + (num_keys_ + 1) * sizeof(uint64_t) + tail_size +
+         Padding(tail_size);
+}
+
+bool KeyIndex::Write(ByteWriter* out) const {
+  size_t offsets_size = (num_keys_ + 1) * sizeof(uint64_t);
+  size_t values_size = num_keys_ * sizeof(int32_t);
+  const char padding[8] = {0};
+  size_t padding_size = Padding(values_size + num_bytes_);
+
+  KeyIndexHeader header;
+  std::memset(&header, 0, sizeof(header));
+  header.checksum = Crc32(offsets_, offsets_size);
+  header.checksum = Crc32(values_, values_size, header.checksum);
+  header.checksum = Crc32(bytes_, num_bytes_, header.checksum);
+  header.checksum = Crc32(padding, padding_size, header.checksum);
+  header.num_keys = num_keys_;
+  header.num_bytes = num_bytes_;
+
+  return out->Write(&header, sizeof(header)) &&
+         out->Write(offsets_, offsets_size) &&
+         (values_size == 0 || out->Write(values_, values_size)) &&
+         (num_bytes_ == 0 || out->Write(bytes_, num_bytes_)) &&
+         (padding_size == 0 || out->Write(padding, padding_size));
+}
+
+}  // namespace node_darts
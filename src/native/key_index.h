@@ -0,0 +1,65 @@
+#ifndef DARTS_KEY_INDEX_H_
+#define DARTS_KEY_INDEX_H_
+
+// Include standard library header files first
+#include <cstdint>
+#include <cstddef>
+#include <cstdio>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace node_darts {
+
+class ByteWriter;
+
+// Keys of a dictionary ordered by their values, so that the key of a value found in the
+// trie can be restored without keeping the keys in JS. Entry i holds a value and the key
+// bytes [offsets[i], offsets[i + 1]); keys sharing a value keep their byte order.
+//
+// Serialized as a section of a dictionary file: a KeyIndexHeader, the num_keys + 1
+// offsets (uint64), the num_keys values (int32), then the key bytes padded to 8 bytes.
+class KeyIndex {
+ public:
+  // Owns the index; values must be in ascending order
+  KeyIndex(std::vector<uint64_t> offsets, std::vector<int32_t> values, std::vector<char> bytes);
+
+  // Collects the keys a dictionary was built from
+  static std::unique_ptr<KeyIndex> Build(size_t num_keys, const char* const* keys,
+                                         const size_t* lengths, const int* values);
+
+  // Reads a serialized index in place; the memory must outlive the index.
+  // verify also checks the index against its checksum.
+  // Returns nullptr and sets error if the data is not a valid index.
+  static std::unique_ptr<KeyIndex> Parse(const void* data, size_t size, bool verify,
+                                         std::string* error);
+
+  size_t size() const { return num_keys_; }
+
+  // Gets the key with the value, the first one in byte order if several keys share it.
+  // Takes constant time when the values are the key indices, as they are by default.
+  // Returns false if no key has the value.
+  bool Find(int value, const char** key, size_t* length) const;
+
+  // Size of the serialized index, a multiple of 8 bytes
+  size_t byte_size() const;
+  // Appends the serialized index to out, returning false on error
+  bool Write(ByteWriter* out) const;
+
+ private:
+  KeyIndex() {}
+
+  size_t num_keys_ = 0;
+  size_t num_bytes_ = 0;
+  const uint64_t* offsets_ = nullptr;
+  const int32_t* values_ = nullptr;
+  const char* bytes_ = nullptr;
+  // Empty for an index read in place
+  std::vector<uint64_t> owned_offsets_;
+  std::vector<int32_t> owned_values_;
+  std::vector<char> owned_bytes_;
+};
+
+}  // namespace node_darts
+
+#endif  // DARTS_KEY_INDEX_H_
@@ -0,0 +1,291 @@
+#include "layered_dictionary.h"
+#include <climits>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace node_darts {
+
+namespace {
+
+// Merges the frozen layer into a new base on the threadpool
+class CompactWorker : public Napi::AsyncWorker {
+ public:
+  CompactWorker(Napi::Env env, std::shared_ptr<LayeredDict> dict)
+      : Napi::AsyncWorker(env, "node_darts:compact"),
+        deferred_(Napi::Promise::Deferred::New(env)),
+        dict_(std::move(dict)),
+        base_(dict_->base()),
+        delta_(dict_->BeginCompaction()) {}
+
+  Napi::Promise Promise() const { return deferred_.Promise(); }
+
+  void Execute() override {
+    try {
+      std::string error;
+      merged_ = LayeredDict::Merge(*base_, *delta_, nullptr, &error);
+      if (!merged_) {
+        SetError(error);
+      }
+    } catch (const std::exception& e) {
+      SetError(e.what());
+    }
+  }
+
+  void OnOK() override {
+    dict_->FinishCompaction(std::shared_ptr<DartsDict>(merged_.release()));
+    deferred_.Resolve(Env().Undefined());
+  }
+
+  void OnError(const Napi::Error& e) override {
+    dict_->AbortCompaction();
+    deferred_.Reject(e.Value());
+  }
+
+ private:
+  Napi::Promise::Deferred deferred_;
+  std::shared_ptr<LayeredDict> dict_;
+  // Neither changes until the worker finishes
+  std::shared_ptr<DartsDict> base_;
+  std::shared_ptr<const DeltaLayer> delta_;
+  std::unique_ptr<DartsDict> merged_;
+};
+
+// Reads a string key argument; throws a TypeError and returns false otherwise
+bool ReadKeyArgument(const Napi::CallbackInfo& info, const char* usage, std::string* key) {
+  Napi::Env env = info.Env();
+  if (info.Length() < 1 || !info[0].IsString()) {
+    Napi::TypeError::New(env, usage).ThrowAsJavaScriptException();
+    return false;
+  }
+  *key = info[0].As<Napi::String>().Utf8Value();
+  return true;
+}
+
+}  // namespace
+
+void LayeredDictionary::Init(Napi::Env env) {
+  Napi::Function func = DefineClass(env, "LayeredDictionary", {
+    InstanceMethod("set", &LayeredDictionary::Set),
+    InstanceMethod("delete", &LayeredDictionary::Delete),
+    InstanceMethod("exactMatchSearch", &LayeredDictionary::ExactMatchSearch),
+    InstanceMethod("commonPrefixSearch", &LayeredDictionary::CommonPrefixSearch),
+    InstanceMethod("predictiveSearchKeys", &LayeredDictionary::PredictiveSearchKeys),
+    InstanceMethod("compact", &LayeredDictionary::Compact),
+    InstanceMethod("base", &LayeredDictionary::Base),
+    InstanceAccessor("pendingChanges", &LayeredDictionary::GetPendingChanges, nullptr),
+    InstanceAccessor("compacting", &LayeredDictionary::GetCompacting, nullptr),
+  });
+
+  // The constructor is not exported; layered dictionaries are only created through
+  // createLayeredDictionary
+  GetAddonData(env)->layered_dictionary_constructor = Napi::Persistent(func);
+}
+
+Napi::Value LayeredDictionary::New(Napi::Env env, std::shared_ptr<DartsDict> base) {
+  Napi::Object obj = GetAddonData(env)->layered_dictionary_constructor.New({});
+  LayeredDictionary* layered = Unwrap(obj);
+  layered->dict_ = std::make_shared<LayeredDict>(std::move(base));
+  return obj;
+}
+
+LayeredDictionary::LayeredDictionary(const Napi::CallbackInfo& info)
+    : Napi::ObjectWrap<LayeredDictionary>(info) {}
+
+Napi::Value LayeredDictionary::Set(const Napi::CallbackInfo& info) {
+  Napi::Env env = info.Env();
+
+  try {
+    const char* usage = "Arguments: (key: string, value: number) expected";
+    std::string key;
+    if (!ReadKeyArgument(info, usage, &key)) {
+      return env.Null();
+    }
+    if (info.Length() < 2 || !info[1].IsNumber()) {
+      Napi::TypeError::New(env, usage).ThrowAsJavaScriptException();
+      return env.Null();
+    }
+    if (key.empty()) {
+      Napi::Error::New(env, "Keys must not be empty").ThrowAsJavaScriptException();
+      return env.Null();
+    }
+
+    // Values are non-negative 32-bit integers, as Darts stores them
+    double value = info[1].As<Napi::Number>().DoubleValue();
+    if (!(value >= 0 && value <= INT_MAX) || value != static_cast<int>(value)) {
+      Napi::Error::New(env, "Values must be non-negative 32-bit integers").ThrowAsJavaScriptException();
+      return env.Null();
+    }
+
+    dict_->Set(std::move(key), static_cast<int>(value));
+    return env.Undefined();
+  } catch (const std::exception& e) {
+    Napi::Error::New(env, e.what()).ThrowAsJavaScriptException();
+    return env.Null();
+  }
+}
+
+Napi::Value LayeredDictionary::Delete(const Napi::CallbackInfo& info) {
+  Napi::Env env = info.Env();
+
+  try {
+    std::string key;
+    if (!ReadKeyArgument(info, "Argument: (key: string) expected", &key)) {
+      return env.Null();
+    }
+
+    // A tombstone is only needed for a key that some layer still holds
+    bool found = dict_->ExactMatch(key) >= 0;
+    if (found) {
+      dict_->Remove(std::move(key));
+    }
+    return Napi::Boolean::New(env, found);
+  } catch (const std::exception& e) {
+    Napi::Error::New(env, e.what()).ThrowAsJavaScriptException();
+    return env.Null();
+  }
+}
+
+Napi::Value LayeredDictionary::ExactMatchSearch(const Napi::CallbackInfo& info) {
+  Napi::Env env = info.Env();
+
+  try {
+    std::string key;
+    if (!ReadKeyArgument(info, "Argument: (key: string) expected", &key)) {
+      return env.Null();
+    }
+    return Napi::Number::New(env, dict_->ExactMatch(key));
+  } catch (const std::exception& e) {
+    Napi::Error::New(env, e.what()).ThrowAsJavaScriptException();
+    return env.Null();
+  }
+}
+
+Napi::Value LayeredDictionary::CommonPrefixSearch(const Napi::CallbackInfo& info) {
+  Napi::Env env = info.Env();
+
+  try {
+    std::string key;
+    if (!ReadKeyArgument(info, "Argument: (key: string) expected", &key)) {
+      return env.Null();
+    }
+
+    std::vector<std::pair<int, size_t>> matches;
+    dict_->CommonPrefix(key, &matches);
+
+    Napi::Array result_array = Napi::Array::New(env, matches.size());
+    for (size_t i = 0; i < matches.size(); i++) {
+      result_array[i] = Napi::Number::New(env, matches[i].first);
+    }
+    return result_array;
+  } catch (const std::exception& e) {
+    Napi::Error::New(env, e.what()).ThrowAsJavaScriptException();
+    return env.Null();
+  }
+}
+
+Napi::Value LayeredDictionary::PredictiveSearchKeys(const Napi::CallbackInfo& info) {
+  Napi::Env env = info.Env();
+
+  try {
+    std::string prefix;
+    if (!ReadKeyArgument(info, "Arguments: (prefix: string, limit?: number) expected", &prefix)) {
+      return env.Null();
+    }
+    size_t limit = 0;
+    if (info.Length() >= 2 && info[1].IsNumber()) {
+      limit = info[1].As<Napi::Number>().Uint32Value();
+    }
+
+    std::vector<std::pair<std::string, int>> matches;
+    dict_->Predictive(prefix, limit, &matches);
+
+    Napi::Array result_array = Napi::Array::New(env, matches.size());
+    for (size_t i = 0; i < matches.size(); i++) {
+      Napi::Object result_obj = Napi::Object::New(env);
+      result_obj.Set("key", Napi::String::New(env, matches[i].first));
+      result_obj.Set("value", Napi::Number::New(env, matches[i].second));
+      result_array[i] = result_obj;
+    }
+    return result_array;
+  } catch (const std::exception& e) {
+    Napi::Error::New(env, e.what()).ThrowAsJavaScriptException();
+    return env.Null();
+  }
+}
+
+Napi::Value LayeredDictionary::Compact(const Napi::CallbackInfo& info) {
+  Napi::Env env = info.Env();
+
+  try {
+    if (dict_->compacting()) {
+      Napi::Error::New(env, "A compaction is already running").ThrowAsJavaScriptException();
+      return env.Null();
+    }
+
+    Napi::Promise::Deferred deferred = Napi::Promise::Deferred::New(env);
+    if (dict_->pending() == 0) {
+      deferred.Resolve(env.Undefined());
+      return deferred.Promise();
+    }
+
+    CompactWorker* worker = new CompactWorker(env, dict_);
+    Napi::Promise promise = worker->Promise();
+    worker->Queue();
+    return promise;
+  } catch (const std::exception& e) {
+    Napi::Error::New(env, e.what()).ThrowAsJavaScriptException();
+    return env.Null();
+  }
+}
+
+Napi::Value LayeredDictionary::Base(const Napi::CallbackInfo& info) {
+  Napi::Env env = info.Env();
+
+  try {
+    // A handle of its own, which keeps working after later compactions replace the base
+    uint32_t handle = AddDictionary(env, dict_->base());
+    return Napi::Number::New(env, handle);
+  } catch (const std::exception& e) {
+    Napi::Error::New(env, e.what()).ThrowAsJavaScriptException();
+    return env.Null();
+  }
+}
+
+Napi::Value LayeredDictionary::GetPendingChanges(const Napi::CallbackInfo& info) {
+  return Napi::Number::New(info.Env(), static_cast<double>(dict_->pending()));
+}
+
+Napi::Value LayeredDictionary::GetCompacting(const Napi::CallbackInfo& info) {
+  return Napi::Boolean::New(info.Env(), dict_->compacting());
+}
+
+Napi::Value CreateLayeredDictionary(const Napi::CallbackInfo& info) {
+  Napi::Env env = info.Env();
+
+  try {
+    if (info.Length() < 1 || !info[0].IsNumber()) {
+      Napi::TypeError::New(env, "Number expected").ThrowAsJavaScriptException();
+      return env.Null();
+    }
+
+    uint32_t handle = info[0].As<Napi::Number>().Uint32Value();
+    std::shared_ptr<DartsDict> base = GetSharedDictionary(env, handle);
+    if (!base) {
+      Napi::Error::New(env, "Invalid dictionary handle").ThrowAsJavaScriptException();
+      return env.Null();
+    }
+    // Set values are plain numbers, which a value table could not resolve
+    if (base->value_table()) {
+      Napi::Error::New(env, "Layered dictionaries do not support value tables").ThrowAsJavaScriptException();
+      return env.Null();
+    }
+
+    return LayeredDictionary::New(env, std::move(base));
+  } catch (const std::exception& e) {
+    Napi::Error::New(env, e.what()).ThrowAsJavaScriptException();
+    return env.Null();
+  }
+}
+
+}  // namespace node_darts
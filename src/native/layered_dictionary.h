@@ -0,0 +1,44 @@
+#ifndef DARTS_LAYERED_DICTIONARY_H_
+#define DARTS_LAYERED_DICTIONARY_H_
+
+// Include standard library header files first
+#include <cstdint>
+#include <cstddef>
+#include <memory>
+
+#include <napi.h>
+#include "common.h"
+#include "delta_layer.h"
+
+namespace node_darts {
+
+// Updatable view of a dictionary: keys set and deleted on it go to a small delta layer that
+// every lookup consults together with the base array, until compact() merges the two into
+// a new base on the threadpool. Updates made during a compaction go to a new layer.
+class LayeredDictionary : public Napi::ObjectWrap<LayeredDictionary> {
+ public:
+  static void Init(Napi::Env env);
+  static Napi::Value New(Napi::Env env, std::shared_ptr<DartsDict> base);
+
+  explicit LayeredDictionary(const Napi::CallbackInfo& info);
+
+ private:
+  Napi::Value Set(const Napi::CallbackInfo& info);
+  Napi::Value Delete(const Napi::CallbackInfo& info);
+  Napi::Value ExactMatchSearch(const Napi::CallbackInfo& info);
+  Napi::Value CommonPrefixSearch(const Napi::CallbackInfo& info);
+  Napi::Value PredictiveSearchKeys(const Napi::CallbackInfo& info);
+  Napi::Value Compact(const Napi::CallbackInfo& info);
+  Napi::Value Base(const Napi::CallbackInfo& info);
+  Napi::Value GetPendingChanges(const Napi::CallbackInfo& info);
+  Napi::Value GetCompacting(const Napi::CallbackInfo& info);
+
+  // Shared with a running compaction, which outlives the JS object if it is collected
+  std::shared_ptr<LayeredDict> dict_;
+};
+
+Napi::Value CreateLayeredDictionary(const Napi::CallbackInfo& info);
+
+}  // namespace node_darts
+
+#endif  // DARTS_LAYERED_DICTIONARY_H_
@@ -0,0 +1,87 @@
+#include "lookup_stats.h"
+
+namespace node_darts {
+
+namespace {
+
+// Shard of the calling thread; threads are spread over the shards in creation order
+size_t ThreadShard(size_t num_shards) {
+  static std::atomic<size_t> next_thread{0};
+  thread_local size_t shard = next_thread.fetch_add(1, std::memory_order_relaxed);
+  return shard % num_shards;
+}
+
+size_t Bucket(uint64_t ns) {
+  size_t bucket = 0;
+  while (ns > 1 && bucket + 1 < LookupStats::kNumBuckets) {
+    ns >>= 1;
+    bucket++;
+  }
+  return bucket;
+}
+
+}  // namespace
+
+LookupStats::~LookupStats() {
+  delete[] shards_.load(std::memory_order_relaxed);
+}
+
+void LookupStats::set_enabled(bool enabled) {
+  if (enabled && !shards_.load(std::memory_order_acquire)) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!shards_.load(std::memory_order_relaxed)) {
+      // Value-initialized, so every counter starts at 0
+      shards_.store(new Shard[kNumShards](), std::memory_order_release);
+    }
+  }
+  enabled_.store(enabled, std::memory_order_relaxed);
+}
+
+void LookupStats::Record(LookupKind kind, size_t keys, uint64_t ns) {
+  Shard* shards = shards_.load(std::memory_order_acquire);
+  if (!shards) {
+    return;
+  }
+  KindCounters& counters = shards[ThreadShard(kNumShards)].kinds[static_cast<size_t>(kind)];
+  counters.calls.fetch_add(1, std::memory_order_relaxed);
+  counters.keys.fetch_add(keys, std::memory_order_relaxed);
+  counters.total_ns.fetch_add(ns, std::memory_order_relaxed);
+  counters.buckets[Bucket(ns)].fetch_add(1, std::memory_order_relaxed);
+}
+
+LookupStats::Counters LookupStats::Get(LookupKind kind) const {
+  Counters result;
+  Shard* shards = shards_.load(std::memory_order_acquire);
+  if (!shards) {
+    return result;
+  }
+  for (size_t i = 0; i < kNumShards; i++) {
+    const KindCounters& counters = shards[i].kinds[static_cast<size_t>(kind)];
+    result.calls += counters.calls.load(std::memory_order_relaxed);
+    result.keys += counters.keys.load(std::memory_order_relaxed);
+    result.total_ns += counters.total_ns.load(std::memory_order_relaxed);
+    for (size_t j = 0; j < kNumBuckets; j++) {
+      result.buckets[j] += counters.buckets[j].load(std::memory_order_relaxed);
+    }
+  }
+  return result;
+}
+
+void LookupStats::Reset() {
+  Shard* shards = shards_.load(std::memory_order_acquire);
+  if (!shards) {
+    return;
+  }
+  for (size_t i = 0; i < kNumShards; i++) {
+    for (KindCounters& counters : shards[i].kinds) {
+      counters.calls.store(0, std::memory_order_relaxed);
+      counters.keys.store(0, std::memory_order_relaxed);
+      counters.total_ns.store(0, std::memory_order_relaxed);
+      for (std::atomic<uint64_t>& bucket : counters.buckets) {
+        bucket.store(0, std::memory_order_relaxed);
+      }
+    }
+  }
+}
+
+}  // namespace node_darts
@@ -0,0 +1,112 @@
+#ifndef DARTS_LOOKUP_STATS_H_
+#define DARTS_LOOKUP_STATS_H_
+
+// Include standard library header files first
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstddef>
+#include <mutex>
+
+namespace node_darts {
+
+// Kinds of lookups counted by LookupStats
+enum class LookupKind {
+  kExactMatch,
+  kCommonPrefix,
+  kPredictive,
+  kTraverse,
+  // findMatches and replaceWords, which scan a whole text per call
+  kText,
+};
+
+const size_t kNumLookupKinds = 5;
+
+// Lookup counters and latency histograms of one dictionary, off until enabled.
+// Counters are split into cache-line sized shards picked by the calling thread, so that
+// threads sharing a dictionary do not contend; recording a call costs two clock reads
+// and a few relaxed increments on memory that stays in the thread's cache.
+class LookupStats {
+ public:
+  // Bucket i counts calls that took [2^i, 2^(i + 1)) ns; bucket 0 also counts 0 ns
+  static constexpr size_t kNumBuckets = 32;
+
+  struct Counters {
+    uint64_t calls = 0;
+    // Keys looked up; batch calls look up several keys per call
+    uint64_t keys = 0;
+    uint64_t total_ns = 0;
+    uint64_t buckets[kNumBuckets] = {};
+  };
+
+  LookupStats() {}
+  ~LookupStats();
+
+  bool enabled() const { return enabled_.load(std::memory_order_relaxed); }
+  // The shards are allocated the first time the stats are enabled
+  void set_enabled(bool enabled);
+
+  void Record(LookupKind kind, size_t keys, uint64_t ns);
+  // Sums the shards; calls recorded concurrently may or may not be included
+  Counters Get(LookupKind kind) const;
+  void Reset();
+
+ private:
+  LookupStats(const LookupStats&) = delete;
+  LookupStats& operator=(const LookupStats&) = delete;
+
+  struct KindCounters {
+    std::atomic<uint64_t> calls;
+    std::atomic<uint64_t> keys;
+    std::atomic<uint64_t> total_ns;
+    std::atomic<uint64_t> buckets[kNumBuckets];
+  };
+  struct alignas(64) Shard {
+    KindCounters kinds[kNumLookupKinds];
+  };
+  static constexpr size_t kNumShards = 16;
+
+  std::atomic<bool> enabled_{false};
+  std::atomic<Shard*> shards_{nullptr};
+  std::mutex mutex_;
+};
+
+// Wall time since start, for the build and load durations the stats report
+inline double MillisecondsSince(std::chrono::steady_clock::time_point start) {
+  return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start)
+      .count();
+}
+
+// Records one call into the stats, if they are enabled, when it goes out of scope
+class LookupTimer {
+ public:
+  LookupTimer(LookupStats* stats, LookupKind kind, size_t keys = 1)
+      : stats_(stats->enabled() ? stats : nullptr), kind_(kind), keys_(keys) {
+    if (stats_) {
+      start_ = std::chrono::steady_clock::now();
+    }
+  }
+  ~LookupTimer() {
+    if (stats_) {
+      std::chrono::steady_clock::duration elapsed = std::chrono::steady_clock::now() - start_;
+      stats_->Record(kind_, keys_,
+                     std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count());
+    }
+  }
+
+  // For batches whose size is only known once the keys are read
+  void set_keys(size_t keys) { keys_ = keys; }
+
+ private:
+  LookupTimer(const LookupTimer&) = delete;
+  LookupTimer& operator=(const LookupTimer&) = delete;
+
+  LookupStats* stats_;
+  LookupKind kind_;
+  size_t keys_;
+  std::chrono::steady_clock::time_point start_;
+};
+
+}  // namespace node_darts
+
+#endif  // DARTS_LOOKUP_STATS_H_
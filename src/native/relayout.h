@@ -0,0 +1,164 @@
+#ifndef DARTS_RELAYOUT_H_
+#define DARTS_RELAYOUT_H_
+
+// Include standard library header files first
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace node_darts {
+
+// Renumbers the nodes of a Darts Double-Array for the cache.
+// Darts places nodes depth first, so the few nodes near the root, which every lookup
+// reads, end up spread over the whole array among the subtries placed between them. Here
+// the top hot_depth levels are placed first, level by level, so that they fill the first
+// cache lines and pages of the array and stay resident; each subtrie below them is then
+// placed depth first as Darts does, which keeps the rest of a lookup's path close together
+// (placing every level breadth first spreads that path over the whole array instead).
+// Siblings stay together as a Double-Array requires. Values are untouched, so a value
+// table or key index still applies; anything indexed by unit position must be rebuilt.
+//
+// Takes the units in the layout Darts uses ({int base; unsigned check;}) and returns the
+// new ones, followed by padding units so that any byte can be probed from any base, as
+// Darts leaves. Returns no units if the array is damaged (its links do not form a trie).
+
+// Levels placed breadth first by default: the root's children and grandchildren, a few
+// thousand units at most
+const size_t kRelayoutHotDepth = 2;
+
+template <class Unit>
+std::vector<Unit> RelayoutForCache(const Unit* units, size_t num_units, size_t hot_depth,
+                                   size_t padding) {
+  struct Move {
+    // Node in the old array and in the new one
+    size_t from;
+    size_t to;
+    size_t depth;
+  };
+
+  std::vector<Unit> relaid(1, Unit{0, 0});
+  // Whether a base is taken, as two nodes must not share one
+  std::vector<uint8_t> used(1, 0);
+  auto reserve = [&relaid, &used](size_t size) {
+    if (size > relaid.size()) {
+      size_t grown = std::max(size, relaid.size() * 2);
+      relaid.resize(grown, Unit{0, 0});
+      used.resize(grown, 0);
+    }
+  };
+  if (num_units == 0) {
+    return relaid;
+  }
+
+  std::vector<size_t> labels;
+  labels.reserve(257);
+  size_t next_check_pos = 0;
+  size_t num_relaid = 1;
+  size_t num_moves = 0;
+  bool damaged = false;
+
+  // Places the children of a node and calls visit(move) for each child that is a node
+  // itself, in byte order. The move is a copy, as visit may grow the queue holding it.
+  auto place_children = [&](Move move, auto visit) {
+    size_t base = static_cast<size_t>(units[move.from].base);
+    if (base == 0) {
+      return;
+    }
+
+    // Label 0 is the node's value, label c the child for byte c - 1
+    labels.clear();
+    for (size_t label = 0; label <= 256 && base + label < num_units; label++) {
+      if (units[base + label].check == base) {
+        labels.push_back(label);
+      }
+    }
+    if (labels.empty()) {
+      return;
+    }
+
+    // First fit from the first cell that may be free, as the Darts builder places nodes
+    size_t first = labels.front();
+    size_t pos = std::max(first + 1, next_check_pos) - 1;
+    size_t nonzero_num = 0;
+    bool first_free = true;
+    size_t begin;
+    for (;;) {
+      pos++;
+      reserve(pos + 1);
+      if (relaid[pos].check) {
+        nonzero_num++;
+        continue;
+      }
+      if (first_free) {
+        next_check_pos = pos;
+        first_free = false;
+      }
+      begin = pos - first;
+      reserve(begin + labels.back() + 1);
+      if (used[begin]) {
+        continue;
+      }
+      bool fits = true;
+      for (size_t i = 1; i < labels.size() && fits; i++) {
+        fits = !relaid[begin + labels[i]].check;
+      }
+      if (fits) {
+        break;
+      }
+    }
+    // Skip the densely filled region from now on
+    if (1.0 * nonzero_num / (pos - next_check_pos + 1) >= 0.95) {
+      next_check_pos = pos;
+    }
+
+    used[begin] = 1;
+    relaid[move.to].base = static_cast<int>(begin);
+    for (size_t label : labels) {
+      size_t to = begin + label;
+      relaid[to].check = static_cast<unsigned int>(begin);
+      num_relaid = std::max(num_relaid, to + 1);
+      if (label == 0) {
+        relaid[to].base = units[base].base;
+      } else if (++num_moves < num_units) {
+        visit(Move{base + label, to, move.depth + 1});
+      } else {
+        // A trie has fewer nodes than units; more means the links loop
+        damaged = true;
+      }
+    }
+  };
+
+  // The top levels, level by level
+  std::vector<Move> queue(1, Move{0, 0, 0});
+  std::vector<Move> subtries;
+  for (size_t head = 0; head < queue.size() && !damaged; head++) {
+    place_children(queue[head], [&](const Move& child) {
+      (child.depth < hot_depth ? queue : subtries).push_back(child);
+    });
+  }
+
+  // Then each subtrie below them depth first, in the order Darts places nodes
+  std::vector<Move> stack;
+  std::vector<Move> children;
+  for (size_t i = 0; i < subtries.size() && !damaged; i++) {
+    stack.push_back(subtries[i]);
+    while (!stack.empty() && !damaged) {
+      Move move = stack.back();
+      stack.pop_back();
+      children.clear();
+      place_children(move, [&children](const Move& child) { children.push_back(child); });
+      stack.insert(stack.end(), children.rbegin(), children.rend());
+    }
+  }
+  if (damaged) {
+    return std::vector<Unit>();
+  }
+
+  relaid.resize(num_relaid + padding, Unit{0, 0});
+  return relaid;
+}
+
+}  // namespace node_darts
+
+#endif  // DARTS_RELAYOUT_H_
@@ -0,0 +1,78 @@
+#include "scan_table.h"
+
+#include <algorithm>
+#include <cstring>
+#include <utility>
+
+#include "file_format.h"
+
+namespace node_darts {
+
+namespace {
+
+struct ScanTableHeader {
+  // CRC-32 of the nodes
+  uint32_t checksum;
+  uint32_t max_length;
+  uint64_t num_nodes;
+};
+
+// Sections are written in multiples of 8 bytes without padding the nodes
+static_assert(sizeof(ScanTable::Node) == 16, "ScanTable::Node must be 16 bytes");
+
+}  // namespace
+
+ScanTable::ScanTable(std::vector<Node> nodes)
+    : num_nodes_(nodes.size()), owned_nodes_(std::move(nodes)) {
+  nodes_ = owned_nodes_.data();
+  for (const Node& node : owned_nodes_) {
+    max_length_ = std::max(max_length_, static_cast<size_t>(node.length));
+  }
+}
+
+std::unique_ptr<ScanTable> ScanTable::Parse(const void* data, size_t size, size_t num_units,
+                                            bool verify, std::string* error) {
+  ScanTableHeader header;
+  if (size < sizeof(header)) {
+    *error = "Invalid scan table";
+    return nullptr;
+  }
+  std::memcpy(&header, data, sizeof(header));
+
+  size_t available = size - sizeof(header);
+  if (header.num_nodes != num_units || header.num_nodes != available / sizeof(Node) ||
+      available % sizeof(Node) != 0) {
+    *error = "Scan table size does not match the dictionary";
+    return nullptr;
+  }
+
+  const char* body = static_cast<const char*>(data) + sizeof(header);
+  if (verify && Crc32(body, available) != header.checksum) {
+    *error = "Scan table checksum mismatch";
+    return nullptr;
+  }
+
+  std::unique_ptr<ScanTable> table(new ScanTable());
+  table->num_nodes_ = static_cast<size_t>(header.num_nodes);
+  table->max_length_ = header.max_length;
+  table->nodes_ = reinterpret_cast<const Node*>(body);
+  return table;
+}
+
+size_t ScanTable::byte_size() const {
+  return sizeof(ScanTableHeader) + num_nodes_ * sizeof(Node);
+}
+
+bool ScanTable::Write(ByteWriter* out) const {
+  size_t nodes_size = num_nodes_ * sizeof(Node);
+
+  ScanTableHeader header;
+  std::memset(&header, 0, sizeof(header));
+  header.checksum = Crc32(nodes_, nodes_size);
+  header.max_length = static_cast<uint32_t>(max_length_);
+  header.num_nodes = num_nodes_;
+
+  return out->Write(&header, sizeof(header)) && out->Write(nodes_, nodes_size);
+}
+
+}  // namespace node_darts
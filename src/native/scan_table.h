@@ -0,0 +1,162 @@
+#ifndef DARTS_SCAN_TABLE_H_
+#define DARTS_SCAN_TABLE_H_
+
+// Include standard library header files first
+#include <cstdint>
+#include <cstddef>
+#include <cstdio>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace node_darts {
+
+class ByteWriter;
+
+// Failure and output links over the nodes of a dictionary's trie, which make it an
+// Aho-Corasick automaton: a text is scanned for every occurrence of every key in one step
+// per byte, instead of a prefix search restarted at each position.
+// Nodes are indexed by the unit positions that traverse reports; units that are not nodes
+// have zero entries. Position 0 is the root, which also stands for "no node".
+//
+// Serialized as a section of a dictionary file: a ScanTableHeader, then one Node per unit.
+class ScanTable {
+ public:
+  struct Node {
+    // Node of the longest proper suffix of the node's key that is in the trie
+    uint32_t fail;
+    // Nearest node along the failure links whose key has a value
+    uint32_t output;
+    // Value of the node's key, or -1 (always -1 for the root, as an empty key never matches)
+    int32_t value;
+    // Length in bytes of the node's key
+    uint32_t length;
+  };
+
+  // Owns the nodes, one per unit of the dictionary
+  explicit ScanTable(std::vector<Node> nodes);
+
+  // Computes the links of a dictionary by a breadth-first walk of its trie.
+  // Returns nullptr if the dictionary is empty or has too many units.
+  template <class Dict>
+  static std::unique_ptr<ScanTable> Build(const Dict& dict);
+
+  // Reads a serialized table in place for a dictionary of num_units units; the memory must
+  // outlive the table. verify also checks the table against its checksum.
+  // Returns nullptr and sets error if the data is not a valid table.
+  static std::unique_ptr<ScanTable> Parse(const void* data, size_t size, size_t num_units,
+                                          bool verify, std::string* error);
+
+  size_t size() const { return num_nodes_; }
+  // Length in bytes of the longest key
+  size_t max_length() const { return max_length_; }
+
+  // Moves the automaton from state over one byte, following failure links until the byte
+  // can be read; returns the root if no suffix of the text read so far continues with it
+  template <class Dict>
+  uint32_t Next(const Dict& dict, uint32_t state, unsigned char byte) const;
+
+  // Calls visit(value, length) for each key that ends at the state, longest first
+  template <class Visitor>
+  void VisitMatches(uint32_t state, Visitor visit) const;
+
+  // Size of the serialized table, a multiple of 8 bytes
+  size_t byte_size() const;
+  // Appends the serialized table to out, returning false on error
+  bool Write(ByteWriter* out) const;
+
+ private:
+  ScanTable() {}
+
+  size_t num_nodes_ = 0;
+  size_t max_length_ = 0;
+  const Node* nodes_ = nullptr;
+  // Empty for a table read in place
+  std::vector<Node> owned_nodes_;
+};
+
+template <class Dict>
+std::unique_ptr<ScanTable> ScanTable::Build(const Dict& dict) {
+  if (dict.size() == 0 || dict.size() > UINT32_MAX) {
+    return nullptr;
+  }
+
+  std::vector<Node> nodes(dict.size(), Node{0, 0, -1, 0});
+  // Goes to the child of node_pos for the byte, returning 0 if there is none
+  auto child_of = [&dict](size_t node_pos, unsigned char byte) -> size_t {
+    char key = static_cast<char>(byte);
+    size_t key_pos = 0;
+    return dict.traverse(&key, node_pos, key_pos, 1) == -2 ? 0 : node_pos;
+  };
+
+  // Nodes are visited by depth, so the links of every shorter key are known already
+  std::vector<uint32_t> queue(1, 0);
+  for (size_t head = 0; head < queue.size(); head++) {
+    uint32_t parent = queue[head];
+    dict.forEachChild(parent, [&](unsigned char byte, size_t child_pos) {
+      Node& node = nodes[child_pos];
+      node.length = nodes[parent].length + 1;
+      size_t value_pos = child_pos;
+      size_t key_pos = 0;
+      node.value = dict.traverse("", value_pos, key_pos, 0);
+      if (node.value < 0) {
+        node.value = -1;
+      }
+
+      // The suffix of a one-byte key is the empty key at the root
+      if (parent != 0) {
+        uint32_t state = nodes[parent].fail;
+        size_t next = child_of(state, byte);
+        while (next == 0 && state != 0) {
+          state = nodes[state].fail;
+          next = child_of(state, byte);
+        }
+        node.fail = static_cast<uint32_t>(next);
+      }
+      const Node& fail = nodes[node.fail];
+      node.output = fail.value >= 0 ? node.fail : fail.output;
+      queue.push_back(static_cast<uint32_t>(child_pos));
+    });
+  }
+  return std::unique_ptr<ScanTable>(new ScanTable(std::move(nodes)));
+}
+
+template <class Dict>
+uint32_t ScanTable::Next(const Dict& dict, uint32_t state, unsigned char byte) const {
+  char key = static_cast<char>(byte);
+  for (;;) {
+    size_t node_pos = state;
+    size_t key_pos = 0;
+    if (dict.traverse(&key, node_pos, key_pos, 1) != -2 && node_pos < num_nodes_) {
+      return static_cast<uint32_t>(node_pos);
+    }
+    if (state == 0) {
+      return 0;
+    }
+    // Links read in place are not trusted to end; each one must lead to a shorter key
+    uint32_t fail = nodes_[state].fail;
+    if (fail >= num_nodes_ || nodes_[fail].length >= nodes_[state].length) {
+      return 0;
+    }
+    state = fail;
+  }
+}
+
+template <class Visitor>
+void ScanTable::VisitMatches(uint32_t state, Visitor visit) const {
+  uint32_t node = nodes_[state].value >= 0 ? state : nodes_[state].output;
+  while (node != 0 && node < num_nodes_) {
+    if (nodes_[node].value >= 0) {
+      visit(static_cast<int>(nodes_[node].value), static_cast<size_t>(nodes_[node].length));
+    }
+    uint32_t next = nodes_[node].output;
+    if (next < num_nodes_ && nodes_[next].length >= nodes_[node].length) {
+      return;
+    }
+    node = next;
+  }
+}
+
+}  // namespace node_darts
+
+#endif  // DARTS_SCAN_TABLE_H_
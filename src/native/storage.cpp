@@ -0,0 +1,347 @@
+#include "storage.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+
+#ifdef _WIN32
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+#ifdef __linux__
+#include <sys/syscall.h>
+#endif
+
+namespace node_darts {
+
+namespace {
+
+// Opens a file to be read in full, returning false and setting error on failure
+bool OpenWholeFile(const std::string& path, std::ifstream* file, size_t* size,
+                   std::string* error) {
+  file->open(path, std::ios::binary | std::ios::ate);
+  if (!*file) {
+    *error = std::strerror(errno);
+    return false;
+  }
+
+  std::streamoff end = file->tellg();
+  if (end < 0) {
+    *error = "Cannot read file";
+    return false;
+  }
+  file->seekg(0);
+  *size = static_cast<size_t>(end);
+  return true;
+}
+
+#ifndef _WIN32
+
+// Huge page size on x86-64 and on ARM64 with 4 KiB pages
+const size_t kHugePageSize = static_cast<size_t>(2) << 20;
+
+size_t RoundUp(size_t size, size_t unit) { return (size + unit - 1) / unit * unit; }
+
+#endif
+
+#ifdef __linux__
+
+// Binds memory that has not been touched yet to a NUMA node, without needing libnuma
+bool BindToNode(void* data, size_t size, int node) {
+  const size_t kBits = sizeof(unsigned long) * 8;
+  std::vector<unsigned long> mask(static_cast<size_t>(node) / kBits + 1, 0);
+  mask.back() = 1UL << (static_cast<size_t>(node) % kBits);
+  // MPOL_BIND; the kernel reads one bit less than maxnode says
+  const int kBind = 2;
+  return syscall(SYS_mbind, data, size, kBind, mask.data(), mask.size() * kBits + 1, 0) == 0;
+}
+
+#endif
+
+}  // namespace
+
+int CurrentNumaNode() {
+#ifdef __linux__
+  unsigned int cpu = 0;
+  unsigned int node = 0;
+  if (syscall(SYS_getcpu, &cpu, &node, nullptr) == 0) {
+    return static_cast<int>(node);
+  }
+#endif
+  return -1;
+}
+
+std::unique_ptr<BufferStorage> BufferStorage::ReadFile(const std::string& path,
+                                                       std::string* error) {
+  std::ifstream file;
+  size_t size = 0;
+  if (!OpenWholeFile(path, &file, &size, error)) {
+    return nullptr;
+  }
+  std::vector<char> bytes(size);
+  if (!file.read(bytes.data(), static_cast<std::streamsize>(size))) {
+    *error = "Cannot read file";
+    return nullptr;
+  }
+  return std::unique_ptr<BufferStorage>(new BufferStorage(std::move(bytes)));
+}
+
+std::unique_ptr<PageStorage> PageStorage::ReadFile(const std::string& path,
+                                                   const PageOptions& options,
+                                                   std::string* error) {
+  std::ifstream file;
+  size_t size = 0;
+  if (!OpenWholeFile(path, &file, &size, error)) {
+    return nullptr;
+  }
+  std::unique_ptr<PageStorage> storage = Allocate(size, options, error);
+  if (!storage) {
+    return nullptr;
+  }
+  // Reading touches the pages, which places them as the options asked
+  if (!file.read(static_cast<char*>(storage->mutable_data()),
+                 static_cast<std::streamsize>(size))) {
+    *error = "Cannot read file";
+    return nullptr;
+  }
+  return storage;
+}
+
+#ifdef _WIN32
+
+PageStorage::~PageStorage() {
+  if (mapping_) {
+    VirtualFree(mapping_, 0, MEM_RELEASE);
+  }
+}
+
+std::unique_ptr<PageStorage> PageStorage::Allocate(size_t size, const PageOptions& options,
+                                                   std::string* error) {
+  // Large pages need a privilege that processes rarely hold, and NUMA binding is left to
+  // the default policy, so the options are ignored
+  (void)options;
+
+  std::unique_ptr<PageStorage> storage(new PageStorage());
+  size_t length = std::max<size_t>(size, 1);
+  storage->mapping_ = VirtualAlloc(nullptr, length, MEM_RESERVE | MEM_COMMIT, PAGE_READWRITE);
+  if (!storage->mapping_) {
+    *error = "Cannot allocate memory";
+    return nullptr;
+  }
+  storage->mapping_size_ = length;
+  storage->data_ = storage->mapping_;
+  storage->size_ = size;
+  return storage;
+}
+
+MappedFileStorage::~MappedFileStorage() {
+  if (data_) {
+    UnmapViewOfFile(data_);
+  }
+  if (mapping_) {
+    CloseHandle(static_cast<HANDLE>(mapping_));
+  }
+}
+
+std::unique_ptr<MappedFileStorage> MappedFileStorage::Open(const std::string& path,
+                                                           const MapOptions& options,
+                                                           std::string* error) {
+  // Access hints have no Windows counterpart and are ignored
+  (void)options;
+
+  HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+                            OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+  if (file == INVALID_HANDLE_VALUE) {
+    *error = "Cannot open file";
+    return nullptr;
+  }
+
+  LARGE_INTEGER file_size;
+  if (!GetFileSizeEx(file, &file_size) || file_size.QuadPart == 0) {
+    CloseHandle(file);
+    *error = "Cannot map an empty file";
+    return nullptr;
+  }
+
+  std::unique_ptr<MappedFileStorage> storage(new MappedFileStorage());
+  storage->mapping_ = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+  // The mapping keeps its own reference to the file
+  CloseHandle(file);
+  if (!storage->mapping_) {
+    *error = "Cannot create file mapping";
+    return nullptr;
+  }
+
+  storage->data_ = MapViewOfFile(static_cast<HANDLE>(storage->mapping_), FILE_MAP_READ, 0, 0, 0);
+  if (!storage->data_) {
+    *error = "Cannot map view of file";
+    return nullptr;
+  }
+  storage->size_ = static_cast<size_t>(file_size.QuadPart);
+
+  return storage;
+}
+
+size_t MappedFileStorage::resident_size() const { return size_; }
+
+#else
+
+PageStorage::~PageStorage() {
+  if (mapping_) {
+    munmap(mapping_, mapping_size_);
+  }
+}
+
+std::unique_ptr<PageStorage> PageStorage::Allocate(size_t size, const PageOptions& options,
+                                                   std::string* error) {
+  std::unique_ptr<PageStorage> storage(new PageStorage());
+  size_t length = std::max<size_t>(size, 1);
+
+#ifdef __linux__
+  // The reserved pool is not split by node here, and a bound fault on a node without free
+  // huge pages would crash, so explicit pages are only used without a node
+  if (options.huge_pages && options.numa_node < 0) {
+    size_t huge_length = RoundUp(length, kHugePageSize);
+    void* data = mmap(nullptr, huge_length, PROT_READ | PROT_WRITE,
+                      MAP_PRIVATE | MAP_ANON | MAP_HUGETLB, -1, 0);
+    if (data != MAP_FAILED) {
+      storage->mapping_ = data;
+      storage->mapping_size_ = huge_length;
+      storage->huge_pages_ = HugePages::kExplicit;
+    }
+  }
+  if (options.huge_pages && !storage->mapping_) {
+    // Transparent huge pages need aligned memory: map one huge page more than needed and
+    // unmap the slack around the aligned start
+    size_t huge_length = RoundUp(length, kHugePageSize);
+    void* raw = mmap(nullptr, huge_length + kHugePageSize, PROT_READ | PROT_WRITE,
+                     MAP_PRIVATE | MAP_ANON, -1, 0);
+    if (raw == MAP_FAILED) {
+      *error = std::strerror(errno);
+      return nullptr;
+    }
+    uintptr_t start = reinterpret_cast<uintptr_t>(raw);
+    uintptr_t aligned = RoundUp(start, kHugePageSize);
+    size_t head = aligned - start;
+    if (head > 0) {
+      munmap(raw, head);
+    }
+    munmap(reinterpret_cast<void*>(aligned + huge_length), kHugePageSize - head);
+    storage->mapping_ = reinterpret_cast<void*>(aligned);
+    storage->mapping_size_ = huge_length;
+    if (madvise(storage->mapping_, huge_length, MADV_HUGEPAGE) == 0) {
+      storage->huge_pages_ = HugePages::kTransparent;
+    }
+  }
+#endif
+
+  if (!storage->mapping_) {
+    length = RoundUp(length, static_cast<size_t>(sysconf(_SC_PAGESIZE)));
+    void* data = mmap(nullptr, length, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANON, -1, 0);
+    if (data == MAP_FAILED) {
+      *error = std::strerror(errno);
+      return nullptr;
+    }
+    storage->mapping_ = data;
+    storage->mapping_size_ = length;
+  }
+
+#ifdef __linux__
+  // Nothing has been touched yet, so every page is allocated on the node
+  if (options.numa_node >= 0 &&
+      BindToNode(storage->mapping_, storage->mapping_size_, options.numa_node)) {
+    storage->numa_node_ = options.numa_node;
+  }
+#endif
+
+  storage->data_ = storage->mapping_;
+  storage->size_ = size;
+  return storage;
+}
+
+MappedFileStorage::~MappedFileStorage() {
+  if (data_) {
+    munmap(data_, size_);
+  }
+}
+
+std::unique_ptr<MappedFileStorage> MappedFileStorage::Open(const std::string& path,
+                                                           const MapOptions& options,
+                                                           std::string* error) {
+  int fd = open(path.c_str(), O_RDONLY);
+  if (fd < 0) {
+    *error = std::strerror(errno);
+    return nullptr;
+  }
+
+  struct stat st;
+  if (fstat(fd, &st) != 0) {
+    *error = std::strerror(errno);
+    close(fd);
+    return nullptr;
+  }
+  if (st.st_size == 0) {
+    close(fd);
+    *error = "Cannot map an empty file";
+    return nullptr;
+  }
+
+  size_t size = static_cast<size_t>(st.st_size);
+  void* data = mmap(nullptr, size, PROT_READ, MAP_SHARED, fd, 0);
+  // The mapping stays valid after the descriptor is closed
+  close(fd);
+  if (data == MAP_FAILED) {
+    *error = std::strerror(errno);
+    return nullptr;
+  }
+
+  // Hints are best effort, so failures are not reported
+  if (options.random_access) {
+    madvise(data, size, MADV_RANDOM);
+  }
+  if (options.prewarm) {
+    madvise(data, size, MADV_WILLNEED);
+  }
+
+  std::unique_ptr<MappedFileStorage> storage(new MappedFileStorage());
+  storage->data_ = data;
+  storage->size_ = size;
+#ifdef __linux__
+  if (options.huge_pages && madvise(data, size, MADV_HUGEPAGE) == 0) {
+    storage->huge_pages_ = HugePages::kTransparent;
+  }
+#endif
+  return storage;
+}
+
+size_t MappedFileStorage::resident_size() const {
+  size_t page_size = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+  size_t num_pages = (size_ + page_size - 1) / page_size;
+#ifdef __linux__
+  std::vector<unsigned char> pages(num_pages);
+#else
+  // char on macOS and the BSDs
+  std::vector<char> pages(num_pages);
+#endif
+  if (mincore(data_, size_, pages.data()) != 0) {
+    return size_;
+  }
+  size_t resident = 0;
+  for (size_t i = 0; i < num_pages; i++) {
+    resident += pages[i] & 1;
+  }
+  return std::min(resident * page_size, size_);
+}
+
+#endif
+
+}  // namespace node_darts
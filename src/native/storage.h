@@ -0,0 +1,151 @@
+#ifndef DARTS_STORAGE_H_
+#define DARTS_STORAGE_H_
+
+// Include standard library header files first
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace node_darts {
+
+// Huge pages backing a storage, as requested from the OS
+enum class HugePages {
+  kNone,
+  // Transparent huge pages (MADV_HUGEPAGE), which the kernel provides where it can
+  kTransparent,
+  // Pages from the reserved pool (MAP_HUGETLB)
+  kExplicit,
+};
+
+// NUMA node of the CPU the calling thread runs on, or -1 where it cannot be told
+int CurrentNumaNode();
+
+// Memory holding a serialized double array that a dictionary reads in place.
+// The dictionary keeps its storage alive for as long as the array is in use.
+class ArrayStorage {
+ public:
+  virtual ~ArrayStorage() {}
+
+  virtual const void* data() const = 0;
+  // Size in bytes
+  virtual size_t size() const = 0;
+  // Bytes currently in physical memory
+  virtual size_t resident_size() const { return size(); }
+  // Whether the bytes are mapped from a file rather than allocated
+  virtual bool mapped() const { return false; }
+  virtual HugePages huge_pages() const { return HugePages::kNone; }
+  // NUMA node the memory is bound to, or -1 if the kernel places it
+  virtual int numa_node() const { return -1; }
+};
+
+// Serialized dictionary held in memory, e.g. a dictionary file read in full
+class BufferStorage : public ArrayStorage {
+ public:
+  explicit BufferStorage(std::vector<char> bytes) : bytes_(std::move(bytes)) {}
+
+  // Reads the whole file, returning nullptr and setting error on failure
+  static std::unique_ptr<BufferStorage> ReadFile(const std::string& path, std::string* error);
+
+  const void* data() const override { return bytes_.data(); }
+  size_t size() const override { return bytes_.size(); }
+
+ private:
+  // The allocation is aligned for any unit type
+  std::vector<char> bytes_;
+};
+
+// How the memory of a PageStorage is allocated
+struct PageOptions {
+  // Back the memory with huge pages, so that lookups across a large array miss the TLB
+  // less: explicit ones while the reserved pool has room, transparent ones otherwise
+  bool huge_pages = false;
+  // NUMA node to bind the memory to (mbind, Linux only), or -1 for the default policy
+  int numa_node = -1;
+};
+
+// Anonymous memory allocated in whole pages for a serialized dictionary, e.g. a dictionary
+// file read in full into huge pages or onto a given NUMA node.
+// Placement is best effort: what the OS cannot provide falls back to ordinary pages and the
+// default policy, which huge_pages() and numa_node() then report.
+class PageStorage : public ArrayStorage {
+ public:
+  ~PageStorage() override;
+
+  // Allocates size bytes, returning nullptr and setting error on failure
+  static std::unique_ptr<PageStorage> Allocate(size_t size, const PageOptions& options,
+                                               std::string* error);
+  // Reads the whole file, returning nullptr and setting error on failure
+  static std::unique_ptr<PageStorage> ReadFile(const std::string& path,
+                                               const PageOptions& options, std::string* error);
+
+  void* mutable_data() { return data_; }
+  const void* data() const override { return data_; }
+  size_t size() const override { return size_; }
+  HugePages huge_pages() const override { return huge_pages_; }
+  int numa_node() const override { return numa_node_; }
+
+ private:
+  PageStorage()
+      : data_(nullptr), size_(0), mapping_(nullptr), mapping_size_(0),
+        huge_pages_(HugePages::kNone), numa_node_(-1) {}
+  PageStorage(const PageStorage&) = delete;
+  PageStorage& operator=(const PageStorage&) = delete;
+
+  void* data_;
+  size_t size_;
+  // The whole allocation, which starts before data_ when it was aligned
+  void* mapping_;
+  size_t mapping_size_;
+  HugePages huge_pages_;
+  int numa_node_;
+};
+
+// Access hints for a mapped dictionary file
+struct MapOptions {
+  // Read the whole file into the page cache ahead of time (MADV_WILLNEED)
+  bool prewarm = false;
+  // Disable read-ahead for lookup-heavy workloads (MADV_RANDOM)
+  bool random_access = false;
+  // Ask for transparent huge pages (MADV_HUGEPAGE); for files in the page cache this needs a
+  // kernel that collapses read-only file pages, while files on hugetlbfs always get them
+  bool huge_pages = false;
+};
+
+// Read-only mapping of a dictionary file.
+// Pages are shared through the page cache by every process and worker that maps
+// the same file, and nothing is read until a lookup touches it.
+// The file must not be modified or truncated while it is mapped.
+class MappedFileStorage : public ArrayStorage {
+ public:
+  ~MappedFileStorage() override;
+
+  // Maps the file, returning nullptr and setting error on failure
+  static std::unique_ptr<MappedFileStorage> Open(const std::string& path,
+                                                 const MapOptions& options,
+                                                 std::string* error);
+
+  const void* data() const override { return data_; }
+  size_t size() const override { return size_; }
+  // Pages of the mapping that are in the page cache (mincore); the mapped size on Windows
+  size_t resident_size() const override;
+  bool mapped() const override { return true; }
+  HugePages huge_pages() const override { return huge_pages_; }
+
+ private:
+  MappedFileStorage()
+      : data_(nullptr), size_(0), mapping_(nullptr), huge_pages_(HugePages::kNone) {}
+  MappedFileStorage(const MappedFileStorage&) = delete;
+  MappedFileStorage& operator=(const MappedFileStorage&) = delete;
+
+  void* data_;
+  size_t size_;
+  // File mapping object on Windows, unused elsewhere
+  void* mapping_;
+  HugePages huge_pages_;
+};
+
+}  // namespace node_darts
+
+#endif  // DARTS_STORAGE_H_
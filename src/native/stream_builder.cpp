@@ -0,0 +1,327 @@
+#include "stream_builder.h"
+#include <cerrno>
+#include <climits>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <utility>
+#include "key_arena.h"
+
+namespace node_darts {
+
+namespace {
+
+// Key data held in memory before a sorted run is spilled to a temporary file
+const size_t kDefaultMemoryLimit = static_cast<size_t>(256) << 20;
+
+// Chunk size used when reading a key file
+const size_t kFileChunkSize = static_cast<size_t>(1) << 20;
+
+// Splits "key[\tvalue]\n" lines, including lines that span chunk boundaries
+class KeyLineReader {
+ public:
+  bool Feed(const char* data, size_t size, ExternalKeySorter* sorter, std::string* error) {
+    const char* end = data + size;
+    while (data < end) {
+      const char* newline = static_cast<const char*>(std::memchr(data, '\n', end - data));
+      if (!newline) {
+        pending_.append(data, end - data);
+        return true;
+      }
+
+      bool ok;
+      if (pending_.empty()) {
+        ok = ParseLine(data, newline - data, sorter, error);
+      } else {
+        pending_.append(data, newline - data);
+        ok = ParseLine(pending_.data(), pending_.length(), sorter, error);
+        pending_.clear();
+      }
+      if (!ok) {
+        return false;
+      }
+      data = newline + 1;
+    }
+    return true;
+  }
+
+  // Parses the last line if the input did not end with a newline
+  bool Flush(ExternalKeySorter* sorter, std::string* error) {
+    if (pending_.empty()) {
+      return true;
+    }
+    bool ok = ParseLine(pending_.data(), pending_.length(), sorter, error);
+    pending_.clear();
+    return ok;
+  }
+
+ private:
+  bool ParseLine(const char* line, size_t length, ExternalKeySorter* sorter, std::string* error) {
+    line_number_++;
+    if (length > 0 && line[length - 1] == '\r') {
+      length--;
+    }
+    // Blank lines are skipped
+    if (length == 0) {
+      return true;
+    }
+
+    size_t key_length = length;
+    int value = kAutoValue;
+    const char* tab = static_cast<const char*>(std::memchr(line, '\t', length));
+    if (tab) {
+      key_length = tab - line;
+      if (!ParseValue(tab + 1, line + length, &value)) {
+        *error = "Invalid value on line " + std::to_string(line_number_);
+        return false;
+      }
+    }
+    if (key_length == 0) {
+      *error = "Empty key on line " + std::to_string(line_number_);
+      return false;
+    }
+
+    return sorter->Add(line, key_length, value, error);
+  }
+
+  // Values are non-negative 32-bit integers, as Darts stores them
+  static bool ParseValue(const char* begin, const char* end, int* value) {
+    if (begin == end) {
+      return false;
+    }
+    long long result = 0;
+    for (const char* p = begin; p < end; p++) {
+      if (*p < '0' || *p > '9') {
+        return false;
+      }
+      result = result * 10 + (*p - '0');
+      if (result > INT_MAX) {
+        return false;
+      }
+    }
+    *value = static_cast<int>(result);
+    return true;
+  }
+
+  std::string pending_;
+  size_t line_number_ = 0;
+};
+
+size_t ReadMemoryLimit(const Napi::Value& value) {
+  if (value.IsNumber()) {
+    double limit = value.As<Napi::Number>().DoubleValue();
+    if (limit >= 1) {
+      return static_cast<size_t>(limit);
+    }
+  }
+  return kDefaultMemoryLimit;
+}
+
+}  // namespace
+
+struct StreamBuildState {
+  explicit StreamBuildState(size_t memory_limit) : sorter(memory_limit) {}
+
+  ExternalKeySorter sorter;
+  KeyLineReader reader;
+};
+
+namespace {
+
+// Merges the collected keys and builds the Double-Array on the libuv threadpool
+class StreamBuildWorker : public Napi::AsyncWorker {
+ public:
+  StreamBuildWorker(Napi::Env env, std::unique_ptr<StreamBuildState> state)
+      : Napi::AsyncWorker(env, "node_darts:streamBuild"),
+        deferred_(Napi::Promise::Deferred::New(env)),
+        state_(std::move(state)) {}
+
+  // Reads the key file on the threadpool as well
+  StreamBuildWorker(Napi::Env env, std::unique_ptr<StreamBuildState> state, std::string path)
+      : StreamBuildWorker(env, std::move(state)) {
+    path_ = std::move(path);
+  }
+
+  Napi::Promise Promise() const { return deferred_.Promise(); }
+
+  void Execute() override {
+    try {
+      std::string error;
+      if (!path_.empty() && !ReadFile(&error)) {
+        SetError(error);
+        return;
+      }
+      if (!state_->reader.Flush(&state_->sorter, &error)) {
+        SetError(error);
+        return;
+      }
+      dict_ = state_->sorter.Finish(&error);
+      if (!dict_) {
+        SetError(error);
+      }
+    } catch (const std::exception& e) {
+      SetError(e.what());
+    }
+  }
+
+  void OnOK() override {
+    // Handles are only ever published from the main thread
+    uint32_t handle = AddDictionary(Env(), dict_.release());
+    deferred_.Resolve(Napi::Number::New(Env(), handle));
+  }
+
+  void OnError(const Napi::Error& e) override {
+    deferred_.Reject(e.Value());
+  }
+
+ private:
+  bool ReadFile(std::string* error) {
+    FILE* file = std::fopen(path_.c_str(), "rb");
+    if (!file) {
+      *error = std::string("Cannot open file: ") + std::strerror(errno);
+      return false;
+    }
+
+    std::vector<char> chunk(kFileChunkSize);
+    bool ok = true;
+    size_t read_size;
+    while (ok && (read_size = std::fread(chunk.data(), 1, chunk.size(), file)) > 0) {
+      ok = state_->reader.Feed(chunk.data(), read_size, &state_->sorter, error);
+    }
+    if (ok && std::ferror(file)) {
+      *error = std::string("Failed to read file: ") + std::strerror(errno);
+      ok = false;
+    }
+    std::fclose(file);
+    return ok;
+  }
+
+  Napi::Promise::Deferred deferred_;
+  std::unique_ptr<StreamBuildState> state_;
+  std::string path_;
+  std::unique_ptr<DartsDict> dict_;
+};
+
+}  // namespace
+
+void StreamBuilder::Init(Napi::Env env) {
+  Napi::Function func = DefineClass(env, "StreamBuilder", {
+    InstanceMethod("add", &StreamBuilder::Add),
+    InstanceMethod("finish", &StreamBuilder::Finish),
+    InstanceAccessor("size", &StreamBuilder::GetSize, nullptr),
+  });
+
+  // The constructor is not exported; builders are only created through createStreamBuilder
+  GetAddonData(env)->stream_builder_constructor = Napi::Persistent(func);
+}
+
+Napi::Value StreamBuilder::New(Napi::Env env, size_t memory_limit) {
+  Napi::Object obj = GetAddonData(env)->stream_builder_constructor.New({});
+  StreamBuilder* builder = Unwrap(obj);
+  builder->state_.reset(new StreamBuildState(memory_limit));
+  return obj;
+}
+
+StreamBuilder::StreamBuilder(const Napi::CallbackInfo& info)
+    : Napi::ObjectWrap<StreamBuilder>(info) {}
+
+StreamBuilder::~StreamBuilder() {}
+
+Napi::Value StreamBuilder::Add(const Napi::CallbackInfo& info) {
+  Napi::Env env = info.Env();
+
+  try {
+    if (!state_) {
+      Napi::Error::New(env, "Stream builder has already been finished or has failed").ThrowAsJavaScriptException();
+      return env.Null();
+    }
+
+    std::string error;
+    bool ok;
+    if (info.Length() >= 1 && info[0].IsString()) {
+      std::string chunk = info[0].As<Napi::String>().Utf8Value();
+      ok = state_->reader.Feed(chunk.data(), chunk.length(), &state_->sorter, &error);
+    } else if (info.Length() >= 1 && info[0].IsTypedArray() &&
+               info[0].As<Napi::TypedArray>().TypedArrayType() == napi_uint8_array) {
+      Napi::Uint8Array chunk = info[0].As<Napi::Uint8Array>();
+      ok = state_->reader.Feed(reinterpret_cast<const char*>(chunk.Data()), chunk.ElementLength(),
+                               &state_->sorter, &error);
+    } else {
+      Napi::TypeError::New(env, "Argument: (chunk: string | Uint8Array) expected").ThrowAsJavaScriptException();
+      return env.Null();
+    }
+
+    if (!ok) {
+      // The input is no longer consistent, so the builder cannot be used any further
+      state_.reset();
+      Napi::Error::New(env, error).ThrowAsJavaScriptException();
+      return env.Null();
+    }
+
+    return env.Undefined();
+  } catch (const std::exception& e) {
+    Napi::Error::New(env, e.what()).ThrowAsJavaScriptException();
+    return env.Null();
+  }
+}
+
+Napi::Value StreamBuilder::Finish(const Napi::CallbackInfo& info) {
+  Napi::Env env = info.Env();
+
+  try {
+    if (!state_) {
+      Napi::Error::New(env, "Stream builder has already been finished or has failed").ThrowAsJavaScriptException();
+      return env.Null();
+    }
+
+    StreamBuildWorker* worker = new StreamBuildWorker(env, std::move(state_));
+    Napi::Promise promise = worker->Promise();
+    worker->Queue();
+    return promise;
+  } catch (const std::exception& e) {
+    Napi::Error::New(env, e.what()).ThrowAsJavaScriptException();
+    return env.Null();
+  }
+}
+
+Napi::Value StreamBuilder::GetSize(const Napi::CallbackInfo& info) {
+  size_t size = state_ ? state_->sorter.size() : 0;
+  return Napi::Number::New(info.Env(), static_cast<double>(size));
+}
+
+Napi::Value CreateStreamBuilder(const Napi::CallbackInfo& info) {
+  Napi::Env env = info.Env();
+
+  try {
+    size_t memory_limit = info.Length() >= 1 ? ReadMemoryLimit(info[0]) : kDefaultMemoryLimit;
+    return StreamBuilder::New(env, memory_limit);
+  } catch (const std::exception& e) {
+    Napi::Error::New(env, e.what()).ThrowAsJavaScriptException();
+    return env.Null();
+  }
+}
+
+Napi::Value BuildFromFileAsync(const Napi::CallbackInfo& info) {
+  Napi::Env env = info.Env();
+
+  try {
+    if (info.Length() < 1 || !info[0].IsString()) {
+      Napi::TypeError::New(env, "Arguments: (filePath: string, memoryLimit?: number) expected").ThrowAsJavaScriptException();
+      return env.Null();
+    }
+
+    std::string path = info[0].As<Napi::String>().Utf8Value();
+    size_t memory_limit = info.Length() >= 2 ? ReadMemoryLimit(info[1]) : kDefaultMemoryLimit;
+
+    std::unique_ptr<StreamBuildState> state(new StreamBuildState(memory_limit));
+    StreamBuildWorker* worker = new StreamBuildWorker(env, std::move(state), std::move(path));
+    Napi::Promise promise = worker->Promise();
+    worker->Queue();
+    return promise;
+  } catch (const std::exception& e) {
+    Napi::Error::New(env, e.what()).ThrowAsJavaScriptException();
+    return env.Null();
+  }
+}
+
+}  // namespace node_darts
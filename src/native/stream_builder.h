@@ -0,0 +1,41 @@
+#ifndef DARTS_STREAM_BUILDER_H_
+#define DARTS_STREAM_BUILDER_H_
+
+// Include standard library header files first
+#include <cstdint>
+#include <cstddef>
+#include <memory>
+
+#include <napi.h>
+#include "common.h"
+
+namespace node_darts {
+
+struct StreamBuildState;
+
+// Builds a dictionary from "key[\tvalue]" lines pushed in chunks.
+// Keys are collected in native memory (spilling sorted runs to temporary files past the
+// memory limit), so no JS array of keys is ever needed.
+class StreamBuilder : public Napi::ObjectWrap<StreamBuilder> {
+ public:
+  static void Init(Napi::Env env);
+  static Napi::Value New(Napi::Env env, size_t memory_limit);
+
+  explicit StreamBuilder(const Napi::CallbackInfo& info);
+  ~StreamBuilder() override;
+
+ private:
+  Napi::Value Add(const Napi::CallbackInfo& info);
+  Napi::Value Finish(const Napi::CallbackInfo& info);
+  Napi::Value GetSize(const Napi::CallbackInfo& info);
+
+  // Handed over to the build worker by finish()
+  std::unique_ptr<StreamBuildState> state_;
+};
+
+Napi::Value CreateStreamBuilder(const Napi::CallbackInfo& info);
+Napi::Value BuildFromFileAsync(const Napi::CallbackInfo& info);
+
+}  // namespace node_darts
+
+#endif  // DARTS_STREAM_BUILDER_H_
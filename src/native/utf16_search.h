@@ -0,0 +1,92 @@
+#ifndef DARTS_UTF16_SEARCH_H_
+#define DARTS_UTF16_SEARCH_H_
+
+// Include standard library header files first
+#include <cstddef>
+#include <cstdint>
+
+namespace node_darts {
+
+// Searches of a UTF-8 trie with UTF-16 text, as JS strings hold it.
+// Each code point is encoded to UTF-8 only when the walk reaches it, so a text is never
+// transcoded as a whole, and positions and lengths come out in UTF-16 code units that
+// index the JS string directly. Lone surrogates are read as U+FFFD, as V8 encodes them.
+
+inline bool IsHighSurrogate(char16_t unit) { return unit >= 0xD800 && unit <= 0xDBFF; }
+inline bool IsLowSurrogate(char16_t unit) { return unit >= 0xDC00 && unit <= 0xDFFF; }
+
+// Code units taken by the code point at text[pos], 1 or 2
+inline size_t CodePointUnits(const char16_t* text, size_t length, size_t pos) {
+  return IsHighSurrogate(text[pos]) && pos + 1 < length && IsLowSurrogate(text[pos + 1]) ? 2 : 1;
+}
+
+// Encodes the code point at text[pos] into bytes (at least 4 of them) and returns the number
+// of bytes written; units receives the code units it takes
+inline size_t EncodeCodePoint(const char16_t* text, size_t length, size_t pos, char* bytes,
+                              size_t* units) {
+  uint32_t c = text[pos];
+  *units = CodePointUnits(text, length, pos);
+  if (*units == 2) {
+    c = 0x10000 + ((c - 0xD800) << 10) + (text[pos + 1] - 0xDC00);
+  } else if (IsHighSurrogate(text[pos]) || IsLowSurrogate(text[pos])) {
+    c = 0xFFFD;
+  }
+
+  if (c < 0x80) {
+    bytes[0] = static_cast<char>(c);
+    return 1;
+  }
+  if (c < 0x800) {
+    bytes[0] = static_cast<char>(0xC0 | (c >> 6));
+    bytes[1] = static_cast<char>(0x80 | (c & 0x3F));
+    return 2;
+  }
+  if (c < 0x10000) {
+    bytes[0] = static_cast<char>(0xE0 | (c >> 12));
+    bytes[1] = static_cast<char>(0x80 | ((c >> 6) & 0x3F));
+    bytes[2] = static_cast<char>(0x80 | (c & 0x3F));
+    return 3;
+  }
+  bytes[0] = static_cast<char>(0xF0 | (c >> 18));
+  bytes[1] = static_cast<char>(0x80 | ((c >> 12) & 0x3F));
+  bytes[2] = static_cast<char>(0x80 | ((c >> 6) & 0x3F));
+  bytes[3] = static_cast<char>(0x80 | (c & 0x3F));
+  return 4;
+}
+
+// Calls visit(value, units) for each key that is a prefix of the text, shortest first, with
+// the key's length in code units, as commonPrefixSearch does for bytes. The dictionary must
+// not be empty.
+template <class Dict, class Visitor>
+void CommonPrefixSearchUtf16(const Dict& dict, const char16_t* text, size_t length,
+                             Visitor visit) {
+  size_t node_pos = 0;
+  size_t pos = 0;
+  char bytes[4];
+  
+  // An empty key is the value of the root; traverse reads "" up to its terminator
+  size_t root_pos = 0;
+  int root_value = dict.traverse("", node_pos, root_pos, 0);
+  if (root_value >= 0) {
+    visit(root_value, 0);
+  }
+  
+  while (pos < length) {
+    size_t units = 0;
+    size_t num_bytes = EncodeCodePoint(text, length, pos, bytes, &units);
+    // traverse resumes from node_pos and reports the value of the node it stops at
+    size_t key_pos = 0;
+    int value = dict.traverse(bytes, node_pos, key_pos, num_bytes);
+    if (value == -2) {
+      return;
+    }
+    pos += units;
+    if (value >= 0) {
+      visit(value, pos);
+    }
+  }
+}
+
+}  // namespace node_darts
+
+#endif  // DARTS_UTF16_SEARCH_H_
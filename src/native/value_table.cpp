@@ -0,0 +1,101 @@
+#include "value_table.h"
+
+#include <cstring>
+#include <utility>
+
+#include "file_format.h"
+
+namespace node_darts {
+
+namespace {
+
+struct ValueTableHeader {
+  uint32_t stride;
+  // CRC-32 of the offsets and the fields
+  uint32_t checksum;
+  uint64_t num_groups;
+  uint64_t num_entries;
+};
+
+}  // namespace
+
+ValueTable::ValueTable(size_t stride, std::vector<uint64_t> offsets, std::vector<int64_t> fields)
+    : stride_(stride),
+      num_groups_(offsets.empty() ? 0 : offsets.size() - 1),
+      num_entries_(stride == 0 ? 0 : fields.size() / stride),
+      owned_offsets_(std::move(offsets)),
+      owned_fields_(std::move(fields)) {
+  offsets_ = owned_offsets_.data();
+  fields_ = owned_fields_.data();
+}
+
+std::unique_ptr<ValueTable> ValueTable::Parse(const void* data, size_t size, bool verify,
+                                              std::string* error) {
+  ValueTableHeader header;
+  if (size < sizeof(header)) {
+    *error = "Invalid value table";
+    return nullptr;
+  }
+  std::memcpy(&header, data, sizeof(header));
+
+  // Sizes are checked in fields so that a forged header cannot overflow them
+  size_t available = (size - sizeof(header)) / sizeof(uint64_t);
+  if (header.stride == 0 || (size - sizeof(header)) % sizeof(uint64_t) != 0 ||
+      header.num_groups >= available ||
+      header.num_entries > (available - header.num_groups - 1) / header.stride ||
+      available != header.num_groups + 1 + header.num_entries * header.stride) {
+    *error = "Value table size does not match its header";
+    return nullptr;
+  }
+
+  const char* body = static_cast<const char*>(data) + sizeof(header);
+  if (verify && Crc32(body, size - sizeof(header)) != header.checksum) {
+    *error = "Value table checksum mismatch";
+    return nullptr;
+  }
+
+  std::unique_ptr<ValueTable> table(new ValueTable());
+  table->stride_ = header.stride;
+  table->num_groups_ = static_cast<size_t>(header.num_groups);
+  table->num_entries_ = static_cast<size_t>(header.num_entries);
+  table->offsets_ = reinterpret_cast<const uint64_t*>(body);
+  table->fields_ = reinterpret_cast<const int64_t*>(body) + table->num_groups_ + 1;
+  return table;
+}
+
+bool ValueTable::Find(int group, size_t* offset, size_t* count) const {
+  if (group < 0 || static_cast<size_t>(group) >= num_groups_) {
+    return false;
+  }
+  // Offsets read in place are not trusted to be ordered
+  uint64_t begin = offsets_[group];
+  uint64_t end = offsets_[group + 1];
+  if (begin > end || end > num_entries_) {
+    return false;
+  }
+  *offset = static_cast<size_t>(begin);
+  *count = static_cast<size_t>(end - begin);
+  return true;
+}
+
+size_t ValueTable::byte_size() const {
+  return sizeof(ValueTableHeader) + (num_groups_ + 1 + num_entries_ * stride_) * sizeof(uint64_t);
+}
+
+bool ValueTable::Write(ByteWriter* out) const {
+  size_t offsets_size = (num_groups_ + 1) * sizeof(uint64_t);
+  size_t fields_size = num_entries_ * stride_ * sizeof(int64_t);
+
+  ValueTableHeader header;
+  std::memset(&header, 0, sizeof(header));
+  header.stride = static_cast<uint32_t>(stride_);
+  header.checksum = Crc32(fields_, fields_size, Crc32(offsets_, offsets_size));
+  header.num_groups = num_groups_;
+  header.num_entries = num_entries_;
+
+  return out->Write(&header, sizeof(header)) &&
+         out->Write(offsets_, offsets_size) &&
+         (fields_size == 0 || out->Write(fields_, fields_size));
+}
+
+}  // namespace node_darts
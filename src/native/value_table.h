@@ -0,0 +1,62 @@
+#ifndef DARTS_VALUE_TABLE_H_
+#define DARTS_VALUE_TABLE_H_
+
+// Include standard library header files first
+#include <cstdint>
+#include <cstddef>
+#include <cstdio>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace node_darts {
+
+class ByteWriter;
+
+// Entries of 64-bit fields stored alongside a dictionary and found through it: the value
+// of a key in the trie is a group number, and group g spans the entries
+// [offsets[g], offsets[g + 1]). Each entry has stride fields, so a key can carry several
+// payloads wider than the 31 bits a Darts leaf holds.
+//
+// Serialized as a section of a dictionary file: a ValueTableHeader, the num_groups + 1
+// offsets (uint64), then num_entries * stride fields (int64).
+class ValueTable {
+ public:
+  // Owns the table; offsets must start at 0 and end at the number of entries
+  ValueTable(size_t stride, std::vector<uint64_t> offsets, std::vector<int64_t> fields);
+
+  // Reads a serialized table in place; the memory must outlive the table.
+  // verify also checks the table against its checksum.
+  // Returns nullptr and sets error if the data is not a valid table.
+  static std::unique_ptr<ValueTable> Parse(const void* data, size_t size, bool verify,
+                                           std::string* error);
+
+  size_t stride() const { return stride_; }
+  size_t num_groups() const { return num_groups_; }
+  size_t num_entries() const { return num_entries_; }
+  const int64_t* fields() const { return fields_; }
+
+  // Gets the entries of a group, returning false if the table has no such group
+  bool Find(int group, size_t* offset, size_t* count) const;
+
+  // Size of the serialized table, a multiple of 8 bytes
+  size_t byte_size() const;
+  // Appends the serialized table to out, returning false on error
+  bool Write(ByteWriter* out) const;
+
+ private:
+  ValueTable() {}
+
+  size_t stride_ = 1;
+  size_t num_groups_ = 0;
+  size_t num_entries_ = 0;
+  const uint64_t* offsets_ = nullptr;
+  const int64_t* fields_ = nullptr;
+  // Empty for a table read in place
+  std::vector<uint64_t> owned_offsets_;
+  std::vector<int64_t> owned_fields_;
+};
+
+}  // namespace node_darts
+
+#endif  // DARTS_VALUE_TABLE_H_
@@ -8,7 +8,15 @@
 import * as fs from 'fs';
 import Dictionary from './core/dictionary';
 import Builder from './core/builder';
-import { WordReplacer, TraverseCallback, BuildOptions } from './core/types';
+import TraverseCursor from './core/cursor';
+import {
+  WordReplacer,
+  TraverseCallback,
+  BuildOptions,
+  LoadOptions,
+  PredictiveSearchResult,
+  TokenizeMode,
+} from './core/types';
 import { dartsNative } from './core/native';
 import { FileNotFoundError } from './core/errors';
 
@@ -26,18 +34,14 @@ const registry = new FinalizationRegistry((handle: number) => {
 export default class TextDarts {
   private dictionary: Dictionary;
 
-  private words: string[];
-
   private isDisposed: boolean;
 
   /**
    * Private constructor - use static methods instead
    * @param dictionary Dictionary object
-   * @param words Array of words
    */
-  private constructor(dictionary: Dictionary, words: string[]) {
+  private constructor(dictionary: Dictionary) {
     this.dictionary = dictionary;
-    this.words = words;
     this.isDisposed = false;
 
     // Register for automatic cleanup when garbage collected
@@ -67,25 +71,24 @@ export default class TextDarts {
   public static build(keys: string[], values?: number[], options?: BuildOptions): TextDarts {
     const builder = new Builder();
     const dictionary = builder.build(keys, values, options);
-    return new TextDarts(dictionary, keys);
+    return new TextDarts(dictionary);
   }
 
   /**
    * Creates a new TextDarts object from a dictionary file
    * @param filePath Path to the dictionary file
+   * @param options Optional load options
    * @returns A new TextDarts object
    */
-  public static load(filePath: string): TextDarts {
+  public static load(filePath: string, options?: LoadOptions): TextDarts {
     // Check if file exists
     if (!fs.existsSync(filePath)) {
       throw new FileNotFoundError(filePath);
     }
 
     const dictionary = new Dictionary();
-    dictionary.loadSync(filePath);
-    // Note: We don't have the original words in this case
-    // This will limit the functionality of replaceWords
-    return new TextDarts(dictionary, []);
+    dictionary.loadSync(filePath, options);
+    return new TextDarts(dictionary);
   }
 
   /**
@@ -135,6 +138,27 @@ export default class TextDarts {
     return this.dictionary.replaceWords(text, replacer);
   }
 
+  /**
+   * Splits a text into tokens
+   * @param text The text to split
+   * @param mode How the text is split (default 'longest')
+   * @returns Flat array of (start, length, value) triples in UTF-16 code units
+   */
+  public tokenize(text: string, mode?: TokenizeMode): Int32Array {
+    this.ensureNotDisposed();
+    return this.dictionary.tokenize(text, mode);
+  }
+
+  /**
+   * Finds every occurrence of every word in a text, overlapping ones included
+   * @param text The text to scan
+   * @returns Flat array of (start, length, value) triples in UTF-16 code units
+   */
+  public scan(text: string): Int32Array {
+    this.ensureNotDisposed();
+    return this.dictionary.scan(text);
+  }
+
   /**
    * Performs an exact match search
    * @param key The key to search for
@@ -155,6 +179,28 @@ export default class TextDarts {
     return this.dictionary.commonPrefixSearch(key);
   }
 
+  /**
+   * Performs a predictive search
+   * @param prefix The prefix to search for
+   * @param limit Maximum number of results (0 or omitted for all)
+   * @returns Array of values of the keys starting with the prefix
+   */
+  public predictiveSearch(prefix: string, limit?: number): number[] {
+    this.ensureNotDisposed();
+    return this.dictionary.predictiveSearch(prefix, limit);
+  }
+
+  /**
+   * Performs a predictive search that also returns the keys
+   * @param prefix The prefix to search for
+   * @param limit Maximum number of results (0 or omitted for all)
+   * @returns Array of keys starting with the prefix and their values
+   */
+  public predictiveSearchKeys(prefix: string, limit?: number): PredictiveSearchResult[] {
+    this.ensureNotDisposed();
+    return this.dictionary.predictiveSearchKeys(prefix, limit);
+  }
+
   /**
    * Traverses the trie
    * @param key The key to start traversal from
@@ -165,6 +211,15 @@ export default class TextDarts {
     this.dictionary.traverse(key, callback);
   }
 
+  /**
+   * Creates a cursor for incremental traversal
+   * @returns A cursor positioned at the root
+   */
+  public createCursor(): TraverseCursor {
+    this.ensureNotDisposed();
+    return this.dictionary.createCursor();
+  }
+
   /**
    * Loads a dictionary file asynchronously
    * @param filePath Path to the dictionary file
@@ -172,10 +227,7 @@ export default class TextDarts {
    */
   public async load(filePath: string): Promise<boolean> {
     this.ensureNotDisposed();
-    const result = await this.dictionary.load(filePath);
-    // Note: We don't have the original words in this case
-    // This will limit the functionality of replaceWords
-    return result;
+    return this.dictionary.load(filePath);
   }
 
   /**
@@ -185,25 +237,29 @@ export default class TextDarts {
    */
   public loadSync(filePath: string): boolean {
     this.ensureNotDisposed();
-    const result = this.dictionary.loadSync(filePath);
-    // Note: We don't have the original words in this case
-    // This will limit the functionality of replaceWords
-    return result;
+    return this.dictionary.loadSync(filePath);
+  }
+
+  /**
+   * Restores the key that has the value
+   * @param value The value of the key
+   * @returns The key, or undefined if no key has the value
+   */
+  public restoreKey(value: number): string | undefined {
+    this.ensureNotDisposed();
+    return this.dictionary.restoreKey(value);
   }
 
   /**
    * Gets the size of the dictionary
-   * @returns The size of the dictionary
+   * @returns The number of keys, or the number of units for files saved without a header
    */
   public size(): number {
     this.ensureNotDisposed();
 
-    // If we have words array, return its size
-    if (this.words && this.words.length > 0) {
-      return this.words.length;
-    }
-    // Otherwise fall back to dictionary size
-    return this.dictionary.size();
+    // The key count is stored with the dictionary, whether built or loaded
+    const numKeys = this.dictionary.numKeys();
+    return numKeys > 0 ? numKeys : this.dictionary.size();
   }
 
   /**
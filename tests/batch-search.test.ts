@@ -0,0 +1,86 @@
+import { buildDictionary, encodeKeys, Dictionary, DartsError } from '../src';
+
+describe('Batch Search Tests', () => {
+  const keys = ['apple', 'banana', 'orange', '東京'];
+  const values = [100, 200, 300, 400];
+  let dict: Dictionary;
+
+  beforeEach(() => {
+    dict = buildDictionary(keys, values);
+  });
+
+  afterEach(() => {
+    dict.dispose();
+  });
+
+  describe('exactMatchSearchBatch', () => {
+    it('should return the value of each key', () => {
+      const results = dict.exactMatchSearchBatch(['banana', 'grape', '東京', 'apple', '']);
+      expect(Array.from(results)).toEqual([200, -1, 400, 100, -1]);
+    });
+
+    it('should write into a caller-supplied array', () => {
+      const results = new Int32Array(4);
+      const returned = dict.exactMatchSearchBatch(['orange', 'apple'], results);
+
+      expect(returned).toBe(results);
+      expect(Array.from(results)).toEqual([300, 100, 0, 0]);
+    });
+
+    it('should throw when the results array is too small', () => {
+      expect(() => {
+        dict.exactMatchSearchBatch(['orange', 'apple'], new Int32Array(1));
+      }).toThrow(DartsError);
+    });
+
+    it('should throw when a key is not a string', () => {
+      expect(() => {
+        dict.exactMatchSearchBatch(['orange', 1 as unknown as string]);
+      }).toThrow(DartsError);
+    });
+  });
+
+  describe('exactMatchSearchBuffer', () => {
+    it('should look up keys concatenated in a UTF-8 buffer', () => {
+      const { buffer, offsets } = encodeKeys(['東京', 'grape', 'banana', '']);
+      const results = dict.exactMatchSearchBuffer(buffer, offsets);
+      expect(Array.from(results)).toEqual([400, -1, 200, -1]);
+    });
+
+    it('should not treat a key as continuing into the next one', () => {
+      const { buffer, offsets } = encodeKeys(['app', 'le']);
+      const results = dict.exactMatchSearchBuffer(buffer, offsets);
+      expect(Array.from(results)).toEqual([-1, -1]);
+    });
+
+    it('should throw for offsets outside the buffer', () => {
+      const buffer = Buffer.from('apple');
+      expect(() => {
+        dict.exactMatchSearchBuffer(buffer, new Uint32Array([0, 10]));
+      }).toThrow(DartsError);
+    });
+  });
+
+  it('should give the same results as single lookups for many keys', () => {
+    const words = Array.from({ length: 500 }, (_, i) => `key${i * 7}`);
+    const darts = buildDictionary(words);
+    const compact = buildDictionary(words, undefined, { unitFormat: 'compact' });
+    const queries = Array.from({ length: 1000 }, (_, i) => `key${i * 3}`);
+
+    [darts, compact].forEach((d) => {
+      const expected = queries.map((query) => d.exactMatchSearch(query));
+      const { buffer, offsets } = encodeKeys(queries);
+      expect(Array.from(d.exactMatchSearchBatch(queries))).toEqual(expected);
+      expect(Array.from(d.exactMatchSearchBuffer(buffer, offsets))).toEqual(expected);
+    });
+
+    darts.dispose();
+    compact.dispose();
+  });
+
+  it('should return -1 for every key in an empty dictionary', () => {
+    const empty = new Dictionary();
+    expect(Array.from(empty.exactMatchSearchBatch(['apple']))).toEqual([-1]);
+    empty.dispose();
+  });
+});
@@ -1,7 +1,7 @@
 import * as path from 'path';
 import * as fs from 'fs';
 import * as os from 'os';
-import { Builder, Dictionary, BuildError } from '../src';
+import { Builder, Dictionary, BuildError, BuildOptions } from '../src';
 
 describe('Builder', () => {
   let tempDir: string;
@@ -103,34 +103,73 @@ describe('Builder', () => {
       }).toThrow('All values must be numbers');
     });
 
-    it('should call progress callback when provided', () => {
-      jest.useFakeTimers();
-
+    it('should throw error when values are negative', async () => {
       const builder = new Builder();
       const keys = ['apple', 'banana', 'orange'];
+      const values = [100, -1, 300];
+
+      // -1 must not be taken for a missing value and replaced by the key's index
+      expect(() => {
+        builder.build(keys, values);
+      }).toThrow(BuildError);
+      expect(() => {
+        builder.build(keys, values);
+      }).toThrow('Values must not be negative');
+      await expect(builder.buildAsync(keys, values)).rejects.toThrow(BuildError);
+    });
 
-      // Mock progress callback
+    it('should report native progress up to the final key', () => {
+      const builder = new Builder();
+      const keys = Array.from({ length: 2000 }, (_, i) => `key${i}`);
       const progressCallback = jest.fn();
 
-      const dict = builder.build(keys, undefined, { progressCallback });
+      const dict = builder.build(keys, undefined, { progressCallback, progressInterval: 0 });
+
+      // Reported synchronously, in order, ending with every key placed
+      const { calls } = progressCallback.mock;
+      expect(calls.length).toBeGreaterThan(1);
+      expect(calls[calls.length - 1]).toEqual([2000, 2000]);
+      for (let i = 1; i < calls.length; i += 1) {
+        expect(calls[i][0]).toBeGreaterThan(calls[i - 1][0]);
+      }
 
-      // Fast-forward timers
-      jest.advanceTimersByTime(100);
-      expect(progressCallback).toHaveBeenCalled();
+      dict.dispose();
+    });
 
-      // Fast-forward more to trigger clearInterval
-      jest.advanceTimersByTime(1000);
+    it('should stop when the signal is aborted from the progress callback', () => {
+      const builder = new Builder();
+      const keys = Array.from({ length: 2000 }, (_, i) => `key${i}`);
+      const controller = new AbortController();
+      const progressCallback = jest.fn(() => controller.abort());
+
+      expect(() =>
+        builder.build(keys, undefined, {
+          progressCallback,
+          progressInterval: 0,
+          signal: controller.signal,
+        })
+      ).toThrow('Build cancelled');
+      expect(progressCallback).toHaveBeenCalledTimes(1);
+    });
 
-      // Verify the callback was called
-      expect(progressCallback).toHaveBeenCalled();
+    it('should throw BuildError when the progress callback throws', () => {
+      const builder = new Builder();
+      const keys = Array.from({ length: 2000 }, (_, i) => `key${i}`);
+      const progressCallback = () => {
+        throw new Error('stop');
+      };
 
-      // Verify that the callback was called at least once
-      expect(progressCallback.mock.calls.length).toBeGreaterThan(0);
+      expect(() => builder.build(keys, undefined, { progressCallback })).toThrow(BuildError);
+    });
 
-      // Clean up
-      dict.dispose();
+    it('should throw BuildError when the signal is already aborted', () => {
+      const builder = new Builder();
+      const controller = new AbortController();
+      controller.abort();
 
-      jest.useRealTimers();
+      expect(() => builder.build(['apple'], undefined, { signal: controller.signal })).toThrow(
+        BuildError
+      );
     });
 
     // Note: Future tests to consider:
@@ -138,6 +177,226 @@ describe('Builder', () => {
     // 2. Test for throwing BuildError when native.build throws a non-BuildError
   });
 
+  describe('buildAsync', () => {
+    it('should build a dictionary on a background thread', async () => {
+      const builder = new Builder();
+      const dict = await builder.buildAsync(['orange', 'apple', 'banana'], [300, 100, 200]);
+
+      // Values stay attached to their keys even though the input is unsorted
+      expect(dict.exactMatchSearch('apple')).toBe(100);
+      expect(dict.exactMatchSearch('banana')).toBe(200);
+      expect(dict.exactMatchSearch('orange')).toBe(300);
+      expect(dict.exactMatchSearch('grape')).toBe(-1);
+
+      dict.dispose();
+    });
+
+    it('should use sorted indices as values when values are omitted', async () => {
+      const builder = new Builder();
+      const dict = await builder.buildAsync(['orange', 'apple', 'banana']);
+
+      expect(dict.exactMatchSearch('apple')).toBe(0);
+      expect(dict.exactMatchSearch('banana')).toBe(1);
+      expect(dict.exactMatchSearch('orange')).toBe(2);
+
+      dict.dispose();
+    });
+
+    it('should keep multi-byte and duplicate keys intact', async () => {
+      const builder = new Builder();
+      const keys = ['東京', 'tokyo', '東京都', 'tokyo', 'a\u{1F600}b'];
+      const dict = await builder.buildAsync(keys, [1, 2, 3, 4, 5]);
+
+      // The first occurrence of a duplicate key wins
+      expect(dict.exactMatchSearch('tokyo')).toBe(2);
+      expect(dict.exactMatchSearch('東京')).toBe(1);
+      expect(dict.exactMatchSearch('東京都')).toBe(3);
+      expect(dict.exactMatchSearch('a\u{1F600}b')).toBe(5);
+      expect(dict.exactMatchSearch('東')).toBe(-1);
+
+      dict.dispose();
+    });
+
+    it('should report progress when the build completes', async () => {
+      const builder = new Builder();
+      const progressCallback = jest.fn();
+      const dict = await builder.buildAsync(['apple', 'banana'], undefined, { progressCallback });
+
+      expect(progressCallback).toHaveBeenCalledWith(2, 2);
+
+      dict.dispose();
+    });
+
+    it('should deliver native progress before resolving', async () => {
+      const builder = new Builder();
+      const keys = Array.from({ length: 5000 }, (_, i) => `key${i}`);
+      const progressCallback = jest.fn();
+      const dict = await builder.buildAsync(keys, undefined, {
+        progressCallback,
+        progressInterval: 0,
+      });
+
+      const { calls } = progressCallback.mock;
+      expect(calls[calls.length - 1]).toEqual([5000, 5000]);
+      for (let i = 1; i < calls.length; i += 1) {
+        expect(calls[i][0]).toBeGreaterThan(calls[i - 1][0]);
+      }
+
+      dict.dispose();
+    });
+
+    it('should reject with BuildError when the signal is aborted', async () => {
+      const builder = new Builder();
+      const keys = Array.from({ length: 200000 }, (_, i) => `key${i}`);
+      const controller = new AbortController();
+
+      const promise = builder.buildAsync(keys, undefined, { signal: controller.signal });
+      controller.abort();
+      await expect(promise).rejects.toThrow('Build cancelled');
+      await expect(promise).rejects.toThrow(BuildError);
+
+      // An aborted signal rejects without starting a build
+      await expect(
+        builder.buildAsync(['apple'], undefined, { signal: controller.signal })
+      ).rejects.toThrow(BuildError);
+    });
+
+    it.each<[string, BuildOptions]>([
+      ['in parallel', { threads: 4 }],
+      ['with the free-list placement', { placement: 'freelist' }],
+      ['in parallel with the free-list placement', { threads: 4, placement: 'freelist' }],
+      ['with the compact unit format', { unitFormat: 'compact' }],
+    ])('should build the same dictionary %s', async (_, options) => {
+      const builder = new Builder();
+      const keys: string[] = [];
+      for (let i = 0; i < 20000; i += 1) {
+        keys.push(`${String.fromCharCode(0x3041 + (i % 80))}${i.toString(36)}`);
+      }
+      keys.push('a', 'ab', 'b');
+      const values = keys.map((_, i) => i * 3);
+
+      const sequential = await builder.buildAsync(keys, values);
+      const parallel = await builder.buildAsync(keys, values, options);
+
+      const probes = [...keys, 'abc', 'c', '', 'ぁ', `${keys[0]}x`];
+      probes.forEach((key) => {
+        expect(parallel.exactMatchSearch(key)).toBe(sequential.exactMatchSearch(key));
+        expect(parallel.commonPrefixSearch(key)).toEqual(sequential.commonPrefixSearch(key));
+      });
+
+      // The array is saved in the usual format
+      const parallelPath = path.join(tempDir, 'parallel.darts');
+      await parallel.save(parallelPath);
+      const loaded = new Dictionary();
+      await loaded.load(parallelPath);
+      expect(loaded.exactMatchSearch(keys[12345])).toBe(12345 * 3);
+
+      loaded.dispose();
+      sequential.dispose();
+      parallel.dispose();
+    });
+
+    it('should support every lookup on the compact unit format', async () => {
+      const builder = new Builder();
+      const keys = ['a', 'ab', 'abc', 'b', 'bcd', '東京', '東京都'];
+      const values = keys.map((_, i) => i + 10);
+      const darts = await builder.buildAsync(keys, values);
+      const compact = await builder.buildAsync(keys, values, { unitFormat: 'compact' });
+
+      // About half the units' bytes are gone, but not their contents
+      expect(compact.predictiveSearchKeys('')).toEqual(darts.predictiveSearchKeys(''));
+      expect(compact.predictiveSearch('ab', 1)).toEqual(darts.predictiveSearch('ab', 1));
+      expect(Array.from(compact.findMatches('xabcd東京都'))).toEqual(
+        Array.from(darts.findMatches('xabcd東京都'))
+      );
+
+      const cursor = compact.createCursor();
+      expect(cursor.advance('東')).toBe(-1);
+      expect(cursor.advance('京')).toBe(15);
+      expect(cursor.advance('x')).toBe(-2);
+
+      darts.dispose();
+      compact.dispose();
+    });
+
+    it('should reject keys with NUL characters in the compact unit format', async () => {
+      const builder = new Builder();
+      await expect(
+        builder.buildAsync(['a\u0000b'], undefined, { unitFormat: 'compact' })
+      ).rejects.toThrow(BuildError);
+      expect(() => builder.build(['a'], undefined, { unitFormat: 'packed' as 'compact' })).toThrow(
+        BuildError
+      );
+    });
+
+    it('should store a value table alongside the dictionary', async () => {
+      const builder = new Builder();
+      // (part of speech, cost, feature offset) per entry; "東京" has two entries
+      const keys = ['東京都', '東京', '京都'];
+      const entries = [
+        [1n, 200n, 0n],
+        [2, 100, 7, 3, -50, 1n << 40n],
+        new BigInt64Array([4n, 9n, 8n]),
+      ];
+      const dict = await builder.buildAsync(keys, undefined, {
+        valueTable: { stride: 3, entries },
+      });
+
+      const table = dict.getValueTable();
+      expect(table?.stride).toBe(3);
+      const tokyo = dict.exactMatchEntries('東京');
+      expect(tokyo).toEqual({ offset: 1, count: 2 });
+      expect(table?.entries[((tokyo?.offset ?? 0) + 1) * 3 + 2]).toBe(1n << 40n);
+      expect(dict.exactMatchEntries('東')).toBeNull();
+      expect(Array.from(dict.commonPrefixSearchEntries('東京都庁'))).toEqual([1, 2, 2, 0, 1, 3]);
+
+      // The table is saved in the same file and read back in place
+      const tablePath = path.join(tempDir, 'table.darts');
+      await dict.save(tablePath);
+      dict.dispose();
+      const loaded = new Dictionary();
+      await loaded.load(tablePath, { mmap: true });
+      expect(loaded.exactMatchEntries('京都')).toEqual({ offset: 3, count: 1 });
+      const loadedTable = loaded.getValueTable();
+      expect(Array.from(loadedTable?.entries.subarray(9, 12) ?? [])).toEqual([4n, 9n, 8n]);
+      loaded.dispose();
+
+      // Without a table, entry lookups fail
+      const plain = builder.build(keys);
+      expect(plain.getValueTable()).toBeUndefined();
+      expect(() => plain.exactMatchEntries('京都')).toThrow('Dictionary has no value table');
+      plain.dispose();
+    });
+
+    it('should reject value tables that do not match the keys', async () => {
+      const builder = new Builder();
+      await expect(
+        builder.buildAsync(['a', 'b'], [1, 2], { valueTable: { entries: [[1], [2]] } })
+      ).rejects.toThrow('Values cannot be combined with a value table');
+      expect(() =>
+        builder.build(['a', 'b'], undefined, { valueTable: { entries: [[1]] } })
+      ).toThrow(BuildError);
+      expect(() =>
+        builder.build(['a'], undefined, { valueTable: { stride: 2, entries: [[1, 2, 3]] } })
+      ).toThrow(BuildError);
+      expect(() => builder.build(['a'], undefined, { valueTable: { entries: [[0.5]] } })).toThrow(
+        BuildError
+      );
+      expect(() =>
+        builder.build(['a'], undefined, { valueTable: { stride: 2.5, entries: [[1, 2]] } })
+      ).toThrow('valueTable.stride must be a positive integer');
+      expect(() =>
+        builder.build(['a'], undefined, { valueTable: { stride: 0, entries: [[1]] } })
+      ).toThrow(BuildError);
+    });
+
+    it('should reject with BuildError for invalid input', async () => {
+      const builder = new Builder();
+      await expect(builder.buildAsync([])).rejects.toThrow(BuildError);
+      await expect(builder.buildAsync(['apple'], [1, 2])).rejects.toThrow(BuildError);
+    });
+  });
+
   describe('buildAndSave', () => {
     it('should build and save a dictionary asynchronously', async () => {
       const builder = new Builder();
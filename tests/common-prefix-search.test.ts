@@ -1,7 +1,7 @@
 import * as path from 'path';
 import * as fs from 'fs';
 import * as os from 'os';
-import { buildDictionary } from '../src';
+import { buildDictionary, createDictionary, DartsError } from '../src';
 
 describe('Common Prefix Search Tests', () => {
   let tempDir: string;
@@ -101,5 +101,160 @@ describe('Common Prefix Search Tests', () => {
       dict.dispose();
       dict2.dispose();
     });
+
+    it('should return every match when there are more than 100 prefixes', () => {
+      // 150 keys that are all prefixes of the longest one
+      const keys = Array.from({ length: 150 }, (_, i) => 'a'.repeat(i + 1));
+      const values = keys.map((_, i) => i);
+
+      const dict = buildDictionary(keys, values);
+
+      const results = dict.commonPrefixSearch('a'.repeat(200));
+      expect(results).toEqual(values);
+
+      dict.dispose();
+    });
+
+    it('should return an empty array for an empty dictionary', () => {
+      const dict = createDictionary();
+      expect(dict.commonPrefixSearch('apple')).toEqual([]);
+      expect(dict.commonPrefixSearchPairs('apple')).toHaveLength(0);
+      dict.dispose();
+    });
+  });
+
+  describe('commonPrefixSearchPairs', () => {
+    it('should return values with match lengths', () => {
+      const dict = buildDictionary(['a', 'app', 'apple', 'banana'], [1, 3, 100, 300]);
+
+      const pairs = dict.commonPrefixSearchPairs('applesauce');
+      expect(Array.from(pairs)).toEqual([1, 1, 3, 3, 100, 5]);
+
+      expect(dict.commonPrefixSearchPairs('cherry')).toHaveLength(0);
+
+      dict.dispose();
+    });
+
+    it('should report lengths in UTF-16 code units', () => {
+      const dict = buildDictionary(['東', '東京', '東京🗼'], [1, 2, 3]);
+
+      const text = '東京🗼タワー';
+      const pairs = dict.commonPrefixSearchPairs(text);
+      expect(Array.from(pairs)).toEqual([1, 1, 2, 2, 3, 4]);
+      expect(text.substring(0, pairs[5])).toBe('東京🗼');
+
+      dict.dispose();
+    });
+  });
+
+  describe('commonPrefixSearchInto', () => {
+    const keys = ['a', 'ap', 'app', 'apple'];
+    const values = [1, 2, 3, 100];
+
+    it('should write pairs into the supplied array', () => {
+      const dict = buildDictionary(keys, values);
+      const results = new Int32Array(16);
+
+      const count = dict.commonPrefixSearchInto('apple', results);
+      expect(count).toBe(4);
+      expect(Array.from(results.subarray(0, count * 2))).toEqual([1, 1, 2, 2, 3, 3, 100, 5]);
+
+      // The same array can be reused for the next search
+      expect(dict.commonPrefixSearchInto('ape', results)).toBe(2);
+      expect(Array.from(results.subarray(0, 4))).toEqual([1, 1, 2, 2]);
+
+      dict.dispose();
+    });
+
+    it('should return the total count when the array is too small', () => {
+      const dict = buildDictionary(keys, values);
+      const results = new Int32Array(4);
+
+      const count = dict.commonPrefixSearchInto('apple', results);
+      expect(count).toBe(4);
+      expect(Array.from(results)).toEqual([1, 1, 2, 2]);
+
+      dict.dispose();
+    });
+
+    it('should throw when results is not an Int32Array', () => {
+      const dict = buildDictionary(keys, values);
+
+      expect(() => {
+        dict.commonPrefixSearchInto('apple', [] as unknown as Int32Array);
+      }).toThrow(DartsError);
+
+      dict.dispose();
+    });
+  });
+
+  describe('Uint8Array keys', () => {
+    const keys = ['a', 'app', 'apple', '東京'];
+    const values = [1, 3, 100, 7];
+
+    it('should look up UTF-8 bytes in place', () => {
+      const dict = buildDictionary(keys, values);
+
+      expect(dict.exactMatchSearch(Buffer.from('apple'))).toBe(100);
+      expect(dict.exactMatchSearch(new TextEncoder().encode('東京'))).toBe(7);
+      expect(dict.exactMatchSearch(Buffer.from('grape'))).toBe(-1);
+      expect(dict.commonPrefixSearch(Buffer.from('applesauce'))).toEqual([1, 3, 100]);
+      expect(dict.exactMatchSearchBatch([Buffer.from('app'), 'apple', Buffer.from('x')])).toEqual(
+        new Int32Array([3, 100, -1])
+      );
+
+      dict.dispose();
+    });
+
+    it('should slice the bytes by offset and length', () => {
+      const dict = buildDictionary(keys, values);
+      const bytes = Buffer.from('xxapplesauce');
+
+      expect(dict.exactMatchSearch(bytes, 2, 5)).toBe(100);
+      expect(dict.exactMatchSearch(bytes, 2, 3)).toBe(3);
+      expect(dict.commonPrefixSearch(bytes, 2)).toEqual([1, 3, 100]);
+
+      // A Buffer view into a larger pool is read from its own start
+      const view = bytes.subarray(2, 7);
+      expect(dict.exactMatchSearch(view)).toBe(100);
+
+      const results = new Int32Array(8);
+      expect(dict.commonPrefixSearchInto(bytes, results, 2, 3)).toBe(2);
+      expect(Array.from(results.subarray(0, 4))).toEqual([1, 1, 3, 3]);
+
+      let visited = 0;
+      dict.traverse(
+        bytes,
+        (result) => {
+          expect(result.value).toBe(3);
+          visited += 1;
+        },
+        2,
+        3
+      );
+      expect(visited).toBe(1);
+
+      dict.dispose();
+    });
+
+    it('should report match lengths in bytes', () => {
+      const dict = buildDictionary(keys, values);
+
+      expect(Array.from(dict.commonPrefixSearchPairs(Buffer.from('東京タワー')))).toEqual([7, 6]);
+      expect(Array.from(dict.commonPrefixSearchPairs('東京タワー'))).toEqual([7, 2]);
+
+      dict.dispose();
+    });
+
+    it('should reject invalid slices', () => {
+      const dict = buildDictionary(keys, values);
+      const bytes = Buffer.from('apple');
+
+      expect(() => dict.exactMatchSearch(bytes, 6)).toThrow(DartsError);
+      expect(() => dict.exactMatchSearch(bytes, 2, 4)).toThrow(DartsError);
+      expect(() => dict.exactMatchSearch('apple', 1)).toThrow(DartsError);
+
+      dict.dispose();
+    });
   });
 });
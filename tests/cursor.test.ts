@@ -0,0 +1,113 @@
+import { buildDictionary, createDictionary, Dictionary, DartsError, TraverseCursor } from '../src';
+
+describe('TraverseCursor Tests', () => {
+  const keys = ['app', 'apple', 'banana', '東京'];
+  const values = [1, 2, 3, 4];
+  let dict: Dictionary;
+
+  beforeEach(() => {
+    dict = buildDictionary(keys, values);
+  });
+
+  afterEach(() => {
+    dict.dispose();
+  });
+
+  it('should start at the root', () => {
+    const cursor = dict.createCursor();
+
+    expect(cursor).toBeInstanceOf(TraverseCursor);
+    expect(cursor.status).toBe(-1);
+    expect(cursor.keyPos).toBe(0);
+  });
+
+  it('should resume the traversal one fragment at a time', () => {
+    const cursor = dict.createCursor();
+
+    expect(cursor.advance('a')).toBe(-1);
+    expect(cursor.advance('p')).toBe(-1);
+    expect(cursor.advance('p')).toBe(1);
+    expect(cursor.advance('le')).toBe(2);
+    expect(cursor.keyPos).toBe(5);
+    expect(cursor.advance('s')).toBe(-2);
+
+    // A failed cursor stays failed until it is reset
+    expect(cursor.advance('auce')).toBe(-2);
+    expect(cursor.status).toBe(-2);
+  });
+
+  it('should give the same result as advancing the whole key at once', () => {
+    const stepwise = dict.createCursor();
+    const whole = dict.createCursor();
+
+    '東京'.split('').forEach((char) => stepwise.advance(char));
+
+    expect(whole.advance('東京')).toBe(4);
+    expect(stepwise.status).toBe(4);
+    expect(stepwise.nodePos).toBe(whole.nodePos);
+    expect(stepwise.keyPos).toBe(6);
+  });
+
+  it('should accept UTF-8 bytes', () => {
+    const cursor = dict.createCursor();
+    const bytes = Buffer.from('東京');
+
+    expect(cursor.advance(bytes.subarray(0, 2))).toBe(-1);
+    expect(cursor.advance(bytes.subarray(2))).toBe(4);
+  });
+
+  it('should reset to the root', () => {
+    const cursor = dict.createCursor();
+
+    cursor.advance('x');
+    expect(cursor.status).toBe(-2);
+
+    cursor.reset();
+    expect(cursor.status).toBe(-1);
+    expect(cursor.keyPos).toBe(0);
+    expect(cursor.advance('banana')).toBe(3);
+  });
+
+  it('should clone an independent cursor', () => {
+    const cursor = dict.createCursor();
+    cursor.advance('app');
+
+    const copy = cursor.clone();
+    expect(copy.status).toBe(1);
+    expect(copy.keyPos).toBe(3);
+
+    expect(copy.advance('le')).toBe(2);
+    expect(cursor.advance('x')).toBe(-2);
+    expect(copy.status).toBe(2);
+  });
+
+  it('should keep working after the dictionary is disposed', () => {
+    const cursor = dict.createCursor();
+    dict.dispose();
+
+    expect(cursor.advance('apple')).toBe(2);
+  });
+
+  it('should report no path on an empty dictionary', () => {
+    const empty = createDictionary();
+    const cursor = empty.createCursor();
+
+    expect(cursor.advance('apple')).toBe(-2);
+
+    empty.dispose();
+  });
+
+  it('should throw for keys that are not strings or bytes', () => {
+    const cursor = dict.createCursor();
+
+    expect(() => {
+      cursor.advance(1 as unknown as string);
+    }).toThrow(DartsError);
+  });
+
+  it('should throw on a disposed dictionary', () => {
+    dict.dispose();
+
+    expect(() => dict.createCursor()).toThrow(DartsError);
+  });
+});
@@ -0,0 +1,76 @@
+import { buildDictionary, createGroup, DartsError, Dictionary, DictionaryGroup } from '../src';
+
+describe('DictionaryGroup', () => {
+  function createMembers(): Dictionary[] {
+    return [
+      buildDictionary(['京都', '東京', '東京都'], [3, 1, 2]),
+      buildDictionary(['東京', '都庁'], [10, 11]),
+      buildDictionary(['東京都庁', '😀'], [20, 21]),
+    ];
+  }
+
+  it('should let the first member holding a key win', () => {
+    const group = createGroup(createMembers());
+
+    expect(group.size).toBe(3);
+    expect(Array.from(group.exactMatchSearch('東京'))).toEqual([0, 1]);
+    expect(Array.from(group.exactMatchSearch('都庁'))).toEqual([1, 11]);
+    expect(group.exactMatchSearch('大阪')).toHaveLength(0);
+  });
+
+  it('should report every member holding a key when duplicates are kept', () => {
+    const group = new DictionaryGroup(createMembers(), { duplicates: 'all' });
+
+    expect(Array.from(group.exactMatchSearch('東京'))).toEqual([0, 1, 1, 10]);
+    expect(Array.from(group.commonPrefixSearch('東京都庁'))).toEqual([
+      0, 1, 2, 1, 10, 2, 0, 2, 3, 2, 20, 4,
+    ]);
+  });
+
+  it('should merge prefix matches by length and then by member', () => {
+    const group = createGroup(createMembers());
+
+    // (source, value, length) triples; the second member's 東京 is hidden by the first's
+    expect(Array.from(group.commonPrefixSearch('東京都庁です'))).toEqual([
+      0, 1, 2, 0, 2, 3, 2, 20, 4,
+    ]);
+    expect(group.commonPrefixSearch('大阪')).toHaveLength(0);
+  });
+
+  it('should tokenize a text against every member', () => {
+    const group = createGroup(createMembers());
+
+    // (start, length, value, source) quadruples
+    expect(Array.from(group.tokenize('東京都庁です'))).toEqual([
+      0, 4, 20, 2, 4, 1, -1, -1, 5, 1, -1, -1,
+    ]);
+    expect(Array.from(group.tokenize('東京😀'))).toEqual([0, 2, 1, 0, 2, 2, 21, 2]);
+    expect(Array.from(group.tokenize('東京都', 'all-matches'))).toEqual([
+      0, 2, 1, 0, 0, 3, 2, 0, 1, 2, 3, 0,
+    ]);
+    expect(Array.from(group.tokenize('x京', 'lattice'))).toEqual([0, 1, -1, -1, 1, 1, -1, -1]);
+    expect(group.tokenize('')).toHaveLength(0);
+  });
+
+  it('should keep reading the members after they are disposed', () => {
+    const members = createMembers();
+    const group = createGroup(members);
+    members.forEach((member) => member.dispose());
+
+    expect(Array.from(group.exactMatchSearch('😀'))).toEqual([2, 21]);
+  });
+
+  it('should reject invalid members and options', () => {
+    const disposed = buildDictionary(['a']);
+    disposed.dispose();
+
+    expect(() => createGroup([])).toThrow(DartsError);
+    expect(() => createGroup([disposed])).toThrow(DartsError);
+    expect(
+      () => new DictionaryGroup(createMembers(), { duplicates: 'none' as unknown as 'all' })
+    ).toThrow(DartsError);
+    expect(() => createGroup(createMembers()).tokenize('東京', 'shortest' as never)).toThrow(
+      DartsError
+    );
+  });
+});
@@ -1,7 +1,15 @@
 import * as path from 'path';
 import * as fs from 'fs';
 import * as os from 'os';
-import { Dictionary, FileNotFoundError, buildDictionary, Builder } from '../src';
+import {
+  DartsError,
+  Dictionary,
+  FileNotFoundError,
+  InvalidDictionaryError,
+  attachDictionary,
+  buildDictionary,
+  Builder,
+} from '../src';
 
 describe('Dictionary', () => {
   let tempDir: string;
@@ -66,6 +74,316 @@ describe('Dictionary', () => {
       // Clean up
       dict.dispose();
     });
+
+    it('should load a memory-mapped dictionary', () => {
+      const builder = new Builder();
+      const mappedPath = path.join(tempDir, 'mapped.darts');
+      builder.buildAndSaveSync(['apple', 'banana', 'orange'], mappedPath, [100, 200, 300]);
+
+      const dict = new Dictionary();
+      expect(dict.loadSync(mappedPath, { mmap: true, prewarm: true, randomAccess: true })).toBe(
+        true
+      );
+      expect(dict.exactMatchSearch('banana')).toBe(200);
+      expect(dict.commonPrefixSearch('orange')).toEqual([300]);
+      expect(dict.exactMatchSearch('grape')).toBe(-1);
+
+      // Reloading from the heap releases the mapping
+      expect(dict.loadSync(mappedPath)).toBe(true);
+      expect(dict.exactMatchSearch('apple')).toBe(100);
+
+      dict.dispose();
+    });
+
+    it('should reject corrupted and truncated dictionary files', () => {
+      const builder = new Builder();
+      const corruptPath = path.join(tempDir, 'corrupt.darts');
+      builder.buildAndSaveSync(['apple', 'banana', 'orange'], corruptPath);
+      const bytes = fs.readFileSync(corruptPath);
+
+      // A flipped bit in the units (which follow the 40-byte header) fails the checksum
+      const corrupted = Buffer.from(bytes);
+      corrupted[64] ^= 1;
+      fs.writeFileSync(corruptPath, corrupted);
+      const dict = new Dictionary();
+      expect(() => dict.loadSync(corruptPath)).toThrow(InvalidDictionaryError);
+      expect(() => dict.loadSync(corruptPath)).toThrow('checksum mismatch');
+
+      // A truncated file no longer matches its header, mapped or not
+      fs.writeFileSync(corruptPath, bytes.subarray(0, bytes.length - 8));
+      expect(() => dict.loadSync(corruptPath)).toThrow(InvalidDictionaryError);
+      expect(() => dict.loadSync(corruptPath, { mmap: true })).toThrow('does not match its header');
+
+      dict.dispose();
+    });
+
+    it('should load a headerless Darts array', () => {
+      // Darts layout of the single key "a" with value 5: the root's child for 'a' is at
+      // base 1 + 'a' + 1 and has base 100, whose terminal unit holds -(5 + 1)
+      const units = new Int32Array(400 * 2);
+      units[0] = 1;
+      units[99 * 2] = 100;
+      units[99 * 2 + 1] = 1;
+      units[100 * 2] = -6;
+      units[100 * 2 + 1] = 100;
+      const rawPath = path.join(tempDir, 'raw.darts');
+      fs.writeFileSync(rawPath, Buffer.from(units.buffer));
+
+      const dict = new Dictionary();
+      expect(dict.loadSync(rawPath)).toBe(true);
+      expect(dict.exactMatchSearch('a')).toBe(5);
+      expect(dict.exactMatchSearch('b')).toBe(-1);
+
+      dict.dispose();
+    });
+
+    it('should throw FileNotFoundError when a mapped file does not exist', () => {
+      const dict = new Dictionary();
+      expect(() => {
+        dict.loadSync(path.join(tempDir, 'non-existent.darts'), { mmap: true });
+      }).toThrow(FileNotFoundError);
+      dict.dispose();
+    });
+  });
+
+  describe('load and save', () => {
+    it('should save and load a dictionary asynchronously', async () => {
+      const asyncPath = path.join(tempDir, 'async.darts');
+      const built = buildDictionary(['apple', 'banana'], [100, 200]);
+      await expect(built.save(asyncPath)).resolves.toBe(true);
+      built.dispose();
+
+      const dict = new Dictionary();
+      await expect(dict.load(asyncPath)).resolves.toBe(true);
+      expect(dict.exactMatchSearch('apple')).toBe(100);
+      expect(dict.exactMatchSearch('banana')).toBe(200);
+
+      // Memory-mapped loading also works in the background
+      await expect(dict.load(asyncPath, { mmap: true })).resolves.toBe(true);
+      expect(dict.exactMatchSearch('banana')).toBe(200);
+
+      dict.dispose();
+    });
+
+    it('should keep the previous contents until an asynchronous load completes', async () => {
+      const asyncPath = path.join(tempDir, 'reload.darts');
+      const builder = new Builder();
+      builder.buildAndSaveSync(['orange'], asyncPath, [300]);
+
+      const dict = buildDictionary(['apple'], [100]);
+      const loading = dict.load(asyncPath);
+      expect(dict.exactMatchSearch('apple')).toBe(100);
+
+      await loading;
+      expect(dict.exactMatchSearch('apple')).toBe(-1);
+      expect(dict.exactMatchSearch('orange')).toBe(300);
+
+      dict.dispose();
+    });
+
+    it('should swap the contents of two dictionaries', () => {
+      const dict = buildDictionary(['apple'], [100]);
+      const next = buildDictionary(['orange'], [300]);
+      const cursor = dict.createCursor();
+
+      dict.swap(next);
+      expect(dict.exactMatchSearch('orange')).toBe(300);
+      expect(next.exactMatchSearch('apple')).toBe(100);
+
+      // The cursor keeps the array it was created on after its last handle is gone
+      next.dispose();
+      expect(cursor.advance('apple')).toBe(100);
+      expect(() => dict.swap(next)).toThrow(DartsError);
+
+      dict.dispose();
+    });
+
+    it('should keep saving the previous contents when swapped during a save', async () => {
+      const savePath = path.join(tempDir, 'swapped.darts');
+      const dict = buildDictionary(['apple'], [100]);
+      const next = buildDictionary(['orange'], [300]);
+
+      const saving = dict.save(savePath);
+      dict.swap(next);
+      next.dispose();
+      await saving;
+
+      const saved = new Dictionary();
+      saved.loadSync(savePath);
+      expect(saved.exactMatchSearch('apple')).toBe(100);
+
+      saved.dispose();
+      dict.dispose();
+    });
+
+    it('should reject with FileNotFoundError when file does not exist', async () => {
+      const dict = new Dictionary();
+      await expect(dict.load(path.join(tempDir, 'non-existent.darts'))).rejects.toThrow(
+        FileNotFoundError
+      );
+      dict.dispose();
+    });
+
+    it('should save synchronously', () => {
+      const syncPath = path.join(tempDir, 'sync.darts');
+      const dict = buildDictionary(['apple']);
+      expect(dict.saveSync(syncPath)).toBe(true);
+      expect(fs.existsSync(syncPath)).toBe(true);
+      dict.dispose();
+    });
+
+    it('should find the same values after saving with relayout', async () => {
+      const words = ['app', 'apple', 'application', 'banana', 'band', '東京', '東京都'];
+      const dict = buildDictionary(words, undefined, { scanTable: true });
+      const syncPath = path.join(tempDir, 'relayout-sync.darts');
+      const asyncPath = path.join(tempDir, 'relayout-async.darts');
+      expect(dict.saveSync(syncPath, { relayout: true })).toBe(true);
+      await expect(dict.save(asyncPath, { relayout: true })).resolves.toBe(true);
+
+      [syncPath, asyncPath].forEach((filePath) => {
+        const relaid = new Dictionary();
+        relaid.loadSync(filePath);
+        words.forEach((word, i) => expect(relaid.exactMatchSearch(word)).toBe(i));
+        expect(relaid.exactMatchSearch('ban')).toBe(-1);
+        expect(relaid.commonPrefixSearch('applications')).toEqual([0, 2]);
+        expect(relaid.predictiveSearch('東京')).toEqual([5, 6]);
+        expect(relaid.stats().scanTableBytes).toBeGreaterThan(0);
+        relaid.dispose();
+      });
+
+      dict.dispose();
+    });
+
+    it('should load compressed files', async () => {
+      const words = Array.from({ length: 2000 }, (_, i) => `word${String(i).padStart(5, '0')}`);
+      const dict = buildDictionary(words, undefined, { scanTable: true });
+      const plainPath = path.join(tempDir, 'plain.darts');
+      const syncPath = path.join(tempDir, 'compressed-sync.darts');
+      const asyncPath = path.join(tempDir, 'compressed-async.darts');
+      expect(dict.saveSync(plainPath)).toBe(true);
+      expect(dict.saveSync(syncPath, { compress: true })).toBe(true);
+      await expect(dict.save(asyncPath, { compressionLevel: 9, relayout: true })).resolves.toBe(
+        true
+      );
+      expect(fs.statSync(syncPath).size).toBeLessThan(fs.statSync(plainPath).size);
+
+      const syncLoaded = new Dictionary();
+      syncLoaded.loadSync(syncPath);
+      const asyncLoaded = new Dictionary();
+      await asyncLoaded.load(asyncPath, { mmap: true });
+
+      [syncLoaded, asyncLoaded].forEach((loaded) => {
+        words.forEach((word, i) => expect(loaded.exactMatchSearch(word)).toBe(i));
+        expect(loaded.exactMatchSearch('word')).toBe(-1);
+        // Compressed files are inflated into memory, even when mapping is asked for
+        expect(loaded.stats().mapped).toBe(false);
+        expect(loaded.stats().scanTableBytes).toBeGreaterThan(0);
+        loaded.dispose();
+      });
+
+      dict.dispose();
+    });
+
+    it('should reject invalid compression levels', () => {
+      const dict = buildDictionary(['apple']);
+      const filePath = path.join(tempDir, 'invalid-level.darts');
+
+      expect(() => dict.saveSync(filePath, { compressionLevel: 0 })).toThrow(DartsError);
+      expect(() => dict.saveSync(filePath, { compressionLevel: 1.5 })).toThrow(DartsError);
+
+      dict.dispose();
+    });
+
+    it('should reject damaged compressed files', () => {
+      const dict = buildDictionary(['apple', 'banana']);
+      const filePath = path.join(tempDir, 'damaged.darts');
+      dict.saveSync(filePath, { compress: true });
+      const bytes = fs.readFileSync(filePath);
+      bytes[bytes.length - 1] ^= 0xff;
+      fs.writeFileSync(filePath, bytes);
+
+      const loaded = new Dictionary();
+      expect(() => loaded.loadSync(filePath)).toThrow(DartsError);
+
+      loaded.dispose();
+      dict.dispose();
+    });
+  });
+
+  describe('buffers', () => {
+    const words = ['apple', 'application', 'banana', '東京'];
+
+    it('should serialize to a buffer holding what a file would', () => {
+      const dict = buildDictionary(words, undefined, { scanTable: true });
+      const filePath = path.join(tempDir, 'buffer.darts');
+      dict.saveSync(filePath);
+
+      const buffer = dict.saveToBuffer();
+      expect(buffer).toBeInstanceOf(ArrayBuffer);
+      expect(Buffer.from(buffer).equals(fs.readFileSync(filePath))).toBe(true);
+
+      dict.dispose();
+    });
+
+    it('should load copied and in-place buffers', () => {
+      const dict = buildDictionary(words);
+      const buffer = dict.saveToBuffer();
+      const compressed = dict.saveToBuffer({ compress: true });
+      dict.dispose();
+
+      const copied = new Dictionary();
+      expect(copied.loadFromBuffer(new Uint8Array(buffer))).toBe(true);
+      const inPlace = new Dictionary();
+      expect(inPlace.loadFromBuffer(buffer, { copy: false })).toBe(true);
+      const inflated = new Dictionary();
+      expect(inflated.loadFromBuffer(compressed, { copy: false })).toBe(true);
+
+      [copied, inPlace, inflated].forEach((loaded) => {
+        words.forEach((word, i) => expect(loaded.exactMatchSearch(word)).toBe(i));
+        expect(loaded.commonPrefixSearch('applications')).toEqual([1]);
+      });
+      // The bytes read in place belong to the addon, so other threads may read them too
+      expect(() => inPlace.share()).not.toThrow();
+      expect(() => copied.share()).not.toThrow();
+
+      copied.dispose();
+      inPlace.dispose();
+      inflated.dispose();
+    });
+
+    it('should keep working after an in-place buffer is transferred', () => {
+      const dict = buildDictionary(words);
+      const saved = dict.saveToBuffer();
+      // A buffer that the addon did not make, which is copied even with copy: false
+      const foreign = new ArrayBuffer(saved.byteLength);
+      new Uint8Array(foreign).set(new Uint8Array(saved));
+      dict.dispose();
+
+      const inPlace = new Dictionary();
+      expect(inPlace.loadFromBuffer(saved, { copy: false })).toBe(true);
+      const copied = new Dictionary();
+      expect(copied.loadFromBuffer(foreign, { copy: false })).toBe(true);
+
+      // Transferring detaches the buffers, leaving them empty in this context
+      structuredClone([saved, foreign], { transfer: [saved, foreign] });
+      expect(saved.byteLength).toBe(0);
+      expect(foreign.byteLength).toBe(0);
+
+      [inPlace, copied].forEach((loaded) => {
+        words.forEach((word, i) => expect(loaded.exactMatchSearch(word)).toBe(i));
+        loaded.dispose();
+      });
+    });
+
+    it('should reject buffers that are not dictionaries', () => {
+      const dict = new Dictionary();
+
+      expect(() => dict.saveToBuffer()).toThrow(DartsError);
+      // Any multiple of 8 bytes could be a headerless Darts array
+      expect(() => dict.loadFromBuffer(new Uint8Array(13).fill(7))).toThrow(InvalidDictionaryError);
+
+      dict.dispose();
+    });
   });
 
   describe('exactMatchSearch', () => {
@@ -149,25 +467,129 @@ describe('Dictionary', () => {
     });
   });
 
-  // Test for private method getWordByValue
-  describe('getWordByValue', () => {
-    it('should return the word at the given value index', () => {
-      const words = ['apple', 'banana', 'orange'];
+  describe('restoreKey', () => {
+    it('should restore keys from their values', () => {
+      const words = ['apple', 'banana', 'orange', 'りんご'];
       const dict = buildDictionary(words);
 
-      // Access the private method using reflection
-      // Use type assertion with Dictionary type and access private method
-      // eslint-disable-next-line @typescript-eslint/no-explicit-any, @typescript-eslint/dot-notation
-      const getWordByValue = (dict as any).getWordByValue.bind(dict);
+      expect(dict.restoreKey(0)).toBe('apple');
+      expect(dict.restoreKey(3)).toBe('りんご');
+      expect(dict.restoreKey(-1)).toBeUndefined();
+      expect(dict.restoreKey(4)).toBeUndefined();
+      expect(dict.numKeys()).toBe(4);
+
+      dict.dispose();
+    });
+
+    it('should restore keys from a loaded dictionary', () => {
+      const builder = new Builder();
+      const keysPath = path.join(tempDir, 'keys.darts');
+      // Values need not be the key indices; keys sharing a value restore the first one
+      builder.buildAndSaveSync(['cherry', 'apple', 'banana'], keysPath, [7, 30, 7]);
+
+      const dict = new Dictionary();
+      dict.loadSync(keysPath);
+      expect(dict.restoreKey(30)).toBe('apple');
+      expect(dict.restoreKey(7)).toBe('banana');
+      expect(dict.restoreKey(8)).toBeUndefined();
+      dict.loadSync(keysPath, { mmap: true });
+      expect(dict.restoreKey(30)).toBe('apple');
+      expect(dict.numKeys()).toBe(3);
+
+      // Without a key index, keys cannot be restored
+      const plainPath = path.join(tempDir, 'plain.darts');
+      builder.buildAndSaveSync(['apple'], plainPath, undefined, { keyIndex: false });
+      dict.loadSync(plainPath);
+      expect(() => dict.restoreKey(0)).toThrow('Dictionary has no key index');
+
+      dict.dispose();
+    });
+  });
+
+  describe('stats', () => {
+    it('should report sizes and the build', () => {
+      const dict = buildDictionary(['apple', 'banana', 'orange']);
+      const stats = dict.stats();
+
+      expect(stats.keys).toBe(3);
+      expect(stats.units).toBe(dict.size());
+      expect(stats.nonzeroUnits).toBeGreaterThan(0);
+      expect(stats.nonzeroUnits).toBeLessThanOrEqual(stats.units);
+      expect(stats.fillRatio).toBeCloseTo(stats.nonzeroUnits / stats.units);
+      expect(stats.arrayBytes).toBe(stats.units * stats.unitBytes);
+      expect(stats.keyIndexBytes).toBeGreaterThan(0);
+      expect(stats.residentBytes).toBeGreaterThanOrEqual(stats.arrayBytes);
+      expect(stats.source).toBe('build');
+      expect(stats.durationMs).toBeGreaterThanOrEqual(0);
+      expect(stats.mapped).toBe(false);
+      expect(stats.hugePages).toBe('none');
+      expect(stats.numaNode).toBe(-1);
+
+      dict.dispose();
+    });
+
+    it('should report a loaded dictionary', () => {
+      const statsPath = path.join(tempDir, 'stats.darts');
+      new Builder().buildAndSaveSync(['apple', 'banana'], statsPath);
+
+      const dict = new Dictionary();
+      dict.loadSync(statsPath, { mmap: true });
+      const stats = dict.stats();
+      expect(stats.source).toBe('load');
+      expect(stats.mapped).toBe(true);
+      expect(stats.keys).toBe(2);
+      expect(stats.residentBytes).toBeLessThanOrEqual(fs.statSync(statsPath).size);
+
+      dict.dispose();
+    });
+
+    it('should load into huge pages and NUMA replicas where the OS provides them', async () => {
+      const pagesPath = path.join(tempDir, 'pages.darts');
+      new Builder().buildAndSaveSync(['apple', 'banana'], pagesPath, [100, 200]);
+
+      const dict = new Dictionary();
+      dict.loadSync(pagesPath, { hugePages: true, numaReplicas: true });
+      expect(dict.exactMatchSearch('banana')).toBe(200);
+      expect(['none', 'transparent', 'explicit']).toContain(dict.stats().hugePages);
+      expect(dict.stats().numaNode).toBeGreaterThanOrEqual(-1);
+
+      // A handle attached from another thread reads the same entries, from its own copy or not
+      const attached = attachDictionary(dict.share());
+      expect(attached.exactMatchSearch('apple')).toBe(100);
+      attached.dispose();
+
+      await dict.load(pagesPath, { mmap: true, hugePages: true });
+      expect(dict.exactMatchSearch('apple')).toBe(100);
+      expect(dict.stats().mapped).toBe(true);
+
+      dict.dispose();
+    });
+
+    it('should count lookups only while enabled', () => {
+      const dict = buildDictionary(['apple', 'banana', 'orange']);
+
+      dict.exactMatchSearch('apple');
+      expect(dict.stats().lookups.enabled).toBe(false);
+      expect(dict.stats().lookups.exactMatch.calls).toBe(0);
 
-      // Test valid indices
-      expect(getWordByValue(0)).toBe('apple');
-      expect(getWordByValue(1)).toBe('banana');
-      expect(getWordByValue(2)).toBe('orange');
+      dict.enableStats();
+      dict.exactMatchSearch('apple');
+      dict.exactMatchSearchBatch(['apple', 'grape']);
+      dict.commonPrefixSearch('bananas');
+      let { lookups } = dict.stats();
+      expect(lookups.enabled).toBe(true);
+      expect(lookups.exactMatch.calls).toBe(2);
+      expect(lookups.exactMatch.keys).toBe(3);
+      expect(lookups.commonPrefix.calls).toBe(1);
+      const histogramCalls = Array.from(lookups.exactMatch.histogram).reduce((a, b) => a + b, 0);
+      expect(histogramCalls).toBe(2);
 
-      // Test invalid indices
-      expect(getWordByValue(-1)).toBeUndefined();
-      expect(getWordByValue(3)).toBeUndefined();
+      dict.resetStats();
+      dict.enableStats(false);
+      dict.exactMatchSearch('apple');
+      ({ lookups } = dict.stats());
+      expect(lookups.exactMatch.calls).toBe(0);
+      expect(lookups.commonPrefix.calls).toBe(0);
 
       dict.dispose();
     });
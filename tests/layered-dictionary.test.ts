@@ -0,0 +1,131 @@
+import { buildDictionary, DartsError, Dictionary, LayeredDictionary } from '../src';
+
+describe('LayeredDictionary', () => {
+  const words = ['apple', 'application', 'apply', 'banana'];
+
+  function createLayered(options?: Parameters<typeof buildDictionary>[2]): LayeredDictionary {
+    const base = buildDictionary(words, [1, 2, 3, 4], options);
+    const layered = new LayeredDictionary(base);
+    // The layered dictionary keeps its own reference to the array
+    base.dispose();
+    return layered;
+  }
+
+  it('should read the base when there are no changes', () => {
+    const layered = createLayered();
+
+    expect(layered.exactMatchSearch('apple')).toBe(1);
+    expect(layered.exactMatchSearch('grape')).toBe(-1);
+    expect(layered.pendingChanges).toBe(0);
+    expect(layered.compacting).toBe(false);
+  });
+
+  it('should apply additions, new values and removals to every lookup', () => {
+    const layered = createLayered();
+
+    layered.set('app', 10);
+    layered.set('apply', 30);
+    expect(layered.delete('apple')).toBe(true);
+    expect(layered.delete('grape')).toBe(false);
+
+    expect(layered.exactMatchSearch('app')).toBe(10);
+    expect(layered.exactMatchSearch('apply')).toBe(30);
+    expect(layered.exactMatchSearch('apple')).toBe(-1);
+    expect(layered.commonPrefixSearch('applesauce')).toEqual([10]);
+    expect(layered.commonPrefixSearch('apply')).toEqual([10, 30]);
+    expect(layered.predictiveSearchKeys('app')).toEqual([
+      { key: 'app', value: 10 },
+      { key: 'application', value: 2 },
+      { key: 'apply', value: 30 },
+    ]);
+    expect(layered.predictiveSearchKeys('app', 2)).toEqual([
+      { key: 'app', value: 10 },
+      { key: 'application', value: 2 },
+    ]);
+    expect(layered.pendingChanges).toBe(3);
+  });
+
+  it('should let a key be added again after it was removed', () => {
+    const layered = createLayered();
+
+    layered.delete('banana');
+    layered.set('banana', 40);
+
+    expect(layered.exactMatchSearch('banana')).toBe(40);
+  });
+
+  it('should merge the changes into a new base when compacting', async () => {
+    const layered = createLayered({ unitFormat: 'compact' });
+    layered.set('cherry', 5);
+    layered.delete('banana');
+
+    await layered.compact();
+
+    expect(layered.pendingChanges).toBe(0);
+    expect(layered.exactMatchSearch('cherry')).toBe(5);
+    expect(layered.exactMatchSearch('banana')).toBe(-1);
+
+    const base = layered.base();
+    expect(base.exactMatchSearch('cherry')).toBe(5);
+    expect(base.exactMatchSearch('banana')).toBe(-1);
+    expect(base.exactMatchSearch('apple')).toBe(1);
+    expect(base.stats().unitFormat).toBe('compact');
+    base.dispose();
+  });
+
+  it('should keep updates made while compacting', async () => {
+    const layered = createLayered();
+    layered.set('cherry', 5);
+
+    const compaction = layered.compact();
+    expect(layered.compacting).toBe(true);
+    layered.set('cherry', 6);
+    layered.delete('apple');
+    await expect(layered.compact()).rejects.toThrow(DartsError);
+    await compaction;
+
+    expect(layered.compacting).toBe(false);
+    expect(layered.pendingChanges).toBe(2);
+    expect(layered.exactMatchSearch('cherry')).toBe(6);
+    expect(layered.exactMatchSearch('apple')).toBe(-1);
+  });
+
+  it('should compact to an empty dictionary when every key is removed', async () => {
+    const layered = createLayered();
+    words.forEach((word) => layered.delete(word));
+
+    await layered.compact();
+
+    expect(layered.exactMatchSearch('apple')).toBe(-1);
+    expect(layered.predictiveSearchKeys('')).toEqual([]);
+    layered.set('apple', 7);
+    expect(layered.exactMatchSearch('apple')).toBe(7);
+  });
+
+  it('should start from an empty dictionary', () => {
+    const empty = new Dictionary();
+    const layered = new LayeredDictionary(empty);
+    empty.dispose();
+
+    layered.set('kiwi', 1);
+    expect(layered.exactMatchSearch('kiwi')).toBe(1);
+    expect(layered.commonPrefixSearch('kiwis')).toEqual([1]);
+  });
+
+  it('should reject invalid keys and values', () => {
+    const layered = createLayered();
+
+    expect(() => layered.set('', 1)).toThrow(DartsError);
+    expect(() => layered.set('kiwi', -1)).toThrow(DartsError);
+    expect(() => layered.set('kiwi', 1.5)).toThrow(DartsError);
+    expect(layered.pendingChanges).toBe(0);
+  });
+
+  it('should reject a base with a value table', () => {
+    const base = buildDictionary(['a'], undefined, { valueTable: { entries: [[1]] } });
+
+    expect(() => new LayeredDictionary(base)).toThrow(DartsError);
+
+    base.dispose();
+  });
+});
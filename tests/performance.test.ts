@@ -6,6 +6,7 @@ import { Dictionary, Builder, TextDarts } from '../src';
 
 // These tests take a long time to run, so they are skipped in CI
 // To run these tests, change describe.skip to describe
+// For comparable numbers across releases, use `yarn bench` instead (see bench/README.md)
 describe.skip('Performance Tests', () => {
   let tempDir: string;
 
@@ -0,0 +1,94 @@
+import * as path from 'path';
+import * as fs from 'fs';
+import * as os from 'os';
+import { buildDictionary, createDictionary, Dictionary, DartsError, TextDarts } from '../src';
+
+describe('Predictive Search Tests', () => {
+  const keys = ['app', 'apple', 'application', 'apply', 'banana', '東京', '東京タワー'];
+  const values = [1, 2, 3, 4, 5, 6, 7];
+  let dict: Dictionary;
+  let tempDir: string;
+
+  beforeAll(() => {
+    tempDir = path.join(os.tmpdir(), `node-darts-predictive-${Date.now()}`);
+    fs.mkdirSync(tempDir, { recursive: true });
+  });
+
+  afterAll(() => {
+    if (fs.existsSync(tempDir)) {
+      fs.rmSync(tempDir, { recursive: true, force: true });
+    }
+  });
+
+  beforeEach(() => {
+    dict = buildDictionary(keys, values);
+  });
+
+  afterEach(() => {
+    dict.dispose();
+  });
+
+  describe('predictiveSearch', () => {
+    it('should return the values of all keys starting with the prefix in key order', () => {
+      expect(dict.predictiveSearch('app')).toEqual([1, 2, 3, 4]);
+      expect(dict.predictiveSearch('appl')).toEqual([2, 3, 4]);
+      expect(dict.predictiveSearch('東京')).toEqual([6, 7]);
+    });
+
+    it('should include the prefix itself when it is a key', () => {
+      expect(dict.predictiveSearch('apple')).toEqual([2]);
+    });
+
+    it('should return an empty array when no key starts with the prefix', () => {
+      expect(dict.predictiveSearch('cherry')).toEqual([]);
+      expect(dict.predictiveSearch('applex')).toEqual([]);
+    });
+
+    it('should enumerate every key for an empty prefix', () => {
+      expect(dict.predictiveSearch('')).toHaveLength(keys.length);
+    });
+
+    it('should stop after the limit', () => {
+      expect(dict.predictiveSearch('app', 2)).toEqual([1, 2]);
+      expect(dict.predictiveSearch('app', 0)).toEqual([1, 2, 3, 4]);
+    });
+
+    it('should return an empty array for an empty dictionary', () => {
+      const empty = createDictionary();
+      expect(empty.predictiveSearch('a')).toEqual([]);
+      empty.dispose();
+    });
+
+    it('should throw on a disposed dictionary', () => {
+      dict.dispose();
+      expect(() => dict.predictiveSearch('a')).toThrow(DartsError);
+    });
+  });
+
+  describe('predictiveSearchKeys', () => {
+    it('should restore the matching keys', () => {
+      expect(dict.predictiveSearchKeys('appl')).toEqual([
+        { key: 'apple', value: 2 },
+        { key: 'application', value: 3 },
+        { key: 'apply', value: 4 },
+      ]);
+    });
+
+    it('should restore multibyte keys', () => {
+      expect(dict.predictiveSearchKeys('東')).toEqual([
+        { key: '東京', value: 6 },
+        { key: '東京タワー', value: 7 },
+      ]);
+    });
+
+    it('should work on a dictionary loaded from a file', () => {
+      const filePath = path.join(tempDir, 'predictive.darts');
+      dict.saveSync(filePath);
+
+      const darts = TextDarts.load(filePath);
+      expect(darts.predictiveSearchKeys('ban')).toEqual([{ key: 'banana', value: 5 }]);
+      expect(darts.predictiveSearch('app', 1)).toEqual([1]);
+      darts.dispose();
+    });
+  });
+});
@@ -4,7 +4,7 @@
  * This file tests the text replacement functionality (replaceWords).
  */
 
-import { buildDictionary, TextDarts } from '../src';
+import { buildDictionary, Dictionary, TextDarts } from '../src';
 
 describe('replaceWords', () => {
   // テストで使用する変数
@@ -61,6 +61,57 @@ describe('replaceWords', () => {
       const result = dict1.replaceWords(noMatchText, (word: string) => `<<${word}>>`);
       expect(result).toBe('I like grapes');
     });
+
+    it('should keep words without an entry in the replacement map', () => {
+      const result = dict1.replaceWords(text, { apple: 'APPLE' });
+      expect(result).toBe('I like APPLE and pineapple for breakfast.');
+    });
+
+    it('should replace multibyte words at the correct positions', () => {
+      const jaDict = buildDictionary(['東京', '東京都', '😀']);
+      const jaText = '😀東京都と東京';
+      expect(jaDict.replaceWords(jaText, (word: string) => `[${word}]`)).toBe(
+        '[😀][東京都]と[東京]'
+      );
+      expect(jaDict.replaceWords(jaText, { 東京: 'Tokyo' })).toBe('😀東京都とTokyo');
+      jaDict.dispose();
+    });
+
+    it('should keep the code units around replaced words', () => {
+      const dict = buildDictionary(['東京']);
+      const result = dict.replaceWords('\uD800東京🗼', { 東京: 'Tokyo' });
+      expect(result).toBe('\uD800Tokyo🗼');
+      dict.dispose();
+    });
+
+    it('should match words longer than 50 characters', () => {
+      const longWord = 'x'.repeat(60);
+      const longDict = buildDictionary([longWord]);
+      expect(longDict.replaceWords(`a${longWord}b`, () => '*')).toBe('a*b');
+      longDict.dispose();
+    });
+  });
+
+  describe('findMatches', () => {
+    it('should return (start, length, value) triples in UTF-16 code units', () => {
+      const dict = buildDictionary(['app', 'apple', '東京', '東京都'], [1, 2, 3, 4]);
+      const matches = dict.findMatches('😀apple 東京都');
+      expect(Array.from(matches)).toEqual([2, 5, 2, 8, 3, 4]);
+      dict.dispose();
+    });
+
+    it('should count a lone surrogate as one code unit', () => {
+      const dict = buildDictionary(['apple', '東京'], [1, 2]);
+      const matches = dict.findMatches('\uD800apple\uDC00東京');
+      expect(Array.from(matches)).toEqual([1, 5, 1, 7, 2, 2]);
+      dict.dispose();
+    });
+
+    it('should return an empty array for an empty dictionary', () => {
+      const dict = new Dictionary();
+      expect(dict.findMatches('apple')).toHaveLength(0);
+      dict.dispose();
+    });
   });
 
   describe('TextDarts', () => {
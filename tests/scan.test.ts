@@ -0,0 +1,142 @@
+import * as path from 'path';
+import * as fs from 'fs';
+import * as os from 'os';
+import { buildDictionary, Builder, Dictionary, TextDarts } from '../src';
+
+describe('scan', () => {
+  const words = ['he', 'she', 'his', 'hers'];
+
+  // Splits the triples into [word, start] pairs
+  function toOccurrences(text: string, triples: Int32Array): [string, number][] {
+    const occurrences: [string, number][] = [];
+    for (let i = 0; i < triples.length; i += 3) {
+      occurrences.push([text.substring(triples[i], triples[i] + triples[i + 1]), triples[i]]);
+    }
+    return occurrences;
+  }
+
+  it('should report every occurrence, overlapping ones included', () => {
+    const dict = buildDictionary(words);
+    const text = 'ushers';
+
+    expect(toOccurrences(text, dict.scan(text))).toEqual([
+      ['she', 1],
+      ['he', 2],
+      ['hers', 2],
+    ]);
+
+    dict.dispose();
+  });
+
+  it('should find the same occurrences as a prefix search at every position', () => {
+    const keys = ['a', 'ab', 'abc', 'b', 'bc', 'bca', 'c', 'cab'];
+    const dict = buildDictionary(keys);
+    const text = 'abcabcaabbcca';
+
+    const expected: number[][] = [];
+    for (let start = 0; start < text.length; start++) {
+      const pairs = dict.commonPrefixSearchPairs(text.substring(start));
+      for (let i = 0; i < pairs.length; i += 2) {
+        expected.push([start, pairs[i + 1], pairs[i]]);
+      }
+    }
+    const triples = Array.from(dict.scan(text));
+    const actual: number[][] = [];
+    for (let i = 0; i < triples.length; i += 3) {
+      actual.push(triples.slice(i, i + 3));
+    }
+
+    const byPosition = (a: number[], b: number[]) => a[0] - b[0] || a[1] - b[1];
+    expect(actual.sort(byPosition)).toEqual(expected.sort(byPosition));
+
+    dict.dispose();
+  });
+
+  it('should report UTF-16 positions for strings and byte positions for Uint8Arrays', () => {
+    const dict = buildDictionary(['東京', '京都', '🗼'], [1, 2, 3]);
+
+    expect(Array.from(dict.scan('🗼東京都'))).toEqual([0, 2, 3, 2, 2, 1, 3, 2, 2]);
+    expect(Array.from(dict.scan(Buffer.from('xx東京都'), 2))).toEqual([0, 6, 1, 3, 6, 2]);
+
+    dict.dispose();
+  });
+
+  it('should find keys containing NUL characters', () => {
+    const dict = buildDictionary(['a\u0000b', 'b'], [1, 2]);
+
+    expect(Array.from(dict.scan('xa\u0000b'))).toEqual([1, 3, 1, 3, 1, 2]);
+    expect(Array.from(dict.scan(Buffer.from('xa\u0000b')))).toEqual([1, 3, 1, 3, 1, 2]);
+
+    dict.dispose();
+  });
+
+  it('should return no occurrences for an empty dictionary or text', () => {
+    const empty = new Dictionary();
+    expect(empty.scan('text')).toHaveLength(0);
+    empty.dispose();
+
+    const dict = buildDictionary(words);
+    expect(dict.scan('')).toHaveLength(0);
+    dict.dispose();
+  });
+
+  it('should work on compact dictionaries', () => {
+    const dict = buildDictionary(words, undefined, { unitFormat: 'compact' });
+
+    expect(toOccurrences('ushers', dict.scan('ushers'))).toEqual([
+      ['she', 1],
+      ['he', 2],
+      ['hers', 2],
+    ]);
+
+    dict.dispose();
+  });
+
+  describe('scan table', () => {
+    let tempDir: string;
+
+    beforeAll(() => {
+      tempDir = path.join(os.tmpdir(), `node-darts-scan-test-${Date.now()}`);
+      fs.mkdirSync(tempDir, { recursive: true });
+    });
+
+    afterAll(() => {
+      fs.rmSync(tempDir, { recursive: true, force: true });
+    });
+
+    it('should be computed on the first scan', () => {
+      const dict = buildDictionary(words);
+
+      expect(dict.stats().scanTableBytes).toBe(0);
+      dict.scan('she');
+      expect(dict.stats().scanTableBytes).toBeGreaterThan(0);
+
+      dict.dispose();
+    });
+
+    it('should be saved and loaded with the dictionary', () => {
+      const dictPath = path.join(tempDir, 'scan.darts');
+      new Builder().buildAndSaveSync(words, dictPath, undefined, { scanTable: true });
+
+      for (const mmap of [false, true]) {
+        const dict = new Dictionary();
+        dict.loadSync(dictPath, { mmap });
+        expect(dict.stats().scanTableBytes).toBeGreaterThan(0);
+        expect(toOccurrences('ushers', dict.scan('ushers'))).toEqual([
+          ['she', 1],
+          ['he', 2],
+          ['hers', 2],
+        ]);
+        dict.dispose();
+      }
+    });
+  });
+
+  it('should be available from TextDarts', () => {
+    const darts = TextDarts.build(words);
+
+    expect(darts.scan('his')).toHaveLength(3);
+
+    darts.dispose();
+  });
+});
@@ -0,0 +1,120 @@
+import * as path from 'path';
+import * as fs from 'fs';
+import * as os from 'os';
+import { createBuilder, BuildError, FileNotFoundError, StreamBuilder } from '../src';
+
+describe('StreamBuilder Tests', () => {
+  let tempDir: string;
+
+  beforeAll(() => {
+    tempDir = path.join(os.tmpdir(), `node-darts-stream-${Date.now()}`);
+    fs.mkdirSync(tempDir, { recursive: true });
+  });
+
+  afterAll(() => {
+    if (fs.existsSync(tempDir)) {
+      fs.rmSync(tempDir, { recursive: true, force: true });
+    }
+  });
+
+  describe('createStream', () => {
+    it('should build from chunks split at arbitrary positions', async () => {
+      const stream = createBuilder().createStream();
+      expect(stream).toBeInstanceOf(StreamBuilder);
+
+      stream.add('orange\t30\nap');
+      stream.add(Buffer.from('ple\t10\r\nbana'));
+      stream.add('na\t20\n\n東京\t40');
+      expect(stream.size).toBe(4);
+
+      const dict = await stream.finish();
+      expect(dict.exactMatchSearch('apple')).toBe(10);
+      expect(dict.exactMatchSearch('banana')).toBe(20);
+      expect(dict.exactMatchSearch('orange')).toBe(30);
+      expect(dict.exactMatchSearch('東京')).toBe(40);
+      expect(dict.exactMatchSearch('ap')).toBe(-1);
+      dict.dispose();
+    });
+
+    it('should use indices in sorted order for keys without values', async () => {
+      const stream = createBuilder().createStream();
+      stream.add('cherry\napple\nbanana\n');
+
+      const dict = await stream.finish();
+      expect(dict.exactMatchSearch('apple')).toBe(0);
+      expect(dict.exactMatchSearch('banana')).toBe(1);
+      expect(dict.exactMatchSearch('cherry')).toBe(2);
+      dict.dispose();
+    });
+
+    it('should keep the first value of duplicate keys across spilled runs', async () => {
+      // A tiny memory limit spills a sorted run after almost every key
+      const stream = createBuilder().createStream({ memoryLimit: 8 });
+      const lines: string[] = [];
+      for (let i = 999; i >= 0; i -= 1) {
+        lines.push(`key${i}\t${i}`);
+      }
+      lines.push('key500\t12345');
+      stream.add(`${lines.join('\n')}\n`);
+
+      const dict = await stream.finish();
+      expect(dict.size()).toBeGreaterThan(0);
+      expect(dict.exactMatchSearch('key0')).toBe(0);
+      expect(dict.exactMatchSearch('key500')).toBe(500);
+      expect(dict.exactMatchSearch('key999')).toBe(999);
+      expect(dict.predictiveSearch('key')).toHaveLength(1000);
+      dict.dispose();
+    });
+
+    it('should reject invalid values', () => {
+      const stream = createBuilder().createStream();
+
+      expect(() => stream.add('apple\tx\n')).toThrow(BuildError);
+      // The builder cannot be used after a failure
+      expect(() => stream.add('banana\n')).toThrow(BuildError);
+    });
+
+    it('should reject an empty stream', async () => {
+      const stream = createBuilder().createStream();
+      stream.add('\n\n');
+
+      await expect(stream.finish()).rejects.toThrow(BuildError);
+    });
+
+    it('should not be usable after finishing', async () => {
+      const stream = createBuilder().createStream();
+      stream.add('apple\n');
+
+      const dict = await stream.finish();
+      expect(() => stream.add('banana\n')).toThrow(BuildError);
+      await expect(stream.finish()).rejects.toThrow(BuildError);
+      dict.dispose();
+    });
+  });
+
+  describe('buildFromFile', () => {
+    it('should build from a key file', async () => {
+      const filePath = path.join(tempDir, 'keys.tsv');
+      fs.writeFileSync(filePath, 'banana\t2\napple\t1\ncherry\t3');
+
+      const dict = await createBuilder().buildFromFile(filePath, { memoryLimit: 4 });
+      expect(dict.exactMatchSearch('apple')).toBe(1);
+      expect(dict.exactMatchSearch('banana')).toBe(2);
+      expect(dict.exactMatchSearch('cherry')).toBe(3);
+      dict.dispose();
+    });
+
+    it('should report the line of an invalid entry', async () => {
+      const filePath = path.join(tempDir, 'invalid.tsv');
+      fs.writeFileSync(filePath, 'apple\t1\n\tbanana\n');
+
+      await expect(createBuilder().buildFromFile(filePath)).rejects.toThrow('line 2');
+    });
+
+    it('should throw FileNotFoundError for a missing file', async () => {
+      await expect(
+        createBuilder().buildFromFile(path.join(tempDir, 'missing.tsv'))
+      ).rejects.toThrow(FileNotFoundError);
+    });
+  });
+});
@@ -233,7 +233,7 @@ describe('TextDarts', () => {
   });
 
   describe('size', () => {
-    it('should return the size of the dictionary from words array', () => {
+    it('should return the number of keys', () => {
       const words = ['apple', 'banana', 'orange'];
       const td = TextDarts.build(words);
 
@@ -241,15 +241,14 @@ describe('TextDarts', () => {
       td.dispose();
     });
 
-    it('should return the size from dictionary when words array is not available', async () => {
-      // Create a dictionary without words array by loading from file
+    it('should return the size of a loaded dictionary', async () => {
       TextDarts.buildAndSaveSync(['apple', 'banana', 'orange'], dictPath);
 
-      // Load the dictionary - this doesn't set the words array
       const td = TextDarts.load(dictPath);
 
-      // Size should still work by falling back to dictionary.size()
-      expect(td.size()).toBeGreaterThan(0);
+      // The key count and the keys are read from the file
+      expect(td.size()).toBe(3);
+      expect(td.restoreKey(1)).toBe('banana');
 
       td.dispose();
     });
@@ -0,0 +1,97 @@
+import { buildDictionary, DartsError, TextDarts } from '../src';
+
+describe('tokenize', () => {
+  const words = ['東', '東京', '京都', '都', 'タワー'];
+  const values = [1, 2, 3, 4, 5];
+
+  // Splits the triples into [word, value] pairs
+  function toTokens(text: string, triples: Int32Array): [string, number][] {
+    const tokens: [string, number][] = [];
+    for (let i = 0; i < triples.length; i += 3) {
+      tokens.push([text.substring(triples[i], triples[i] + triples[i + 1]), triples[i + 2]]);
+    }
+    return tokens;
+  }
+
+  it('should split a text at the longest matches', () => {
+    const dict = buildDictionary(words, values);
+    const text = '東京都のタワー';
+
+    expect(toTokens(text, dict.tokenize(text))).toEqual([
+      ['東京', 2],
+      ['都', 4],
+      ['の', -1],
+      ['タワー', 5],
+    ]);
+    expect(dict.tokenize(text, 'longest')).toEqual(dict.tokenize(text));
+
+    dict.dispose();
+  });
+
+  it('should report every match in all-matches mode', () => {
+    const dict = buildDictionary(words, values);
+    const text = '東京都の';
+
+    expect(toTokens(text, dict.tokenize(text, 'all-matches'))).toEqual([
+      ['東', 1],
+      ['東京', 2],
+      ['京都', 3],
+      ['都', 4],
+    ]);
+
+    dict.dispose();
+  });
+
+  it('should add unknown characters to a lattice', () => {
+    const dict = buildDictionary(words, values);
+    const text = '東京都の';
+
+    expect(Array.from(dict.tokenize(text, 'lattice'))).toEqual([
+      0, 1, 1, 0, 2, 2, 1, 2, 3, 2, 1, 4, 3, 1, -1,
+    ]);
+
+    dict.dispose();
+  });
+
+  it('should count surrogate pairs as two UTF-16 code units', () => {
+    const dict = buildDictionary(['🗼', 'タワー'], [1, 2]);
+    const text = '𠮷🗼タワー';
+
+    expect(Array.from(dict.tokenize(text))).toEqual([0, 2, -1, 2, 2, 1, 4, 3, 2]);
+
+    dict.dispose();
+  });
+
+  it('should report byte positions for a Uint8Array text', () => {
+    const dict = buildDictionary(words, values);
+    const bytes = Buffer.from('xx東京タワー');
+
+    expect(Array.from(dict.tokenize(bytes, 'longest', 2))).toEqual([0, 6, 2, 6, 9, 5]);
+
+    dict.dispose();
+  });
+
+  it('should return no tokens for an empty text', () => {
+    const dict = buildDictionary(words, values);
+
+    expect(dict.tokenize('')).toHaveLength(0);
+
+    dict.dispose();
+  });
+
+  it('should reject an unknown mode', () => {
+    const dict = buildDictionary(words, values);
+
+    expect(() => dict.tokenize('東京', 'shortest' as 'longest')).toThrow(DartsError);
+
+    dict.dispose();
+  });
+
+  it('should be available from TextDarts', () => {
+    const darts = TextDarts.build(words, values);
+
+    expect(Array.from(darts.tokenize('京都'))).toEqual([0, 2, 3]);
+
+    darts.dispose();
+  });
+});
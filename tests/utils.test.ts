@@ -8,6 +8,7 @@ import {
   sortStrings,
   uniqueArray,
   sortAndUniqueStrings,
+  encodeKeys,
 } from '../src/core/utils';
 import { FileNotFoundError } from '../src/core/errors';
 
@@ -149,4 +150,19 @@ describe('Utils', () => {
       expect(sortAndUniqueStrings(['apple'])).toEqual(['apple']);
     });
   });
+
+  describe('encodeKeys', () => {
+    it('should concatenate keys as UTF-8 with their offsets', () => {
+      const { buffer, offsets } = encodeKeys(['ab', '', '東京']);
+
+      expect(Array.from(offsets)).toEqual([0, 2, 2, 8]);
+      expect(buffer.toString('utf8')).toBe('ab東京');
+    });
+
+    it('should handle empty arrays', () => {
+      const { buffer, offsets } = encodeKeys([]);
+      expect(buffer.length).toBe(0);
+      expect(Array.from(offsets)).toEqual([0]);
+    });
+  });
 });
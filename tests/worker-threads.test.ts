@@ -0,0 +1,100 @@
+import * as path from 'path';
+import { Worker } from 'worker_threads';
+import { attachDictionary, buildDictionary, DartsError } from '../src';
+
+// Loads the addon in a worker thread, builds a dictionary there and reports the results
+function runInWorker(keys: string[]): Promise<{ handle: number; values: number[] }> {
+  const source = `
+    const { parentPort, workerData } = require('worker_threads');
+    const native = require('bindings')({ bindings: 'node_darts', module_root: workerData.root });
+    const handle = native.build(workerData.keys);
+    const values = workerData.keys.map((key) => native.exactMatchSearch(handle, key));
+    native.destroyDictionary(handle);
+    parentPort.postMessage({ handle, values });
+  `;
+
+  return new Promise((resolve, reject) => {
+    const worker = new Worker(source, {
+      eval: true,
+      workerData: { keys, root: path.resolve(__dirname, '..') },
+    });
+    worker.once('message', resolve);
+    worker.once('error', reject);
+  });
+}
+
+// Attaches to a shared dictionary in a worker thread and looks the keys up
+function lookUpInWorker(token: number, keys: string[]): Promise<number[]> {
+  const source = `
+    const { parentPort, workerData } = require('worker_threads');
+    const native = require('bindings')({ bindings: 'node_darts', module_root: workerData.root });
+    const handle = native.attachDictionary(workerData.token);
+    const values = workerData.keys.map((key) => native.exactMatchSearch(handle, key));
+    native.destroyDictionary(handle);
+    parentPort.postMessage(values);
+  `;
+
+  return new Promise((resolve, reject) => {
+    const worker = new Worker(source, {
+      eval: true,
+      workerData: { token, keys, root: path.resolve(__dirname, '..') },
+    });
+    worker.once('message', resolve);
+    worker.once('error', reject);
+  });
+}
+
+describe('Worker Threads Tests', () => {
+  it('should keep separate dictionaries in each worker', async () => {
+    const dict = buildDictionary(['main', 'thread'], [10, 20]);
+
+    const results = await Promise.all([
+      runInWorker(['apple', 'banana']),
+      runInWorker(['cherry', 'date', 'elderberry']),
+    ]);
+
+    // Each worker has its own handle table, so both start from the first handle
+    expect(results[0].handle).toBe(results[1].handle);
+    expect(results[0].values).toEqual([0, 1]);
+    expect(results[1].values).toEqual([0, 1, 2]);
+
+    // The main thread's dictionary is untouched
+    expect(dict.exactMatchSearch('thread')).toBe(20);
+    dict.dispose();
+  });
+
+  describe('shared dictionaries', () => {
+    it('should let workers attach to a dictionary without loading a copy', async () => {
+      const dict = buildDictionary(['apple', 'banana', 'orange'], [1, 2, 3]);
+      const token = dict.share();
+
+      const results = await Promise.all([
+        lookUpInWorker(token, ['apple', 'grape']),
+        lookUpInWorker(token, ['orange', 'banana']),
+      ]);
+
+      expect(results).toEqual([
+        [1, -1],
+        [3, 2],
+      ]);
+      dict.dispose();
+    });
+
+    it('should keep the array alive while an attached dictionary exists', () => {
+      const dict = buildDictionary(['apple', 'banana'], [1, 2]);
+      const attached = attachDictionary(dict.share());
+
+      dict.dispose();
+      expect(attached.exactMatchSearch('banana')).toBe(2);
+      attached.dispose();
+    });
+
+    it('should fail to attach once every handle is disposed', () => {
+      const dict = buildDictionary(['apple']);
+      const token = dict.share();
+      dict.dispose();
+
+      expect(() => attachDictionary(token)).toThrow(DartsError);
+    });
+  });
+});